@@ -11,6 +11,7 @@
 #include <benchmark/benchmark.h>
 
 #include <dynd/array.hpp>
+#include <dynd/memblock/array_memory_block.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -47,3 +48,29 @@ static void BM_Array_2DEmpty(benchmark::State &state)
   }
 }
 BENCHMARK_TEMPLATE(BM_Array_2DEmpty, int)->RangePair(2, 512, 2, 512);
+
+// Compares small array creation with and without the array memory block pool
+template <bool Pooled>
+static void BM_Array_SmallEmpty(benchmark::State &state)
+{
+  bool prev = set_array_memory_block_pool_enabled(Pooled);
+  ndt::type tp = ndt::make_type<int>();
+  while (state.KeepRunning()) {
+    nd::empty(state.range_x(), tp);
+  }
+  set_array_memory_block_pool_enabled(prev);
+}
+BENCHMARK_TEMPLATE(BM_Array_SmallEmpty, false)->Range(1, 512);
+BENCHMARK_TEMPLATE(BM_Array_SmallEmpty, true)->Range(1, 512);
+
+template <bool Pooled>
+static void BM_Array_Scalar(benchmark::State &state)
+{
+  bool prev = set_array_memory_block_pool_enabled(Pooled);
+  while (state.KeepRunning()) {
+    nd::array a(1.5);
+  }
+  set_array_memory_block_pool_enabled(prev);
+}
+BENCHMARK_TEMPLATE(BM_Array_Scalar, false);
+BENCHMARK_TEMPLATE(BM_Array_Scalar, true);
@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void run_cast(benchmark::State &state, const char *src_tp,
+                     const char *dst_tp, assign_error_mode errmode)
+{
+  nd::array a = nd::empty(state.range_x(), ndt::type(src_tp));
+  a.vals() = 1;
+  nd::array b = nd::empty(state.range_x(), ndt::type(dst_tp));
+  eval::eval_context ectx;
+  ectx.errmode = errmode;
+  while (state.KeepRunning()) {
+    b.val_assign(a, &ectx);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+
+static void BM_Func_Assign_Int64ToFloat64(benchmark::State &state)
+{
+  run_cast(state, "int64", "float64", assign_error_nocheck);
+}
+BENCHMARK(BM_Func_Assign_Int64ToFloat64)->Range(1024, 1 << 22);
+
+static void BM_Func_Assign_Float64ToFloat32(benchmark::State &state)
+{
+  run_cast(state, "float64", "float32", assign_error_overflow);
+}
+BENCHMARK(BM_Func_Assign_Float64ToFloat32)->Range(1024, 1 << 22);
+
+static void BM_Func_Assign_Int32ToInt16(benchmark::State &state)
+{
+  run_cast(state, "int32", "int16", assign_error_overflow);
+}
+BENCHMARK(BM_Func_Assign_Int32ToInt16)->Range(1024, 1 << 22);
+
+static void BM_Func_Assign_Float16ToFloat32(benchmark::State &state)
+{
+  run_cast(state, "float16", "float32", assign_error_nocheck);
+}
+BENCHMARK(BM_Func_Assign_Float16ToFloat32)->Range(1024, 1 << 22);
+
+static void BM_Func_Assign_Float32ToFloat16(benchmark::State &state)
+{
+  run_cast(state, "float32", "float16", assign_error_overflow);
+}
+BENCHMARK(BM_Func_Assign_Float32ToFloat16)->Range(1024, 1 << 22);
+
+static void BM_Func_Assign_ByteswapInt32ToInt32(benchmark::State &state)
+{
+  run_cast(state, "byteswap[int32]", "int32", assign_error_nocheck);
+}
+BENCHMARK(BM_Func_Assign_ByteswapInt32ToInt32)->Range(1024, 1 << 22);
+
+static void BM_Func_Assign_ByteswapInt32ToFloat64(benchmark::State &state)
+{
+  run_cast(state, "byteswap[int32]", "float64", assign_error_nocheck);
+}
+BENCHMARK(BM_Func_Assign_ByteswapInt32ToFloat64)->Range(1024, 1 << 22);
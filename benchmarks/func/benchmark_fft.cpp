@@ -0,0 +1,43 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/fft.hpp>
+#include <dynd/func/random.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Func_FFT_Complex128(benchmark::State &state)
+{
+  nd::array x = nd::random::uniform(
+      kwds("dst_tp",
+           ndt::make_fixed_dim(state.range_x(),
+                               ndt::make_type<dynd::complex<double>>())));
+  while (state.KeepRunning()) {
+    nd::fft(x);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Func_FFT_Complex128)->Range(64, 1 << 20)->Arg(1000)->Arg(1021);
+
+static void BM_Func_RFFT_Float64(benchmark::State &state)
+{
+  nd::array x = nd::random::uniform(
+      kwds("dst_tp", ndt::make_fixed_dim(state.range_x(),
+                                         ndt::make_type<double>())));
+  while (state.KeepRunning()) {
+    nd::rfft(x);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Func_RFFT_Float64)->Range(64, 1 << 20);
@@ -0,0 +1,61 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/matmul.hpp>
+#include <dynd/func/lift_reduction_arrfunc.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static nd::array make_matrix(intptr_t m, intptr_t n, intptr_t p)
+{
+  nd::array a = nd::empty(m, n, p, ndt::make_type<double>());
+  double *data = reinterpret_cast<double *>(a.get_readwrite_originptr());
+  for (intptr_t i = 0; i < m * n * p; ++i) {
+    data[i] = static_cast<double>(i % 13) - 6.0;
+  }
+  return a;
+}
+
+static void BM_Func_Matmul_Float64(benchmark::State &state)
+{
+  intptr_t size = state.range_x();
+  nd::array a = make_matrix(size, size, 1)(irange(), irange(), 0),
+            b = make_matrix(size, size, 1)(irange(), irange(), 0);
+  while (state.KeepRunning()) {
+    nd::matmul(a, b);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * size *
+                          size * size);
+}
+BENCHMARK(BM_Func_Matmul_Float64)->Range(64, 512);
+
+// The composition users would otherwise write, broadcasting an M * K * 1
+// array against a K * N one and summing the M * K * N product over K
+static void BM_Func_OuterSum_Float64(benchmark::State &state)
+{
+  intptr_t size = state.range_x();
+  nd::array a = make_matrix(size, size, 1),
+            b = make_matrix(size, size, 1)(irange(), irange(), 0);
+  bool reduction_dimflags[3] = {false, true, false};
+  nd::arrfunc sum = lift_reduction_arrfunc(
+      kernels::make_builtin_sum_reduction_arrfunc(float64_type_id),
+      ndt::type("Fixed * Fixed * Fixed * float64"), nd::array(), false, 3,
+      reduction_dimflags, true, true, false, nd::array());
+  nd::array c = nd::empty(size, size, ndt::make_type<double>());
+  while (state.KeepRunning()) {
+    sum((a * b).eval(), kwds("dst", c));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * size *
+                          size * size);
+}
+BENCHMARK(BM_Func_OuterSum_Float64)->Range(64, 512);
@@ -0,0 +1,62 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/apply.hpp>
+#include <dynd/func/neighborhood.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static double sum(const nd::strided_vals<double, 2> &nh)
+{
+  double res = 0;
+  for (nd::strided_vals<double, 2>::iterator it = nh.begin(); it != nh.end();
+       ++it) {
+    res += *it;
+  }
+  return res;
+}
+
+static void BM_Func_Neighborhood_Sum2D(benchmark::State &state)
+{
+  nd::arrfunc af =
+      nd::functional::neighborhood(nd::functional::apply(&sum), 2);
+  nd::array a = nd::empty(state.range_x(), state.range_x(),
+                          ndt::make_type<double>());
+  a.vals() = 1.0;
+  nd::array shape = parse_json("2 * int", "[3, 3]");
+  nd::array offset = parse_json("2 * int", "[-1, -1]");
+  while (state.KeepRunning()) {
+    af(a, kwds("shape", shape, "offset", offset, "threads",
+               static_cast<int>(state.range_y())));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x() * state.range_x());
+}
+BENCHMARK(BM_Func_Neighborhood_Sum2D)->ArgPair(256, 1)->ArgPair(2048, 1)->ArgPair(2048, 4);
+
+static void BM_Func_SeparableConvolution_Float64(benchmark::State &state)
+{
+  vector<vector<double>> weights(2, vector<double>(5, 0.2));
+  nd::arrfunc af = nd::functional::separable_convolution(weights);
+  nd::array a = nd::empty(state.range_x(), state.range_x(),
+                          ndt::make_type<double>());
+  a.vals() = 1.0;
+  nd::array offset = parse_json("2 * int", "[-2, -2]");
+  while (state.KeepRunning()) {
+    af(a, kwds("offset", offset));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x() * state.range_x());
+}
+BENCHMARK(BM_Func_SeparableConvolution_Float64)->Range(256, 2048);
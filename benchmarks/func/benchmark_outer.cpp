@@ -0,0 +1,53 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/apply.hpp>
+#include <dynd/func/outer.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static double sqdist(double x, double y) { return (x - y) * (x - y); }
+
+static nd::array make_points(intptr_t size)
+{
+  vector<double> vals(size);
+  for (intptr_t i = 0; i < size; ++i) {
+    vals[i] = static_cast<double>(i * 7919 % size);
+  }
+  return vals;
+}
+
+static void BM_Func_Outer_Float64(benchmark::State &state)
+{
+  nd::arrfunc af = nd::functional::outer(nd::functional::apply(&sqdist));
+  nd::array x = make_points(state.range_x()), y = make_points(state.range_x());
+  while (state.KeepRunning()) {
+    af(x, y);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x() * state.range_x());
+}
+BENCHMARK(BM_Func_Outer_Float64)->Range(256, 4096);
+
+static void BM_Func_OuterArgMin_Float64(benchmark::State &state)
+{
+  nd::arrfunc af =
+      nd::functional::outer_argmin(nd::functional::apply(&sqdist));
+  nd::array x = make_points(state.range_x()), y = make_points(state.range_x());
+  while (state.KeepRunning()) {
+    af(x, y);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x() * state.range_x());
+}
+BENCHMARK(BM_Func_OuterArgMin_Float64)->Range(256, 4096);
@@ -0,0 +1,69 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/sort.hpp>
+
+using namespace std;
+using namespace dynd;
+
+template <typename T>
+static nd::array make_random(intptr_t size)
+{
+  std::mt19937_64 g(1);
+  vector<T> vals(size);
+  for (intptr_t i = 0; i < size; ++i) {
+    vals[i] = static_cast<T>(g());
+  }
+  return nd::array(vals);
+}
+
+template <typename T>
+static void BM_Func_Sort(benchmark::State &state)
+{
+  nd::array a = make_random<T>(state.range_x());
+  while (state.KeepRunning()) {
+    nd::sort(a);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK_TEMPLATE(BM_Func_Sort, int32_t)->Range(1024, 1 << 22);
+BENCHMARK_TEMPLATE(BM_Func_Sort, int64_t)->Range(1024, 1 << 22);
+BENCHMARK_TEMPLATE(BM_Func_Sort, double)->Range(1024, 1 << 22);
+
+static void BM_Func_ArgSort_Int64(benchmark::State &state)
+{
+  nd::array a = make_random<int64_t>(state.range_x());
+  while (state.KeepRunning()) {
+    nd::argsort(a);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Func_ArgSort_Int64)->Range(1024, 1 << 22);
+
+static void BM_Func_Sort_String(benchmark::State &state)
+{
+  std::mt19937_64 g(1);
+  nd::array a = nd::empty(state.range_x(), ndt::make_string());
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    a(i).vals() = "key_" + to_string(g() % 1000000);
+  }
+  while (state.KeepRunning()) {
+    nd::sort(a);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Func_Sort_String)->Range(1024, 1 << 20);
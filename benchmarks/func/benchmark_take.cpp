@@ -0,0 +1,73 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/take.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Func_Take_Indexed_Float64(benchmark::State &state)
+{
+  std::mt19937_64 g(1);
+  vector<double> vals(state.range_x());
+  vector<intptr_t> index(state.range_x());
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    vals[i] = static_cast<double>(i);
+    index[i] = g() % state.range_x();
+  }
+  nd::array a = vals, b = index;
+  while (state.KeepRunning()) {
+    nd::take(a, b);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Func_Take_Indexed_Float64)->Range(1024, 1 << 22);
+
+static void BM_Func_Take_Masked_Float64(benchmark::State &state)
+{
+  std::mt19937_64 g(1);
+  vector<double> vals(state.range_x());
+  nd::array mask = nd::empty(state.range_x(), ndt::type("bool"));
+  bool1 *mask_data = reinterpret_cast<bool1 *>(mask.get_readwrite_originptr());
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    vals[i] = static_cast<double>(i);
+    mask_data[i] = bool1(g() % 2 == 0);
+  }
+  nd::array a = vals;
+  while (state.KeepRunning()) {
+    nd::take(a, mask);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Func_Take_Masked_Float64)->Range(1024, 1 << 22);
+
+static void BM_Func_Put_Float64(benchmark::State &state)
+{
+  std::mt19937_64 g(1);
+  vector<double> vals(state.range_x());
+  vector<intptr_t> index(state.range_x());
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    vals[i] = static_cast<double>(i);
+    index[i] = g() % state.range_x();
+  }
+  nd::array a = nd::empty(state.range_x(), ndt::type("float64"));
+  nd::array b = index, c = vals;
+  while (state.KeepRunning()) {
+    nd::put(b, c, kwds("dst", a));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Func_Put_Float64)->Range(1024, 1 << 22);
@@ -0,0 +1,48 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/func/unique.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Func_Unique_Int64(benchmark::State &state)
+{
+  std::mt19937_64 g(1);
+  vector<int64_t> vals(state.range_x());
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    vals[i] = g() % 10000;
+  }
+  nd::array a = vals;
+  while (state.KeepRunning()) {
+    nd::unique(a);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Func_Unique_Int64)->Range(1024, 1 << 22);
+
+static void BM_Func_ValueCounts_String(benchmark::State &state)
+{
+  std::mt19937_64 g(1);
+  nd::array a = nd::empty(state.range_x(), ndt::make_string());
+  for (intptr_t i = 0; i < state.range_x(); ++i) {
+    a(i).vals() = "key_" + to_string(g() % 10000);
+  }
+  while (state.KeepRunning()) {
+    nd::value_counts(a);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Func_ValueCounts_String)->Range(1024, 1 << 20);
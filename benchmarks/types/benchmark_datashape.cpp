@@ -0,0 +1,45 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/type.hpp>
+#include <dynd/types/datashape_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static const char *struct_datashape =
+    "{id: int64, name: string, tags: var * string, score: ?float64}";
+
+// Dimensions over a builtin scalar take the fast path of the parser
+static void BM_Datashape_ParseSimple(benchmark::State &state)
+{
+  ndt::type tp;
+  while (state.KeepRunning()) {
+    tp = type_from_datashape("3 * var * float64");
+  }
+}
+BENCHMARK(BM_Datashape_ParseSimple);
+
+static void BM_Datashape_ParseStruct(benchmark::State &state)
+{
+  ndt::type tp;
+  while (state.KeepRunning()) {
+    tp = type_from_datashape(struct_datashape);
+  }
+}
+BENCHMARK(BM_Datashape_ParseStruct);
+
+// ndt::type(const std::string&) looks the datashape up in the cache
+static void BM_Datashape_CachedStruct(benchmark::State &state)
+{
+  string ds = struct_datashape;
+  ndt::type tp;
+  while (state.KeepRunning()) {
+    tp = ndt::type(ds);
+  }
+}
+BENCHMARK(BM_Datashape_CachedStruct);
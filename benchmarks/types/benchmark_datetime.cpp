@@ -0,0 +1,67 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/types/datetime_type.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static nd::array make_datetime_strings(intptr_t size, const char *value)
+{
+  nd::array a = nd::empty(size, ndt::make_string());
+  for (intptr_t i = 0; i < size; ++i) {
+    a(i).vals() = value;
+  }
+  return a;
+}
+
+// Uniform ISO 8601 strings take the fixed layout fast path
+static void BM_Datetime_ParseISO8601(benchmark::State &state)
+{
+  nd::array a = make_datetime_strings(state.range_x(), "2013-02-16T12:13:19.012");
+  ndt::type tp = ndt::make_datetime();
+  while (state.KeepRunning()) {
+    a.ucast(tp).eval();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Datetime_ParseISO8601)->Range(1024, 1 << 20);
+
+// Strings in other formats go through the general parser
+static void BM_Datetime_ParseGeneral(benchmark::State &state)
+{
+  nd::array a = make_datetime_strings(state.range_x(), "Fri Dec 19 15:10:11 1997");
+  ndt::type tp = ndt::make_datetime();
+  while (state.KeepRunning()) {
+    a.ucast(tp).eval();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Datetime_ParseGeneral)->Range(1024, 1 << 20);
+
+static void BM_Datetime_FormatISO8601(benchmark::State &state)
+{
+  nd::array a = make_datetime_strings(state.range_x(), "2013-02-16T12:13:19.012")
+                    .ucast(ndt::make_datetime())
+                    .eval();
+  ndt::type tp = ndt::make_string();
+  while (state.KeepRunning()) {
+    a.ucast(tp).eval();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range_x());
+}
+BENCHMARK(BM_Datetime_FormatISO8601)->Range(1024, 1 << 20);
@@ -1796,6 +1796,38 @@ namespace nd {
                intptr_t end = std::numeric_limits<intptr_t>::max(),
                uint32_t access = default_access_flags);
 
+  /**
+   * Saves an array of fixed dimensions over a POD type to a file, in a
+   * self-describing binary format which ``load_mmap`` opens without
+   * parsing the data. Element types with arrmeta, like structs, can't be
+   * saved.
+   *
+   * The file is a header holding the datashape of the array type, its
+   * shape and strides, and the byte order, padded so the data which
+   * follows it is aligned to ``saved_array_alignment`` bytes. The data is
+   * written in C order.
+   *
+   * \param filename  The name of the file to write.
+   * \param a  The array to save.
+   */
+  void save(const std::string &filename, const array &a);
+
+  /** The alignment of the data within a file written by ``save`` */
+  enum { saved_array_alignment = 64 };
+
+  /**
+   * Memory-maps a file written by ``save``, returning a typed view of the
+   * mapped data. No data is read or copied, so opening is independent of
+   * the array size.
+   *
+   * \param filename  The name of the file to memory map.
+   * \param access  The access permissions with which to open the file.
+   *                With write access, assignments to the array are
+   *                written to the file.
+   */
+  array load_mmap(const std::string &filename,
+                  uint32_t access = default_access_flags);
+
   /**
    * Performs a binary search of the first dimension of the array, which
    * should be sorted. The data/arrmeta must correspond to the type
@@ -28,6 +28,24 @@ DYND_CUDA_HOST_DEVICE uint16_t
 DYND_CUDA_HOST_DEVICE float halfbits_to_float(uint16_t value);
 DYND_CUDA_HOST_DEVICE double halfbits_to_double(uint16_t value);
 
+// Conversions of contiguous runs of values. These use the F16C instructions
+// when the CPU has them, and otherwise a table lookup for float16 -> float
+// and the bit-level conversion above for float -> float16, which rounds
+// the same way. No error checking is done.
+void halfbits_to_float_n(float *dst, const uint16_t *src, size_t count);
+void halfbits_to_double_n(double *dst, const uint16_t *src, size_t count);
+void float_to_halfbits_n(uint16_t *dst, const float *src, size_t count);
+
+/** Returns true if the conversions of runs are using F16C */
+bool float16_f16c_enabled();
+
+/**
+ * Enables or disables the use of F16C by the conversions of runs. It is
+ * only enabled if the CPU supports it. Disabling it is for testing the
+ * portable code.
+ */
+void set_float16_f16c_enabled(bool enabled);
+
 class float16 {
   uint16_t m_bits;
 
@@ -24,10 +24,9 @@ namespace nd {
     {
       const arrfunc self = functional::call<F>(ndt::type("(Any) -> Any"));
 
-      for (const std::pair<const type_id_t, arrfunc> &pair :
-           arrfunc::make_all<K, numeric_type_ids>(0)) {
-        children[pair.first] = pair.second;
-      }
+      // The kernels for numeric types are made when first called
+      default_child = functional::lazy_multidispatch<1>(
+          self.get_array_type(), arrfunc::make_all_lazy<K, numeric_type_ids>());
 
       for (type_id_t i0 : dim_type_ids::vals()) {
         const ndt::type child_tp = ndt::arrfunc_type::make(
@@ -61,12 +60,18 @@ namespace nd {
     {
       arrfunc self = functional::call<F>(ndt::type("(Any, Any) -> Any"));
 
-      for (const std::pair<std::array<type_id_t, 2>, arrfunc> &pair :
-           arrfunc::make_all<K, numeric_type_ids, numeric_type_ids>(0)) {
-        children[pair.first[0]][pair.first[1]] = pair.second;
-      }
-
-      for (type_id_t i0 : numeric_type_ids::vals()) {
+      // The kernels for pairs of numeric types are made when first called,
+      // and float16 pairs have their own kernels which compute in float32
+      std::map<std::array<type_id_t, 2>, arrfunc (*)()> makers =
+          arrfunc::make_all_lazy<K, numeric_type_ids, numeric_type_ids>();
+      makers[{{float16_type_id, float16_type_id}}] =
+          &detail::make_with_no_data<K<float16_type_id, float16_type_id>>;
+      default_child =
+          functional::lazy_multidispatch<2>(self.get_array_type(), makers);
+
+      typedef join<numeric_type_ids, type_id_sequence<float16_type_id>>::type
+          scalar_type_ids;
+      for (type_id_t i0 : scalar_type_ids::vals()) {
         for (type_id_t i1 : dim_type_ids::vals()) {
           const ndt::type child_tp =
               ndt::arrfunc_type::make({ndt::type(i0), ndt::type(i1)},
@@ -76,7 +81,7 @@ namespace nd {
       }
 
       for (type_id_t i0 : dim_type_ids::vals()) {
-        typedef join<numeric_type_ids, dim_type_ids>::type type_ids;
+        typedef join<scalar_type_ids, dim_type_ids>::type type_ids;
         for (type_id_t i1 : type_ids::vals()) {
           const ndt::type child_tp =
               ndt::arrfunc_type::make({ndt::type(i0), ndt::type(i1)},
@@ -5,7 +5,9 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <typeinfo>
 
 #include <dynd/config.hpp>
 #include <dynd/eval/eval_context.hpp>
@@ -711,8 +713,26 @@ namespace nd {
     template <template <type_id_t...> class KernelType>
     struct make_all;
 
+    template <template <type_id_t...> class KernelType>
+    struct make_all_lazy;
+
+    void record_declfunc_make_time(const char *name, double seconds);
+
   } // namespace dynd::nd::detail
 
+  /** How long the make() of a declfunc took */
+  struct declfunc_make_time {
+    std::string name;
+    /** Including any other declfuncs it made */
+    double seconds;
+  };
+
+  /**
+   * Returns how long each declfunc made so far took to make, in the order
+   * they finished. Declfuncs are made on their first use.
+   */
+  std::vector<declfunc_make_time> get_declfunc_make_times();
+
   template <typename T>
   struct declfunc;
 
@@ -1097,6 +1117,31 @@ namespace nd {
 
       return arrfuncs;
     }
+
+    /**
+     * Like make_all with a data size of 0, but returns functions which
+     * make the arrfuncs instead, so each can be made on first use.
+     */
+    template <template <type_id_t> class KernelType, typename I0>
+    static std::map<type_id_t, arrfunc (*)()> make_all_lazy()
+    {
+      std::map<type_id_t, arrfunc (*)()> makers;
+      for_each<I0>(detail::make_all_lazy<KernelType>(), makers);
+
+      return makers;
+    }
+
+    template <template <type_id_t, type_id_t, type_id_t...> class KernelType,
+              typename I0, typename I1, typename... I>
+    static std::map<std::array<type_id_t, 2 + sizeof...(I)>, arrfunc (*)()>
+    make_all_lazy()
+    {
+      std::map<std::array<type_id_t, 2 + sizeof...(I)>, arrfunc (*)()> makers;
+      for_each<typename outer<I0, I1, I...>::type>(
+          detail::make_all_lazy<KernelType>(), makers);
+
+      return makers;
+    }
   };
 
   namespace detail {
@@ -1129,6 +1174,29 @@ namespace nd {
       }
     };
 
+    template <typename KernelType>
+    arrfunc make_with_no_data()
+    {
+      return arrfunc::make<KernelType>(0);
+    }
+
+    template <template <type_id_t...> class KernelType>
+    struct make_all_lazy {
+      template <type_id_t TypeID>
+      void on_each(std::map<type_id_t, arrfunc (*)()> &makers) const
+      {
+        makers[TypeID] = &make_with_no_data<KernelType<TypeID>>;
+      }
+
+      template <typename TypeIDSequence>
+      void on_each(std::map<std::array<type_id_t, TypeIDSequence::size>,
+                            arrfunc (*)()> &makers) const
+      {
+        makers[TypeIDSequence()] = &make_with_no_data<
+            typename apply<KernelType, TypeIDSequence>::type>;
+      }
+    };
+
   } // namespace dynd::nd::detail
 
   template <typename FuncType>
@@ -1145,7 +1213,20 @@ namespace nd {
 
     static arrfunc &get()
     {
-      static arrfunc self = FuncType::make();
+      static arrfunc self = make_timed();
+      return self;
+    }
+
+  private:
+    static arrfunc make_timed()
+    {
+      std::chrono::steady_clock::time_point begin =
+          std::chrono::steady_clock::now();
+      arrfunc self = FuncType::make();
+      detail::record_declfunc_make_time(
+          typeid(FuncType).name(),
+          std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                        begin).count());
       return self;
     }
   };
@@ -5,25 +5,37 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
+
 #include <dynd/func/arrfunc.hpp>
 
 namespace dynd { namespace func {
 
 /**
- * Returns a reference to the map of registered arrfuncs.
- * NOTE: The internal representation will change, this
- *       function will change.
+ * Returns a snapshot of the registered arrfuncs. This constructs every
+ * registered arrfunc which hasn't been looked up yet, so prefer
+ * get_regfunction for single lookups.
  */
-std::map<nd::string, nd::arrfunc>& get_regfunctions();
+std::map<nd::string, nd::arrfunc> get_regfunctions();
 
 /**
-  * Looks up a named arrfunc from the registry.
+  * Looks up a named arrfunc from the registry, constructing it on the
+  * first lookup. This is safe to call concurrently with other lookups and
+  * with registrations, and doesn't take a lock once the arrfunc has been
+  * constructed.
   */
 nd::arrfunc get_regfunction(const nd::string &name);
 /**
   * Sets a named arrfunc in the registry.
   */
 void set_regfunction(const nd::string &name, const nd::arrfunc &af);
+/**
+  * Sets a named arrfunc in the registry, which ``make`` constructs the
+  * first time it is looked up.
+  */
+void set_lazy_regfunction(const nd::string &name,
+                          const std::function<nd::arrfunc()> &make);
 
 } // namespace func
 
@@ -20,15 +20,14 @@ namespace nd {
     static arrfunc children[DYND_TYPE_ID_MAX + 1][DYND_TYPE_ID_MAX + 1];
     static arrfunc default_child;
 
+    typedef type_id_sequence<
+        bool_type_id, int8_type_id, int16_type_id, int32_type_id,
+        int64_type_id, uint8_type_id, uint16_type_id, uint32_type_id,
+        uint64_type_id, float32_type_id, float64_type_id> numeric_type_ids;
+
     static std::map<std::array<type_id_t, 2>, arrfunc> make_children()
     {
-      typedef type_id_sequence<
-          bool_type_id, int8_type_id, int16_type_id, int32_type_id,
-          int64_type_id, uint8_type_id, uint16_type_id, uint32_type_id,
-          uint64_type_id, float32_type_id, float64_type_id> numeric_type_ids;
-
-      std::map<std::array<type_id_t, 2>, arrfunc> children =
-          arrfunc::make_all<K, numeric_type_ids, numeric_type_ids>(0);
+      std::map<std::array<type_id_t, 2>, arrfunc> children;
 
       arrfunc self = functional::call<F>(ndt::type("(Any, Any) -> Any"));
 
@@ -66,6 +65,11 @@ namespace nd {
         children[pair.first[0]][pair.first[1]] = pair.second;
       }
 
+      // The kernels for pairs of numeric types are made when first called
+      default_child = functional::lazy_multidispatch<2>(
+          ndt::type("(Any, Any) -> Any"),
+          arrfunc::make_all_lazy<K, numeric_type_ids, numeric_type_ids>());
+
       return functional::multidispatch(ndt::type("(Any, Any) -> Any"), children,
                                        default_child);
     }
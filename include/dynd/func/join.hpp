@@ -0,0 +1,43 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * An arrfunc which joins two one-dimensional arrays of structs on the
+   * field named by ``on``, which both structs must have with the same
+   * type, e.g.
+   *
+   *   nd::join(left, right, kwds("on", "id"))
+   *   nd::join(left, right, kwds("on", "id", "how", "left"))
+   *
+   * The result has a row for each pair of matching rows, ordered by the
+   * left row and then the right row. Its fields are the fields of the left
+   * struct followed by the fields of the right struct other than ``on``,
+   * with "_right" appended to any right field name that is already taken.
+   *
+   * With ``how`` as "inner", the default, left rows without a match are
+   * dropped. With ``how`` as "left", they are kept once, with the right
+   * fields made option types and set to NA.
+   *
+   * The rows of the smaller array are put in a hash table, which the rows
+   * of the larger array probe. If ``sorted`` is true, both arrays must
+   * already be sorted by ``on``, and a merge join through the sorting_less
+   * comparison kernel is done instead.
+   *
+   * (LeftDims... * L, RightDims... * R, on: string, how: ?string,
+   *  sorted: ?bool) -> var * T
+   */
+  extern struct join : declfunc<join> {
+    static arrfunc make();
+  } join;
+
+} // namespace dynd::nd
+} // namespace dynd
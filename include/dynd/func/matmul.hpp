@@ -0,0 +1,36 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * An arrfunc which multiplies matrices of float32, float64 or complex
+   * values, broadcasting over any leading dimensions, so a stack of
+   * matrices may be multiplied by one matrix or by another stack.
+   *
+   * (Dims... * M * K * T, Dims... * K * N * T) -> Dims... * M * N * T
+   */
+  extern struct matmul : declfunc<matmul> {
+    static arrfunc make();
+  } matmul;
+
+  /**
+   * An arrfunc which takes the inner product of vectors of float32, float64
+   * or complex values along their last dimension, broadcasting over any
+   * leading ones. Complex values are not conjugated.
+   *
+   * (Dims... * N * T, Dims... * N * T) -> Dims... * T
+   */
+  extern struct dot : declfunc<dot> {
+    static arrfunc make();
+  } dot;
+
+} // namespace dynd::nd
+} // namespace dynd
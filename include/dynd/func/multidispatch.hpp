@@ -53,6 +53,34 @@ namespace nd {
       return old_multidispatch(children.size(), children.begin());
     }
 
+    /**
+     * Creates a multiple dispatch arrfunc on the type ids of its N source
+     * types, from functions which make the children, such as those
+     * returned by arrfunc::make_all_lazy. Each child is only made the first
+     * time it is dispatched to.
+     */
+    template <int N>
+    arrfunc lazy_multidispatch(
+        const ndt::type &self_tp,
+        const std::map<std::array<type_id_t, N>, arrfunc (*)()> &makers)
+    {
+      return arrfunc::make<lazy_multidispatch_kernel<N>>(
+          self_tp, std::make_shared<lazy_multidispatch_static_data<N>>(makers),
+          0);
+    }
+
+    template <int N>
+    typename std::enable_if<N == 1, arrfunc>::type
+    lazy_multidispatch(const ndt::type &self_tp,
+                       const std::map<type_id_t, arrfunc (*)()> &makers)
+    {
+      std::map<std::array<type_id_t, 1>, arrfunc (*)()> array_makers;
+      for (const auto &pair : makers) {
+        array_makers[{{pair.first}}] = pair.second;
+      }
+      return lazy_multidispatch<1>(self_tp, array_makers);
+    }
+
     namespace detail {
 
       template <typename ContainerType,
@@ -184,19 +212,15 @@ namespace nd {
                       sizeof(this->permutation));
         }
 
-        const arrfunc &operator()(const ndt::type &dst_tp, intptr_t nsrc,
+        const arrfunc &operator()(const ndt::type &dst_tp,
+                                  intptr_t DYND_UNUSED(nsrc),
                                   const ndt::type *src_tp)
         {
-          std::vector<ndt::type> tp;
-          tp.push_back(dst_tp);
-          for (int j = 0; j < nsrc; ++j) {
-            tp.push_back(src_tp[j]);
-          }
-          ndt::type *new_src_tp = tp.data() + 1;
-
+          // A permutation entry of -1 refers to the destination type
           std::array<type_id_t, N> key;
           for (int i = 0; i < N; ++i) {
-            key[i] = (new_src_tp + permutation[i])->get_type_id();
+            key[i] = permutation[i] < 0 ? dst_tp.get_type_id()
+                                        : src_tp[permutation[i]].get_type_id();
           }
 
           return base_static_data::operator()(key);
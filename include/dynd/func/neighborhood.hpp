@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <dynd/strided_vals.hpp>
 #include <dynd/func/arrfunc.hpp>
 
@@ -21,9 +23,31 @@ namespace nd {
      *                         a single output value. Signature
      *                         '(Fixed * Fixed * NH, Fixed * Fixed * MSK) ->
      *OUT',
+     *
+     * The output is computed in cache-sized tiles, and the ``threads``
+     * keyword splits the tiles between that many threads, each with its own
+     * instance of the neighborhood op, which must then be safe to call
+     * concurrently. Large counts are capped at the larger of 64 and the
+     * hardware concurrency.
      */
     arrfunc neighborhood(const arrfunc &neighborhood_op, intptr_t nh_ndim);
 
+    /**
+     * Create an arrfunc which convolves a float32 or float64 array with a
+     * separable kernel, the outer product of the weights of each dimension,
+     * e.g. a 3 x 3 box blur is
+     *
+     *   nd::functional::separable_convolution({{1, 1, 1}, {1, 1, 1}})
+     *
+     * As with the neighborhood arrfunc, the window of each point starts at
+     * ``offset`` from it, 0 by default, the weights are not reversed, and
+     * points outside the array count as zero.
+     *
+     *   (Fixed**N * R, offset: ?N * int) -> Fixed**N * R
+     */
+    arrfunc
+    separable_convolution(const std::vector<std::vector<double>> &weights);
+
   } // namespace dynd::nd::functional
 } // namespace dynd::nd
 } // namespace dynd
@@ -12,10 +12,39 @@ namespace dynd {
 namespace nd {
   namespace functional {
 
+    /**
+     * Lifts the child over the Cartesian product of its arguments. The outer
+     * product of two arguments with one strided dimension each is evaluated
+     * in cache-sized blocks of both.
+     */
     arrfunc outer(const arrfunc &child);
 
     ndt::type outer_make_type(const ndt::arrfunc_type *child_tp);
 
+    /**
+     * Lifts a binary child over the outer product of two one-dimensional
+     * arguments and reduces each row of it with ``reduction``, without
+     * storing the product. The reduction must be a unary operation which
+     * accumulates into its destination, like those lift_reduction_arrfunc
+     * takes, and the child must return a builtin type.
+     *
+     *   (Fixed * S0, Fixed * S1) -> Fixed * R
+     */
+    arrfunc outer_reduce(const arrfunc &child, const arrfunc &reduction);
+
+    /**
+     * The index of the minimum of each row of the outer product of a binary
+     * child, e.g. the nearest neighbour of each point of the first argument
+     * in the second one for a distance, without storing the product. The
+     * child must return an integer or floating point type.
+     *
+     *   (Fixed * S0, Fixed * S1) -> Fixed * intptr
+     */
+    arrfunc outer_argmin(const arrfunc &child);
+
+    /** Like outer_argmin, for the index of the maximum */
+    arrfunc outer_argmax(const arrfunc &child);
+
   } // namespace dynd::nd::functional
 } // namespace dynd::nd
 } // namespace dynd
\ No newline at end of file
@@ -0,0 +1,53 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * An arrfunc which sorts along the last dimension, e.g.
+   *
+   *   nd::sort(a)
+   *   nd::sort(a, kwds("stable", true))
+   *
+   * Integer, floating point, bool, date, time and datetime elements are
+   * sorted with an LSD radix sort, and utf-8 or ascii strings with a sort
+   * on cached byte prefixes. Both of these are always stable. Other types
+   * fall back to a comparison sort through the sorting_less comparison
+   * kernel, which is only stable when ``stable`` is true.
+   *
+   * NaNs sort after all other floating point values, and datetime NAs
+   * sort before all other datetimes.
+   *
+   * Rows of a million or more elements are sorted on all the hardware
+   * threads, with ``threads`` overriding the count for rows of any size.
+   * The radix sort partitions each pass across the threads, and the other
+   * sorts sort a chunk per thread and merge them. The result is the same
+   * as sorting on one thread, which is why the comparison sort only runs
+   * in parallel when ``stable`` is true.
+   *
+   * (Dims... * N * T, stable: ?bool, threads: ?int) -> Dims... * N * T
+   */
+  extern struct sort : declfunc<sort> {
+    static arrfunc make();
+  } sort;
+
+  /**
+   * An arrfunc which returns the indices that sort along the last
+   * dimension, with the same ordering as nd::sort. Equal elements keep
+   * their original order whenever nd::sort would.
+   *
+   * (Dims... * N * T, stable: ?bool, threads: ?int) -> Dims... * N * intptr
+   */
+  extern struct argsort : declfunc<argsort> {
+    static arrfunc make();
+  } argsort;
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -18,5 +18,20 @@ namespace nd {
     static arrfunc make();
   } take;
 
+  /**
+   * An arrfunc which scatters values into the "dst" array at the given
+   * indices, the counterpart of an indexed take, e.g.
+   *
+   *   nd::put(index, values, kwds("dst", a))
+   *
+   * sets a(index(i)) to values(i) for each i. Negative indices count from
+   * the end, and repeated indices leave the last value.
+   *
+   * (N * intptr, N * S) -> M * T
+   */
+  extern struct put : declfunc<put> {
+    static arrfunc make();
+  } put;
+
 } // namespace dynd::nd
 } // namespace dynd
\ No newline at end of file
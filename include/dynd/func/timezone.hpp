@@ -0,0 +1,38 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * An arrfunc which converts UTC datetimes to the wall clock time of a
+   * named time zone, e.g.
+   *
+   *   nd::utc_to_local(a, kwds("tz", "America/New_York"))
+   *
+   * (Dims... * datetime[tz='UTC'], tz: string) -> Dims... * datetime
+   */
+  extern struct utc_to_local : declfunc<utc_to_local> {
+    static arrfunc make();
+  } utc_to_local;
+
+  /**
+   * An arrfunc which converts wall clock datetimes of a named time zone to
+   * UTC. Times that occur twice when the clocks go back resolve to the
+   * earlier instant, and times skipped when the clocks go forward are
+   * interpreted with the offset from before the change.
+   *
+   * (Dims... * datetime, tz: string) -> Dims... * datetime[tz='UTC']
+   */
+  extern struct local_to_utc : declfunc<local_to_utc> {
+    static arrfunc make();
+  } local_to_utc;
+
+} // namespace dynd::nd
+} // namespace dynd
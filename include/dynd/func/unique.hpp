@@ -0,0 +1,61 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/func/arrfunc.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * An arrfunc which returns the distinct values of a one-dimensional
+   * array, in the order each first appears, e.g.
+   *
+   *   nd::unique(a)
+   *   nd::unique(a, kwds("return_inverse", true))
+   *
+   * With ``return_inverse``, the result is a struct whose ``inverse``
+   * field holds, for each element, the index of its value in ``values``.
+   *
+   * Values are grouped with a hash table in one pass, so the element type
+   * must be supported by element_hasher: builtin, string, bytes and other
+   * POD types, and structs of them. All NaNs count as one value, and -0.0
+   * counts as 0.0.
+   *
+   * Unlike value_counts and isin, unique isn't lifted over leading
+   * dimensions, because its return type depends on ``return_inverse``.
+   * Arrays with more than one dimension don't match its signature, as
+   * ``T`` is a scalar type.
+   *
+   * (N * T, return_inverse: ?bool) -> var * T
+   * (N * T, return_inverse: true) -> {values: var * T, inverse: N * intptr}
+   */
+  extern struct unique : declfunc<unique> {
+    static arrfunc make();
+  } unique;
+
+  /**
+   * An arrfunc which counts the occurrences of each distinct value along
+   * the last dimension, with the values in the order each first appears.
+   *
+   * (Dims... * N * T) -> Dims... * {values: var * T, counts: var * intptr}
+   */
+  extern struct value_counts : declfunc<value_counts> {
+    static arrfunc make();
+  } value_counts;
+
+  /**
+   * An arrfunc which tests whether each element is one of the values in a
+   * set, hashing the set once and probing it with each element.
+   *
+   * (Dims... * N * T, M * T) -> Dims... * N * bool
+   */
+  extern struct isin : declfunc<isin> {
+    static arrfunc make();
+  } isin;
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+
+#include <dynd/float16.hpp>
 #include <dynd/kernels/base_kernel.hpp>
 
 namespace dynd {
@@ -89,6 +92,99 @@ namespace nd {
     }
   };
 
+  /**
+   * Binary arithmetic on float16, done in float32. The strided case converts
+   * blocks of the inputs with halfbits_to_float_n, applies
+   * ``SelfType::op`` to them and converts the results back with
+   * float_to_halfbits_n. Float32 has enough precision that rounding
+   * twice gives the correctly rounded float16 result for +, -, * and /.
+   */
+  template <typename SelfType>
+  struct float16_arithmetic_kernel
+      : base_kernel<SelfType, kernel_request_host, 2> {
+    typedef float16 A0;
+    typedef float16 A1;
+    typedef float16 R;
+
+    enum { block_size = 256 };
+
+    static void load_block(float *dst, const char *src, intptr_t src_stride,
+                           size_t count)
+    {
+      if (src_stride == sizeof(float16)) {
+        halfbits_to_float_n(dst, reinterpret_cast<const uint16_t *>(src),
+                            count);
+      } else {
+        for (size_t i = 0; i < count; ++i, src += src_stride) {
+          dst[i] = halfbits_to_float(*reinterpret_cast<const uint16_t *>(src));
+        }
+      }
+    }
+
+    void single(char *dst, char *const *src)
+    {
+      float r =
+          SelfType::op(halfbits_to_float(*reinterpret_cast<uint16_t *>(src[0])),
+                       halfbits_to_float(*reinterpret_cast<uint16_t *>(src[1])));
+      *reinterpret_cast<uint16_t *>(dst) =
+          float_to_halfbits(r, assign_error_nocheck);
+    }
+
+    void strided(char *dst, intptr_t dst_stride, char *const *src,
+                 const intptr_t *src_stride, size_t count)
+    {
+      float a[block_size], b[block_size];
+      uint16_t r[block_size];
+      const char *src0 = src[0], *src1 = src[1];
+      for (size_t i = 0; i < count; i += block_size) {
+        size_t n = std::min<size_t>(block_size, count - i);
+        load_block(a, src0, src_stride[0], n);
+        load_block(b, src1, src_stride[1], n);
+        for (size_t j = 0; j < n; ++j) {
+          a[j] = SelfType::op(a[j], b[j]);
+        }
+        if (dst_stride == sizeof(float16)) {
+          float_to_halfbits_n(reinterpret_cast<uint16_t *>(dst), a, n);
+          dst += n * sizeof(float16);
+        } else {
+          float_to_halfbits_n(r, a, n);
+          for (size_t j = 0; j < n; ++j, dst += dst_stride) {
+            *reinterpret_cast<uint16_t *>(dst) = r[j];
+          }
+        }
+        src0 += n * src_stride[0];
+        src1 += n * src_stride[1];
+      }
+    }
+  };
+
+  template <>
+  struct add_kernel<float16_type_id, float16_type_id>
+      : float16_arithmetic_kernel<add_kernel<float16_type_id, float16_type_id>> {
+    static float op(float a, float b) { return a + b; }
+  };
+
+  template <>
+  struct subtract_kernel<float16_type_id, float16_type_id>
+      : float16_arithmetic_kernel<
+            subtract_kernel<float16_type_id, float16_type_id>> {
+    static float op(float a, float b) { return a - b; }
+  };
+
+  template <>
+  struct multiply_kernel<float16_type_id, float16_type_id>
+      : float16_arithmetic_kernel<
+            multiply_kernel<float16_type_id, float16_type_id>> {
+    static float op(float a, float b) { return a * b; }
+  };
+
+  template <>
+  struct divide_kernel<float16_type_id, float16_type_id>
+      : float16_arithmetic_kernel<
+            divide_kernel<float16_type_id, float16_type_id>> {
+    static float op(float a, float b) { return a / b; }
+  };
+
 } // namespace dynd::nd
 
 namespace ndt {
@@ -125,9 +221,9 @@ namespace ndt {
 
   template <type_id_t Src0TypeID, type_id_t Src1TypeID>
   struct type::equivalent<nd::add_kernel<Src0TypeID, Src1TypeID>> {
-    typedef typename dynd::type_of<Src0TypeID>::type A0;
-    typedef typename dynd::type_of<Src1TypeID>::type A1;
-    typedef decltype(std::declval<A0>() + std::declval<A1>()) R;
+    typedef typename nd::add_kernel<Src0TypeID, Src1TypeID>::A0 A0;
+    typedef typename nd::add_kernel<Src0TypeID, Src1TypeID>::A1 A1;
+    typedef typename nd::add_kernel<Src0TypeID, Src1TypeID>::R R;
 
     static type make()
     {
@@ -142,9 +238,9 @@ namespace ndt {
 
   template <type_id_t Src0TypeID, type_id_t Src1TypeID>
   struct type::equivalent<nd::subtract_kernel<Src0TypeID, Src1TypeID>> {
-    typedef typename dynd::type_of<Src0TypeID>::type A0;
-    typedef typename dynd::type_of<Src1TypeID>::type A1;
-    typedef decltype(std::declval<A0>() - std::declval<A1>()) R;
+    typedef typename nd::subtract_kernel<Src0TypeID, Src1TypeID>::A0 A0;
+    typedef typename nd::subtract_kernel<Src0TypeID, Src1TypeID>::A1 A1;
+    typedef typename nd::subtract_kernel<Src0TypeID, Src1TypeID>::R R;
 
     static type make()
     {
@@ -159,9 +255,9 @@ namespace ndt {
 
   template <type_id_t Src0TypeID, type_id_t Src1TypeID>
   struct type::equivalent<nd::multiply_kernel<Src0TypeID, Src1TypeID>> {
-    typedef typename dynd::type_of<Src0TypeID>::type A0;
-    typedef typename dynd::type_of<Src1TypeID>::type A1;
-    typedef decltype(std::declval<A0>() * std::declval<A1>()) R;
+    typedef typename nd::multiply_kernel<Src0TypeID, Src1TypeID>::A0 A0;
+    typedef typename nd::multiply_kernel<Src0TypeID, Src1TypeID>::A1 A1;
+    typedef typename nd::multiply_kernel<Src0TypeID, Src1TypeID>::R R;
 
     static type make()
     {
@@ -176,9 +272,9 @@ namespace ndt {
 
   template <type_id_t Src0TypeID, type_id_t Src1TypeID>
   struct type::equivalent<nd::divide_kernel<Src0TypeID, Src1TypeID>> {
-    typedef typename dynd::type_of<Src0TypeID>::type A0;
-    typedef typename dynd::type_of<Src1TypeID>::type A1;
-    typedef decltype(std::declval<A0>() / std::declval<A1>()) R;
+    typedef typename nd::divide_kernel<Src0TypeID, Src1TypeID>::A0 A0;
+    typedef typename nd::divide_kernel<Src0TypeID, Src1TypeID>::A1 A1;
+    typedef typename nd::divide_kernel<Src0TypeID, Src1TypeID>::R R;
 
     static type make()
     {
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <stdexcept>
 
 #include <dynd/fpstatus.hpp>
@@ -176,13 +177,71 @@ namespace nd {
       }
     };
 
+    /**
+     * A base for assignment kernels between builtin types whose value is
+     * ``static_cast<DstType>(src)`` once it passes a check. The kernel
+     * provides that check as ``static bool is_error(Src0Type)``.
+     *
+     * The strided function converts contiguous runs in blocks, checking a
+     * whole block before converting it with a plain loop the compiler can
+     * vectorize. Only a block where the check trips goes through
+     * ``single``, which raises the error for the first failing element.
+     */
+    template <typename SelfType, typename DstType, typename Src0Type>
+    struct base_builtin_assignment_kernel
+        : base_kernel<SelfType, kernel_request_host, 1> {
+      typedef base_kernel<SelfType, kernel_request_host, 1> parent_type;
+
+      enum { block_size = 256 };
+
+      static bool is_error(Src0Type DYND_UNUSED(s)) { return false; }
+
+      void strided(char *dst, intptr_t dst_stride, char *const *src,
+                   const intptr_t *src_stride, size_t count)
+      {
+#if DYND_ASSIGNMENT_TRACING
+        parent_type::strided(dst, dst_stride, src, src_stride, count);
+#else
+        if (dst_stride != sizeof(DstType) ||
+            src_stride[0] != sizeof(Src0Type)) {
+          parent_type::strided(dst, dst_stride, src, src_stride, count);
+          return;
+        }
+
+        DstType *d = reinterpret_cast<DstType *>(dst);
+        const Src0Type *s = reinterpret_cast<const Src0Type *>(src[0]);
+        for (size_t i = 0; i < count; i += block_size) {
+          size_t n = std::min<size_t>(block_size, count - i);
+          bool error = false;
+          for (size_t j = 0; j < n; ++j) {
+            error |= SelfType::is_error(s[i + j]);
+          }
+          if (!error) {
+            for (size_t j = 0; j < n; ++j) {
+              d[i + j] = static_cast<DstType>(s[i + j]);
+            }
+          } else {
+            SelfType *self = parent_type::get_self(this);
+            for (size_t j = 0; j < n; ++j) {
+              char *src_j =
+                  reinterpret_cast<char *>(const_cast<Src0Type *>(s + i + j));
+              self->single(reinterpret_cast<char *>(d + i + j), &src_j);
+            }
+          }
+        }
+#endif
+      }
+    };
+
     template <type_id_t DstTypeID, type_kind_t DstTypeKind,
               type_id_t Src0TypeID, type_kind_t Src0TypeKind,
               assign_error_mode ErrorMode>
     struct assignment_kernel
-        : base_kernel<assignment_kernel<DstTypeID, DstTypeKind, Src0TypeID,
-                                        Src0TypeKind, ErrorMode>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, DstTypeKind, Src0TypeID,
+                                Src0TypeKind, ErrorMode>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src_type;
 
@@ -377,12 +436,19 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, real_kind, Src0TypeID, uint_kind,
                              assign_error_inexact>
-        : base_kernel<assignment_kernel<DstTypeID, real_kind, Src0TypeID,
-                                        uint_kind, assign_error_inexact>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, real_kind, Src0TypeID, uint_kind,
+                                assign_error_inexact>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+        return static_cast<src0_type>(static_cast<dst_type>(s)) != s;
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -485,12 +551,20 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, sint_kind, Src0TypeID, real_kind,
                              assign_error_overflow>
-        : base_kernel<assignment_kernel<DstTypeID, sint_kind, Src0TypeID,
-                                        real_kind, assign_error_overflow>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, sint_kind, Src0TypeID, real_kind,
+                                assign_error_overflow>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+        return s < std::numeric_limits<dst_type>::min() ||
+               std::numeric_limits<dst_type>::max() < s;
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -513,12 +587,21 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, sint_kind, Src0TypeID, real_kind,
                              assign_error_fractional>
-        : base_kernel<assignment_kernel<DstTypeID, sint_kind, Src0TypeID,
-                                        real_kind, assign_error_fractional>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, sint_kind, Src0TypeID, real_kind,
+                                assign_error_fractional>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+        return s < std::numeric_limits<dst_type>::min() ||
+               std::numeric_limits<dst_type>::max() < s ||
+               floor(s) != s;
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -647,12 +730,19 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, uint_kind, Src0TypeID, real_kind,
                              assign_error_overflow>
-        : base_kernel<assignment_kernel<DstTypeID, uint_kind, Src0TypeID,
-                                        real_kind, assign_error_overflow>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, uint_kind, Src0TypeID, real_kind,
+                                assign_error_overflow>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+        return s < 0 || std::numeric_limits<dst_type>::max() < s;
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -674,12 +764,20 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, uint_kind, Src0TypeID, real_kind,
                              assign_error_fractional>
-        : base_kernel<assignment_kernel<DstTypeID, uint_kind, Src0TypeID,
-                                        real_kind, assign_error_fractional>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, uint_kind, Src0TypeID, real_kind,
+                                assign_error_fractional>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+        return s < 0 || std::numeric_limits<dst_type>::max() < s ||
+               floor(s) != s;
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -951,6 +1049,212 @@ namespace nd {
                             assign_error_nocheck> {
     };
 
+    /**
+     * float16 -> float32 or float64, which is always exact. Contiguous runs
+     * are converted by halfbits_to_float_n or halfbits_to_double_n.
+     */
+    template <typename DstType>
+    struct float16_widening_assignment_kernel
+        : base_kernel<float16_widening_assignment_kernel<DstType>,
+                      kernel_request_host, 1> {
+      typedef base_kernel<float16_widening_assignment_kernel<DstType>,
+                          kernel_request_host, 1> parent_type;
+
+      static void convert_n(float *dst, const uint16_t *src, size_t count)
+      {
+        halfbits_to_float_n(dst, src, count);
+      }
+
+      static void convert_n(double *dst, const uint16_t *src, size_t count)
+      {
+        halfbits_to_double_n(dst, src, count);
+      }
+
+      void single(char *dst, char *const *src)
+      {
+        *reinterpret_cast<DstType *>(dst) =
+            static_cast<DstType>(*reinterpret_cast<float16 *>(src[0]));
+      }
+
+      void strided(char *dst, intptr_t dst_stride, char *const *src,
+                   const intptr_t *src_stride, size_t count)
+      {
+        if (dst_stride == sizeof(DstType) &&
+            src_stride[0] == sizeof(float16)) {
+          convert_n(reinterpret_cast<DstType *>(dst),
+                    reinterpret_cast<const uint16_t *>(src[0]), count);
+        } else {
+          parent_type::strided(dst, dst_stride, src, src_stride, count);
+        }
+      }
+    };
+
+    /**
+     * float32 -> float16. Contiguous runs are converted in blocks by
+     * float_to_halfbits_n, and a block which overflowed goes back through
+     * ``single`` to raise the error. With inexact checking, underflow is
+     * checked element by element.
+     */
+    template <assign_error_mode ErrorMode>
+    struct float32_to_float16_assignment_kernel
+        : base_kernel<float32_to_float16_assignment_kernel<ErrorMode>,
+                      kernel_request_host, 1> {
+      typedef base_kernel<float32_to_float16_assignment_kernel<ErrorMode>,
+                          kernel_request_host, 1> parent_type;
+
+      enum { block_size = 256 };
+
+      void single(char *dst, char *const *src)
+      {
+        *reinterpret_cast<float16 *>(dst) =
+            float16(*reinterpret_cast<float *>(src[0]), ErrorMode);
+      }
+
+      void strided(char *dst, intptr_t dst_stride, char *const *src,
+                   const intptr_t *src_stride, size_t count)
+      {
+        if (ErrorMode == assign_error_inexact ||
+            dst_stride != sizeof(float16) || src_stride[0] != sizeof(float)) {
+          parent_type::strided(dst, dst_stride, src, src_stride, count);
+          return;
+        }
+
+        const float *s = reinterpret_cast<const float *>(src[0]);
+        uint16_t h[block_size];
+        for (size_t i = 0; i < count; i += block_size) {
+          size_t n = std::min<size_t>(block_size, count - i);
+          float_to_halfbits_n(h, s + i, n);
+          bool overflow = false;
+          if (ErrorMode != assign_error_nocheck) {
+            for (size_t j = 0; j < n; ++j) {
+              overflow |= (h[j] & 0x7fffu) == DYND_FLOAT16_PINF &&
+                          std::abs(s[i + j]) <= std::numeric_limits<float>::max();
+            }
+          }
+          if (!overflow) {
+            memcpy(dst + i * sizeof(float16), h, n * sizeof(float16));
+          } else {
+            for (size_t j = 0; j < n; ++j) {
+              char *src_j = reinterpret_cast<char *>(const_cast<float *>(s + i + j));
+              single(dst + (i + j) * sizeof(float16), &src_j);
+            }
+          }
+        }
+      }
+    };
+
+    /** float64 -> float16, with the error checking of double_to_halfbits */
+    template <assign_error_mode ErrorMode>
+    struct float64_to_float16_assignment_kernel
+        : base_kernel<float64_to_float16_assignment_kernel<ErrorMode>,
+                      kernel_request_host, 1> {
+      void single(char *dst, char *const *src)
+      {
+        *reinterpret_cast<float16 *>(dst) =
+            float16(*reinterpret_cast<double *>(src[0]), ErrorMode);
+      }
+    };
+
+    // float16 -> float32
+    template <>
+    struct assignment_kernel<float32_type_id, real_kind, float16_type_id,
+                             real_kind, assign_error_nocheck>
+        : float16_widening_assignment_kernel<float> {
+    };
+
+    template <>
+    struct assignment_kernel<float32_type_id, real_kind, float16_type_id,
+                             real_kind, assign_error_overflow>
+        : float16_widening_assignment_kernel<float> {
+    };
+
+    template <>
+    struct assignment_kernel<float32_type_id, real_kind, float16_type_id,
+                             real_kind, assign_error_fractional>
+        : float16_widening_assignment_kernel<float> {
+    };
+
+    template <>
+    struct assignment_kernel<float32_type_id, real_kind, float16_type_id,
+                             real_kind, assign_error_inexact>
+        : float16_widening_assignment_kernel<float> {
+    };
+
+    // float16 -> float64
+    template <>
+    struct assignment_kernel<float64_type_id, real_kind, float16_type_id,
+                             real_kind, assign_error_nocheck>
+        : float16_widening_assignment_kernel<double> {
+    };
+
+    template <>
+    struct assignment_kernel<float64_type_id, real_kind, float16_type_id,
+                             real_kind, assign_error_overflow>
+        : float16_widening_assignment_kernel<double> {
+    };
+
+    template <>
+    struct assignment_kernel<float64_type_id, real_kind, float16_type_id,
+                             real_kind, assign_error_fractional>
+        : float16_widening_assignment_kernel<double> {
+    };
+
+    template <>
+    struct assignment_kernel<float64_type_id, real_kind, float16_type_id,
+                             real_kind, assign_error_inexact>
+        : float16_widening_assignment_kernel<double> {
+    };
+
+    // float32 -> float16
+    template <>
+    struct assignment_kernel<float16_type_id, real_kind, float32_type_id,
+                             real_kind, assign_error_nocheck>
+        : float32_to_float16_assignment_kernel<assign_error_nocheck> {
+    };
+
+    template <>
+    struct assignment_kernel<float16_type_id, real_kind, float32_type_id,
+                             real_kind, assign_error_overflow>
+        : float32_to_float16_assignment_kernel<assign_error_overflow> {
+    };
+
+    template <>
+    struct assignment_kernel<float16_type_id, real_kind, float32_type_id,
+                             real_kind, assign_error_fractional>
+        : float32_to_float16_assignment_kernel<assign_error_fractional> {
+    };
+
+    template <>
+    struct assignment_kernel<float16_type_id, real_kind, float32_type_id,
+                             real_kind, assign_error_inexact>
+        : float32_to_float16_assignment_kernel<assign_error_inexact> {
+    };
+
+    // float64 -> float16
+    template <>
+    struct assignment_kernel<float16_type_id, real_kind, float64_type_id,
+                             real_kind, assign_error_nocheck>
+        : float64_to_float16_assignment_kernel<assign_error_nocheck> {
+    };
+
+    template <>
+    struct assignment_kernel<float16_type_id, real_kind, float64_type_id,
+                             real_kind, assign_error_overflow>
+        : float64_to_float16_assignment_kernel<assign_error_overflow> {
+    };
+
+    template <>
+    struct assignment_kernel<float16_type_id, real_kind, float64_type_id,
+                             real_kind, assign_error_fractional>
+        : float64_to_float16_assignment_kernel<assign_error_fractional> {
+    };
+
+    template <>
+    struct assignment_kernel<float16_type_id, real_kind, float64_type_id,
+                             real_kind, assign_error_inexact>
+        : float64_to_float16_assignment_kernel<assign_error_inexact> {
+    };
+
     /*
       // double -> float with overflow checking
       template <type_id_t DstTypeID, type_id_t Src0TypeID>
@@ -1000,12 +1304,25 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, real_kind, Src0TypeID, real_kind,
                              assign_error_overflow>
-        : base_kernel<assignment_kernel<DstTypeID, real_kind, Src0TypeID,
-                                        real_kind, assign_error_overflow>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, real_kind, Src0TypeID, real_kind,
+                                assign_error_overflow>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+#if defined(DYND_USE_FPSTATUS)
+        // The fp status is only available element by element
+        return true;
+#else
+        return isfinite(s) && (s < -std::numeric_limits<dst_type>::max() ||
+                              s > std::numeric_limits<dst_type>::max());
+#endif
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -1049,12 +1366,26 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, real_kind, Src0TypeID, real_kind,
                              assign_error_inexact>
-        : base_kernel<assignment_kernel<DstTypeID, real_kind, Src0TypeID,
-                                        real_kind, assign_error_inexact>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, real_kind, Src0TypeID, real_kind,
+                                assign_error_inexact>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+#if defined(DYND_USE_FPSTATUS)
+        // The fp status is only available element by element
+        return true;
+#else
+        return (isfinite(s) && (s < -std::numeric_limits<dst_type>::max() ||
+                               s > std::numeric_limits<dst_type>::max())) ||
+               static_cast<dst_type>(s) != s;
+#endif
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -1194,12 +1525,19 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, sint_kind, Src0TypeID, sint_kind,
                              assign_error_overflow>
-        : base_kernel<assignment_kernel<DstTypeID, sint_kind, Src0TypeID,
-                                        sint_kind, assign_error_overflow>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, sint_kind, Src0TypeID, sint_kind,
+                                assign_error_overflow>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+        return is_overflow<dst_type>(s);
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -1236,12 +1574,19 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, sint_kind, Src0TypeID, uint_kind,
                              assign_error_overflow>
-        : base_kernel<assignment_kernel<DstTypeID, sint_kind, Src0TypeID,
-                                        uint_kind, assign_error_overflow>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, sint_kind, Src0TypeID, uint_kind,
+                                assign_error_overflow>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+        return is_overflow<dst_type>(s);
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -1279,12 +1624,19 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, uint_kind, Src0TypeID, sint_kind,
                              assign_error_overflow>
-        : base_kernel<assignment_kernel<DstTypeID, uint_kind, Src0TypeID,
-                                        sint_kind, assign_error_overflow>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, uint_kind, Src0TypeID, sint_kind,
+                                assign_error_overflow>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+        return is_overflow<dst_type>(s);
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -1323,12 +1675,19 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, uint_kind, Src0TypeID, uint_kind,
                              assign_error_overflow>
-        : base_kernel<assignment_kernel<DstTypeID, uint_kind, Src0TypeID,
-                                        uint_kind, assign_error_overflow>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, uint_kind, Src0TypeID, uint_kind,
+                                assign_error_overflow>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+        return is_overflow<dst_type>(s);
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -1365,12 +1724,19 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t Src0TypeID>
     struct assignment_kernel<DstTypeID, real_kind, Src0TypeID, sint_kind,
                              assign_error_inexact>
-        : base_kernel<assignment_kernel<DstTypeID, real_kind, Src0TypeID,
-                                        sint_kind, assign_error_inexact>,
-                      kernel_request_host, 1> {
+        : base_builtin_assignment_kernel<
+              assignment_kernel<DstTypeID, real_kind, Src0TypeID, sint_kind,
+                                assign_error_inexact>,
+              typename type_of<DstTypeID>::type,
+              typename type_of<Src0TypeID>::type> {
       typedef typename type_of<DstTypeID>::type dst_type;
       typedef typename type_of<Src0TypeID>::type src0_type;
 
+      static bool is_error(src0_type s)
+      {
+        return static_cast<src0_type>(static_cast<dst_type>(s)) != s;
+      }
+
       void single(char *dst, char *const *src)
       {
         src0_type s = *reinterpret_cast<src0_type *>(src[0]);
@@ -0,0 +1,257 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/fft.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+namespace dynd {
+namespace nd {
+
+  namespace detail {
+
+    /**
+     * An unnormalized one-dimensional complex discrete Fourier transform of
+     * size ``n``, with ``sign`` the sign of the exponent, -1 for forward
+     * transforms and 1 for backward ones.
+     *
+     * The size is split into factors of 4, 2, 3 and 5, which have dedicated
+     * butterflies, and other primes up to 31, which use a generic one, and
+     * the transform recurses through them in the manner of a decimation in
+     * time. Sizes with a larger prime factor are done with Bluestein's
+     * algorithm, as a convolution through transforms of a power of two size.
+     *
+     * Plans are immutable, so ``get`` shares them through a process-wide
+     * cache, and the twiddle factors of each size are computed only once.
+     */
+    class fft_plan {
+      struct factor {
+        intptr_t radix, size;
+      };
+
+      intptr_t m_n;
+      int m_sign;
+      std::vector<factor> m_factors;
+      // exp(sign * 2 pi i k / n), for k < n
+      std::vector<complex<double>> m_twiddles;
+      intptr_t m_scratch_size;
+
+      // For Bluestein's algorithm, the transforms of size m_m, the chirp
+      // exp(sign * pi i k^2 / n) and the transform of its conjugate,
+      // divided by m_m
+      intptr_t m_m;
+      std::shared_ptr<const fft_plan> m_forward, m_backward;
+      std::vector<complex<double>> m_chirp, m_chirp_fft;
+
+      void work(complex<double> *out, const complex<double> *in,
+                intptr_t fstride, const factor *f,
+                complex<double> *scratch) const;
+
+    public:
+      fft_plan(intptr_t n, int sign);
+
+      static std::shared_ptr<const fft_plan> get(intptr_t n, int sign);
+
+      intptr_t get_size() const { return m_n; }
+
+      /** The number of complex values of scratch space execute needs */
+      intptr_t get_scratch_size() const { return m_scratch_size; }
+
+      /** ``in`` and ``out`` are contiguous and must not overlap */
+      void execute(const complex<double> *in, complex<double> *out,
+                   complex<double> *scratch) const;
+    };
+
+    /**
+     * An unnormalized one-dimensional real transform of size ``n``, where
+     * ``forward`` takes ``n`` reals to the ``n / 2 + 1`` complex values of
+     * the nonnegative frequencies, and ``backward`` takes them back,
+     * ignoring the imaginary parts of the zero and Nyquist frequencies.
+     * Even sizes are done as a complex transform of half the size.
+     */
+    class rfft_plan {
+      intptr_t m_n;
+      std::shared_ptr<const fft_plan> m_forward, m_backward;
+      // exp(-2 pi i k / n), for k <= n / 2, when n is even
+      std::vector<complex<double>> m_twiddles;
+      intptr_t m_scratch_size;
+
+    public:
+      explicit rfft_plan(intptr_t n);
+
+      static std::shared_ptr<const rfft_plan> get(intptr_t n);
+
+      intptr_t get_size() const { return m_n; }
+
+      intptr_t get_scratch_size() const { return m_scratch_size; }
+
+      void forward(const double *in, complex<double> *out,
+                   complex<double> *scratch) const;
+
+      void backward(const complex<double> *in, double *out,
+                    complex<double> *scratch) const;
+    };
+
+    enum fft_kind_t {
+      complex_to_complex_fft,
+      real_to_complex_fft,
+      complex_to_real_fft
+    };
+
+    /**
+     * A multidimensional transform over strided arrays, done as a
+     * one-dimensional transform along each axis in turn through contiguous
+     * line buffers. Dimensions of the source shorter than the destination
+     * are padded with zeros, and longer ones are cropped. The real
+     * transforms halve the last of the axes.
+     */
+    class strided_fft {
+      fft_kind_t m_kind;
+      int m_sign;
+      intptr_t m_ndim;
+      std::vector<intptr_t> m_dst_shape, m_dst_stride, m_src_shape,
+          m_src_stride;
+      std::vector<intptr_t> m_axes;
+      // The plans for the complex passes, one per axis, and for the real pass
+      std::vector<std::shared_ptr<const fft_plan>> m_plans;
+      std::shared_ptr<const rfft_plan> m_rplan;
+      std::vector<complex<double>> m_buffer;
+      // For a complex to real transform of more than one axis, the complex
+      // passes are done in a contiguous copy of the source
+      std::vector<intptr_t> m_temp_shape, m_temp_stride;
+      std::vector<complex<double>> m_temp;
+
+    public:
+      /**
+       * ``n`` is the logical size of the last axis of a real transform,
+       * which is the destination size for complex to real ones.
+       */
+      strided_fft(fft_kind_t kind, int sign, intptr_t ndim,
+                  const size_stride_t *dst_size_stride,
+                  const size_stride_t *src_size_stride,
+                  const std::vector<intptr_t> &axes, intptr_t n);
+
+      void execute(char *dst, const char *src);
+    };
+
+    /**
+     * The axes from the ``axes`` keyword, or all of them if it's missing.
+     * Throws if an axis is out of range.
+     */
+    std::vector<intptr_t> get_fft_axes(const nd::array &kwds, intptr_t ndim);
+
+    /** The ``shape`` keyword, or an empty vector if it's missing */
+    std::vector<intptr_t> get_fft_shape(const nd::array &kwds);
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * The transforms of nd::fft, nd::ifft, nd::rfft and nd::irfft done
+   * without FFTW, by strided_fft. The ``flags`` keyword is accepted for
+   * compatibility and ignored.
+   */
+  template <typename DstType, typename SrcType, int Sign = 0>
+  struct builtin_fft_ck
+      : base_kernel<builtin_fft_ck<DstType, SrcType, Sign>, kernel_request_host,
+                    1> {
+    static const detail::fft_kind_t kind =
+        std::is_same<SrcType, double>::value
+            ? detail::real_to_complex_fft
+            : (std::is_same<DstType, double>::value
+                   ? detail::complex_to_real_fft
+                   : detail::complex_to_complex_fft);
+
+    detail::strided_fft transform;
+
+    builtin_fft_ck(const detail::strided_fft &transform) : transform(transform)
+    {
+    }
+
+    void single(char *dst, char *const *src) { transform.execute(dst, src[0]); }
+
+    static intptr_t instantiate(
+        char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+        char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+        const ndt::type &DYND_UNUSED(dst_tp), const char *dst_arrmeta,
+        intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+        const char *const *src_arrmeta, kernel_request_t kernreq,
+        const eval::eval_context *DYND_UNUSED(ectx), const nd::array &kwds,
+        const std::map<dynd::nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+    {
+      intptr_t ndim = src_tp[0].get_ndim();
+      std::vector<intptr_t> axes = detail::get_fft_axes(kwds, ndim);
+      const size_stride_t *dst_size_stride =
+          reinterpret_cast<const size_stride_t *>(dst_arrmeta);
+      const size_stride_t *src_size_stride =
+          reinterpret_cast<const size_stride_t *>(src_arrmeta[0]);
+
+      intptr_t n = 0;
+      if (!axes.empty()) {
+        intptr_t j = axes.back();
+        if (kind == detail::complex_to_real_fft) {
+          n = dst_size_stride[j].dim_size;
+        } else {
+          std::vector<intptr_t> shape = detail::get_fft_shape(kwds);
+          n = shape.empty() ? src_size_stride[j].dim_size : shape[j];
+        }
+      }
+
+      builtin_fft_ck::make(ckb, kernreq, ckb_offset,
+                           detail::strided_fft(kind, Sign, ndim,
+                                               dst_size_stride,
+                                               src_size_stride, axes, n));
+      return ckb_offset;
+    }
+
+    static void resolve_dst_type(
+        char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+        char *DYND_UNUSED(data), ndt::type &dst_tp, intptr_t DYND_UNUSED(nsrc),
+        const ndt::type *src_tp, const nd::array &kwds,
+        const std::map<dynd::nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+    {
+      intptr_t ndim = src_tp[0].get_ndim();
+      std::vector<intptr_t> shape = detail::get_fft_shape(kwds);
+      if (shape.empty()) {
+        shape.resize(ndim);
+        src_tp[0].extended()->get_shape(ndim, 0, shape.data(), NULL, NULL);
+        std::vector<intptr_t> axes = detail::get_fft_axes(kwds, ndim);
+        if (kind == detail::complex_to_real_fft && !axes.empty()) {
+          shape[axes.back()] = 2 * (shape[axes.back()] - 1);
+        }
+      } else if (static_cast<intptr_t>(shape.size()) != ndim) {
+        throw std::invalid_argument(
+            "the fft shape must have a size for each dimension");
+      }
+      if (kind == detail::real_to_complex_fft) {
+        std::vector<intptr_t> axes = detail::get_fft_axes(kwds, ndim);
+        if (!axes.empty()) {
+          shape[axes.back()] = shape[axes.back()] / 2 + 1;
+        }
+      }
+      dst_tp = ndt::make_fixed_dim(ndim, shape.data(),
+                                   ndt::make_type<DstType>());
+    }
+  };
+
+} // namespace dynd::nd
+
+namespace ndt {
+
+  template <typename DstType, typename SrcType, int Sign>
+  struct type::equivalent<nd::builtin_fft_ck<DstType, SrcType, Sign>> {
+    static type make()
+    {
+      return nd::detail::make_fft_type(make_type<DstType>(),
+                                       make_type<SrcType>());
+    }
+  };
+
+} // namespace dynd::ndt
+} // namespace dynd
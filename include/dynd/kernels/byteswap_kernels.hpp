@@ -11,23 +11,34 @@ namespace dynd {
  * Function for byteswapping a single value.
  */
 inline uint16_t byteswap_value(uint16_t value) {
+#if defined(__GNUC__)
+    return __builtin_bswap16(value);
+#else
     return ((value&0xffu) << 8) | (value >> 8);
+#endif
 }
 
 /**
  * Function for byteswapping a single value.
  */
 inline uint32_t byteswap_value(uint32_t value) {
+#if defined(__GNUC__)
+    return __builtin_bswap32(value);
+#else
     return ((value&0xffu) << 24) |
             ((value&0xff00u) << 8) |
             ((value&0xff0000u) >> 8) |
             (value >> 24);
+#endif
 }
 
 /**
  * Function for byteswapping a single value.
  */
 inline uint64_t byteswap_value(uint64_t value) {
+#if defined(__GNUC__)
+    return __builtin_bswap64(value);
+#else
     return ((value&0xffULL) << 56) |
             ((value&0xff00ULL) << 40) |
             ((value&0xff0000ULL) << 24) |
@@ -36,11 +47,15 @@ inline uint64_t byteswap_value(uint64_t value) {
             ((value&0xff0000000000ULL) >> 24) |
             ((value&0xff000000000000ULL) >> 40) |
             (value >> 56);
+#endif
 }
 
 /**
  * Creates an assignment kernel which does a byteswap
- * of the specified data size.
+ * of the specified data size. Sizes 2, 4, 8 and 16 get
+ * kernels which don't require the data to be aligned, and
+ * which use SSSE3 shuffles for contiguous runs if the CPU
+ * supports them.
  */
 size_t make_byteswap_assignment_function(
                 void *ckb, intptr_t ckb_offset,
@@ -48,8 +63,9 @@ size_t make_byteswap_assignment_function(
                 kernel_request_t kernreq);
 
 /**
- * Creates an assignment kernel which does a byteswap
- * of the specified data size.
+ * Creates an assignment kernel which byteswaps the two
+ * halves of the specified data size separately, as for
+ * complex types.
  */
 size_t make_pairwise_byteswap_assignment_function(
                 void *ckb, intptr_t ckb_offset,
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/base_virtual_kernel.hpp>
 #include <dynd/types/ellipsis_dim_type.hpp>
@@ -12,6 +14,7 @@
 #include <dynd/types/dim_fragment_type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/func/arrfunc.hpp>
+#include <dynd/shape_tools.hpp>
 
 namespace dynd {
 namespace nd {
@@ -172,7 +175,7 @@ namespace nd {
 
         // Check if no lifting is required
         intptr_t dst_ndim = dst_tp.get_ndim();
-        if (!child_tp->get_return_type().is_symbolic()) {
+        if (!child_tp->get_return_type().is_variadic()) {
           dst_ndim -= child_tp->get_return_type().get_ndim();
         }
 
@@ -340,57 +343,133 @@ namespace nd {
         const ndt::arrfunc_type *child_tp = child.get_type();
 
         intptr_t dst_ndim = dst_tp.get_ndim();
-        if (!child_tp->get_return_type().is_symbolic() ||
+        if (!child_tp->get_return_type().is_variadic() ||
             child_tp->get_return_type().get_type_id() ==
                 typevar_constructed_type_id) {
           dst_ndim -= child_tp->get_return_type().get_ndim();
         }
 
-        const char *child_dst_arrmeta;
-        const char *child_src_arrmeta[N];
-        ndt::type child_dst_tp;
+        ndt::type child_dst_tp = dst_tp;
+        const char *child_dst_arrmeta = dst_arrmeta;
         ndt::type child_src_tp[N];
-
-        intptr_t size, dst_stride, src_stride[N];
-        if (!dst_tp.get_as_strided(dst_arrmeta, &size, &dst_stride,
-                                   &child_dst_tp, &child_dst_arrmeta)) {
-          std::stringstream ss;
-          ss << "make_elwise_strided_dimension_expr_kernel: error processing "
-                "type " << dst_tp << " as strided";
-          throw type_error(ss.str());
+        const char *child_src_arrmeta[N];
+        for (int i = 0; i < N; ++i) {
+          child_src_tp[i] = src_tp[i];
+          child_src_arrmeta[i] = src_arrmeta[i];
         }
 
-        bool finished = dst_ndim == 1;
-        for (int i = 0; i < N; ++i) {
-          intptr_t src_ndim =
-              src_tp[i].get_ndim() - child_tp->get_pos_type(i).get_ndim();
-          intptr_t src_size;
-          if (src_ndim < dst_ndim) {
-            // This src value is getting broadcasted
-            src_stride[i] = 0;
-            child_src_arrmeta[i] = src_arrmeta[i];
-            child_src_tp[i] = src_tp[i];
-            finished &= src_ndim == 0;
-          } else if (src_tp[i].get_as_strided(src_arrmeta[i], &src_size,
-                                              &src_stride[i], &child_src_tp[i],
-                                              &child_src_arrmeta[i])) {
-            // Check for a broadcasting error
-            if (src_size != 1 && size != src_size) {
-              throw broadcast_error(dst_tp, dst_arrmeta, src_tp[i],
-                                    src_arrmeta[i]);
-            }
-            finished &= src_ndim == 1;
-          } else {
+        // Peel off the leading run of dimensions which are strided in the
+        // destination and every source, with the strides of the destination
+        // at index 0 and of source i at index i + 1
+        std::vector<intptr_t> shape, strides[N + 1];
+        bool finished;
+        do {
+          intptr_t size, stride[N + 1];
+          const ndt::type level_dst_tp = child_dst_tp;
+          const char *level_dst_arrmeta = child_dst_arrmeta;
+          if (!level_dst_tp.get_as_strided(level_dst_arrmeta, &size,
+                                           &stride[0], &child_dst_tp,
+                                           &child_dst_arrmeta)) {
             std::stringstream ss;
-            ss << "make_elwise_strided_dimension_expr_kernel: expected strided "
-                  "or fixed dim, got " << src_tp[i];
-            throw std::runtime_error(ss.str());
+            ss << "make_elwise_strided_dimension_expr_kernel: error "
+                  "processing type " << level_dst_tp << " as strided";
+            throw type_error(ss.str());
+          }
+
+          finished = dst_ndim == 1;
+          for (int i = 0; i < N; ++i) {
+            intptr_t src_ndim = child_src_tp[i].get_ndim() -
+                                child_tp->get_pos_type(i).get_ndim();
+            intptr_t src_size;
+            const ndt::type level_src_tp = child_src_tp[i];
+            const char *level_src_arrmeta = child_src_arrmeta[i];
+            if (src_ndim < dst_ndim) {
+              // This src value is getting broadcasted
+              stride[i + 1] = 0;
+              finished &= src_ndim == 0;
+            } else if (level_src_tp.get_as_strided(
+                           level_src_arrmeta, &src_size, &stride[i + 1],
+                           &child_src_tp[i], &child_src_arrmeta[i])) {
+              // Check for a broadcasting error
+              if (src_size != 1 && size != src_size) {
+                throw broadcast_error(level_dst_tp, level_dst_arrmeta,
+                                      level_src_tp, level_src_arrmeta);
+              }
+              if (src_size == 1) {
+                stride[i + 1] = 0;
+              }
+              finished &= src_ndim == 1;
+            } else {
+              std::stringstream ss;
+              ss << "make_elwise_strided_dimension_expr_kernel: expected "
+                    "strided or fixed dim, got " << level_src_tp;
+              throw std::runtime_error(ss.str());
+            }
+          }
+
+          shape.push_back(size);
+          for (int j = 0; j <= N; ++j) {
+            // A dimension of size one is visited once, so its stride is
+            // free, and zero keeps it out of the ordering below
+            strides[j].push_back(size == 1 ? 0 : stride[j]);
+          }
+          --dst_ndim;
+        } while (!finished && dst_ndim > 0 &&
+                 is_strided_level(child_tp, dst_ndim, child_dst_tp,
+                                  child_src_tp));
+
+        // Order the dimensions by stride, so the innermost kernel walks
+        // memory contiguously, and fuse neighbours which are jointly
+        // contiguous into one longer dimension
+        intptr_t ndim = shape.size();
+        shortvector<int> axis_perm(ndim);
+        if (ndim > 1) {
+          const intptr_t *operstrides[N + 1];
+          for (int j = 0; j <= N; ++j) {
+            operstrides[j] = strides[j].data();
+          }
+          multistrides_to_axis_perm(ndim, N + 1, operstrides,
+                                    axis_perm.get());
+        } else {
+          axis_perm[0] = 0;
+        }
+        std::vector<intptr_t> coalesced_shape, coalesced_strides[N + 1];
+        for (intptr_t k = ndim - 1; k >= 0; --k) {
+          intptr_t axis = axis_perm[k];
+          intptr_t size = shape[axis];
+          if (!coalesced_shape.empty()) {
+            intptr_t &outer_size = coalesced_shape.back();
+            bool contiguous = true;
+            for (int j = 0; j <= N && contiguous; ++j) {
+              contiguous =
+                  coalesced_strides[j].back() == strides[j][axis] * size;
+            }
+            if (size == 1) {
+              continue;
+            } else if (outer_size == 1 || contiguous) {
+              outer_size *= size;
+              for (int j = 0; j <= N; ++j) {
+                coalesced_strides[j].back() = strides[j][axis];
+              }
+              continue;
+            }
+          }
+          coalesced_shape.push_back(size);
+          for (int j = 0; j <= N; ++j) {
+            coalesced_strides[j].push_back(strides[j][axis]);
           }
         }
 
-        self_type::make(ckb, kernreq, ckb_offset, size, dst_stride,
-                        dynd::detail::make_array_wrapper<N>(src_stride));
-        kernreq = (kernreq & kernel_request_memory) | kernel_request_strided;
+        for (size_t k = 0; k < coalesced_shape.size(); ++k) {
+          intptr_t src_stride[N];
+          for (int i = 0; i < N; ++i) {
+            src_stride[i] = coalesced_strides[i + 1][k];
+          }
+          self_type::make(ckb, kernreq, ckb_offset, coalesced_shape[k],
+                          coalesced_strides[0][k],
+                          dynd::detail::make_array_wrapper<N>(src_stride));
+          kernreq = (kernreq & kernel_request_memory) | kernel_request_strided;
+        }
 
         // If there are still dimensions to broadcast, recursively lift more
         if (!finished) {
@@ -406,6 +485,28 @@ namespace nd {
             child_dst_arrmeta, nsrc, child_src_tp, child_src_arrmeta, kernreq,
             ectx, kwds, tp_vars);
       }
+
+      /**
+       * Returns true if the next dimension to lift is a fixed dimension in
+       * the destination and in every source which isn't being broadcast.
+       */
+      static bool is_strided_level(const ndt::arrfunc_type *child_tp,
+                                   intptr_t dst_ndim, const ndt::type &dst_tp,
+                                   const ndt::type *src_tp)
+      {
+        if (dst_tp.get_type_id() != fixed_dim_type_id) {
+          return false;
+        }
+        for (int i = 0; i < N; ++i) {
+          intptr_t src_ndim =
+              src_tp[i].get_ndim() - child_tp->get_pos_type(i).get_ndim();
+          if (src_ndim >= dst_ndim &&
+              src_tp[i].get_type_id() != fixed_dim_type_id) {
+            return false;
+          }
+        }
+        return true;
+      }
     };
 
     // int N, int K
@@ -463,7 +564,7 @@ namespace nd {
         const ndt::arrfunc_type *child_tp = child.get_type();
 
         intptr_t dst_ndim = dst_tp.get_ndim();
-        if (!child_tp->get_return_type().is_symbolic()) {
+        if (!child_tp->get_return_type().is_variadic()) {
           dst_ndim -= child_tp->get_return_type().get_ndim();
         } else if (child_tp->get_return_type().get_type_id() ==
                    typevar_constructed_type_id) {
@@ -590,7 +691,7 @@ namespace nd {
         const ndt::arrfunc_type *child_tp = child.get_type();
 
         intptr_t dst_ndim = dst_tp.get_ndim();
-        if (!child_tp->get_return_type().is_symbolic()) {
+        if (!child_tp->get_return_type().is_variadic()) {
           dst_ndim -= child_tp->get_return_type().get_ndim();
         }
 
@@ -721,7 +822,7 @@ namespace nd {
         const ndt::arrfunc_type *child_tp = child.get_type();
 
         intptr_t dst_ndim = dst_tp.get_ndim();
-        if (!child_tp->get_return_type().is_symbolic()) {
+        if (!child_tp->get_return_type().is_variadic()) {
           dst_ndim -= child_tp->get_return_type().get_ndim();
         }
 
@@ -929,7 +1030,7 @@ namespace nd {
         const ndt::arrfunc_type *child_tp = child.get_type();
 
         intptr_t dst_ndim = dst_tp.get_ndim();
-        if (!child_tp->get_return_type().is_symbolic()) {
+        if (!child_tp->get_return_type().is_variadic()) {
           dst_ndim -= child_tp->get_return_type().get_ndim();
         }
 
@@ -1094,7 +1195,7 @@ namespace nd {
         const ndt::arrfunc_type *child_tp = child.get_type();
 
         intptr_t dst_ndim = dst_tp.get_ndim();
-        if (!child_tp->get_return_type().is_symbolic()) {
+        if (!child_tp->get_return_type().is_variadic()) {
           dst_ndim -= child_tp->get_return_type().get_ndim();
         }
 
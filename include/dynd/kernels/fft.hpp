@@ -16,6 +16,27 @@
 #include <cufft.h>
 #endif
 
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    /**
+     * The arrfunc type of every FFT engine, which transforms
+     * ``Fixed**N * src_tp`` into ``Fixed**N * dst_tp``, so code calling
+     * fft, rfft and their inverses works the same with and without FFTW.
+     */
+    inline ndt::type make_fft_type(const ndt::type &dst_tp,
+                                   const ndt::type &src_tp)
+    {
+      return ndt::type("(Fixed**N * " + src_tp.str() +
+                       ", shape: ?N * int64, axes: ?Fixed * int64, flags: "
+                       "?int32) -> Fixed**N * " + dst_tp.str());
+    }
+
+  } // namespace dynd::nd::detail
+} // namespace dynd::nd
+} // namespace dynd
+
 #ifdef DYND_FFTW
 #include <fftw3.h>
 
@@ -318,9 +339,13 @@ namespace ndt {
   struct type::equivalent<nd::fftw_ck<fftw_dst_type, fftw_src_type, sign>> {
     static type make()
     {
-      return ndt::type("(Fixed**N * complex[float64], shape: ?N * int64, axes: "
-                       "?Fixed * int64, flags: ?int32) -> Fixed**N * "
-                       "complex[float64]");
+      return nd::detail::make_fft_type(
+          std::is_same<fftw_dst_type, double>::value
+              ? make_type<double>()
+              : make_type<complex<double>>(),
+          std::is_same<fftw_src_type, double>::value
+              ? make_type<double>()
+              : make_type<complex<double>>());
     }
   };
 
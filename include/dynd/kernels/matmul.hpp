@@ -0,0 +1,111 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/base_virtual_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+
+  namespace detail {
+
+    /**
+     * The matrix product ``c = a b`` of an ``m`` by ``k`` matrix and a ``k``
+     * by ``n`` one, all with arbitrary byte strides between rows and
+     * columns, for T one of float, double, complex<float> and
+     * complex<double>. ``c`` must not overlap the operands.
+     *
+     * Without a BLAS backend, or for layouts BLAS doesn't take, this is a
+     * blocked GEMM. Panels of ``b`` and blocks of ``a`` are packed into
+     * contiguous buffers sized for the L1 and L2 caches, and a micro-kernel
+     * computes a small tile of ``c`` in registers from them, with SSE2 for
+     * the real types on x86.
+     */
+    template <typename T>
+    void gemm(intptr_t m, intptr_t n, intptr_t k, const char *a,
+              intptr_t a_row_stride, intptr_t a_col_stride, const char *b,
+              intptr_t b_row_stride, intptr_t b_col_stride, char *c,
+              intptr_t c_row_stride, intptr_t c_col_stride);
+
+    /**
+     * The unconjugated inner product of two strided vectors of size ``n``,
+     * for the same types as gemm.
+     */
+    template <typename T>
+    T dot(intptr_t n, const char *a, intptr_t a_stride, const char *b,
+          intptr_t b_stride);
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * The matrix product of two strided matrices,
+   * ``(M * K * T, K * N * T) -> M * N * T``.
+   */
+  template <typename T>
+  struct matmul_ck : base_kernel<matmul_ck<T>, kernel_request_host, 2> {
+    intptr_t m_m, m_n, m_k;
+    intptr_t m_dst_stride[2], m_src0_stride[2], m_src1_stride[2];
+
+    void single(char *dst, char *const *src)
+    {
+      detail::gemm<T>(m_m, m_n, m_k, src[0], m_src0_stride[0],
+                      m_src0_stride[1], src[1], m_src1_stride[0],
+                      m_src1_stride[1], dst, m_dst_stride[0],
+                      m_dst_stride[1]);
+    }
+  };
+
+  /**
+   * The inner product of two strided vectors, ``(N * T, N * T) -> T``.
+   */
+  template <typename T>
+  struct dot_ck : base_kernel<dot_ck<T>, kernel_request_host, 2> {
+    intptr_t m_n, m_src_stride[2];
+
+    void single(char *dst, char *const *src)
+    {
+      *reinterpret_cast<T *>(dst) =
+          detail::dot<T>(m_n, src[0], m_src_stride[0], src[1], m_src_stride[1]);
+    }
+  };
+
+  /**
+   * Dispatches nd::matmul to matmul_ck by the element type, which must be
+   * the same for both operands.
+   */
+  struct matmul_virtual_ck : base_virtual_kernel<matmul_virtual_ck> {
+    static void
+    resolve_dst_type(char *static_data, size_t data_size, char *data,
+                     ndt::type &dst_tp, intptr_t nsrc, const ndt::type *src_tp,
+                     const nd::array &kwds,
+                     const std::map<nd::string, ndt::type> &tp_vars);
+
+    static intptr_t
+    instantiate(char *static_data, size_t data_size, char *data, void *ckb,
+                intptr_t ckb_offset, const ndt::type &dst_tp,
+                const char *dst_arrmeta, intptr_t nsrc, const ndt::type *src_tp,
+                const char *const *src_arrmeta, kernel_request_t kernreq,
+                const eval::eval_context *ectx, const nd::array &kwds,
+                const std::map<nd::string, ndt::type> &tp_vars);
+  };
+
+  /**
+   * Dispatches nd::dot to dot_ck by the element type, which must be the
+   * same for both operands.
+   */
+  struct dot_virtual_ck : base_virtual_kernel<dot_virtual_ck> {
+    static intptr_t
+    instantiate(char *static_data, size_t data_size, char *data, void *ckb,
+                intptr_t ckb_offset, const ndt::type &dst_tp,
+                const char *dst_arrmeta, intptr_t nsrc, const ndt::type *src_tp,
+                const char *const *src_arrmeta, kernel_request_t kernreq,
+                const eval::eval_context *ectx, const nd::array &kwds,
+                const std::map<nd::string, ndt::type> &tp_vars);
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <set>
 #include <unordered_map>
 
@@ -67,6 +68,48 @@ namespace nd {
       return false;
     }
 
+    /**
+     * The static data of an old_multidispatch arrfunc, which holds the
+     * children in topologically sorted order. Calls are matched against
+     * them in order, the first child whose signature the source types can
+     * implicitly convert to being chosen.
+     *
+     * When all the source types are builtin, they are identified by their
+     * type ids alone, and the decision is looked up in an index keyed on
+     * those. The index starts out with the exact signatures of the
+     * children, and memoizes the decisions for other builtin combinations
+     * as calls come in. Calls with other types are matched in full.
+     */
+    class old_multidispatch_static_data {
+    public:
+      struct decision {
+        /** Index of the child, or -1 if none match */
+        intptr_t child;
+        /** True if the source types are the child's exactly, so no
+         * buffering is needed */
+        bool exact;
+      };
+
+    private:
+      std::vector<arrfunc> m_children;
+      std::unordered_map<uint64_t, decision> m_index;
+      std::mutex m_index_mutex;
+
+      /** Packs the type ids of builtin source types into a key */
+      static bool get_key(intptr_t nsrc, const ndt::type *src_tp,
+                          uint64_t &out_key);
+
+      /** Matches the source types against each child in order */
+      decision match(intptr_t nsrc, const ndt::type *src_tp) const;
+
+    public:
+      old_multidispatch_static_data(std::vector<arrfunc> &&children);
+
+      const arrfunc &get_child(intptr_t i) const { return m_children[i]; }
+
+      decision resolve(intptr_t nsrc, const ndt::type *src_tp);
+    };
+
     struct old_multidispatch_ck : base_virtual_kernel<old_multidispatch_ck> {
       static void
       resolve_dst_type(char *static_data, size_t data_size, char *data,
@@ -84,6 +127,128 @@ namespace nd {
                   const std::map<dynd::nd::string, ndt::type> &tp_vars);
     };
 
+    /**
+     * The static data of a lazy_multidispatch arrfunc, a table of children
+     * indexed by the type ids of the N source types. Each child is made by
+     * its function the first time it is dispatched to.
+     */
+    template <int N>
+    class lazy_multidispatch_static_data {
+      struct entry {
+        arrfunc (*make)();
+        std::once_flag once;
+        arrfunc child;
+
+        entry() : make(NULL) {}
+      };
+
+      std::unique_ptr<entry[]> m_entries;
+
+      static size_t get_index(const type_id_t *key)
+      {
+        size_t index = 0;
+        for (int i = 0; i < N; ++i) {
+          index = index * (DYND_TYPE_ID_MAX + 1) + key[i];
+        }
+        return index;
+      }
+
+    public:
+      lazy_multidispatch_static_data(
+          const std::map<std::array<type_id_t, N>, arrfunc (*)()> &makers)
+      {
+        size_t size = 1;
+        for (int i = 0; i < N; ++i) {
+          size *= DYND_TYPE_ID_MAX + 1;
+        }
+        m_entries.reset(new entry[size]);
+        for (const auto &pair : makers) {
+          m_entries[get_index(pair.first.data())].make = pair.second;
+        }
+      }
+
+      /** Returns the child for the source types, or NULL if there is none */
+      const arrfunc *get(intptr_t nsrc, const ndt::type *src_tp)
+      {
+        if (nsrc != N) {
+          return NULL;
+        }
+        type_id_t key[N];
+        for (int i = 0; i < N; ++i) {
+          key[i] = src_tp[i].get_type_id();
+          if (key[i] > DYND_TYPE_ID_MAX) {
+            return NULL;
+          }
+        }
+        entry &e = m_entries[get_index(key)];
+        if (e.make == NULL) {
+          return NULL;
+        }
+        std::call_once(e.once, [&e] { e.child = e.make(); });
+        return &e.child;
+      }
+    };
+
+    template <int N>
+    struct lazy_multidispatch_kernel
+        : base_virtual_kernel<lazy_multidispatch_kernel<N>> {
+      static const arrfunc &get_child(char *static_data, intptr_t nsrc,
+                                      const ndt::type *src_tp)
+      {
+        lazy_multidispatch_static_data<N> &sd =
+            **reinterpret_cast<
+                std::shared_ptr<lazy_multidispatch_static_data<N>> *>(
+                static_data);
+        const arrfunc *child = sd.get(nsrc, src_tp);
+        if (child == NULL) {
+          std::stringstream ss;
+          ss << "No matching signature found in multidispatch arrfunc for "
+                "input types (";
+          for (intptr_t i = 0; i < nsrc; ++i) {
+            ss << src_tp[i] << (i != nsrc - 1 ? ", " : "");
+          }
+          ss << ")";
+          throw type_error(ss.str());
+        }
+        return *child;
+      }
+
+      static void
+      resolve_dst_type(char *static_data, size_t DYND_UNUSED(data_size),
+                       char *data, ndt::type &dst_tp, intptr_t nsrc,
+                       const ndt::type *src_tp, const dynd::nd::array &kwds,
+                       const std::map<dynd::nd::string, ndt::type> &tp_vars)
+      {
+        const arrfunc &child = get_child(static_data, nsrc, src_tp);
+        const ndt::type &child_dst_tp = child.get_type()->get_return_type();
+        if (child_dst_tp.is_symbolic()) {
+          child.get()->resolve_dst_type(
+              const_cast<char *>(child.get()->static_data),
+              child.get()->data_size, data, dst_tp, nsrc, src_tp, kwds,
+              tp_vars);
+        } else {
+          dst_tp = child_dst_tp;
+        }
+      }
+
+      static intptr_t
+      instantiate(char *static_data, size_t DYND_UNUSED(data_size), char *data,
+                  void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+                  const char *dst_arrmeta, intptr_t nsrc,
+                  const ndt::type *src_tp, const char *const *src_arrmeta,
+                  kernel_request_t kernreq, const eval::eval_context *ectx,
+                  const dynd::nd::array &kwds,
+                  const std::map<dynd::nd::string, ndt::type> &tp_vars)
+      {
+        const arrfunc &child = get_child(static_data, nsrc, src_tp);
+        return child.get()->instantiate(
+            const_cast<char *>(child.get()->static_data),
+            child.get()->data_size, data, ckb, ckb_offset, dst_tp,
+            dst_arrmeta, nsrc, src_tp, src_arrmeta, kernreq, ectx, kwds,
+            tp_vars);
+      }
+    };
+
     template <typename StaticDataType>
     struct multidispatch_kernel
         : base_virtual_kernel<multidispatch_kernel<StaticDataType>> {
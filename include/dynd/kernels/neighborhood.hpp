@@ -5,7 +5,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include <dynd/kernels/base_kernel.hpp>
+#include <dynd/parallel.hpp>
 #include <dynd/types/substitute_shape.hpp>
 
 namespace dynd {
@@ -14,72 +19,151 @@ namespace nd {
 
     struct neighborhood_data {
       arrfunc op;
-      start_stop_t *start_stop;
 
-      neighborhood_data(const arrfunc &neighborhood_op, intptr_t ndim)
+      neighborhood_data(const arrfunc &neighborhood_op) : op(neighborhood_op)
       {
-        op = neighborhood_op;
-        start_stop = static_cast<start_stop_t *>(
-            std::malloc(ndim * sizeof(start_stop_t)));
       }
-
-      ~neighborhood_data() { std::free(start_stop); }
     };
 
+    /**
+     * The bytes of source that the neighborhoods of a tile's rows should fit
+     * in, about the size of an L2 cache.
+     */
+    static const intptr_t neighborhood_tile_bytes = 256 * 1024;
+
+    /**
+     * Applies the neighborhood op at every point of the destination, walking
+     * it tile by tile. Tiles are narrowed in the inner dimensions until the
+     * neighborhoods of a few consecutive outer rows fit in
+     * neighborhood_tile_bytes, and run down each column of tiles in turn, so
+     * source points are reused from cache. The op sees the bounds of the
+     * source through the start_stop keyword, which is only updated point by
+     * point in tiles that reach the boundary.
+     *
+     * With the ``threads`` keyword, the tiles are split between that many
+     * threads, up to dynd::detail::clamp_thread_count, each with its own
+     * instance of the op. An exception thrown by the op on any thread is
+     * rethrown from the calling thread.
+     */
     template <int N>
     struct neighborhood_ck
         : base_kernel<neighborhood_ck<N>, kernel_request_host, N> {
       typedef neighborhood_ck<N> self_type;
 
-      intptr_t dst_stride;
-      intptr_t src_offset[N];
-      intptr_t src_stride[N];
-      intptr_t count[3];
-      intptr_t nh_size;
-      start_stop_t *nh_start_stop;
+      struct dim_t {
+        intptr_t size, dst_stride, src_size, src_stride;
+        intptr_t nh_size, offset;
+        // The points whose neighborhood is entirely within the source
+        intptr_t interior_begin, interior_end;
+        intptr_t tile;
+      };
 
-      // local index of first in of bounds element in the neighborhood
-      // local index of first out of bounds element in the neighborhood
+      std::vector<dim_t> dims;
+      int thread_count;
+      // The start_stop array of each thread's op, one entry per dimension
+      std::vector<start_stop_t> start_stop;
+      // The offset of each thread's op from this ckernel
+      std::vector<intptr_t> child_offsets;
 
-      void single(char *dst, char *const *src)
+      neighborhood_ck(const std::vector<dim_t> &dims, int thread_count)
+          : dims(dims), thread_count(thread_count),
+            start_stop(dims.size() * thread_count), child_offsets(thread_count)
       {
-        ckernel_prefix *child = self_type::get_child_ckernel();
-        expr_single_t child_fn = child->get_function<expr_single_t>();
+      }
 
+      void run_tile(size_t d, char *dst, char *const *src, const intptr_t *lo,
+                    const intptr_t *hi, bool interior, start_stop_t *ss,
+                    expr_single_t child_fn, ckernel_prefix *child)
+      {
+        const dim_t &dim = dims[d];
         char *src_copy[N];
-        memcpy(src_copy, src, sizeof(src_copy));
         for (intptr_t j = 0; j < N; ++j) {
-          src_copy[j] += src_offset[j];
+          src_copy[j] = src[j] + (lo[d] + dim.offset) * dim.src_stride;
         }
+        dst += lo[d] * dim.dst_stride;
 
-        nh_start_stop->start = count[0];
-        nh_start_stop->stop = nh_size; // min(nh_size, dst_size)
-        for (intptr_t i = 0; i < count[0]; ++i) {
-          child_fn(dst, src_copy, child);
-          --(nh_start_stop->start);
-          dst += dst_stride;
-          for (intptr_t j = 0; j < N; ++j) {
-            src_copy[j] += src_stride[j];
+        if (d + 1 == dims.size()) {
+          for (intptr_t i = lo[d]; i < hi[d]; ++i) {
+            if (!interior) {
+              ss[d].start = std::max<intptr_t>(0, -(i + dim.offset));
+              ss[d].stop = std::min(dim.nh_size,
+                                    dim.src_size - (i + dim.offset));
+            }
+            child_fn(dst, src_copy, child);
+            dst += dim.dst_stride;
+            for (intptr_t j = 0; j < N; ++j) {
+              src_copy[j] += dim.src_stride;
+            }
           }
-        }
-        //  *nh_start = 0;
-        //    *nh_stop = nh_size;
-        for (intptr_t i = 0; i < count[1]; ++i) {
-          child_fn(dst, src_copy, child);
-          dst += dst_stride;
-          for (intptr_t j = 0; j < N; ++j) {
-            src_copy[j] += src_stride[j];
+        } else {
+          for (intptr_t i = lo[d]; i < hi[d]; ++i) {
+            if (!interior) {
+              ss[d].start = std::max<intptr_t>(0, -(i + dim.offset));
+              ss[d].stop = std::min(dim.nh_size,
+                                    dim.src_size - (i + dim.offset));
+            }
+            run_tile(d + 1, dst, src_copy, lo, hi, interior, ss, child_fn,
+                     child);
+            dst += dim.dst_stride;
+            for (intptr_t j = 0; j < N; ++j) {
+              src_copy[j] += dim.src_stride;
+            }
           }
         }
-        //      *nh_start = 0;
-        //        *nh_stop = count[2]; // 0 if count[2] >
-        for (intptr_t i = 0; i < count[2]; ++i) {
-          --(nh_start_stop->stop);
-          child_fn(dst, src_copy, child);
-          dst += dst_stride;
-          for (intptr_t j = 0; j < N; ++j) {
-            src_copy[j] += src_stride[j];
+      }
+
+      void single(char *dst, char *const *src)
+      {
+        size_t ndim = dims.size();
+        intptr_t tile_count = 1;
+        std::vector<intptr_t> tiles(ndim);
+        for (size_t d = 0; d < ndim; ++d) {
+          tiles[d] = (dims[d].size + dims[d].tile - 1) / dims[d].tile;
+          tile_count *= tiles[d];
+        }
+        if (tile_count == 0) {
+          return;
+        }
+
+        int nthreads =
+            static_cast<int>(std::min<intptr_t>(thread_count, tile_count));
+        dynd::detail::parallel_for(nthreads, [&](int t) {
+          ckernel_prefix *child = this->get_child_ckernel(child_offsets[t]);
+          expr_single_t child_fn = child->get_function<expr_single_t>();
+          start_stop_t *ss = &start_stop[t * ndim];
+          std::vector<intptr_t> lo(ndim), hi(ndim);
+          intptr_t k_begin =
+              dynd::detail::chunk_begin(tile_count, nthreads, t);
+          intptr_t k_end = dynd::detail::chunk_begin(tile_count, nthreads, t + 1);
+          for (intptr_t k = k_begin; k < k_end; ++k) {
+            // The outermost dimension varies fastest, so consecutive tiles
+            // share the rows at their edges
+            bool interior = true;
+            intptr_t r = k;
+            for (size_t d = 0; d < ndim; ++d) {
+              const dim_t &dim = dims[d];
+              lo[d] = (r % tiles[d]) * dim.tile;
+              hi[d] = std::min(lo[d] + dim.tile, dim.size);
+              r /= tiles[d];
+              interior = interior && lo[d] >= dim.interior_begin &&
+                         hi[d] <= dim.interior_end;
+            }
+            if (interior) {
+              for (size_t d = 0; d < ndim; ++d) {
+                ss[d].start = 0;
+                ss[d].stop = dims[d].nh_size;
+              }
+            }
+            run_tile(0, dst, src, lo.data(), hi.data(), interior, ss, child_fn,
+                     child);
           }
+        });
+      }
+
+      void destruct_children()
+      {
+        for (size_t t = 0; t < child_offsets.size(); ++t) {
+          this->destroy_child_ckernel(child_offsets[t]);
         }
       }
 
@@ -113,6 +197,20 @@ namespace nd {
           offset = kwds.p("offset").f("dereference");
         }
 
+        int thread_count = 1;
+        nd::array threads = kwds.p("threads");
+        if (!threads.is_missing()) {
+          if (threads.get_type().get_type_id() == pointer_type_id) {
+            threads = threads.f("dereference");
+          }
+          intptr_t requested = threads.as<intptr_t>();
+          if (requested < 1) {
+            throw std::invalid_argument(
+                "neighborhood threads must be at least 1");
+          }
+          thread_count = dynd::detail::clamp_thread_count(requested);
+        }
+
         // Process the dst array striding/types
         const size_stride_t *dst_shape;
         ndt::type nh_dst_tp;
@@ -150,48 +248,64 @@ namespace nd {
         }
         const char *nh_src_arrmeta[1] = {nh_arrmeta.get()};
 
+        std::vector<dim_t> dims(ndim);
         for (intptr_t i = 0; i < ndim; ++i) {
-          typedef dynd::nd::functional::neighborhood_ck<N> self_type;
-          self_type *self = self_type::make(ckb, kernreq, ckb_offset);
-
-          self->dst_stride = dst_shape[i].stride;
-          for (intptr_t j = 0; j < N; ++j) {
-            self->src_offset[j] =
-                offset.is_null()
-                    ? 0
-                    : (offset(i).as<intptr_t>() * src0_shape[i].stride);
-            self->src_stride[j] = src0_shape[i].stride;
-          }
-
-          self->count[0] = offset.is_null() ? 0 : -offset(i).as<intptr_t>();
-          if (self->count[0] < 0) {
-            self->count[0] = 0;
-          } else if (self->count[0] > dst_shape[i].dim_size) {
-            self->count[0] = dst_shape[i].dim_size;
-          }
-          self->count[2] = shape(i).as<intptr_t>() +
-                           (offset.is_null() ? 0 : offset(i).as<intptr_t>()) -
-                           1;
-          if (self->count[2] < 0) {
-            self->count[2] = 0;
-          } else if (self->count[2] >
-                     (dst_shape[i].dim_size - self->count[0])) {
-            self->count[2] = dst_shape[i].dim_size - self->count[0];
+          dim_t &dim = dims[i];
+          dim.size = dst_shape[i].dim_size;
+          dim.dst_stride = dst_shape[i].stride;
+          dim.src_size = src0_shape[i].dim_size;
+          dim.src_stride = src0_shape[i].stride;
+          dim.nh_size = shape(i).as<intptr_t>();
+          dim.offset = offset.is_null() ? 0 : offset(i).as<intptr_t>();
+          dim.interior_begin =
+              std::min(std::max<intptr_t>(0, -dim.offset), dim.size);
+          dim.interior_end =
+              std::max(std::min(dim.src_size - dim.nh_size - dim.offset + 1,
+                                dim.size),
+                       dim.interior_begin);
+          dim.tile = std::max<intptr_t>(dim.size, 1);
+        }
+        if (ndim == 1) {
+          dims[0].tile = std::min<intptr_t>(dims[0].tile, 4096);
+        } else if (ndim > 1) {
+          // Narrow the inner dimensions, the middle ones first, until the
+          // neighborhoods of the points in nh_size outer rows fit
+          intptr_t el_size =
+              std::max<intptr_t>(src0_el_tp.get_data_size(), 1);
+          for (intptr_t i = 1; i < ndim; ++i) {
+            intptr_t min_tile = (i == ndim - 1) ? 64 : 1;
+            for (;;) {
+              intptr_t bytes = dims[0].nh_size * el_size;
+              for (intptr_t j = 1; j < ndim; ++j) {
+                bytes *= dims[j].tile + dims[j].nh_size - 1;
+              }
+              if (bytes <= neighborhood_tile_bytes ||
+                  dims[i].tile <= min_tile) {
+                break;
+              }
+              dims[i].tile = std::max(min_tile, (dims[i].tile + 1) / 2);
+            }
           }
-          self->count[1] =
-              dst_shape[i].dim_size - self->count[0] - self->count[2];
-
-          self->nh_size = shape(i).as<intptr_t>();
-          self->nh_start_stop = nh->start_stop + i;
+          dims[0].tile = std::min(
+              dims[0].tile, std::max<intptr_t>(32, 4 * dims[0].nh_size));
         }
 
-        ckb_offset = nh_op.get()->instantiate(
-            nh_op.get()->static_data, 0, NULL, ckb, ckb_offset, nh_dst_tp,
-            nh_dst_arrmeta, nsrc, nh_src_tp, nh_src_arrmeta,
-            kernel_request_single, ectx,
-            struct_concat(kwds, pack("start_stop", reinterpret_cast<intptr_t>(
-                                                       nh->start_stop))),
-            tp_vars);
+        intptr_t root_ckb_offset = ckb_offset;
+        self_type::make(ckb, kernreq, ckb_offset, dims, thread_count);
+        for (int t = 0; t < thread_count; ++t) {
+          self_type *self = self_type::get_self(
+              reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+              root_ckb_offset);
+          self->child_offsets[t] = ckb_offset - root_ckb_offset;
+          start_stop_t *start_stop = &self->start_stop[t * ndim];
+          ckb_offset = nh_op.get()->instantiate(
+              nh_op.get()->static_data, 0, NULL, ckb, ckb_offset, nh_dst_tp,
+              nh_dst_arrmeta, nsrc, nh_src_tp, nh_src_arrmeta,
+              kernel_request_single, ectx,
+              struct_concat(kwds, pack("start_stop",
+                                       reinterpret_cast<intptr_t>(start_stop))),
+              tp_vars);
+        }
 
         return ckb_offset;
       }
@@ -238,6 +352,217 @@ namespace nd {
       }
     };
 
+    struct separable_convolution_data {
+      std::vector<std::vector<double>> weights;
+
+      separable_convolution_data(
+          const std::vector<std::vector<double>> &weights)
+          : weights(weights)
+      {
+      }
+    };
+
+    /**
+     * Convolves with a separable kernel as one pass per dimension, through
+     * contiguous buffers. The pass over the last dimension runs along zero
+     * padded copies of the rows, and the passes over the others add whole
+     * contiguous rows of the previous pass, so the inner loops have unit
+     * stride and no bounds checks.
+     */
+    struct separable_convolution_ck
+        : base_kernel<separable_convolution_ck, kernel_request_host, 1> {
+      type_id_t value_type_id;
+      std::vector<intptr_t> shape, dst_stride, src_stride, offset;
+      std::vector<std::vector<double>> weights;
+
+      separable_convolution_ck(type_id_t value_type_id,
+                               const std::vector<intptr_t> &shape,
+                               const std::vector<intptr_t> &dst_stride,
+                               const std::vector<intptr_t> &src_stride,
+                               const std::vector<intptr_t> &offset,
+                               const std::vector<std::vector<double>> &weights)
+          : value_type_id(value_type_id), shape(shape), dst_stride(dst_stride),
+            src_stride(src_stride), offset(offset), weights(weights)
+      {
+      }
+
+      template <typename T>
+      static void gather(T *&out, const char *src, const intptr_t *shape,
+                         const intptr_t *stride, size_t ndim)
+      {
+        if (ndim == 1) {
+          for (intptr_t i = 0; i < shape[0]; ++i, src += stride[0]) {
+            *out++ = *reinterpret_cast<const T *>(src);
+          }
+        } else {
+          for (intptr_t i = 0; i < shape[0]; ++i, src += stride[0]) {
+            gather(out, src, shape + 1, stride + 1, ndim - 1);
+          }
+        }
+      }
+
+      template <typename T>
+      static void scatter(char *dst, const T *&in, const intptr_t *shape,
+                          const intptr_t *stride, size_t ndim)
+      {
+        if (ndim == 1) {
+          for (intptr_t i = 0; i < shape[0]; ++i, dst += stride[0]) {
+            *reinterpret_cast<T *>(dst) = *in++;
+          }
+        } else {
+          for (intptr_t i = 0; i < shape[0]; ++i, dst += stride[0]) {
+            scatter(dst, in, shape + 1, stride + 1, ndim - 1);
+          }
+        }
+      }
+
+      template <typename T>
+      void run(char *dst, const char *src)
+      {
+        size_t ndim = shape.size();
+        intptr_t size = 1;
+        for (size_t d = 0; d < ndim; ++d) {
+          size *= shape[d];
+        }
+        if (size == 0) {
+          return;
+        }
+
+        std::vector<T> a(size), b(size);
+        T *out = a.data();
+        gather(out, src, shape.data(), src_stride.data(), ndim);
+
+        for (size_t d = 0; d < ndim; ++d) {
+          const std::vector<double> &w = weights[d];
+          intptr_t len = w.size(), off = offset[d], n = shape[d];
+          intptr_t outer = 1, inner = 1;
+          for (size_t j = 0; j < d; ++j) {
+            outer *= shape[j];
+          }
+          for (size_t j = d + 1; j < ndim; ++j) {
+            inner *= shape[j];
+          }
+
+          if (inner == 1) {
+            intptr_t pad_lo = std::max<intptr_t>(0, -off);
+            intptr_t pad_hi = std::max<intptr_t>(0, off + len - 1);
+            std::vector<T> line(pad_lo + n + pad_hi);
+            const T *base = line.data() + pad_lo + off;
+            for (intptr_t o = 0; o < outer; ++o) {
+              memcpy(line.data() + pad_lo, a.data() + o * n, n * sizeof(T));
+              T *row = b.data() + o * n;
+              std::fill(row, row + n, T(0));
+              for (intptr_t k = 0; k < len; ++k) {
+                T wk = static_cast<T>(w[k]);
+                const T *p = base + k;
+                for (intptr_t i = 0; i < n; ++i) {
+                  row[i] += wk * p[i];
+                }
+              }
+            }
+          } else {
+            for (intptr_t o = 0; o < outer; ++o) {
+              for (intptr_t i = 0; i < n; ++i) {
+                T *row = b.data() + (o * n + i) * inner;
+                std::fill(row, row + inner, T(0));
+                intptr_t k_begin = std::max<intptr_t>(0, -(i + off));
+                intptr_t k_end = std::min(len, n - (i + off));
+                for (intptr_t k = k_begin; k < k_end; ++k) {
+                  T wk = static_cast<T>(w[k]);
+                  const T *p = a.data() + (o * n + i + off + k) * inner;
+                  for (intptr_t j = 0; j < inner; ++j) {
+                    row[j] += wk * p[j];
+                  }
+                }
+              }
+            }
+          }
+          a.swap(b);
+        }
+
+        const T *in = a.data();
+        scatter(dst, in, shape.data(), dst_stride.data(), ndim);
+      }
+
+      void single(char *dst, char *const *src)
+      {
+        if (value_type_id == float32_type_id) {
+          run<float>(dst, src[0]);
+        } else {
+          run<double>(dst, src[0]);
+        }
+      }
+
+      static intptr_t
+      instantiate(char *static_data, size_t DYND_UNUSED(data_size),
+                  char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+                  const ndt::type &dst_tp, const char *dst_arrmeta,
+                  intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                  const char *const *src_arrmeta, kernel_request_t kernreq,
+                  const eval::eval_context *DYND_UNUSED(ectx),
+                  const nd::array &kwds,
+                  const std::map<dynd::nd::string, ndt::type> &
+                      DYND_UNUSED(tp_vars))
+      {
+        const separable_convolution_data &sd =
+            **reinterpret_cast<std::shared_ptr<separable_convolution_data> *>(
+                static_data);
+        intptr_t ndim = sd.weights.size();
+
+        const size_stride_t *dst_shape, *src_shape;
+        ndt::type dst_el_tp, src_el_tp;
+        const char *dst_el_arrmeta, *src_el_arrmeta;
+        if (!dst_tp.get_as_strided(dst_arrmeta, ndim, &dst_shape, &dst_el_tp,
+                                   &dst_el_arrmeta) ||
+            !src_tp[0].get_as_strided(src_arrmeta[0], ndim, &src_shape,
+                                      &src_el_tp, &src_el_arrmeta)) {
+          std::stringstream ss;
+          ss << "separable_convolution requires strided arrays, not "
+             << src_tp[0] << " and " << dst_tp;
+          throw std::invalid_argument(ss.str());
+        }
+        if (src_el_tp != dst_el_tp ||
+            (src_el_tp.get_type_id() != float32_type_id &&
+             src_el_tp.get_type_id() != float64_type_id)) {
+          std::stringstream ss;
+          ss << "separable_convolution requires float32 or float64 values, "
+                "not " << src_el_tp;
+          throw type_error(ss.str());
+        }
+
+        nd::array offset;
+        if (!kwds.p("offset").is_missing()) {
+          offset = kwds.p("offset").f("dereference");
+        }
+
+        std::vector<intptr_t> shape(ndim), dst_stride(ndim), src_stride(ndim),
+            offsets(ndim);
+        for (intptr_t i = 0; i < ndim; ++i) {
+          shape[i] = dst_shape[i].dim_size;
+          dst_stride[i] = dst_shape[i].stride;
+          src_stride[i] = src_shape[i].stride;
+          offsets[i] = offset.is_null() ? 0 : offset(i).as<intptr_t>();
+        }
+
+        make(ckb, kernreq, ckb_offset, src_el_tp.get_type_id(), shape,
+             dst_stride, src_stride, offsets, sd.weights);
+        return ckb_offset;
+      }
+
+      static void resolve_dst_type(
+          char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+          char *DYND_UNUSED(data), ndt::type &dst_tp,
+          intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+          const nd::array &DYND_UNUSED(kwds),
+          const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+      {
+        intptr_t ndim = src_tp[0].get_ndim();
+        dimvector shape(ndim);
+        src_tp[0].extended()->get_shape(ndim, 0, shape.get(), NULL, NULL);
+        dst_tp = ndt::make_fixed_dim(ndim, shape.get(), src_tp[0].get_dtype());
+      }
+    };
+
   } // namespace dynd::nd::functional
 } // namespace dynd::nd
-} // namespace dynd
\ No newline at end of file
+} // namespace dynd
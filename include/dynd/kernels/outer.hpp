@@ -5,7 +5,10 @@
 
 #pragma once
 
+#include <vector>
+
 #include <dynd/arrmeta_holder.hpp>
+#include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/base_virtual_kernel.hpp>
 #include <dynd/kernels/elwise.hpp>
 
@@ -13,6 +16,193 @@ namespace dynd {
 namespace nd {
   namespace functional {
 
+    /**
+     * The bytes of the two operands a block of an outer product should
+     * touch, about the size of an L1 data cache.
+     */
+    static const intptr_t outer_block_bytes = 16 * 1024;
+
+    /**
+     * The rows and columns of the blocks of an outer product whose operands
+     * have elements of the given sizes, so that a block of each fits in
+     * outer_block_bytes together.
+     */
+    void get_outer_block_shape(intptr_t src0_el_size, intptr_t src1_el_size,
+                               intptr_t &block_rows, intptr_t &block_cols);
+
+    /**
+     * Evaluates the outer product of two one-dimensional strided operands
+     * a block at a time. For each block of columns of the second operand,
+     * a block of rows of the first one is run through it with one strided
+     * call of the child per row, so both blocks are reused from cache
+     * rather than the whole second operand being streamed for every row.
+     * The child should be a strided binary operation.
+     */
+    struct outer_blocked_ck
+        : base_kernel<outer_blocked_ck, kernel_request_host, 2> {
+      intptr_t m_dst_stride[2], m_src_size[2], m_src_stride[2];
+      intptr_t m_block_rows, m_block_cols;
+
+      void single(char *dst, char *const *src);
+
+      void destruct_children();
+
+      /**
+       * Instantiates the blocked kernel if the outer product is of two
+       * operands with one strided dimension each, returning -1 otherwise.
+       */
+      static intptr_t
+      instantiate(char *static_data, size_t data_size, char *data, void *ckb,
+                  intptr_t ckb_offset, const ndt::type &dst_tp,
+                  const char *dst_arrmeta, intptr_t nsrc,
+                  const ndt::type *src_tp, const char *const *src_arrmeta,
+                  kernel_request_t kernreq, const eval::eval_context *ectx,
+                  const nd::array &kwds,
+                  const std::map<nd::string, ndt::type> &tp_vars);
+    };
+
+    struct outer_reduce_data {
+      arrfunc child;
+      // A "(R) -> R" operation accumulating into its destination, or null
+      // for an arg reduction
+      arrfunc reduction;
+      // For an arg reduction, whether it finds the maximum
+      bool arg_max;
+
+      outer_reduce_data(const arrfunc &child, const arrfunc &reduction,
+                        bool arg_max)
+          : child(child), reduction(reduction), arg_max(arg_max)
+      {
+      }
+    };
+
+    /**
+     * Reduces each row of the outer product of two one-dimensional strided
+     * operands without storing the product. The values of the child are
+     * computed a block of columns at a time into a buffer, with the blocks
+     * visited as in outer_blocked_ck, and folded into the destination by
+     * the reduction, the first value of each row being copied.
+     */
+    struct outer_reduce_ck
+        : base_kernel<outer_reduce_ck, kernel_request_host, 2> {
+      intptr_t m_dst_stride, m_src_size[2], m_src_stride[2];
+      intptr_t m_block_rows, m_block_cols;
+      intptr_t m_value_size;
+      intptr_t m_reduction_offset;
+      std::vector<char> m_buffer;
+
+      void single(char *dst, char *const *src);
+
+      void destruct_children();
+
+      static void
+      resolve_dst_type(char *static_data, size_t data_size, char *data,
+                       ndt::type &dst_tp, intptr_t nsrc,
+                       const ndt::type *src_tp, const nd::array &kwds,
+                       const std::map<nd::string, ndt::type> &tp_vars);
+
+      static intptr_t
+      instantiate(char *static_data, size_t data_size, char *data, void *ckb,
+                  intptr_t ckb_offset, const ndt::type &dst_tp,
+                  const char *dst_arrmeta, intptr_t nsrc,
+                  const ndt::type *src_tp, const char *const *src_arrmeta,
+                  kernel_request_t kernreq, const eval::eval_context *ectx,
+                  const nd::array &kwds,
+                  const std::map<nd::string, ndt::type> &tp_vars);
+    };
+
+    /**
+     * Finds the index of the minimum, or with Max the maximum, of each row
+     * of the outer product of two one-dimensional strided operands, as
+     * outer_reduce_ck does, keeping the best value of each row of a block
+     * of rows. Ties go to the first index, and NaNs are skipped unless a
+     * whole row is NaN.
+     */
+    template <typename T, bool Max>
+    struct outer_arg_ck
+        : base_kernel<outer_arg_ck<T, Max>, kernel_request_host, 2> {
+      intptr_t m_dst_stride, m_src_size[2], m_src_stride[2];
+      intptr_t m_block_rows, m_block_cols;
+      std::vector<T> m_values, m_best;
+
+      outer_arg_ck(intptr_t dst_stride, const intptr_t *src_size,
+                   const intptr_t *src_stride, intptr_t block_rows,
+                   intptr_t block_cols)
+          : m_dst_stride(dst_stride), m_block_rows(block_rows),
+            m_block_cols(block_cols), m_values(block_cols),
+            m_best(block_rows)
+      {
+        for (int i = 0; i < 2; ++i) {
+          m_src_size[i] = src_size[i];
+          m_src_stride[i] = src_stride[i];
+        }
+      }
+
+      static bool better(T value, T best)
+      {
+        return (Max ? best < value : value < best) ||
+               (best != best && value == value);
+      }
+
+      void single(char *dst, char *const *src)
+      {
+        ckernel_prefix *child = this->get_child_ckernel();
+        expr_strided_t child_fn = child->get_function<expr_strided_t>();
+        intptr_t child_src_stride[2] = {0, m_src_stride[1]};
+        char *child_src[2];
+        for (intptr_t i0 = 0; i0 < m_src_size[0]; i0 += m_block_rows) {
+          intptr_t i1 = std::min(i0 + m_block_rows, m_src_size[0]);
+          for (intptr_t j0 = 0; j0 < m_src_size[1]; j0 += m_block_cols) {
+            intptr_t count = std::min(m_block_cols, m_src_size[1] - j0);
+            child_src[1] = src[1] + j0 * m_src_stride[1];
+            for (intptr_t i = i0; i < i1; ++i) {
+              child_src[0] = src[0] + i * m_src_stride[0];
+              child_fn(reinterpret_cast<char *>(m_values.data()), sizeof(T),
+                       child_src, child_src_stride, count, child);
+              T &best = m_best[i - i0];
+              intptr_t &arg =
+                  *reinterpret_cast<intptr_t *>(dst + i * m_dst_stride);
+              intptr_t k = 0;
+              if (j0 == 0) {
+                best = m_values[0];
+                arg = 0;
+                k = 1;
+              }
+              for (; k < count; ++k) {
+                if (better(m_values[k], best)) {
+                  best = m_values[k];
+                  arg = j0 + k;
+                }
+              }
+            }
+          }
+        }
+      }
+
+      void destruct_children() { this->get_child_ckernel()->destroy(); }
+    };
+
+    /**
+     * Dispatches an arg reduction over an outer product to outer_arg_ck by
+     * the value type of the child.
+     */
+    struct outer_arg_virtual_ck : base_virtual_kernel<outer_arg_virtual_ck> {
+      static void
+      resolve_dst_type(char *static_data, size_t data_size, char *data,
+                       ndt::type &dst_tp, intptr_t nsrc,
+                       const ndt::type *src_tp, const nd::array &kwds,
+                       const std::map<nd::string, ndt::type> &tp_vars);
+
+      static intptr_t
+      instantiate(char *static_data, size_t data_size, char *data, void *ckb,
+                  intptr_t ckb_offset, const ndt::type &dst_tp,
+                  const char *dst_arrmeta, intptr_t nsrc,
+                  const ndt::type *src_tp, const char *const *src_arrmeta,
+                  kernel_request_t kernreq, const eval::eval_context *ectx,
+                  const nd::array &kwds,
+                  const std::map<nd::string, ndt::type> &tp_vars);
+    };
+
     template <int N>
     struct outer_ck : base_virtual_kernel<outer_ck<N>> {
       static intptr_t
@@ -25,6 +215,15 @@ namespace nd {
                   const eval::eval_context *ectx, const dynd::nd::array &kwds,
                   const std::map<dynd::nd::string, ndt::type> &tp_vars)
       {
+        if (N == 2) {
+          intptr_t blocked_ckb_offset = outer_blocked_ck::instantiate(
+              static_data, 0, NULL, ckb, ckb_offset, dst_tp, dst_arrmeta,
+              nsrc, src_tp, src_arrmeta, kernreq, ectx, kwds, tp_vars);
+          if (blocked_ckb_offset >= 0) {
+            return blocked_ckb_offset;
+          }
+        }
+
         intptr_t ndim = 0;
         for (intptr_t i = 0; i < nsrc; ++i) {
           ndim += src_tp[i].get_ndim();
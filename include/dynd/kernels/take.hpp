@@ -11,10 +11,17 @@
 namespace dynd {
 namespace nd {
 
+  /**
+   * CKernel which does a boolean masked take operation. The child ckernel
+   * should be a strided unary operation. Builtin elements which don't need
+   * converting are compacted directly instead.
+   */
   struct masked_take_ck : base_kernel<masked_take_ck, kernel_request_host, 2> {
     ndt::type m_dst_tp;
     const char *m_dst_meta;
     intptr_t m_dim_size, m_src0_stride, m_mask_stride;
+    // The size of a builtin element copied without the child, or 0
+    intptr_t m_pod_size;
 
     void single(char *dst, char *const *src);
 
@@ -31,17 +38,51 @@ namespace nd {
 
   /**
    * CKernel which does an indexed take operation. The child ckernel
-   * should be a single unary operation.
+   * should be a single unary operation. Builtin elements which don't need
+   * converting are gathered directly instead.
    */
   struct indexed_take_ck
       : base_kernel<indexed_take_ck, kernel_request_host, 2> {
     intptr_t m_dst_dim_size, m_dst_stride, m_index_stride;
     intptr_t m_src0_dim_size, m_src0_stride;
+    // The size of a builtin element copied without the child, or 0
+    intptr_t m_pod_size;
+
+    void single(char *dst, char *const *src);
+
+    void destruct_children();
+
+    static intptr_t
+    instantiate(char *static_data, size_t data_size, char *data, void *ckb,
+                intptr_t ckb_offset, const ndt::type &dst_tp,
+                const char *dst_arrmeta, intptr_t nsrc, const ndt::type *src_tp,
+                const char *const *src_arrmeta, kernel_request_t kernreq,
+                const eval::eval_context *ectx, const nd::array &kwds,
+                const std::map<nd::string, ndt::type> &tp_vars);
+  };
+
+  /**
+   * CKernel which does an indexed put operation, the scatter counterpart of
+   * an indexed take. The child ckernel should be a single unary operation.
+   * Builtin elements which don't need converting are scattered directly
+   * instead.
+   */
+  struct put_ck : base_kernel<put_ck, kernel_request_host, 2> {
+    intptr_t m_dst_dim_size, m_dst_stride, m_index_stride;
+    intptr_t m_src0_dim_size, m_src0_stride;
+    // The size of a builtin element copied without the child, or 0
+    intptr_t m_pod_size;
 
     void single(char *dst, char *const *src);
 
     void destruct_children();
 
+    static void
+    resolve_dst_type(char *static_data, size_t data_size, char *data,
+                     ndt::type &dst_tp, intptr_t nsrc, const ndt::type *src_tp,
+                     const nd::array &kwds,
+                     const std::map<nd::string, ndt::type> &tp_vars);
+
     static intptr_t
     instantiate(char *static_data, size_t data_size, char *data, void *ckb,
                 intptr_t ckb_offset, const ndt::type &dst_tp,
@@ -84,6 +84,20 @@ memory_block_ptr make_array_memory_block(size_t arrmeta_size, size_t extra_size,
  */
 memory_block_ptr shallow_copy_array_memory_block(const memory_block_ptr& ndo);
 
+/**
+ * Enables or disables the per-thread pooling of small array memory blocks,
+ * returning the previous setting. Pooling is enabled by default, and
+ * applies only while the malloc allocator is installed. Disabling it
+ * also frees the blocks cached by the calling thread.
+ */
+bool set_array_memory_block_pool_enabled(bool enabled);
+
+/**
+ * Frees the small array memory blocks cached by the calling thread. Each
+ * thread's cache is also freed when the thread exits.
+ */
+void clear_array_memory_block_pool();
+
 void array_memory_block_debug_print(const memory_block_data *memblock,
                                     std::ostream &o, const std::string &indent);
 
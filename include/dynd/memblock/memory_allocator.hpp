@@ -0,0 +1,109 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <string>
+
+#include <dynd/config.hpp>
+#include <dynd/memblock/memory_block.hpp>
+
+namespace dynd {
+
+/** The number of values in memory_block_type_t */
+enum { memory_block_type_count = memmap_memory_block_type + 1 };
+
+/**
+ * An allocator through which the memory blocks obtain the memory they
+ * manage. The allocation and deallocation are done through function
+ * pointers, and every allocator keeps its own accounting of the memory
+ * that passed through it.
+ *
+ * To install a custom allocator (e.g. a jemalloc arena or a pool),
+ * derive a struct from memory_allocator, pass the two functions to the
+ * constructor, and install it with set_memory_allocator. The allocator
+ * must outlive every memory block allocated from it, as each memory block
+ * records the allocator it came from and frees its memory through it.
+ */
+struct memory_allocator {
+    /**
+     * Allocates the requested number of bytes, returning NULL on failure.
+     * The memory must have alignment suitable for any builtin type, like
+     * the memory returned by malloc.
+     */
+    void *(*allocate)(memory_allocator *self, size_t size_bytes);
+    /**
+     * Frees memory returned by allocate. The size is the same as was
+     * requested from allocate.
+     */
+    void (*deallocate)(memory_allocator *self, void *ptr, size_t size_bytes);
+
+    /**
+     * The maximum number of bytes which may be live at once from this
+     * allocator, or 0 for no limit. Allocations beyond the limit throw
+     * std::bad_alloc.
+     */
+    std::atomic<intptr_t> limit_bytes;
+    /** The number of bytes currently allocated */
+    std::atomic<intptr_t> live_bytes;
+    /** The high water mark of live_bytes */
+    std::atomic<intptr_t> peak_bytes;
+    /** The number of bytes currently allocated, by memory_block_type_t */
+    std::atomic<intptr_t> live_bytes_by_type[memory_block_type_count];
+    /** The number of allocations made so far, by memory_block_type_t */
+    std::atomic<intptr_t> allocation_count_by_type[memory_block_type_count];
+
+    memory_allocator(void *(*allocate_func)(memory_allocator *, size_t),
+                     void (*deallocate_func)(memory_allocator *, void *, size_t));
+
+    /** Sets the peak back to the current number of live bytes */
+    void reset_peak();
+
+private:
+    // Non-copyable, as memory blocks hold pointers to their allocator
+    memory_allocator(const memory_allocator &);
+    memory_allocator &operator=(const memory_allocator &);
+};
+
+/**
+ * Returns the builtin allocator, which uses malloc and free.
+ */
+memory_allocator *get_malloc_memory_allocator();
+
+/**
+ * Returns the allocator which newly created memory blocks use.
+ */
+memory_allocator *get_memory_allocator();
+
+/**
+ * Sets the allocator which newly created memory blocks use, returning the
+ * previous one. Passing NULL restores the malloc allocator. Existing memory
+ * blocks keep using the allocator they were created with.
+ */
+memory_allocator *set_memory_allocator(memory_allocator *alloc);
+
+void memory_allocator_debug_print(const memory_allocator *alloc, std::ostream &o,
+                                  const std::string &indent = "");
+
+namespace detail {
+    /**
+     * Allocates memory for a memory block of the given type through the
+     * allocator, updating its accounting. Throws std::bad_alloc on failure
+     * or if the allocator's limit would be exceeded.
+     */
+    char *memory_allocator_allocate(memory_allocator *alloc, memory_block_type_t mbt,
+                                    size_t size_bytes);
+
+    /**
+     * Frees memory obtained from memory_allocator_allocate, updating
+     * the accounting of the allocator.
+     */
+    void memory_allocator_deallocate(memory_allocator *alloc, memory_block_type_t mbt,
+                                     void *ptr, size_t size_bytes);
+} // namespace detail
+
+} // namespace dynd
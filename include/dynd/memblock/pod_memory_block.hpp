@@ -17,6 +17,12 @@ namespace dynd {
  * for blockref types.
  *
  * The initial capacity can be set if a good estimate is known.
+ *
+ * The block can be recycled across batches of output through the reset
+ * function of its allocator API. On each reset it learns how many bytes
+ * the batch used, and consolidates its memory into a single chunk of
+ * about that size, so repeated batches of similar size reuse the same
+ * memory without going back to the allocator.
  */
 memory_block_ptr make_pod_memory_block(intptr_t initial_capacity_bytes = 2048);
 
@@ -0,0 +1,200 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+namespace detail {
+
+  /**
+   * Requested thread counts are capped at this, or at the hardware
+   * concurrency when that is larger, so per-thread state stays bounded.
+   */
+  const int max_thread_count = 64;
+
+  /** Clamps a requested thread count to [1, max(max_thread_count, cores)] */
+  inline int clamp_thread_count(intptr_t count)
+  {
+    intptr_t limit = std::max<intptr_t>(max_thread_count,
+                                        std::thread::hardware_concurrency());
+    return static_cast<int>(std::max<intptr_t>(1, std::min(count, limit)));
+  }
+
+  /**
+   * A fixed set of worker threads which run ``parallel_for`` calls, so code
+   * with many parallel phases starts its threads once rather than per
+   * phase. The workers are started by the constructor and joined by the
+   * destructor. Only one thread at a time may call ``parallel_for``, and
+   * tasks must not call back into the pool they run on.
+   */
+  class thread_pool {
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_start, m_done;
+    // The current call, published under the mutex by bumping m_generation
+    const std::function<void(int)> *m_task;
+    int m_task_count, m_busy;
+    unsigned m_generation;
+    bool m_stopping;
+    std::vector<std::exception_ptr> m_errors;
+
+    /** Runs the tasks of the current call which belong to thread ``e`` */
+    void run(int e)
+    {
+      int stride = get_thread_count();
+      for (int t = e; t < m_task_count; t += stride) {
+        try {
+          (*m_task)(t);
+        }
+        catch (...) {
+          m_errors[t] = std::current_exception();
+        }
+      }
+    }
+
+    void work(int e)
+    {
+      unsigned seen = 0;
+      std::unique_lock<std::mutex> lock(m_mutex);
+      for (;;) {
+        m_start.wait(lock,
+                     [&] { return m_stopping || m_generation != seen; });
+        if (m_stopping) {
+          return;
+        }
+        seen = m_generation;
+        lock.unlock();
+        run(e);
+        lock.lock();
+        if (--m_busy == 0) {
+          m_done.notify_one();
+        }
+      }
+    }
+
+  public:
+    /**
+     * Starts thread_count - 1 workers, the calling thread being the last
+     * one. If a worker can't be started, the pool keeps the ones that were.
+     */
+    explicit thread_pool(int thread_count)
+        : m_task(NULL), m_task_count(0), m_busy(0), m_generation(0),
+          m_stopping(false)
+    {
+      if (thread_count > 1) {
+        m_workers.reserve(thread_count - 1);
+      }
+      try {
+        for (int e = 1; e < thread_count; ++e) {
+          m_workers.push_back(std::thread(&thread_pool::work, this, e));
+        }
+      }
+      catch (...) {
+      }
+    }
+
+    ~thread_pool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+      }
+      m_start.notify_all();
+      for (size_t e = 0; e < m_workers.size(); ++e) {
+        m_workers[e].join();
+      }
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    /** The number of threads, including the one calling parallel_for */
+    int get_thread_count() const
+    {
+      return static_cast<int>(m_workers.size()) + 1;
+    }
+
+    /**
+     * Runs ``f(t)`` for t in [0, task_count), thread ``e`` of the pool
+     * taking the tasks e, e + get_thread_count(), .... Returns once every
+     * task is done, rethrowing the first exception any of them threw.
+     */
+    template <typename F>
+    void parallel_for(int task_count, const F &f)
+    {
+      if (task_count <= 0) {
+        return;
+      }
+      std::function<void(int)> task = std::cref(f);
+      m_errors.assign(task_count, std::exception_ptr());
+      m_task = &task;
+      m_task_count = task_count;
+      if (task_count > 1 && !m_workers.empty()) {
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_busy = static_cast<int>(m_workers.size());
+          ++m_generation;
+        }
+        m_start.notify_all();
+        run(0);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busy == 0; });
+      } else {
+        // Every task belongs to this thread
+        for (int t = 0; t < task_count; ++t) {
+          try {
+            f(t);
+          }
+          catch (...) {
+            m_errors[t] = std::current_exception();
+          }
+        }
+      }
+      m_task = NULL;
+      for (int t = 0; t < task_count; ++t) {
+        if (m_errors[t]) {
+          std::rethrow_exception(m_errors[t]);
+        }
+      }
+    }
+  };
+
+  /**
+   * Runs ``f(t)`` for t in [0, thread_count), on the calling thread and
+   * thread_count - 1 additional threads. If a thread can't be started, its
+   * calls run on one of the others instead. Every thread is joined before
+   * this returns, and the first exception thrown by any ``f(t)`` is
+   * rethrown from the calling thread. Code with several parallel phases
+   * should keep a thread_pool instead.
+   */
+  template <typename F>
+  void parallel_for(int thread_count, const F &f)
+  {
+    if (thread_count <= 1) {
+      f(0);
+      return;
+    }
+    thread_pool pool(thread_count);
+    pool.parallel_for(thread_count, f);
+  }
+
+  /** The start of chunk ``t`` when splitting ``n`` items into ``count`` */
+  inline intptr_t chunk_begin(intptr_t n, int count, int t)
+  {
+    return static_cast<intptr_t>(static_cast<double>(n) * t / count);
+  }
+
+} // namespace dynd::detail
+} // namespace dynd
@@ -246,14 +246,34 @@ namespace ndt {
 
     bool operator==(const type &rhs) const
     {
-      return m_extended == rhs.m_extended ||
-             (!is_builtin() && !rhs.is_builtin() &&
-              *m_extended == *rhs.m_extended);
+      if (m_extended == rhs.m_extended) {
+        return true;
+      } else if (is_builtin() || rhs.is_builtin()) {
+        return false;
+      } else if (m_extended->is_interned() && rhs.m_extended->is_interned()) {
+        // Distinct interned instances always differ in structure
+        return false;
+      }
+      return *m_extended == *rhs.m_extended;
     }
     bool operator!=(const type &rhs) const { return !(operator==(rhs)); }
 
     bool is_null() const { return m_extended == NULL; }
 
+    /**
+     * A hash of the type consistent with operator==, so types can be used
+     * as keys in hash tables. For non-builtin types it is cached on the
+     * base_type instance.
+     */
+    size_t get_hash() const
+    {
+      if (is_builtin()) {
+        return static_cast<size_t>(reinterpret_cast<uintptr_t>(m_extended) *
+                                   0x9e3779b97f4a7c15ULL);
+      }
+      return m_extended->get_hash();
+    }
+
     /**
      * Returns true if this type is built in, which
      * means the type id is encoded directly in the m_extended
@@ -1113,6 +1133,25 @@ namespace ndt {
 
   std::ostream &operator<<(std::ostream &o, const type &rhs);
 
+  /**
+   * Returns the canonical instance of the type's structure, adding it to a
+   * global intern table if no equal type was interned before. Two interned
+   * types are equal only if they are the same instance, so comparing them
+   * is a pointer compare.
+   *
+   * Types constructed from datashape strings are interned. Types from the
+   * make_* factories aren't, and compare structurally unless both sides
+   * are interned. An interned type is dropped from the table, and freed,
+   * once the table holds its only reference.
+   */
+  type intern(const type &tp);
+
+  /**
+   * Returns the number of types in the intern table which are still
+   * referenced outside it, for diagnostics and tests.
+   */
+  size_t get_interned_type_count();
+
 } // namespace ndt
 
 /** Prints raw bytes as hexadecimal */
@@ -1134,3 +1173,12 @@ void print_indented(std::ostream &o, const std::string &indent,
                     const std::string &s, bool skipfirstline = false);
 
 } // namespace dynd
+
+namespace std {
+
+template <>
+struct hash<dynd::ndt::type> {
+  size_t operator()(const dynd::ndt::type &tp) const { return tp.get_hash(); }
+};
+
+} // namespace std
@@ -24,6 +24,9 @@ namespace ndt {
   protected:
     nd::array m_field_names;
 
+    /** Compares the field names with those of another struct type */
+    bool field_names_equal(const base_struct_type &rhs) const;
+
   public:
     base_struct_type(type_id_t type_id, const nd::array &field_names,
                      const nd::array &field_types, flags_type flags,
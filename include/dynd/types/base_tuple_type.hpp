@@ -47,6 +47,12 @@ namespace ndt {
       return NULL;
     }
 
+    /**
+     * Compares the field types with those of another tuple or struct type,
+     * one ndt::type comparison per field.
+     */
+    bool field_types_equal(const base_tuple_type &rhs) const;
+
   public:
     base_tuple_type(type_id_t type_id, const nd::array &field_types,
                     flags_type flags, bool layout_in_arrmeta, bool variadic);
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <unordered_set>
 #include <vector>
 
@@ -141,6 +142,12 @@ namespace ndt {
   class base_type {
     /** Embedded reference counting */
     mutable atomic_refcount m_use_count;
+    /** The structural hash, or 0 if it hasn't been computed yet */
+    mutable std::atomic<size_t> m_hash;
+    /** Whether this is the canonical instance held by the intern table */
+    mutable std::atomic<bool> m_interned;
+
+    size_t compute_hash() const;
 
   protected:
     /// Standard dynd type data
@@ -160,7 +167,7 @@ namespace ndt {
     inline base_type(type_id_t type_id, type_kind_t kind, size_t data_size,
                      size_t alignment, flags_type flags, size_t arrmeta_size,
                      size_t ndim, size_t strided_ndim)
-        : m_use_count(1),
+        : m_use_count(1), m_hash(0), m_interned(false),
           m_members(static_cast<uint16_t>(type_id), static_cast<uint8_t>(kind),
                     static_cast<uint8_t>(alignment), flags, data_size,
                     arrmeta_size, static_cast<uint8_t>(ndim),
@@ -173,6 +180,23 @@ namespace ndt {
     /** For debugging purposes, the type's use count */
     inline int32_t get_use_count() const { return m_use_count; }
 
+    /**
+     * A hash of the structure of the type, consistent with operator==. It
+     * is computed from the datashape of the type on first use and cached.
+     */
+    inline size_t get_hash() const
+    {
+      size_t h = m_hash.load(std::memory_order_relaxed);
+      return h != 0 ? h : compute_hash();
+    }
+
+    /**
+     * Returns true if this is the instance ndt::intern returns for its
+     * structure, in which case it is equal only to itself among interned
+     * types.
+     */
+    inline bool is_interned() const { return m_interned; }
+
     /** Returns the struct of data common to all types. */
     inline const base_type_members &get_base_type_members() const
     {
@@ -751,6 +775,7 @@ namespace ndt {
                                     nd::arrfunc &out_forward,
                                     nd::arrfunc &out_reverse) const;
 
+    friend type intern(const type &tp);
     friend void base_type_incref(const base_type *ed);
     friend void base_type_decref(const base_type *ed);
   };
@@ -37,4 +37,41 @@ inline ndt::type type_from_datashape(const char (&datashape)[N])
     return type_from_datashape(datashape, datashape + N - 1);
 }
 
+/**
+ * Parses a blaze datashape like type_from_datashape, but through a
+ * thread-safe cache of recently parsed datashapes, returning interned
+ * types. This is what ndt::type(const std::string&) uses.
+ *
+ * \param datashape_begin  The start of the buffer containing the datashape.
+ * \param datashape_end    The end of the buffer containing the datashape.
+ */
+ndt::type cached_type_from_datashape(const char *datashape_begin,
+                                     const char *datashape_end);
+
+/** Statistics of the datashape cache */
+struct datashape_cache_stats {
+    /** The number of lookups which found their datashape in the cache */
+    intptr_t hits;
+    /** The number of lookups which had to parse their datashape */
+    intptr_t misses;
+    /** The number of datashapes in the cache */
+    intptr_t size;
+    /** The maximum number of datashapes the cache holds */
+    intptr_t capacity;
+};
+
+datashape_cache_stats get_datashape_cache_stats();
+
+/**
+ * Sets the maximum number of datashapes in the cache, evicting the least
+ * recently used ones beyond it. A capacity of 0 disables the cache.
+ * Evicted types which nothing else references are later dropped from the
+ * intern table too, so the capacity bounds the memory the cache keeps
+ * alive as well as its entries.
+ */
+void set_datashape_cache_capacity(intptr_t capacity);
+
+/** Removes all datashapes from the cache, and resets its statistics */
+void clear_datashape_cache();
+
 } // namespace dynd
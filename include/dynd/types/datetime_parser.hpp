@@ -68,6 +68,46 @@ namespace parse {
                         datetime_struct &out_dt, const char *&out_tz_begin,
                         const char *&out_tz_end);
 
+    /**
+     * A fixed ISO 8601 datetime layout, "YYYY-MM-DDThh:mm[:ss[.fffffffff]][Z]",
+     * with either 'T' or ' ' separating the date and time. Columns of
+     * timestamps typically all share one such layout, so it is detected
+     * once from a sample, and subsequent strings with the same layout are
+     * parsed by extracting the digits at fixed offsets rather than going
+     * through parse_datetime.
+     */
+    struct iso8601_datetime_layout {
+        /** The length of strings with this layout, 0 if none was detected */
+        intptr_t size;
+        char date_time_separator;
+        bool has_seconds;
+        /** The number of fractional second digits, 0 to 9 */
+        int fraction_digits;
+        /** Whether the strings end with a 'Z' UTC marker */
+        bool utc_suffix;
+
+        iso8601_datetime_layout()
+            : size(0), date_time_separator('T'), has_seconds(false),
+              fraction_digits(0), utc_suffix(false)
+        {
+        }
+
+        /**
+         * Detects the layout of the string, returning true if it is a valid
+         * datetime with a fixed ISO 8601 layout. If it returns false, the
+         * layout matches no strings.
+         */
+        bool detect(const char *begin, const char *end);
+
+        /**
+         * Parses a string with this layout into datetime ticks. Returns false
+         * if the string does not match the layout or is not a valid datetime,
+         * in which case the general parser should be used instead. Any time
+         * zone marker is dropped, the same as string_to_datetime does.
+         */
+        bool parse(const char *begin, const char *end, int64_t &out_ticks) const;
+    };
+
 } // namespace parse
 
 } // namespace parse
@@ -0,0 +1,229 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include <dynd/type.hpp>
+
+namespace dynd {
+
+/** Mixes the bits of a 64-bit value, the finalizer of MurmurHash3 */
+inline uint64_t hash_mix(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/** Hashes a run of bytes, eight at a time */
+inline uint64_t hash_bytes(const char *data, size_t size, uint64_t h)
+{
+  h ^= size * 0x9e3779b97f4a7c15ULL;
+  for (; size >= 8; size -= 8, data += 8) {
+    uint64_t word;
+    memcpy(&word, data, 8);
+    h = (h ^ word) * 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 29;
+  }
+  if (size > 0) {
+    uint64_t word = 0;
+    memcpy(&word, data, size);
+    h = (h ^ word) * 0x9e3779b97f4a7c15ULL;
+  }
+  return hash_mix(h);
+}
+
+/**
+ * Hashes and compares the values of elements of one type, with the
+ * arrmeta fixed. Builtin, string, bytes and other POD scalar types are
+ * supported, as are fixed dims, structs and tuples of them.
+ *
+ * float32 and float64 values, and the parts of complex values, compare by
+ * value with two exceptions, so that equality is consistent with the
+ * hash: all NaNs are equal to each other, and -0.0 is equal to 0.0.
+ * Everything else compares by its bytes.
+ */
+class element_hasher {
+public:
+  enum leaf_kind_t {
+    leaf_bytes,
+    leaf_float32,
+    leaf_float64,
+    leaf_string
+  };
+
+  struct leaf {
+    leaf_kind_t kind;
+    /** The offset of the leaf within the element */
+    intptr_t offset;
+    /** The size in bytes, for leaf_bytes */
+    intptr_t size;
+  };
+
+private:
+  std::vector<leaf> m_leaves;
+
+  void add_leaves(const ndt::type &tp, const char *arrmeta, intptr_t offset);
+
+public:
+  /** Throws type_error if the type is not supported */
+  element_hasher(const ndt::type &tp, const char *arrmeta);
+
+  /** Returns true if elements of the type can be hashed */
+  static bool is_hashable(const ndt::type &tp);
+
+  const std::vector<leaf> &get_leaves() const { return m_leaves; }
+
+  /**
+   * If elements are a single run of 1, 2, 4 or 8 bytes, which
+   * raw_element_hasher can hash as an unsigned integer, returns the size,
+   * and otherwise returns 0.
+   */
+  intptr_t get_raw_size() const
+  {
+    if (m_leaves.size() == 1 && m_leaves[0].kind == leaf_bytes &&
+        m_leaves[0].offset == 0) {
+      intptr_t size = m_leaves[0].size;
+      if (size == 1 || size == 2 || size == 4 || size == 8) {
+        return size;
+      }
+    }
+    return 0;
+  }
+
+  uint64_t hash(const char *data) const;
+
+  bool equal(const char *lhs, const char *rhs) const;
+};
+
+/**
+ * Hashes and compares elements that are a single POD value of the given
+ * unsigned integer size, such as integers, dates, datetimes and short
+ * fixed strings.
+ */
+template <typename UIntType>
+struct raw_element_hasher {
+  uint64_t hash(const char *data) const
+  {
+    UIntType value;
+    memcpy(&value, data, sizeof(UIntType));
+    return hash_mix(value);
+  }
+
+  bool equal(const char *lhs, const char *rhs) const
+  {
+    return memcmp(lhs, rhs, sizeof(UIntType)) == 0;
+  }
+};
+
+/**
+ * A hash table from element values to group ids, which number the
+ * distinct values in the order they were first inserted. The table holds
+ * pointers to the first element of each group, so the inserted data must
+ * outlive it. Open addressing with linear probing, kept at most half
+ * full, with each slot caching the hash of its group.
+ */
+template <typename Hasher>
+class element_hash_table {
+  Hasher m_hasher;
+  std::vector<intptr_t> m_slot_groups;
+  std::vector<uint64_t> m_slot_hashes;
+  std::vector<const char *> m_groups;
+  size_t m_mask;
+
+  void grow()
+  {
+    size_t capacity = m_slot_groups.size() * 2;
+    std::vector<intptr_t> groups(capacity, -1);
+    std::vector<uint64_t> hashes(capacity);
+    size_t mask = capacity - 1;
+    for (size_t s = 0; s < m_slot_groups.size(); ++s) {
+      if (m_slot_groups[s] >= 0) {
+        size_t i = m_slot_hashes[s] & mask;
+        while (groups[i] >= 0) {
+          i = (i + 1) & mask;
+        }
+        groups[i] = m_slot_groups[s];
+        hashes[i] = m_slot_hashes[s];
+      }
+    }
+    m_slot_groups.swap(groups);
+    m_slot_hashes.swap(hashes);
+    m_mask = mask;
+  }
+
+public:
+  /** ``size_hint`` is the expected number of distinct values */
+  element_hash_table(const Hasher &hasher, intptr_t size_hint = 0)
+      : m_hasher(hasher)
+  {
+    size_t capacity = 16;
+    while (capacity < 2 * static_cast<size_t>(size_hint)) {
+      capacity *= 2;
+    }
+    m_slot_groups.resize(capacity, -1);
+    m_slot_hashes.resize(capacity);
+    m_mask = capacity - 1;
+  }
+
+  /** The number of distinct values */
+  intptr_t size() const { return m_groups.size(); }
+
+  /** The first element inserted with the value of the group */
+  const char *get_group_data(intptr_t group) const { return m_groups[group]; }
+
+  /**
+   * Returns the group id of the element's value, starting a new group if
+   * the value hasn't been seen.
+   */
+  intptr_t insert(const char *data)
+  {
+    uint64_t h = m_hasher.hash(data);
+    size_t i = h & m_mask;
+    for (;;) {
+      intptr_t group = m_slot_groups[i];
+      if (group < 0) {
+        break;
+      } else if (m_slot_hashes[i] == h &&
+                 m_hasher.equal(m_groups[group], data)) {
+        return group;
+      }
+      i = (i + 1) & m_mask;
+    }
+    intptr_t group = m_groups.size();
+    m_groups.push_back(data);
+    m_slot_groups[i] = group;
+    m_slot_hashes[i] = h;
+    if (m_groups.size() * 2 > m_slot_groups.size()) {
+      grow();
+    }
+    return group;
+  }
+
+  /** Returns the group id of the element's value, or -1 if it's absent */
+  intptr_t find(const char *data) const
+  {
+    uint64_t h = m_hasher.hash(data);
+    size_t i = h & m_mask;
+    for (;;) {
+      intptr_t group = m_slot_groups[i];
+      if (group < 0) {
+        return -1;
+      } else if (m_slot_hashes[i] == h &&
+                 m_hasher.equal(m_groups[group], data)) {
+        return group;
+      }
+      i = (i + 1) & m_mask;
+    }
+  }
+};
+
+} // namespace dynd
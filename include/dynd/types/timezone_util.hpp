@@ -0,0 +1,100 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * The UTC offset history of a named time zone, as a table of transition
+ * instants. The table is loaded from the compiled tzdata (TZif) files of
+ * the system, and rules for times after the last listed transition are
+ * expanded into the table up to the year 2200.
+ *
+ * All times are in datetime ticks (100ns units since 1970-01-01).
+ */
+class timezone_transitions {
+  std::string m_name;
+  /** The UTC instants at which the offset changes, ascending */
+  std::vector<int64_t> m_utc_ticks;
+  /** The UTC offset in effect starting at the corresponding instant */
+  std::vector<int64_t> m_offsets;
+  /** The UTC offset before the first transition */
+  int64_t m_initial_offset;
+
+public:
+  timezone_transitions(const std::string &name,
+                       const std::vector<int64_t> &utc_ticks,
+                       const std::vector<int64_t> &offsets,
+                       int64_t initial_offset);
+
+  const std::string &name() const { return m_name; }
+
+  intptr_t get_transition_count() const { return m_utc_ticks.size(); }
+
+  /**
+   * Returns the UTC offset in effect at the UTC instant. ``inout_hint`` is
+   * the index of the table entry used in the previous call, and is updated,
+   * so runs of nearby times skip the binary search. Start it at 0.
+   */
+  int64_t utc_offset_at_utc(int64_t utc_ticks, intptr_t &inout_hint) const
+  {
+    intptr_t i = inout_hint;
+    intptr_t count = m_utc_ticks.size();
+    // Entry i covers [m_utc_ticks[i-1], m_utc_ticks[i])
+    if (i < 0 || i > count || (i > 0 && utc_ticks < m_utc_ticks[i - 1]) ||
+        (i < count && utc_ticks >= m_utc_ticks[i])) {
+      i = find_entry(utc_ticks);
+      inout_hint = i;
+    }
+    return i == 0 ? m_initial_offset : m_offsets[i - 1];
+  }
+
+  /** Converts a UTC instant to the wall clock time of the zone */
+  int64_t utc_to_local(int64_t utc_ticks, intptr_t &inout_hint) const
+  {
+    return utc_ticks + utc_offset_at_utc(utc_ticks, inout_hint);
+  }
+
+  /**
+   * Converts a wall clock time of the zone to a UTC instant. A time that
+   * occurs twice, when clocks go back, resolves to the earlier instant.
+   * A time skipped when clocks go forward is interpreted with the offset
+   * in effect before the change, e.g. 02:30 on a 02:00 -> 03:00 change
+   * becomes 03:30 local.
+   */
+  int64_t local_to_utc(int64_t local_ticks, intptr_t &inout_hint) const;
+
+private:
+  /** Binary searches for the number of transitions at or before the instant */
+  intptr_t find_entry(int64_t utc_ticks) const;
+};
+
+/**
+ * Returns the transition table of the named time zone, e.g.
+ * "America/New_York" or "UTC". Each zone is read from the tzdata files
+ * once per process, and the table is cached and shared.
+ *
+ * The tzdata directory is taken from the TZDIR environment variable,
+ * defaulting to /usr/share/zoneinfo. Throws std::invalid_argument if
+ * the zone is unknown.
+ */
+std::shared_ptr<const timezone_transitions>
+get_timezone_transitions(const std::string &name);
+
+/**
+ * Parses the contents of a TZif file into a transition table. Throws
+ * std::invalid_argument if the data is not valid TZif data.
+ */
+std::shared_ptr<const timezone_transitions>
+parse_tzif_data(const std::string &name, const char *begin, const char *end);
+
+} // namespace dynd
@@ -3,6 +3,8 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <fstream>
+
 #include <dynd/array.hpp>
 #include <dynd/array_iter.hpp>
 #include <dynd/func/arrfunc.hpp>
@@ -1952,6 +1954,209 @@ nd::array nd::memmap(const std::string &filename, intptr_t begin, intptr_t end,
   return result;
 }
 
+namespace {
+/**
+ * The fixed part of the header of a file written by nd::save. It is
+ * followed by the shape and the strides as int64 values, then by the
+ * datashape of the array type, then by padding up to header_size.
+ */
+struct saved_array_header {
+  char magic[8];
+  uint32_t version;
+  /** 0x01020304 as written, to detect a foreign byte order */
+  uint32_t byteorder;
+  /** The offset of the data within the file */
+  uint64_t header_size;
+  uint64_t data_size;
+  uint32_t ndim;
+  uint32_t datashape_size;
+};
+
+const char saved_array_magic[8] = {'D', 'Y', 'N', 'D', 'A', 'R', 'R', '\0'};
+const uint32_t saved_array_version = 1;
+const uint32_t saved_array_byteorder = 0x01020304;
+
+/**
+ * Splits a type of fixed dimensions into its shape and its POD element
+ * type, throwing if the type isn't of that form. Element types with
+ * arrmeta, like structs, are rejected too, as their layout lives in the
+ * arrmeta rather than the type and isn't saved.
+ */
+ndt::type get_saveable_dtype(const ndt::type &tp, vector<intptr_t> &shape)
+{
+  ndt::type dtp = tp;
+  while (dtp.get_type_id() == fixed_dim_type_id) {
+    const ndt::fixed_dim_type *fdt = dtp.extended<ndt::fixed_dim_type>();
+    shape.push_back(fdt->get_fixed_dim_size());
+    dtp = fdt->get_element_type();
+  }
+  if (dtp.get_ndim() != 0 || !dtp.is_pod() || dtp.get_arrmeta_size() != 0) {
+    stringstream ss;
+    ss << "Cannot save a dynd array of type " << tp
+       << ", only fixed dimensions over a POD type without arrmeta are "
+          "supported";
+    throw type_error(ss.str());
+  }
+  return dtp;
+}
+} // anonymous namespace
+
+void nd::save(const std::string &filename, const nd::array &a)
+{
+  vector<intptr_t> shape;
+  ndt::type dtp = get_saveable_dtype(a.get_type(), shape);
+
+  // Data which isn't already in C order is copied to a new array which is
+  nd::array c = a;
+  if (!a.get_type().is_c_contiguous(a.get_arrmeta())) {
+    c = nd::empty(a.get_type());
+    c.vals() = a;
+  }
+
+  intptr_t ndim = shape.size();
+  vector<int64_t> shape_strides(2 * ndim);
+  int64_t stride = dtp.get_data_size();
+  for (intptr_t i = ndim - 1; i >= 0; --i) {
+    shape_strides[i] = shape[i];
+    shape_strides[ndim + i] = stride;
+    stride *= shape[i];
+  }
+  std::string ds;
+  {
+    stringstream ss;
+    ss << a.get_type();
+    ds = ss.str();
+  }
+
+  saved_array_header hdr;
+  memcpy(hdr.magic, saved_array_magic, sizeof(hdr.magic));
+  hdr.version = saved_array_version;
+  hdr.byteorder = saved_array_byteorder;
+  hdr.data_size = stride;
+  hdr.ndim = static_cast<uint32_t>(ndim);
+  hdr.datashape_size = static_cast<uint32_t>(ds.size());
+  size_t used = sizeof(hdr) + shape_strides.size() * sizeof(int64_t) +
+                ds.size();
+  hdr.header_size = inc_to_alignment(used, saved_array_alignment);
+
+  ofstream fout(filename.c_str(), ios::binary | ios::trunc);
+  if (!fout) {
+    stringstream ss;
+    ss << "failed to open file \"" << filename << "\" for saving";
+    throw runtime_error(ss.str());
+  }
+  fout.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+  fout.write(reinterpret_cast<const char *>(shape_strides.data()),
+             shape_strides.size() * sizeof(int64_t));
+  fout.write(ds.data(), ds.size());
+  std::string padding(hdr.header_size - used, '\0');
+  fout.write(padding.data(), padding.size());
+  fout.write(c.get_readonly_originptr(), hdr.data_size);
+  if (!fout) {
+    stringstream ss;
+    ss << "failed to write file \"" << filename << "\"";
+    throw runtime_error(ss.str());
+  }
+}
+
+nd::array nd::load_mmap(const std::string &filename, uint32_t access)
+{
+  if (access == 0) {
+    access = nd::default_access_flags;
+  }
+
+  char *mm_ptr = NULL;
+  intptr_t mm_size = 0;
+  memory_block_ptr mm =
+      make_memmap_memory_block(filename, access, &mm_ptr, &mm_size);
+
+  saved_array_header hdr;
+  if (mm_size < (intptr_t)sizeof(hdr)) {
+    stringstream ss;
+    ss << "file \"" << filename << "\" is too small to be a saved dynd array";
+    throw runtime_error(ss.str());
+  }
+  memcpy(&hdr, mm_ptr, sizeof(hdr));
+  if (memcmp(hdr.magic, saved_array_magic, sizeof(hdr.magic)) != 0) {
+    stringstream ss;
+    ss << "file \"" << filename << "\" is not a saved dynd array";
+    throw runtime_error(ss.str());
+  }
+  if (hdr.version != saved_array_version) {
+    stringstream ss;
+    ss << "saved dynd array \"" << filename << "\" has unsupported version "
+       << hdr.version;
+    throw runtime_error(ss.str());
+  }
+  if (hdr.byteorder != saved_array_byteorder) {
+    stringstream ss;
+    ss << "saved dynd array \"" << filename
+       << "\" was written with a different byte order";
+    throw runtime_error(ss.str());
+  }
+  size_t used = sizeof(hdr) + 2 * hdr.ndim * sizeof(int64_t) +
+                hdr.datashape_size;
+  if (hdr.header_size < used ||
+      hdr.header_size % saved_array_alignment != 0 ||
+      hdr.header_size > (uint64_t)mm_size ||
+      hdr.data_size > (uint64_t)mm_size - hdr.header_size) {
+    stringstream ss;
+    ss << "saved dynd array \"" << filename << "\" is truncated or corrupt";
+    throw runtime_error(ss.str());
+  }
+
+  const char *ds_begin = mm_ptr + sizeof(hdr) + 2 * hdr.ndim * sizeof(int64_t);
+  ndt::type tp(ds_begin, ds_begin + hdr.datashape_size);
+  vector<intptr_t> shape;
+  ndt::type dtp = get_saveable_dtype(tp, shape);
+  intptr_t ndim = shape.size();
+  vector<int64_t> shape_strides(2 * hdr.ndim);
+  memcpy(shape_strides.data(), mm_ptr + sizeof(hdr),
+         shape_strides.size() * sizeof(int64_t));
+  if (ndim != (intptr_t)hdr.ndim) {
+    stringstream ss;
+    ss << "saved dynd array \"" << filename << "\" has type " << tp
+       << " which doesn't match its recorded shape";
+    throw runtime_error(ss.str());
+  }
+  // Validate the strides against the mapped data, so a corrupt header
+  // can't produce a view outside the mapping. The strides are
+  // non-negative, so no element lies before the data, and the extent is
+  // accumulated with checks against overflow.
+  uint64_t data_avail = (uint64_t)mm_size - hdr.header_size;
+  uint64_t extent = dtp.get_data_size();
+  bool empty = false;
+  vector<intptr_t> strides(ndim);
+  for (intptr_t i = 0; i < ndim; ++i) {
+    if (shape_strides[i] != shape[i] || shape_strides[ndim + i] < 0) {
+      stringstream ss;
+      ss << "saved dynd array \"" << filename << "\" has type " << tp
+         << " which doesn't match its recorded shape";
+      throw runtime_error(ss.str());
+    }
+    strides[i] = static_cast<intptr_t>(shape_strides[ndim + i]);
+    if (shape[i] == 0) {
+      empty = true;
+    } else if (extent <= data_avail) {
+      uint64_t step = static_cast<uint64_t>(shape_strides[ndim + i]);
+      uint64_t count = static_cast<uint64_t>(shape[i] - 1);
+      if (step != 0 && count > (data_avail - extent) / step) {
+        extent = data_avail + 1;
+      } else {
+        extent += count * step;
+      }
+    }
+  }
+  if (!empty && extent > data_avail) {
+    stringstream ss;
+    ss << "saved dynd array \"" << filename << "\" is truncated or corrupt";
+    throw runtime_error(ss.str());
+  }
+
+  return make_strided_array_from_data(dtp, ndim, shape.data(), strides.data(),
+                                      access, mm_ptr + hdr.header_size, mm);
+}
+
 intptr_t nd::binary_search(const nd::array &n, const char *arrmeta,
                            const char *data)
 {
@@ -2285,6 +2490,17 @@ void nd::forward_as_array(const ndt::type &tp, char *arrmeta, char *data,
 
   if (tp.is_builtin() || tp.get_type_id() == arrfunc_type_id) {
     memcpy(data, val.get_readonly_originptr(), tp.get_data_size());
+  } else if (tp.get_type_id() != pointer_type_id && tp.get_ndim() == 0) {
+    // A scalar value like a string is copied in, referencing the same data
+    if (tp.get_arrmeta_size() > 0) {
+      tp.extended()->arrmeta_copy_construct(arrmeta, val.get_arrmeta(),
+                                            val.get_memblock().get());
+    }
+    memcpy(data, val.get_readonly_originptr(), tp.get_data_size());
+  } else if (tp.get_type_id() != pointer_type_id) {
+    // An array value may be strided, so it is copied into the default layout
+    tp.extended()->arrmeta_default_construct(arrmeta, true);
+    typed_data_assign(tp, arrmeta, data, val);
   } else {
     pointer_type_arrmeta *am =
         reinterpret_cast<pointer_type_arrmeta *>(arrmeta);
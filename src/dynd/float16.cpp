@@ -8,9 +8,21 @@
 #include <dynd/int128.hpp>
 #include <dynd/uint128.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) &&        \
+    !defined(__CUDACC__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define DYND_FLOAT16_F16C 1
+#else
+#define DYND_FLOAT16_F16C 0
+#endif
+
 using namespace std;
 using namespace dynd;
 
@@ -354,3 +366,176 @@ dynd::float16::operator float128() const
 {
     return float128(double(*this));
 }
+
+namespace {
+
+/**
+ * The tables for converting float16 to float32 with lookups and an add,
+ * from "Fast Half Float Conversions" by Jeroen van der Zijp.
+ */
+struct halfbits_to_float_tables {
+  uint32_t mantissa[2048];
+  uint32_t exponent[64];
+  uint16_t offset[64];
+
+  halfbits_to_float_tables()
+  {
+    mantissa[0] = 0;
+    for (uint32_t i = 1; i < 1024; ++i) {
+      // Normalize the subnormal significand
+      uint32_t m = i << 13, e = 0;
+      while ((m & 0x00800000u) == 0) {
+        e -= 0x00800000u;
+        m <<= 1;
+      }
+      m &= ~0x00800000u;
+      e += 0x38800000u;
+      mantissa[i] = m | e;
+    }
+    for (uint32_t i = 1024; i < 2048; ++i) {
+      mantissa[i] = 0x38000000u + ((i - 1024) << 13);
+    }
+    exponent[0] = 0;
+    exponent[32] = 0x80000000u;
+    for (uint32_t i = 1; i < 31; ++i) {
+      exponent[i] = i << 23;
+      exponent[i + 32] = 0x80000000u + (i << 23);
+    }
+    exponent[31] = 0x47800000u;
+    exponent[63] = 0xc7800000u;
+    for (int i = 0; i < 64; ++i) {
+      offset[i] = 1024;
+    }
+    offset[0] = 0;
+    offset[32] = 0;
+  }
+
+  float convert(uint16_t h) const
+  {
+    uint32_t bits = mantissa[offset[h >> 10] + (h & 0x3ffu)] + exponent[h >> 10];
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+  }
+};
+
+const halfbits_to_float_tables &get_halfbits_to_float_tables()
+{
+  static const halfbits_to_float_tables tables;
+  return tables;
+}
+
+#if DYND_FLOAT16_F16C
+bool cpu_has_f16c()
+{
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return false;
+  }
+  // F16C is bit 29, AVX bit 28 and OSXSAVE bit 27
+  const unsigned int needed = (1u << 29) | (1u << 28) | (1u << 27);
+  if ((ecx & needed) != needed) {
+    return false;
+  }
+  // The OS must save the ymm registers
+  unsigned int xcr0_lo, xcr0_hi;
+  __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  return (xcr0_lo & 6u) == 6u;
+}
+
+__attribute__((target("avx,f16c"))) void
+halfbits_to_float_n_f16c(float *dst, const uint16_t *src, size_t count)
+{
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+  }
+  if (i < count) {
+    uint16_t h[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    float f[8];
+    memcpy(h, src + i, (count - i) * sizeof(uint16_t));
+    _mm256_storeu_ps(
+        f, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<__m128i *>(h))));
+    memcpy(dst + i, f, (count - i) * sizeof(float));
+  }
+}
+
+__attribute__((target("avx,f16c"))) void
+float_to_halfbits_n_f16c(uint16_t *dst, const float *src, size_t count)
+{
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i),
+                                _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), h);
+  }
+  if (i < count) {
+    float f[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    uint16_t h[8];
+    memcpy(f, src + i, (count - i) * sizeof(float));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(h),
+        _mm256_cvtps_ph(_mm256_loadu_ps(f), _MM_FROUND_TO_NEAREST_INT));
+    memcpy(dst + i, h, (count - i) * sizeof(uint16_t));
+  }
+}
+#else
+bool cpu_has_f16c() { return false; }
+#endif
+
+std::atomic<bool> &get_use_f16c()
+{
+  static std::atomic<bool> use_f16c(cpu_has_f16c());
+  return use_f16c;
+}
+
+} // anonymous namespace
+
+bool dynd::float16_f16c_enabled() { return get_use_f16c().load(); }
+
+void dynd::set_float16_f16c_enabled(bool enabled)
+{
+  get_use_f16c().store(enabled && cpu_has_f16c());
+}
+
+void dynd::halfbits_to_float_n(float *dst, const uint16_t *src, size_t count)
+{
+#if DYND_FLOAT16_F16C
+  if (get_use_f16c().load(std::memory_order_relaxed)) {
+    halfbits_to_float_n_f16c(dst, src, count);
+    return;
+  }
+#endif
+  const halfbits_to_float_tables &tables = get_halfbits_to_float_tables();
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = tables.convert(src[i]);
+  }
+}
+
+void dynd::halfbits_to_double_n(double *dst, const uint16_t *src,
+                                size_t count)
+{
+  // Every float16 value is exact as a float32, so widening that is exact
+  float tmp[256];
+  for (size_t i = 0; i < count; i += 256) {
+    size_t n = std::min<size_t>(256, count - i);
+    halfbits_to_float_n(tmp, src + i, n);
+    for (size_t j = 0; j < n; ++j) {
+      dst[i + j] = tmp[j];
+    }
+  }
+}
+
+void dynd::float_to_halfbits_n(uint16_t *dst, const float *src, size_t count)
+{
+#if DYND_FLOAT16_F16C
+  if (get_use_f16c().load(std::memory_order_relaxed)) {
+    float_to_halfbits_n_f16c(dst, src, count);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = float_to_halfbits(src[i], assign_error_nocheck);
+  }
+}
@@ -3,6 +3,12 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <mutex>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
 #include <dynd/func/arrfunc.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/ckernel_common_functions.hpp>
@@ -229,4 +235,47 @@ nd::arrfunc::arrfunc(const nd::array &rhs)
       throw type_error(ss.str());
     }
   }
-}
\ No newline at end of file
+}
+
+namespace {
+struct declfunc_make_times {
+  std::mutex mutex;
+  vector<nd::declfunc_make_time> times;
+};
+
+declfunc_make_times &get_declfunc_make_times_storage()
+{
+  // Never destroyed, so declfuncs may be made during static destruction
+  static declfunc_make_times *storage = new declfunc_make_times;
+  return *storage;
+}
+} // anonymous namespace
+
+void nd::detail::record_declfunc_make_time(const char *name, double seconds)
+{
+  declfunc_make_time t;
+#if defined(__GNUC__)
+  int status;
+  char *demangled = abi::__cxa_demangle(name, NULL, NULL, &status);
+  if (demangled != NULL) {
+    t.name = demangled;
+    free(demangled);
+  } else {
+    t.name = name;
+  }
+#else
+  t.name = name;
+#endif
+  t.seconds = seconds;
+
+  declfunc_make_times &storage = get_declfunc_make_times_storage();
+  lock_guard<mutex> lock(storage.mutex);
+  storage.times.push_back(t);
+}
+
+vector<nd::declfunc_make_time> nd::get_declfunc_make_times()
+{
+  declfunc_make_times &storage = get_declfunc_make_times_storage();
+  lock_guard<mutex> lock(storage.mutex);
+  return storage.times;
+}
@@ -3,7 +3,11 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <cmath>
 
 #include <dynd/func/arrfunc_registry.hpp>
@@ -154,104 +158,257 @@ struct logaddexp2 {
 #endif
 } // anonymous namespace
 
-std::map<nd::string, nd::arrfunc> &func::get_regfunctions()
+// Inside namespace dynd, so complex<T> is dynd::complex<T>
+namespace dynd {
+namespace {
+/** A registered arrfunc, which is constructed on its first lookup */
+class regfunction_entry {
+  std::function<nd::arrfunc()> m_make;
+  std::once_flag m_once;
+  nd::arrfunc m_af;
+
+public:
+  explicit regfunction_entry(const std::function<nd::arrfunc()> &make)
+      : m_make(make)
+  {
+  }
+
+  const nd::arrfunc &get()
+  {
+    // If make throws, the next lookup tries again
+    std::call_once(m_once, [this] { m_af = m_make(); });
+    return m_af;
+  }
+};
+
+typedef map<nd::string, shared_ptr<regfunction_entry>> registry_map;
+
+/**
+ * The registry is an immutable map, which registrations replace with an
+ * updated copy. Lookups never wait for a registration, they only count
+ * themselves in as readers of the current epoch while they copy an entry
+ * out of the map. A registration publishes its map, moves new lookups to
+ * the next epoch, and frees the replaced map once the lookups counted in
+ * the previous epoch have finished.
+ */
+class arrfunc_registry {
+  std::atomic<const registry_map *> m_map;
+  std::atomic<unsigned> m_epoch;
+  // The number of lookups in progress, by the parity of their epoch
+  std::atomic<intptr_t> m_readers[2];
+  // Serializes registrations, so none of them is lost
+  std::mutex m_write_mutex;
+
+  static void add_entry(registry_map &map, const char *name,
+                        const std::function<nd::arrfunc()> &make)
+  {
+    map[name] = make_shared<regfunction_entry>(make);
+  }
+
+  /** Counts a lookup in for as long as it reads the current map */
+  class read_guard {
+    std::atomic<intptr_t> *m_readers;
+
+  public:
+    explicit read_guard(arrfunc_registry &registry)
+    {
+      for (;;) {
+        unsigned epoch = registry.m_epoch.load();
+        m_readers = &registry.m_readers[epoch & 1];
+        ++*m_readers;
+        // If a registration moved to the next epoch meanwhile, it may not
+        // wait for this lookup, so count it in again
+        if (registry.m_epoch.load() == epoch) {
+          break;
+        }
+        --*m_readers;
+      }
+    }
+
+    ~read_guard() { --*m_readers; }
+  };
+
+public:
+  arrfunc_registry();
+
+  /** Returns the entry for ``name``, or NULL if it isn't registered */
+  shared_ptr<regfunction_entry> find(const nd::string &name)
+  {
+    read_guard guard(*this);
+    const registry_map &map = *m_map.load();
+    registry_map::const_iterator it = map.find(name);
+    return it != map.end() ? it->second : shared_ptr<regfunction_entry>();
+  }
+
+  registry_map get_map()
+  {
+    read_guard guard(*this);
+    return *m_map.load();
+  }
+
+  void set(const nd::string &name, const std::function<nd::arrfunc()> &make)
+  {
+    lock_guard<std::mutex> lock(m_write_mutex);
+    const registry_map *old_map = m_map.load();
+    unique_ptr<registry_map> map(new registry_map(*old_map));
+    (*map)[name] = make_shared<regfunction_entry>(make);
+    m_map.store(map.release());
+
+    // Lookups of the previous epoch may still be reading the old map, while
+    // later ones can only see the new one. Lookups are short, and new ones
+    // don't add to the count being waited on.
+    unsigned epoch = m_epoch.load();
+    m_epoch.store(epoch + 1);
+    while (m_readers[epoch & 1].load() != 0) {
+      std::this_thread::yield();
+    }
+    delete old_map;
+  }
+};
+
+arrfunc_registry::arrfunc_registry() : m_epoch(0)
 {
-  // Probably want to use a concurrent_hash_map, like
-  // http://www.threadingbuildingblocks.org/docs/help/reference/containers_overview/concurrent_hash_map_cls.htm
-  static map<nd::string, nd::arrfunc> registry;
-  if (registry.empty()) {
-    // Arithmetic
-    /*
-      func::set_regfunction(
-          "add", make_ufunc(add<int32_t>(), add<int64_t>(), add<int128>(),
-                            add<uint32_t>(), add<uint64_t>(),
-      add<dynd_uint128>(),
-                            add<float>(), add<double>(), add<complex<float>>(),
-                            add<complex<double>>()));
-    */
-    registry["add"] = nd::add;
-    registry["subtract"] =
-        make_ufunc(subtract<int32_t>(), subtract<int64_t>(), subtract<int128>(),
-                   subtract<float>(), subtract<double>(),
-                   subtract<complex<float>>(), subtract<complex<double>>());
-    registry["multiply"] =
-        make_ufunc(multiply<int32_t>(), multiply<int64_t>(),
-                   /*multiply<int128>(),*/ multiply<uint32_t>(),
-                   multiply<uint64_t>(), /*multiply<dynd_uint128>(),*/
-                   multiply<float>(), multiply<double>(),
-                   multiply<complex<float>>(), multiply<complex<double>>());
-    registry["divide"] = make_ufunc(
+  m_readers[0] = 0;
+  m_readers[1] = 0;
+  unique_ptr<registry_map> map(new registry_map);
+
+  // Arithmetic
+  /*
+    func::set_regfunction(
+        "add", make_ufunc(add<int32_t>(), add<int64_t>(), add<int128>(),
+                          add<uint32_t>(), add<uint64_t>(),
+    add<dynd_uint128>(),
+                          add<float>(), add<double>(), add<complex<float>>(),
+                          add<complex<double>>()));
+  */
+  add_entry(*map, "add", [] { return nd::arrfunc(nd::add); });
+  add_entry(*map, "subtract", [] {
+    return make_ufunc(subtract<int32_t>(), subtract<int64_t>(),
+                      subtract<int128>(), subtract<float>(), subtract<double>(),
+                      subtract<complex<float>>(), subtract<complex<double>>());
+  });
+  add_entry(*map, "multiply", [] {
+    return make_ufunc(multiply<int32_t>(), multiply<int64_t>(),
+                      /*multiply<int128>(),*/ multiply<uint32_t>(),
+                      multiply<uint64_t>(), /*multiply<dynd_uint128>(),*/
+                      multiply<float>(), multiply<double>(),
+                      multiply<complex<float>>(), multiply<complex<double>>());
+  });
+  add_entry(*map, "divide", [] {
+    return make_ufunc(
         divide<int32_t>(), divide<int64_t>(),   /*divide<int128>(),*/
         divide<uint32_t>(), divide<uint64_t>(), /*divide<dynd_uint128>(),*/
         divide<float>(), divide<double>(), divide<complex<float>>(),
         divide<complex<double>>());
-    registry["negative"] =
-        make_ufunc(negative<int32_t>(), negative<int64_t>(), negative<int128>(),
-                   negative<float>(), negative<double>(),
-                   negative<complex<float>>(), negative<complex<double>>());
-    registry["sign"] =
-        make_ufunc(sign<int32_t>(), sign<int64_t>(), sign<int128>(),
-                   sign<float>(), sign<double>());
-    registry["conj"] = make_ufunc(conj_fn<std::complex<float>>(),
-                                  conj_fn<std::complex<double>>());
+  });
+  add_entry(*map, "negative", [] {
+    return make_ufunc(negative<int32_t>(), negative<int64_t>(),
+                      negative<int128>(), negative<float>(), negative<double>(),
+                      negative<complex<float>>(), negative<complex<double>>());
+  });
+  add_entry(*map, "sign", [] {
+    return make_ufunc(sign<int32_t>(), sign<int64_t>(), sign<int128>(),
+                      sign<float>(), sign<double>());
+  });
+  add_entry(*map, "conj", [] {
+    return make_ufunc(conj_fn<std::complex<float>>(),
+                      conj_fn<std::complex<double>>());
+  });
 
 #if !(defined(_MSC_VER) && _MSC_VER < 1700)
-    registry["logaddexp"] = make_ufunc(logaddexp<float>(), logaddexp<double>());
-    registry["logaddexp2"] =
-        make_ufunc(logaddexp2<float>(), logaddexp2<double>());
+  add_entry(*map, "logaddexp",
+      [] { return make_ufunc(logaddexp<float>(), logaddexp<double>()); });
+  add_entry(*map, "logaddexp2",
+      [] { return make_ufunc(logaddexp2<float>(), logaddexp2<double>()); });
 #endif
 
-    // Trig functions
-    registry["sin"] =
-        make_ufunc(&::sinf, static_cast<double (*)(double)>(&::sin));
-    registry["cos"] =
-        make_ufunc(&::cosf, static_cast<double (*)(double)>(&::cos));
-    registry["tan"] =
-        make_ufunc(&::tanf, static_cast<double (*)(double)>(&::tan));
-    registry["exp"] =
-        make_ufunc(&::expf, static_cast<double (*)(double)>(&::exp));
-    registry["arcsin"] =
-        make_ufunc(&::asinf, static_cast<double (*)(double)>(&::asin));
-    registry["arccos"] =
-        make_ufunc(&::acosf, static_cast<double (*)(double)>(&::acos));
-    registry["arctan"] =
-        make_ufunc(&::atanf, static_cast<double (*)(double)>(&::atan));
-    registry["arctan2"] = make_ufunc(
-        &::atan2f, static_cast<double (*)(double, double)>(&::atan2));
-    registry["hypot"] = make_ufunc(
-        &::hypotf, static_cast<double (*)(double, double)>(&::hypot));
-    registry["sinh"] =
-        make_ufunc(&::sinhf, static_cast<double (*)(double)>(&::sinh));
-    registry["cosh"] =
-        make_ufunc(&::coshf, static_cast<double (*)(double)>(&::cosh));
-    registry["tanh"] =
-        make_ufunc(&::tanhf, static_cast<double (*)(double)>(&::tanh));
+  // Trig functions
+  add_entry(*map, "sin", [] {
+    return make_ufunc(&::sinf, static_cast<double (*)(double)>(&::sin));
+  });
+  add_entry(*map, "cos", [] {
+    return make_ufunc(&::cosf, static_cast<double (*)(double)>(&::cos));
+  });
+  add_entry(*map, "tan", [] {
+    return make_ufunc(&::tanf, static_cast<double (*)(double)>(&::tan));
+  });
+  add_entry(*map, "exp", [] {
+    return make_ufunc(&::expf, static_cast<double (*)(double)>(&::exp));
+  });
+  add_entry(*map, "arcsin", [] {
+    return make_ufunc(&::asinf, static_cast<double (*)(double)>(&::asin));
+  });
+  add_entry(*map, "arccos", [] {
+    return make_ufunc(&::acosf, static_cast<double (*)(double)>(&::acos));
+  });
+  add_entry(*map, "arctan", [] {
+    return make_ufunc(&::atanf, static_cast<double (*)(double)>(&::atan));
+  });
+  add_entry(*map, "arctan2", [] {
+    return make_ufunc(&::atan2f,
+                      static_cast<double (*)(double, double)>(&::atan2));
+  });
+  add_entry(*map, "hypot", [] {
+    return make_ufunc(&::hypotf,
+                      static_cast<double (*)(double, double)>(&::hypot));
+  });
+  add_entry(*map, "sinh", [] {
+    return make_ufunc(&::sinhf, static_cast<double (*)(double)>(&::sinh));
+  });
+  add_entry(*map, "cosh", [] {
+    return make_ufunc(&::coshf, static_cast<double (*)(double)>(&::cosh));
+  });
+  add_entry(*map, "tanh", [] {
+    return make_ufunc(&::tanhf, static_cast<double (*)(double)>(&::tanh));
+  });
 #if !(defined(_MSC_VER) && _MSC_VER < 1700)
-    registry["asinh"] =
-        make_ufunc(&::asinhf, static_cast<double (*)(double)>(&::asinh));
-    registry["acosh"] =
-        make_ufunc(&::acoshf, static_cast<double (*)(double)>(&::acosh));
-    registry["atanh"] =
-        make_ufunc(&::atanhf, static_cast<double (*)(double)>(&::atanh));
+  add_entry(*map, "asinh", [] {
+    return make_ufunc(&::asinhf, static_cast<double (*)(double)>(&::asinh));
+  });
+  add_entry(*map, "acosh", [] {
+    return make_ufunc(&::acoshf, static_cast<double (*)(double)>(&::acosh));
+  });
+  add_entry(*map, "atanh", [] {
+    return make_ufunc(&::atanhf, static_cast<double (*)(double)>(&::atanh));
+  });
 #endif
 
-    registry["power"] =
-        make_ufunc(&powf, static_cast<double (*)(double, double)>(&::pow));
+  add_entry(*map, "power", [] {
+    return make_ufunc(&powf, static_cast<double (*)(double, double)>(&::pow));
+  });
 
-    registry["uniform"] = nd::random::uniform;
-    registry["take"] = nd::take;
-  }
+  add_entry(*map, "uniform", [] { return nd::arrfunc(nd::random::uniform); });
+  add_entry(*map, "take", [] { return nd::arrfunc(nd::take); });
+  add_entry(*map, "put", [] { return nd::arrfunc(nd::put); });
 
-  return registry;
+  m_map.store(map.release());
 }
 
-nd::arrfunc func::get_regfunction(const nd::string &name)
+arrfunc_registry &get_registry()
 {
-  const std::map<nd::string, nd::arrfunc> &registry = get_regfunctions();
+  // Never destroyed, so lookups remain valid during static destruction
+  static arrfunc_registry *registry = new arrfunc_registry;
+  return *registry;
+}
+} // anonymous namespace
+} // namespace dynd
 
-  map<nd::string, nd::arrfunc>::const_iterator it = registry.find(name);
-  if (it != registry.end()) {
-    return it->second;
+std::map<nd::string, nd::arrfunc> func::get_regfunctions()
+{
+  registry_map map = get_registry().get_map();
+  std::map<nd::string, nd::arrfunc> result;
+  for (registry_map::const_iterator it = map.begin(); it != map.end(); ++it) {
+    result[it->first] = it->second->get();
+  }
+  return result;
+}
+
+nd::arrfunc func::get_regfunction(const nd::string &name)
+{
+  // The entry is constructed outside of the lookup, as that may take a while
+  shared_ptr<regfunction_entry> entry = get_registry().find(name);
+  if (entry) {
+    return entry->get();
   } else {
     stringstream ss;
     ss << "No dynd function ";
@@ -263,7 +420,11 @@ nd::arrfunc func::get_regfunction(const nd::string &name)
 
 void func::set_regfunction(const nd::string &name, const nd::arrfunc &af)
 {
-  std::map<nd::string, nd::arrfunc> &registry = get_regfunctions();
+  get_registry().set(name, [af] { return af; });
+}
 
-  registry[name] = af;
+void func::set_lazy_regfunction(const nd::string &name,
+                                const std::function<nd::arrfunc()> &make)
+{
+  get_registry().set(name, make);
 }
@@ -4,6 +4,7 @@
 //
 
 #include <dynd/func/fft.hpp>
+#include <dynd/kernels/builtin_fft.hpp>
 #include <dynd/func/multidispatch.hpp>
 #include <dynd/func/take.hpp>
 
@@ -17,6 +18,9 @@ nd::arrfunc nd::fft::make()
 #ifdef DYND_FFTW
   typedef fftw_ck<fftw_complex, fftw_complex, FFTW_FORWARD> CKT;
   children.push_back(nd::arrfunc::make<CKT>(0));
+#else
+  children.push_back(nd::arrfunc::make<
+      builtin_fft_ck<complex<double>, complex<double>, -1>>(0));
 #endif
 
 #ifdef DYND_CUDA
@@ -24,10 +28,6 @@ nd::arrfunc nd::fft::make()
       cufft_ck<cufftDoubleComplex, cufftDoubleComplex, CUFFT_FORWARD>>(0));
 #endif
 
-  if (children.empty()) {
-    throw std::runtime_error("no fft enabled");
-  }
-
   return children[0];
 /*
   return functional::multidispatch(
@@ -45,6 +45,9 @@ nd::arrfunc nd::ifft::make()
 #ifdef DYND_FFTW
   children.push_back(
       nd::arrfunc::make<fftw_ck<fftw_complex, fftw_complex, FFTW_BACKWARD>>(0));
+#else
+  children.push_back(nd::arrfunc::make<
+      builtin_fft_ck<complex<double>, complex<double>, 1>>(0));
 #endif
 
 #ifdef DYND_CUDA
@@ -52,10 +55,6 @@ nd::arrfunc nd::ifft::make()
       cufft_ck<cufftDoubleComplex, cufftDoubleComplex, CUFFT_INVERSE>>(0));
 #endif
 
-  if (children.empty()) {
-    throw std::runtime_error("no fft enabled");
-  }
-
   return children[0];
 /*
   return functional::multidispatch(
@@ -71,7 +70,7 @@ nd::arrfunc nd::rfft::make()
 #ifdef DYND_FFTW
   return nd::arrfunc::make<fftw_ck<fftw_complex, double>>(0);
 #else
-  throw std::runtime_error("no fft enabled");
+  return nd::arrfunc::make<builtin_fft_ck<complex<double>, double>>(0);
 #endif
 }
 
@@ -80,7 +79,7 @@ nd::arrfunc nd::irfft::make()
 #ifdef DYND_FFTW
   return nd::arrfunc::make<fftw_ck<double, fftw_complex>>(0);
 #else
-  throw std::runtime_error("no fft enabled");
+  return nd::arrfunc::make<builtin_fft_ck<double, complex<double>>>(0);
 #endif
 }
 
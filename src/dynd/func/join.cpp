@@ -0,0 +1,579 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <dynd/func/join.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/base_virtual_kernel.hpp>
+#include <dynd/kernels/comparison_kernels.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/hash_util.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/** One side of the join, a fixed or var dim of structs */
+struct join_input {
+  bool m_var;
+  // The size and stride of a fixed dim, or the arrmeta of a var dim
+  intptr_t m_size, m_stride;
+  const char *m_arrmeta;
+  // Data offset of the key field within the struct
+  intptr_t m_key_offset;
+
+  /** Returns the first row, setting ``size`` to the row count */
+  const char *get_rows(const char *data, intptr_t &size) const
+  {
+    if (m_var) {
+      const var_dim_type_arrmeta *md =
+          reinterpret_cast<const var_dim_type_arrmeta *>(m_arrmeta);
+      const var_dim_type_data *d =
+          reinterpret_cast<const var_dim_type_data *>(data);
+      size = d->size;
+      return d->begin + md->offset;
+    } else {
+      size = m_size;
+      return data;
+    }
+  }
+
+  intptr_t get_stride() const
+  {
+    return m_var ? reinterpret_cast<const var_dim_type_arrmeta *>(m_arrmeta)
+                       ->stride
+                 : m_stride;
+  }
+};
+
+/**
+ * Puts the keys of the ``build`` rows in a hash table, chaining rows with
+ * equal keys in order, and emits a (build, probe) pair for each match of a
+ * ``probe`` row. Unmatched probe rows are emitted with -1 if
+ * ``keep_unmatched`` is true.
+ */
+template <typename Hasher>
+void hash_join(const Hasher &hasher, const char *build, intptr_t build_size,
+               intptr_t build_stride, const char *probe, intptr_t probe_size,
+               intptr_t probe_stride, bool keep_unmatched,
+               vector<intptr_t> &build_idx, vector<intptr_t> &probe_idx)
+{
+  element_hash_table<Hasher> table(hasher, build_size);
+  vector<intptr_t> head, tail, next(build_size, -1);
+  for (intptr_t i = 0; i < build_size; ++i, build += build_stride) {
+    intptr_t group = table.insert(build);
+    if (group == static_cast<intptr_t>(head.size())) {
+      head.push_back(i);
+      tail.push_back(i);
+    } else {
+      next[tail[group]] = i;
+      tail[group] = i;
+    }
+  }
+
+  for (intptr_t i = 0; i < probe_size; ++i, probe += probe_stride) {
+    intptr_t group = table.find(probe);
+    if (group >= 0) {
+      for (intptr_t j = head[group]; j >= 0; j = next[j]) {
+        build_idx.push_back(j);
+        probe_idx.push_back(i);
+      }
+    } else if (keep_unmatched) {
+      build_idx.push_back(-1);
+      probe_idx.push_back(i);
+    }
+  }
+}
+
+struct join_ck : nd::base_kernel<join_ck, kernel_request_host, 2> {
+  typedef join_ck self_type;
+
+  struct output_field {
+    // 0 for a field of the left struct, 1 for the right
+    int m_side;
+    intptr_t m_src_offset, m_dst_offset;
+    // Offsets of the child copy kernel, and of the child which assigns NA
+    // for unmatched left rows in a left join
+    intptr_t m_copy_offset, m_na_offset;
+  };
+
+  bool m_left_join, m_sorted;
+  join_input m_inputs[2];
+  unique_ptr<element_hasher> m_hasher;
+  intptr_t m_less_lr_offset, m_less_rl_offset;
+  ndt::type m_dst_tp;
+  const char *m_dst_arrmeta;
+  vector<output_field> m_fields;
+  vector<intptr_t> m_left_idx, m_right_idx;
+
+  join_ck(bool left_join, bool sorted)
+      : m_left_join(left_join), m_sorted(sorted), m_less_lr_offset(0),
+        m_less_rl_offset(0), m_dst_arrmeta(NULL)
+  {
+  }
+
+  bool less(intptr_t child_offset, const char *lhs, const char *rhs)
+  {
+    ckernel_prefix *child = this->get_child_ckernel(child_offset);
+    int dst;
+    char *src[2] = {const_cast<char *>(lhs), const_cast<char *>(rhs)};
+    child->get_function<expr_single_t>()(reinterpret_cast<char *>(&dst), src,
+                                         child);
+    return dst != 0;
+  }
+
+  /** Joins rows already sorted by key, emitting pairs in left row order */
+  void merge_join(const char *left, intptr_t left_size, intptr_t left_stride,
+                  const char *right, intptr_t right_size,
+                  intptr_t right_stride)
+  {
+    intptr_t left_key = m_inputs[0].m_key_offset,
+             right_key = m_inputs[1].m_key_offset;
+    intptr_t i = 0, j = 0;
+    while (i < left_size) {
+      const char *l = left + i * left_stride + left_key;
+      if (j == right_size ||
+          less(m_less_lr_offset, l, right + j * right_stride + right_key)) {
+        if (m_left_join) {
+          m_left_idx.push_back(i);
+          m_right_idx.push_back(-1);
+        }
+        ++i;
+      } else if (less(m_less_rl_offset, right + j * right_stride + right_key,
+                      l)) {
+        ++j;
+      } else {
+        // The run of right rows with this key
+        const char *r = right + j * right_stride + right_key;
+        intptr_t j_end = j + 1;
+        while (j_end < right_size &&
+               !less(m_less_lr_offset, l,
+                     right + j_end * right_stride + right_key)) {
+          ++j_end;
+        }
+        // Every left row with the key pairs with the whole run
+        do {
+          for (intptr_t k = j; k < j_end; ++k) {
+            m_left_idx.push_back(i);
+            m_right_idx.push_back(k);
+          }
+          ++i;
+        } while (i < left_size &&
+                 !less(m_less_rl_offset, r,
+                       left + i * left_stride + left_key));
+        j = j_end;
+      }
+    }
+  }
+
+  template <typename Hasher>
+  void hash_join(const Hasher &hasher, const char *left, intptr_t left_size,
+                 intptr_t left_stride, const char *right, intptr_t right_size,
+                 intptr_t right_stride)
+  {
+    const char *left_keys = left + m_inputs[0].m_key_offset,
+               *right_keys = right + m_inputs[1].m_key_offset;
+    if (right_size <= left_size) {
+      // Probing with the left rows keeps them in order
+      ::hash_join(hasher, right_keys, right_size, right_stride, left_keys,
+                  left_size, left_stride, m_left_join, m_right_idx,
+                  m_left_idx);
+      return;
+    }
+
+    vector<intptr_t> left_idx, right_idx;
+    ::hash_join(hasher, left_keys, left_size, left_stride, right_keys,
+                right_size, right_stride, false, left_idx, right_idx);
+    // Counting sort the pairs by left row, which keeps the right rows of
+    // each in order, making room for the unmatched rows of a left join
+    vector<intptr_t> starts(left_size + 1, 0);
+    for (size_t k = 0; k < left_idx.size(); ++k) {
+      ++starts[left_idx[k] + 1];
+    }
+    if (m_left_join) {
+      for (intptr_t i = 0; i < left_size; ++i) {
+        if (starts[i + 1] == 0) {
+          starts[i + 1] = 1;
+        }
+      }
+    }
+    for (intptr_t i = 0; i < left_size; ++i) {
+      starts[i + 1] += starts[i];
+    }
+    m_left_idx.resize(starts[left_size]);
+    m_right_idx.assign(starts[left_size], -1);
+    if (m_left_join) {
+      // Every row has a slot, which unmatched rows keep with -1
+      for (intptr_t i = 0; i < left_size; ++i) {
+        m_left_idx[starts[i]] = i;
+      }
+    }
+    for (size_t k = 0; k < left_idx.size(); ++k) {
+      intptr_t pos = starts[left_idx[k]]++;
+      m_left_idx[pos] = left_idx[k];
+      m_right_idx[pos] = right_idx[k];
+    }
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    intptr_t left_size, right_size;
+    const char *left = m_inputs[0].get_rows(src[0], left_size);
+    const char *right = m_inputs[1].get_rows(src[1], right_size);
+    intptr_t left_stride = m_inputs[0].get_stride(),
+             right_stride = m_inputs[1].get_stride();
+
+    m_left_idx.clear();
+    m_right_idx.clear();
+    if (m_sorted) {
+      merge_join(left, left_size, left_stride, right, right_size,
+                 right_stride);
+    } else {
+      switch (m_hasher->get_raw_size()) {
+      case 1:
+        hash_join(raw_element_hasher<uint8_t>(), left, left_size, left_stride,
+                  right, right_size, right_stride);
+        break;
+      case 2:
+        hash_join(raw_element_hasher<uint16_t>(), left, left_size, left_stride,
+                  right, right_size, right_stride);
+        break;
+      case 4:
+        hash_join(raw_element_hasher<uint32_t>(), left, left_size, left_stride,
+                  right, right_size, right_stride);
+        break;
+      case 8:
+        hash_join(raw_element_hasher<uint64_t>(), left, left_size, left_stride,
+                  right, right_size, right_stride);
+        break;
+      default:
+        hash_join(*m_hasher, left, left_size, left_stride, right, right_size,
+                  right_stride);
+        break;
+      }
+    }
+
+    // Gather the fields of each pair of rows
+    intptr_t count = m_left_idx.size();
+    ndt::var_dim_element_initialize(m_dst_tp, m_dst_arrmeta, dst, count);
+    char *dst_row = reinterpret_cast<var_dim_type_data *>(dst)->begin;
+    intptr_t dst_stride =
+        reinterpret_cast<const var_dim_type_arrmeta *>(m_dst_arrmeta)->stride;
+    for (vector<output_field>::const_iterator it = m_fields.begin();
+         it != m_fields.end(); ++it) {
+      const char *rows = it->m_side == 0 ? left : right;
+      intptr_t stride = it->m_side == 0 ? left_stride : right_stride;
+      const intptr_t *idx =
+          count == 0 ? NULL
+                     : (it->m_side == 0 ? &m_left_idx[0] : &m_right_idx[0]);
+      ckernel_prefix *copy = this->get_child_ckernel(it->m_copy_offset);
+      expr_single_t copy_fn = copy->get_function<expr_single_t>();
+      ckernel_prefix *na = it->m_na_offset == 0
+                               ? NULL
+                               : this->get_child_ckernel(it->m_na_offset);
+      char *field_dst = dst_row + it->m_dst_offset;
+      for (intptr_t k = 0; k < count; ++k, field_dst += dst_stride) {
+        if (idx[k] >= 0) {
+          char *child_src =
+              const_cast<char *>(rows) + idx[k] * stride + it->m_src_offset;
+          copy_fn(field_dst, &child_src, copy);
+        } else {
+          na->get_function<expr_single_t>()(field_dst, NULL, na);
+        }
+      }
+    }
+  }
+
+  void destruct_children()
+  {
+    for (vector<output_field>::const_iterator it = m_fields.begin();
+         it != m_fields.end(); ++it) {
+      if (it->m_copy_offset != 0) {
+        this->destroy_child_ckernel(it->m_copy_offset);
+      }
+      if (it->m_na_offset != 0) {
+        this->destroy_child_ckernel(it->m_na_offset);
+      }
+    }
+    if (m_less_lr_offset != 0) {
+      this->destroy_child_ckernel(m_less_lr_offset);
+    }
+    if (m_less_rl_offset != 0) {
+      this->destroy_child_ckernel(m_less_rl_offset);
+    }
+  }
+
+  /** Returns the struct type of the rows, checking there is one dim */
+  static const ndt::base_struct_type *get_row_type(const ndt::type &tp)
+  {
+    if ((tp.get_type_id() != fixed_dim_type_id &&
+         tp.get_type_id() != var_dim_type_id) ||
+        tp.get_ndim() != 1 ||
+        tp.get_type_at_dimension(NULL, 1).get_kind() != struct_kind) {
+      stringstream ss;
+      ss << "join arrfunc: expected a one-dimensional array of structs, not "
+         << tp;
+      throw type_error(ss.str());
+    }
+    return tp.get_type_at_dimension(NULL, 1)
+        .extended<ndt::base_struct_type>();
+  }
+
+  static intptr_t get_key_index(const ndt::base_struct_type *left,
+                                const ndt::base_struct_type *right,
+                                const string &on)
+  {
+    intptr_t left_index = left->get_field_index(on),
+             right_index = right->get_field_index(on);
+    if (left_index < 0 || right_index < 0) {
+      stringstream ss;
+      ss << "join arrfunc: both structs must have the field \"" << on << "\"";
+      throw invalid_argument(ss.str());
+    }
+    if (left->get_field_type(left_index) !=
+        right->get_field_type(right_index)) {
+      stringstream ss;
+      ss << "join arrfunc: the field \"" << on << "\" has type "
+         << left->get_field_type(left_index) << " on the left and "
+         << right->get_field_type(right_index) << " on the right";
+      throw type_error(ss.str());
+    }
+    return left_index;
+  }
+
+  static bool is_left_join(const nd::array &kwds)
+  {
+    nd::array how = kwds.p("how");
+    if (how.is_missing()) {
+      return false;
+    }
+    string how_str = how.as<string>();
+    if (how_str == "inner") {
+      return false;
+    } else if (how_str == "left") {
+      return true;
+    }
+    stringstream ss;
+    ss << "join arrfunc: how must be \"inner\" or \"left\", not \"" << how_str
+       << "\"";
+    throw invalid_argument(ss.str());
+  }
+
+  static void resolve_dst_type(
+      char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+      char *DYND_UNUSED(data), ndt::type &dst_tp, intptr_t DYND_UNUSED(nsrc),
+      const ndt::type *src_tp, const nd::array &kwds,
+      const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    const ndt::base_struct_type *left = get_row_type(src_tp[0]);
+    const ndt::base_struct_type *right = get_row_type(src_tp[1]);
+    string on = kwds.p("on").as<string>();
+    get_key_index(left, right, on);
+    bool left_join = is_left_join(kwds);
+
+    vector<string> names;
+    vector<ndt::type> types;
+    for (intptr_t i = 0; i < left->get_field_count(); ++i) {
+      names.push_back(left->get_field_name(i));
+      types.push_back(left->get_field_type(i).get_canonical_type());
+    }
+    for (intptr_t i = 0; i < right->get_field_count(); ++i) {
+      string name = right->get_field_name(i);
+      if (name == on) {
+        continue;
+      }
+      while (std::find(names.begin(), names.end(), name) != names.end()) {
+        name += "_right";
+      }
+      names.push_back(name);
+      ndt::type tp = right->get_field_type(i).get_canonical_type();
+      if (left_join && tp.get_type_id() != option_type_id) {
+        tp = ndt::make_option(tp);
+      }
+      types.push_back(tp);
+    }
+
+    vector<const string *> name_ptrs(names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+      name_ptrs[i] = &names[i];
+    }
+    nd::array field_names =
+        nd::make_strided_string_array(&name_ptrs[0], names.size());
+    nd::array field_types = nd::empty(types.size(), ndt::make_type());
+    for (size_t i = 0; i < types.size(); ++i) {
+      ndt::unchecked_fixed_dim_get_rw<ndt::type>(field_types, i) = types[i];
+    }
+    field_types.flag_as_immutable();
+    dst_tp = ndt::make_var_dim(ndt::make_struct(field_names, field_types));
+  }
+
+  static intptr_t
+  instantiate(char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *ectx, const nd::array &kwds,
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    intptr_t root_ckb_offset = ckb_offset;
+    nd::array sorted = kwds.p("sorted");
+    self_type *self =
+        self_type::make(ckb, kernreq, ckb_offset, is_left_join(kwds),
+                        !sorted.is_missing() && sorted.as<bool>());
+
+    string on = kwds.p("on").as<string>();
+    const ndt::base_struct_type *row_tp[2];
+    const char *row_meta[2];
+    const uintptr_t *src_offsets[2];
+    for (int side = 0; side < 2; ++side) {
+      row_tp[side] = get_row_type(src_tp[side]);
+      join_input &input = self->m_inputs[side];
+      input.m_var = src_tp[side].get_type_id() == var_dim_type_id;
+      input.m_arrmeta = src_arrmeta[side];
+      if (input.m_var) {
+        input.m_size = 0;
+        input.m_stride = 0;
+        row_meta[side] = src_arrmeta[side] + sizeof(var_dim_type_arrmeta);
+      } else {
+        const fixed_dim_type_arrmeta *md =
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(
+                src_arrmeta[side]);
+        input.m_size = md->dim_size;
+        input.m_stride = md->stride;
+        row_meta[side] = src_arrmeta[side] + sizeof(fixed_dim_type_arrmeta);
+      }
+      src_offsets[side] = row_tp[side]->get_data_offsets(row_meta[side]);
+    }
+
+    intptr_t key_index[2] = {
+        get_key_index(row_tp[0], row_tp[1], on),
+        row_tp[1]->get_field_index(on)};
+    ndt::type key_tp = row_tp[0]->get_field_type(key_index[0]);
+    const char *key_meta[2];
+    for (int side = 0; side < 2; ++side) {
+      self->m_inputs[side].m_key_offset = src_offsets[side][key_index[side]];
+      key_meta[side] = row_meta[side] +
+                       row_tp[side]->get_arrmeta_offsets_raw()[key_index[side]];
+    }
+    if (!self->m_sorted) {
+      self->m_hasher.reset(new element_hasher(key_tp, key_meta[0]));
+      // Right keys are hashed with the arrmeta of the left keys
+      element_hasher right_hasher(key_tp, key_meta[1]);
+      for (size_t i = 0; i < right_hasher.get_leaves().size(); ++i) {
+        if (right_hasher.get_leaves()[i].offset !=
+            self->m_hasher->get_leaves()[i].offset) {
+          stringstream ss;
+          ss << "join arrfunc: the left and right keys have different "
+                "layouts of type " << key_tp;
+          throw type_error(ss.str());
+        }
+      }
+    }
+
+    self->m_dst_tp = dst_tp;
+    self->m_dst_arrmeta = dst_arrmeta;
+    const ndt::base_struct_type *dst_row_tp =
+        dst_tp.extended<ndt::var_dim_type>()
+            ->get_element_type()
+            .extended<ndt::base_struct_type>();
+    const char *dst_row_meta = dst_arrmeta + sizeof(var_dim_type_arrmeta);
+    const uintptr_t *dst_offsets = dst_row_tp->get_data_offsets(dst_row_meta);
+    const uintptr_t *dst_arrmeta_offsets =
+        dst_row_tp->get_arrmeta_offsets_raw();
+
+    // Match up the output fields with their source fields
+    intptr_t dst_index = 0;
+    for (int side = 0; side < 2; ++side) {
+      for (intptr_t i = 0; i < row_tp[side]->get_field_count(); ++i) {
+        if (side == 1 && i == key_index[1]) {
+          continue;
+        }
+        output_field field;
+        field.m_side = side;
+        field.m_src_offset = src_offsets[side][i];
+        field.m_dst_offset = dst_offsets[dst_index];
+        field.m_copy_offset = 0;
+        field.m_na_offset = 0;
+        self->m_fields.push_back(field);
+        ++dst_index;
+      }
+    }
+
+    dst_index = 0;
+    for (int side = 0; side < 2; ++side) {
+      for (intptr_t i = 0; i < row_tp[side]->get_field_count(); ++i) {
+        if (side == 1 && i == key_index[1]) {
+          continue;
+        }
+        const ndt::type &field_tp = dst_row_tp->get_field_type(dst_index);
+        const char *field_meta =
+            dst_row_meta + dst_arrmeta_offsets[dst_index];
+
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+            ->reserve(ckb_offset + sizeof(ckernel_prefix));
+        self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+                   ->get_at<self_type>(root_ckb_offset);
+        self->m_fields[dst_index].m_copy_offset = ckb_offset - root_ckb_offset;
+        ckb_offset = make_assignment_kernel(
+            ckb, ckb_offset, field_tp, field_meta,
+            row_tp[side]->get_field_type(i),
+            row_meta[side] + row_tp[side]->get_arrmeta_offsets_raw()[i],
+            kernel_request_single, ectx);
+
+        if (side == 1 && self->m_left_join) {
+          reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+              ->reserve(ckb_offset + sizeof(ckernel_prefix));
+          self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+                     ->get_at<self_type>(root_ckb_offset);
+          self->m_fields[dst_index].m_na_offset = ckb_offset - root_ckb_offset;
+          const arrfunc_type_data *assign_na =
+              field_tp.extended<ndt::option_type>()->get_assign_na_arrfunc();
+          ckb_offset = assign_na->instantiate(
+              NULL, 0, NULL, ckb, ckb_offset, field_tp, field_meta, 0, NULL,
+              NULL, kernel_request_single, ectx, nd::array(),
+              std::map<nd::string, ndt::type>());
+        }
+        ++dst_index;
+      }
+    }
+
+    if (self->m_sorted) {
+      for (int k = 0; k < 2; ++k) {
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+            ->reserve(ckb_offset + sizeof(ckernel_prefix));
+        self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+                   ->get_at<self_type>(root_ckb_offset);
+        (k == 0 ? self->m_less_lr_offset : self->m_less_rl_offset) =
+            ckb_offset - root_ckb_offset;
+        ckb_offset = make_comparison_kernel(
+            ckb, ckb_offset, key_tp, key_meta[k], key_tp, key_meta[1 - k],
+            comparison_type_sorting_less, ectx);
+      }
+    }
+
+    return ckb_offset;
+  }
+};
+
+} // anonymous namespace
+
+nd::arrfunc nd::join::make()
+{
+  return arrfunc::make<join_ck>(
+      ndt::type("(LeftDims... * L, RightDims... * R, on: string, how: ?string, "
+                "sorted: ?bool) -> var * T"),
+      0);
+}
+
+struct nd::join nd::join;
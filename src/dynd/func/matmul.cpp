@@ -0,0 +1,27 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/func/elwise.hpp>
+#include <dynd/func/matmul.hpp>
+#include <dynd/kernels/matmul.hpp>
+
+using namespace std;
+using namespace dynd;
+
+nd::arrfunc nd::matmul::make()
+{
+  return functional::elwise(arrfunc::make<matmul_virtual_ck>(
+      ndt::type("(M * K * T, K * N * T) -> M * N * T"), 0));
+}
+
+struct nd::matmul nd::matmul;
+
+nd::arrfunc nd::dot::make()
+{
+  return functional::elwise(
+      arrfunc::make<dot_virtual_ck>(ndt::type("(N * T, N * T) -> T"), 0));
+}
+
+struct nd::dot nd::dot;
@@ -277,8 +277,9 @@ nd::arrfunc nd::functional::old_multidispatch(intptr_t naf,
   }
 
   // TODO: Component arrfuncs might be arrays, not just scalars
-  return arrfunc::make<old_multidispatch_ck>(ndt::make_generic_funcproto(nargs),
-                                             std::move(sorted_af), 0);
+  return arrfunc::make<old_multidispatch_ck>(
+      ndt::make_generic_funcproto(nargs),
+      std::make_shared<old_multidispatch_static_data>(std::move(sorted_af)), 0);
 }
 
 nd::arrfunc
@@ -17,15 +17,17 @@ nd::arrfunc nd::functional::neighborhood(const nd::arrfunc &neighborhood_op,
   const ndt::arrfunc_type *funcproto_tp =
       neighborhood_op.get_array_type().extended<ndt::arrfunc_type>();
 
-  nd::array arg_tp = nd::empty(3, ndt::make_type());
+  nd::array arg_tp = nd::empty(4, ndt::make_type());
   arg_tp(0).vals() = ndt::type("?" + std::to_string(nh_ndim) + " * int");
   arg_tp(1).vals() = ndt::type("?" + std::to_string(nh_ndim) + " * int");
   arg_tp(2).vals() =
       ndt::type("?Fixed**" + std::to_string(nh_ndim) + " * bool");
+  arg_tp(3).vals() = ndt::type("?int32");
   std::vector<std::string> arg_names;
   arg_names.push_back("shape");
   arg_names.push_back("offset");
   arg_names.push_back("mask");
+  arg_names.push_back("threads");
   ndt::type ret_tp = funcproto_tp->get_pos_type(0)
                          .with_replaced_dtype(funcproto_tp->get_return_type());
   ndt::type self_tp =
@@ -46,6 +48,24 @@ nd::arrfunc nd::functional::neighborhood(const nd::arrfunc &neighborhood_op,
     throw invalid_argument(ss.str());
   }
 
-  std::shared_ptr<neighborhood_data> nh(new nd::functional::neighborhood_data(neighborhood_op, nh_ndim));
+  std::shared_ptr<neighborhood_data> nh(
+      new nd::functional::neighborhood_data(neighborhood_op));
   return arrfunc::make<neighborhood_ck<1>>(self_tp, nh, 0);
 }
+
+nd::arrfunc nd::functional::separable_convolution(
+    const std::vector<std::vector<double>> &weights)
+{
+  if (weights.empty()) {
+    throw invalid_argument(
+        "separable_convolution requires weights for at least one dimension");
+  }
+
+  std::string ndim = std::to_string(weights.size());
+  ndt::type self_tp("(Fixed**" + ndim + " * R, offset: ?" + ndim +
+                    " * int) -> Fixed**" + ndim + " * R");
+
+  std::shared_ptr<separable_convolution_data> sd(
+      new separable_convolution_data(weights));
+  return arrfunc::make<separable_convolution_ck>(self_tp, sd, 0);
+}
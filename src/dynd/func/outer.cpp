@@ -15,6 +15,55 @@ nd::arrfunc nd::functional::outer(const arrfunc &child)
   return arrfunc::make<outer_ck>(outer_make_type(child.get_type()), child, 0);
 }
 
+/**
+ * The type of a reduction over the outer product of a binary child,
+ * ``(Fixed * S0, Fixed * S1) -> Fixed * R``.
+ */
+static ndt::type outer_reduce_make_type(const ndt::arrfunc_type *child_tp,
+                                        const ndt::type &ret_tp)
+{
+  if (child_tp->get_npos() != 2) {
+    throw invalid_argument("outer reductions require a binary child");
+  }
+  return ndt::make_arrfunc(
+      ndt::make_tuple(ndt::make_fixed_dim_kind(child_tp->get_pos_type(0)),
+                      ndt::make_fixed_dim_kind(child_tp->get_pos_type(1))),
+      child_tp->get_kwd_struct(), ndt::make_fixed_dim_kind(ret_tp));
+}
+
+nd::arrfunc nd::functional::outer_reduce(const arrfunc &child,
+                                         const arrfunc &reduction)
+{
+  const ndt::arrfunc_type *reduction_tp = reduction.get_type();
+  if (reduction_tp->get_npos() != 1) {
+    throw invalid_argument("outer_reduce requires a unary reduction");
+  }
+  return arrfunc::make<outer_reduce_ck>(
+      outer_reduce_make_type(child.get_type(),
+                             child.get_type()->get_return_type()),
+      std::shared_ptr<outer_reduce_data>(
+          new outer_reduce_data(child, reduction, false)),
+      0);
+}
+
+nd::arrfunc nd::functional::outer_argmin(const arrfunc &child)
+{
+  return arrfunc::make<outer_arg_virtual_ck>(
+      outer_reduce_make_type(child.get_type(), ndt::make_type<intptr_t>()),
+      std::shared_ptr<outer_reduce_data>(
+          new outer_reduce_data(child, arrfunc(), false)),
+      0);
+}
+
+nd::arrfunc nd::functional::outer_argmax(const arrfunc &child)
+{
+  return arrfunc::make<outer_arg_virtual_ck>(
+      outer_reduce_make_type(child.get_type(), ndt::make_type<intptr_t>()),
+      std::shared_ptr<outer_reduce_data>(
+          new outer_reduce_data(child, arrfunc(), true)),
+      0);
+}
+
 ndt::type nd::functional::outer_make_type(const ndt::arrfunc_type *child_tp)
 {
   const ndt::type *param_types = child_tp->get_pos_types_raw();
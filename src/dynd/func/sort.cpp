@@ -0,0 +1,760 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include <dynd/func/elwise.hpp>
+#include <dynd/func/sort.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/comparison_kernels.hpp>
+#include <dynd/parallel.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/fixed_string_type.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * Maps a builtin value to an unsigned integer key whose unsigned ordering
+ * is the ordering of the values, so the keys can be radix sorted.
+ */
+template <typename T, typename Enable = void>
+struct radix_key;
+
+template <typename T>
+struct radix_key<T, typename std::enable_if<std::is_integral<T>::value &&
+                                            std::is_unsigned<T>::value>::type> {
+  typedef T type;
+
+  static type to_key(T value) { return value; }
+  static T from_key(type key) { return key; }
+};
+
+template <typename T>
+struct radix_key<T, typename std::enable_if<std::is_integral<T>::value &&
+                                            std::is_signed<T>::value>::type> {
+  typedef typename std::make_unsigned<T>::type type;
+
+  // Flipping the sign bit puts the negative values first
+  static type to_key(T value)
+  {
+    return static_cast<type>(value) ^
+           (static_cast<type>(1) << (8 * sizeof(T) - 1));
+  }
+  static T from_key(type key)
+  {
+    return static_cast<T>(key ^ (static_cast<type>(1) << (8 * sizeof(T) - 1)));
+  }
+};
+
+template <typename T>
+struct radix_key<T, typename std::enable_if<
+                        std::is_floating_point<T>::value>::type> {
+  typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type
+      type;
+
+  // Negative values have all their bits flipped, so larger magnitudes come
+  // first, and positive values have the sign bit set to follow them. NaNs
+  // map to the largest key.
+  static type to_key(T value)
+  {
+    const type sign = static_cast<type>(1) << (8 * sizeof(T) - 1);
+    if (value != value) {
+      return ~static_cast<type>(0);
+    }
+    type bits;
+    memcpy(&bits, &value, sizeof(T));
+    return (bits & sign) ? ~bits : (bits | sign);
+  }
+  static T from_key(type key)
+  {
+    const type sign = static_cast<type>(1) << (8 * sizeof(T) - 1);
+    type bits = (key & sign) ? (key ^ sign) : ~key;
+    T value;
+    memcpy(&value, &bits, sizeof(T));
+    return value;
+  }
+};
+
+/**
+ * LSD radix sort of the keys, carrying the indices along when ``idx`` is
+ * not NULL. Wide keys use 11-bit digits, so 64-bit keys take six passes
+ * instead of eight, and passes in which every key has the same digit are
+ * skipped. On return ``keys`` and ``idx`` point at whichever of the two
+ * buffers holds the sorted data.
+ *
+ * The keys are split into ``thread_count`` chunks, which each pass
+ * histograms and scatters as tasks on ``pool``. The bucket offsets of a
+ * chunk follow those of the earlier chunks, so the result is the same as
+ * sorting on one thread.
+ */
+template <typename K>
+void radix_sort(K *&inout_keys, K *&inout_keys_tmp, intptr_t *&inout_idx,
+                intptr_t *&inout_idx_tmp, intptr_t n, detail::thread_pool &pool,
+                int thread_count)
+{
+  const int digit_bits = sizeof(K) >= 4 ? 11 : 8;
+  const int radix = 1 << digit_bits;
+  const int pass_count = (8 * sizeof(K) + digit_bits - 1) / digit_bits;
+
+  // Local copies of the pointers, so the stores in the loops can't alias them
+  K *keys = inout_keys, *keys_tmp = inout_keys_tmp;
+  intptr_t *idx = inout_idx, *idx_tmp = inout_idx_tmp;
+
+  // The digit counts of every pass, per chunk
+  std::vector<intptr_t> all_counts(thread_count * pass_count * radix);
+  pool.parallel_for(thread_count, [&](int t) {
+    intptr_t *counts = &all_counts[t * pass_count * radix];
+    for (intptr_t i = detail::chunk_begin(n, thread_count, t),
+                  i_end = detail::chunk_begin(n, thread_count, t + 1);
+         i < i_end; ++i) {
+      K key = keys[i];
+      for (int p = 0; p < pass_count; ++p) {
+        ++counts[p * radix + ((key >> (digit_bits * p)) & (radix - 1))];
+      }
+    }
+  });
+
+  for (int p = 0; p < pass_count; ++p) {
+    int shift = digit_bits * p;
+    intptr_t first_digit = (keys[0] >> shift) & (radix - 1), first_count = 0;
+    for (int t = 0; t < thread_count; ++t) {
+      first_count += all_counts[(t * pass_count + p) * radix + first_digit];
+    }
+    if (first_count == n) {
+      continue;
+    }
+
+    // After the first pass the keys have moved between chunks, so the
+    // counts of the chunks are redone
+    if (thread_count > 1 && p > 0) {
+      pool.parallel_for(thread_count, [&](int t) {
+        intptr_t *c = &all_counts[(t * pass_count + p) * radix];
+        memset(c, 0, radix * sizeof(intptr_t));
+        for (intptr_t i = detail::chunk_begin(n, thread_count, t),
+                      i_end = detail::chunk_begin(n, thread_count, t + 1);
+             i < i_end; ++i) {
+          ++c[(keys[i] >> shift) & (radix - 1)];
+        }
+      });
+    }
+
+    intptr_t total = 0;
+    for (int b = 0; b < radix; ++b) {
+      for (int t = 0; t < thread_count; ++t) {
+        intptr_t &c = all_counts[(t * pass_count + p) * radix + b];
+        intptr_t count = c;
+        c = total;
+        total += count;
+      }
+    }
+
+    pool.parallel_for(thread_count, [&](int t) {
+      intptr_t *c = &all_counts[(t * pass_count + p) * radix];
+      intptr_t i = detail::chunk_begin(n, thread_count, t),
+               i_end = detail::chunk_begin(n, thread_count, t + 1);
+      if (idx != NULL) {
+        for (; i < i_end; ++i) {
+          K key = keys[i];
+          intptr_t pos = c[(key >> shift) & (radix - 1)]++;
+          keys_tmp[pos] = key;
+          idx_tmp[pos] = idx[i];
+        }
+      } else {
+        for (; i < i_end; ++i) {
+          K key = keys[i];
+          keys_tmp[c[(key >> shift) & (radix - 1)]++] = key;
+        }
+      }
+    });
+    std::swap(keys, keys_tmp);
+    std::swap(idx, idx_tmp);
+  }
+
+  inout_keys = keys;
+  inout_keys_tmp = keys_tmp;
+  inout_idx = idx;
+  inout_idx_tmp = idx_tmp;
+}
+
+/**
+ * Sorts ``thread_count`` chunks of the data as tasks on ``pool``, then
+ * merges pairs of runs until one is left, also in parallel. std::merge
+ * takes from the earlier run on ties, so with stable chunk sorts the result
+ * is the stable order. Task ``t`` compares with ``get_less(t)``, so
+ * comparisons which aren't thread-safe can use one comparator per task.
+ * Returns whichever of ``data`` and ``tmp`` holds the result.
+ */
+template <typename T, typename GetLess>
+T *merge_sort(T *data, T *tmp, intptr_t n, detail::thread_pool &pool,
+              int thread_count, const GetLess &get_less, bool stable)
+{
+  pool.parallel_for(thread_count, [&](int t) {
+    auto less = get_less(t);
+    T *begin = data + detail::chunk_begin(n, thread_count, t),
+      *end = data + detail::chunk_begin(n, thread_count, t + 1);
+    if (stable) {
+      std::stable_sort(begin, end, less);
+    } else {
+      std::sort(begin, end, less);
+    }
+  });
+
+  // The boundaries of the sorted runs
+  std::vector<intptr_t> bounds(thread_count + 1);
+  for (int t = 0; t <= thread_count; ++t) {
+    bounds[t] = detail::chunk_begin(n, thread_count, t);
+  }
+  while (bounds.size() > 2) {
+    intptr_t run_count = bounds.size() - 1;
+    pool.parallel_for(static_cast<int>((run_count + 1) / 2), [&](int t) {
+      intptr_t begin = bounds[2 * t],
+               mid = bounds[std::min<intptr_t>(2 * t + 1, run_count)],
+               end = bounds[std::min<intptr_t>(2 * t + 2, run_count)];
+      std::merge(data + begin, data + mid, data + mid, data + end,
+                 tmp + begin, get_less(t));
+    });
+    std::swap(data, tmp);
+    std::vector<intptr_t> merged_bounds;
+    for (intptr_t r = 0; r < run_count; r += 2) {
+      merged_bounds.push_back(bounds[r]);
+    }
+    merged_bounds.push_back(n);
+    bounds.swap(merged_bounds);
+  }
+  return data;
+}
+
+/** Below this size std::sort beats the radix passes */
+const intptr_t radix_sort_min_size = 256;
+
+/** Below this size a row is sorted on one thread by default */
+const intptr_t parallel_sort_min_size = 1 << 20;
+
+/** The smallest chunk of a row given to a thread */
+const intptr_t parallel_sort_min_chunk_size = 1 << 12;
+
+template <typename K>
+struct key_index_less {
+  const K *m_keys;
+
+  key_index_less(const K *keys) : m_keys(keys) {}
+
+  bool operator()(intptr_t i, intptr_t j) const
+  {
+    return m_keys[i] < m_keys[j] || (m_keys[i] == m_keys[j] && i < j);
+  }
+};
+
+/**
+ * A string to sort, with its first eight bytes packed big-endian into an
+ * integer so most comparisons don't touch the string data.
+ */
+struct string_sort_entry {
+  uint64_t prefix;
+  const char *begin;
+  const char *end;
+  intptr_t index;
+
+  void set(const char *b, const char *e, intptr_t i)
+  {
+    begin = b;
+    end = e;
+    index = i;
+    prefix = 0;
+    intptr_t size = std::min<intptr_t>(e - b, 8);
+    for (intptr_t j = 0; j < 8; ++j) {
+      prefix = (prefix << 8) |
+               (j < size ? static_cast<uint8_t>(b[j]) : static_cast<uint8_t>(0));
+    }
+  }
+
+  // Orders by bytes, then length, then original position
+  bool operator<(const string_sort_entry &rhs) const
+  {
+    if (prefix != rhs.prefix) {
+      return prefix < rhs.prefix;
+    }
+    intptr_t size = end - begin, rhs_size = rhs.end - rhs.begin;
+    if (size > 8 && rhs_size > 8) {
+      int cmp =
+          memcmp(begin + 8, rhs.begin + 8, std::min(size, rhs_size) - 8);
+      if (cmp != 0) {
+        return cmp < 0;
+      }
+    }
+    if (size != rhs_size) {
+      return size < rhs_size;
+    }
+    return index < rhs.index;
+  }
+};
+
+struct comparison_index_less {
+  ckernel_prefix *m_less;
+  expr_single_t m_less_fn;
+  const char *m_src;
+  intptr_t m_src_stride;
+
+  comparison_index_less(ckernel_prefix *less, const char *src,
+                        intptr_t src_stride)
+      : m_less(less), m_less_fn(less->get_function<expr_single_t>()),
+        m_src(src), m_src_stride(src_stride)
+  {
+  }
+
+  bool operator()(intptr_t i, intptr_t j) const
+  {
+    int dst;
+    char *src[2] = {const_cast<char *>(m_src) + i * m_src_stride,
+                    const_cast<char *>(m_src) + j * m_src_stride};
+    m_less_fn(reinterpret_cast<char *>(&dst), src, m_less);
+    return dst != 0;
+  }
+};
+
+enum sort_method_t {
+  sort_uint8,
+  sort_uint16,
+  sort_uint32,
+  sort_uint64,
+  sort_int8,
+  sort_int16,
+  sort_int32,
+  sort_int64,
+  sort_float32,
+  sort_float64,
+  sort_string,
+  sort_fixed_string,
+  sort_comparison
+};
+
+/**
+ * Sorts, or argsorts when ``Arg`` is true, one strided dimension. The
+ * comparison sort uses a sorting_less child ckernel per thread, and
+ * sorting by something other than radix copies the elements through an
+ * assignment child ckernel. Scratch buffers and threads are kept across
+ * calls, so sorting along the last dimension of a large array allocates and
+ * starts threads once.
+ */
+template <bool Arg>
+struct sort_ck : nd::base_kernel<sort_ck<Arg>, kernel_request_host, 1> {
+  typedef sort_ck self_type;
+
+  sort_method_t m_method;
+  bool m_stable;
+  int m_requested_thread_count;
+  intptr_t m_size, m_src_stride, m_dst_stride, m_src_el_size;
+  size_t m_copy_offset;
+  // One comparison child per thread, as they may keep conversion buffers
+  std::vector<size_t> m_less_offsets;
+  std::vector<uint64_t> m_scratch;
+  // Started on the first call, then reused by every phase of every row
+  std::unique_ptr<detail::thread_pool> m_pool;
+
+  sort_ck(bool stable, int requested_thread_count)
+      : m_method(sort_comparison), m_stable(stable),
+        m_requested_thread_count(requested_thread_count), m_size(0),
+        m_src_stride(0), m_dst_stride(0), m_src_el_size(0), m_copy_offset(0)
+  {
+  }
+
+  /** Returns scratch space for ``n`` elements of type T */
+  template <typename T>
+  T *scratch(intptr_t n)
+  {
+    size_t words = (n * sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    if (m_scratch.size() < words) {
+      m_scratch.resize(words);
+    }
+    return reinterpret_cast<T *>(&m_scratch[0]);
+  }
+
+  /**
+   * The number of threads to sort a row with. Unless a count was requested,
+   * rows smaller than parallel_sort_min_size stay on one thread.
+   */
+  int get_thread_count() const
+  {
+    intptr_t count = m_requested_thread_count;
+    if (count <= 0) {
+      if (m_size < parallel_sort_min_size) {
+        return 1;
+      }
+      count = std::thread::hardware_concurrency();
+    }
+    return dynd::detail::clamp_thread_count(
+        std::min(count, m_size / parallel_sort_min_chunk_size));
+  }
+
+  /**
+   * The threads to sort with. A kernel always asks for the same count, as
+   * its row size is fixed, and a count of one starts no threads.
+   */
+  detail::thread_pool &get_pool(int thread_count)
+  {
+    if (!m_pool) {
+      m_pool.reset(new detail::thread_pool(thread_count));
+    }
+    return *m_pool;
+  }
+
+  void write_indices(char *dst, const intptr_t *idx)
+  {
+    for (intptr_t i = 0; i < m_size; ++i, dst += m_dst_stride) {
+      *reinterpret_cast<intptr_t *>(dst) = idx[i];
+    }
+  }
+
+  /** Copies the source elements to the destination in the given order */
+  void copy_in_order(char *dst, const char *src, const intptr_t *idx)
+  {
+    ckernel_prefix *copy = this->get_child_ckernel(m_copy_offset);
+    expr_single_t copy_fn = copy->get_function<expr_single_t>();
+    for (intptr_t i = 0; i < m_size; ++i, dst += m_dst_stride) {
+      char *child_src = const_cast<char *>(src) + idx[i] * m_src_stride;
+      copy_fn(dst, &child_src, copy);
+    }
+  }
+
+  template <typename T>
+  void radix(char *dst, const char *src)
+  {
+    typedef radix_key<T> traits;
+    typedef typename traits::type K;
+    intptr_t n = m_size;
+
+    size_t key_words = (n * sizeof(K) + 7) / 8;
+    uint64_t *buffers = scratch<uint64_t>(2 * key_words + (Arg ? 2 * n : 0));
+    K *keys = reinterpret_cast<K *>(buffers);
+    K *keys_tmp = reinterpret_cast<K *>(buffers + key_words);
+    intptr_t *idx = NULL, *idx_tmp = NULL;
+    if (Arg) {
+      idx = reinterpret_cast<intptr_t *>(buffers + 2 * key_words);
+      idx_tmp = idx + n;
+    }
+
+    int thread_count = n < radix_sort_min_size ? 1 : get_thread_count();
+    detail::thread_pool &pool = get_pool(thread_count);
+    pool.parallel_for(thread_count, [&](int t) {
+      for (intptr_t i = detail::chunk_begin(n, thread_count, t),
+                    i_end = detail::chunk_begin(n, thread_count, t + 1);
+           i < i_end; ++i) {
+        keys[i] = traits::to_key(
+            *reinterpret_cast<const T *>(src + i * m_src_stride));
+        if (Arg) {
+          idx[i] = i;
+        }
+      }
+    });
+
+    if (n < radix_sort_min_size) {
+      if (Arg) {
+        std::sort(idx, idx + n, key_index_less<K>(keys));
+      } else {
+        std::sort(keys, keys + n);
+      }
+    } else {
+      radix_sort(keys, keys_tmp, idx, idx_tmp, n, pool, thread_count);
+    }
+
+    if (Arg) {
+      write_indices(dst, idx);
+    } else {
+      pool.parallel_for(thread_count, [&](int t) {
+        for (intptr_t i = detail::chunk_begin(n, thread_count, t),
+                      i_end = detail::chunk_begin(n, thread_count, t + 1);
+             i < i_end; ++i) {
+          *reinterpret_cast<T *>(dst + i * m_dst_stride) =
+              traits::from_key(keys[i]);
+        }
+      });
+    }
+  }
+
+  void strings(char *dst, const char *src)
+  {
+    intptr_t n = m_size;
+    int thread_count = get_thread_count();
+    string_sort_entry *entries =
+        scratch<string_sort_entry>(thread_count > 1 ? 2 * n : n);
+    if (m_method == sort_string) {
+      for (intptr_t i = 0; i < n; ++i) {
+        const string_type_data *s =
+            reinterpret_cast<const string_type_data *>(src + i * m_src_stride);
+        entries[i].set(s->begin, s->end, i);
+      }
+    } else {
+      // Fixed strings are zero padded, so comparing all the bytes works
+      intptr_t size = m_src_el_size;
+      for (intptr_t i = 0; i < n; ++i) {
+        const char *s = src + i * m_src_stride;
+        entries[i].set(s, s + size, i);
+      }
+    }
+    // The entries are totally ordered, so chunk sorts need not be stable
+    string_sort_entry *sorted = merge_sort(
+        entries, entries + n, n, get_pool(thread_count), thread_count,
+        [](int) { return std::less<string_sort_entry>(); }, false);
+
+    // Compact the order into the front of the entries, each index landing
+    // on an entry that was already read
+    intptr_t *idx = reinterpret_cast<intptr_t *>(entries);
+    for (intptr_t i = 0; i < n; ++i) {
+      idx[i] = sorted[i].index;
+    }
+    if (Arg) {
+      write_indices(dst, idx);
+    } else {
+      copy_in_order(dst, src, idx);
+    }
+  }
+
+  void comparison(char *dst, const char *src)
+  {
+    intptr_t n = m_size;
+    // Only a stable sort gives the same order however the row is split
+    int thread_count = static_cast<int>(m_less_offsets.size());
+    intptr_t *idx = scratch<intptr_t>(thread_count > 1 ? 2 * n : n);
+    for (intptr_t i = 0; i < n; ++i) {
+      idx[i] = i;
+    }
+    idx = merge_sort(idx, idx + n, n, get_pool(thread_count), thread_count,
+                     [&](int t) {
+                       return comparison_index_less(
+                           this->get_child_ckernel(m_less_offsets[t]), src,
+                           m_src_stride);
+                     },
+                     m_stable);
+    if (Arg) {
+      write_indices(dst, idx);
+    } else {
+      copy_in_order(dst, src, idx);
+    }
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    if (m_size == 0) {
+      return;
+    }
+
+    switch (m_method) {
+    case sort_uint8:
+      radix<uint8_t>(dst, src[0]);
+      break;
+    case sort_uint16:
+      radix<uint16_t>(dst, src[0]);
+      break;
+    case sort_uint32:
+      radix<uint32_t>(dst, src[0]);
+      break;
+    case sort_uint64:
+      radix<uint64_t>(dst, src[0]);
+      break;
+    case sort_int8:
+      radix<int8_t>(dst, src[0]);
+      break;
+    case sort_int16:
+      radix<int16_t>(dst, src[0]);
+      break;
+    case sort_int32:
+      radix<int32_t>(dst, src[0]);
+      break;
+    case sort_int64:
+      radix<int64_t>(dst, src[0]);
+      break;
+    case sort_float32:
+      radix<float>(dst, src[0]);
+      break;
+    case sort_float64:
+      radix<double>(dst, src[0]);
+      break;
+    case sort_string:
+    case sort_fixed_string:
+      strings(dst, src[0]);
+      break;
+    case sort_comparison:
+      comparison(dst, src[0]);
+      break;
+    }
+  }
+
+  void destruct_children()
+  {
+    if (m_copy_offset != 0) {
+      this->destroy_child_ckernel(m_copy_offset);
+    }
+    for (size_t i = 0; i < m_less_offsets.size(); ++i) {
+      this->destroy_child_ckernel(m_less_offsets[i]);
+    }
+  }
+
+  static sort_method_t get_sort_method(const ndt::type &tp)
+  {
+    switch (tp.get_type_id()) {
+    case bool_type_id:
+    case uint8_type_id:
+      return sort_uint8;
+    case uint16_type_id:
+      return sort_uint16;
+    case uint32_type_id:
+      return sort_uint32;
+    case uint64_type_id:
+      return sort_uint64;
+    case int8_type_id:
+      return sort_int8;
+    case int16_type_id:
+      return sort_int16;
+    case int32_type_id:
+      return sort_int32;
+    case int64_type_id:
+      return sort_int64;
+    case float32_type_id:
+      return sort_float32;
+    case float64_type_id:
+      return sort_float64;
+    case date_type_id:
+    case time_type_id:
+    case datetime_type_id:
+      // Stored as signed integer ticks
+      return tp.get_data_size() == 4 ? sort_int32 : sort_int64;
+    case string_type_id: {
+      // Byte order is code point order only for utf-8
+      string_encoding_t encoding =
+          tp.extended<ndt::string_type>()->get_encoding();
+      if (encoding == string_encoding_utf_8 ||
+          encoding == string_encoding_ascii) {
+        return sort_string;
+      }
+      return sort_comparison;
+    }
+    case fixed_string_type_id: {
+      string_encoding_t encoding =
+          tp.extended<ndt::fixed_string_type>()->get_encoding();
+      if (encoding == string_encoding_utf_8 ||
+          encoding == string_encoding_ascii) {
+        return sort_fixed_string;
+      }
+      return sort_comparison;
+    }
+    default:
+      return sort_comparison;
+    }
+  }
+
+  static void resolve_dst_type(
+      char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+      char *DYND_UNUSED(data), ndt::type &dst_tp, intptr_t DYND_UNUSED(nsrc),
+      const ndt::type *src_tp, const nd::array &DYND_UNUSED(kwds),
+      const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    if (Arg) {
+      dst_tp = ndt::make_fixed_dim(
+          src_tp[0].extended<ndt::fixed_dim_type>()->get_fixed_dim_size(),
+          ndt::make_type<intptr_t>());
+    } else {
+      dst_tp = src_tp[0].get_canonical_type();
+    }
+  }
+
+  static intptr_t
+  instantiate(char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *ectx, const nd::array &kwds,
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    intptr_t root_ckb_offset = ckb_offset;
+    nd::array stable = kwds.p("stable"), threads = kwds.p("threads");
+    self_type *self = self_type::make(
+        ckb, kernreq, ckb_offset, !stable.is_missing() && stable.as<bool>(),
+        threads.is_missing() ? 0 : threads.as<int>());
+
+    intptr_t src_size, dst_size;
+    ndt::type src_el_tp, dst_el_tp;
+    const char *src_el_meta, *dst_el_meta;
+    if (!src_tp[0].get_as_strided(src_arrmeta[0], &src_size,
+                                  &self->m_src_stride, &src_el_tp,
+                                  &src_el_meta)) {
+      stringstream ss;
+      ss << "sort arrfunc: could not process type " << src_tp[0];
+      ss << " as a strided dimension";
+      throw type_error(ss.str());
+    }
+    if (!dst_tp.get_as_strided(dst_arrmeta, &dst_size, &self->m_dst_stride,
+                               &dst_el_tp, &dst_el_meta)) {
+      stringstream ss;
+      ss << "sort arrfunc: could not process type " << dst_tp;
+      ss << " as a strided dimension";
+      throw type_error(ss.str());
+    }
+    if (src_size != dst_size) {
+      stringstream ss;
+      ss << "sort arrfunc: source and destination have different sizes, ";
+      ss << src_size << " and " << dst_size;
+      throw invalid_argument(ss.str());
+    }
+    self->m_size = src_size;
+    self->m_src_el_size = src_el_tp.get_data_size();
+    self->m_method = get_sort_method(src_el_tp);
+    if (!Arg && self->m_method < sort_string &&
+        dst_el_tp.get_type_id() != src_el_tp.get_type_id()) {
+      self->m_method = sort_comparison;
+    }
+
+    if (!Arg && self->m_method >= sort_string) {
+      reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+          ->reserve(ckb_offset + sizeof(ckernel_prefix));
+      self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+                 ->get_at<self_type>(root_ckb_offset);
+      self->m_copy_offset = ckb_offset - root_ckb_offset;
+      ckb_offset = make_assignment_kernel(
+          ckb, ckb_offset, dst_el_tp, dst_el_meta, src_el_tp, src_el_meta,
+          kernel_request_single, ectx);
+    }
+    if (self->m_method == sort_comparison) {
+      int thread_count = self->m_stable ? self->get_thread_count() : 1;
+      for (int t = 0; t < thread_count; ++t) {
+        reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+            ->reserve(ckb_offset + sizeof(ckernel_prefix));
+        self = reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb)
+                   ->get_at<self_type>(root_ckb_offset);
+        self->m_less_offsets.push_back(ckb_offset - root_ckb_offset);
+        ckb_offset = make_comparison_kernel(
+            ckb, ckb_offset, src_el_tp, src_el_meta, src_el_tp, src_el_meta,
+            comparison_type_sorting_less, ectx);
+      }
+    }
+
+    return ckb_offset;
+  }
+};
+
+} // anonymous namespace
+
+nd::arrfunc nd::sort::make()
+{
+  return functional::elwise(arrfunc::make<sort_ck<false>>(
+      ndt::type("(N * T, stable: ?bool, threads: ?int) -> N * T"), 0));
+}
+
+nd::arrfunc nd::argsort::make()
+{
+  return functional::elwise(arrfunc::make<sort_ck<true>>(
+      ndt::type("(N * T, stable: ?bool, threads: ?int) -> N * intptr"), 0));
+}
+
+struct nd::sort nd::sort;
+
+struct nd::argsort nd::argsort;
@@ -17,4 +17,11 @@ nd::arrfunc nd::take::make()
   return arrfunc::make<take_ck>(ndt::type("(Dims... * T, N * Ix) -> R * T"), 0);
 }
 
-struct nd::take nd::take;
\ No newline at end of file
+struct nd::take nd::take;
+
+nd::arrfunc nd::put::make()
+{
+  return arrfunc::make<put_ck>(ndt::type("(N * intptr, N * S) -> M * T"), 0);
+}
+
+struct nd::put nd::put;
\ No newline at end of file
@@ -0,0 +1,99 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/func/elwise.hpp>
+#include <dynd/func/timezone.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/types/datetime_util.hpp>
+#include <dynd/types/timezone_util.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * Converts between UTC and the wall clock time of a time zone, looking up
+ * the offset in the zone's transition table. The table index used for the
+ * previous element is remembered, so sorted or clustered timestamps mostly
+ * skip the binary search.
+ */
+template <bool ToLocal>
+struct timezone_convert_ck
+    : nd::base_kernel<timezone_convert_ck<ToLocal>, kernel_request_host, 1> {
+  std::shared_ptr<const timezone_transitions> m_tz;
+  intptr_t m_hint;
+
+  timezone_convert_ck(const std::shared_ptr<const timezone_transitions> &tz)
+      : m_tz(tz), m_hint(0)
+  {
+  }
+
+  int64_t convert(int64_t ticks)
+  {
+    if (ticks == DYND_DATETIME_NA) {
+      return ticks;
+    } else if (ToLocal) {
+      return m_tz->utc_to_local(ticks, m_hint);
+    } else {
+      return m_tz->local_to_utc(ticks, m_hint);
+    }
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    *reinterpret_cast<int64_t *>(dst) =
+        convert(*reinterpret_cast<const int64_t *>(src[0]));
+  }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src,
+               const intptr_t *src_stride, size_t count)
+  {
+    const char *src0 = src[0];
+    intptr_t src0_stride = src_stride[0];
+    for (size_t i = 0; i != count; ++i) {
+      *reinterpret_cast<int64_t *>(dst) =
+          convert(*reinterpret_cast<const int64_t *>(src0));
+      dst += dst_stride;
+      src0 += src0_stride;
+    }
+  }
+
+  static intptr_t
+  instantiate(char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &DYND_UNUSED(dst_tp),
+              const char *DYND_UNUSED(dst_arrmeta), intptr_t DYND_UNUSED(nsrc),
+              const ndt::type *DYND_UNUSED(src_tp),
+              const char *const *DYND_UNUSED(src_arrmeta),
+              kernel_request_t kernreq,
+              const eval::eval_context *DYND_UNUSED(ectx),
+              const nd::array &kwds,
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    timezone_convert_ck::make(
+        ckb, kernreq, ckb_offset,
+        get_timezone_transitions(kwds.p("tz").as<std::string>()));
+    return ckb_offset;
+  }
+};
+
+} // anonymous namespace
+
+nd::arrfunc nd::utc_to_local::make()
+{
+  return functional::elwise(arrfunc::make<timezone_convert_ck<true>>(
+      ndt::type("(datetime[tz='UTC'], tz: string) -> datetime"), 0));
+}
+
+nd::arrfunc nd::local_to_utc::make()
+{
+  return functional::elwise(arrfunc::make<timezone_convert_ck<false>>(
+      ndt::type("(datetime, tz: string) -> datetime[tz='UTC']"), 0));
+}
+
+struct nd::utc_to_local nd::utc_to_local;
+
+struct nd::local_to_utc nd::local_to_utc;
@@ -0,0 +1,402 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <memory>
+#include <vector>
+
+#include <dynd/func/elwise.hpp>
+#include <dynd/func/unique.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/base_virtual_kernel.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/hash_util.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * Calls ``KernelType<Hasher>::instantiate_with(hasher, ...)`` with the
+ * fastest hasher for the element type. Elements that are a single run of
+ * 1, 2, 4 or 8 bytes hash as an unsigned integer.
+ */
+template <template <typename> class KernelType>
+intptr_t instantiate_with_hasher(
+    const ndt::type &el_tp, const char *el_meta, void *ckb, intptr_t ckb_offset,
+    const ndt::type &dst_tp, const char *dst_arrmeta, const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &kwds)
+{
+  element_hasher hasher(el_tp, el_meta);
+  switch (hasher.get_raw_size()) {
+  case 1:
+    return KernelType<raw_element_hasher<uint8_t>>::instantiate_with(
+        raw_element_hasher<uint8_t>(), ckb, ckb_offset, dst_tp, dst_arrmeta,
+        src_tp, src_arrmeta, kernreq, ectx, kwds);
+  case 2:
+    return KernelType<raw_element_hasher<uint16_t>>::instantiate_with(
+        raw_element_hasher<uint16_t>(), ckb, ckb_offset, dst_tp, dst_arrmeta,
+        src_tp, src_arrmeta, kernreq, ectx, kwds);
+  case 4:
+    return KernelType<raw_element_hasher<uint32_t>>::instantiate_with(
+        raw_element_hasher<uint32_t>(), ckb, ckb_offset, dst_tp, dst_arrmeta,
+        src_tp, src_arrmeta, kernreq, ectx, kwds);
+  case 8:
+    return KernelType<raw_element_hasher<uint64_t>>::instantiate_with(
+        raw_element_hasher<uint64_t>(), ckb, ckb_offset, dst_tp, dst_arrmeta,
+        src_tp, src_arrmeta, kernreq, ectx, kwds);
+  default:
+    break;
+  }
+  return KernelType<element_hasher>::instantiate_with(
+      hasher, ckb, ckb_offset, dst_tp, dst_arrmeta, src_tp, src_arrmeta,
+      kernreq, ectx, kwds);
+}
+
+void get_strided_src(const char *name, const ndt::type &tp,
+                     const char *arrmeta, intptr_t *size, intptr_t *stride,
+                     ndt::type *el_tp, const char **el_meta)
+{
+  if (!tp.get_as_strided(arrmeta, size, stride, el_tp, el_meta)) {
+    stringstream ss;
+    ss << name << " arrfunc: could not process type " << tp;
+    ss << " as a strided dimension";
+    throw type_error(ss.str());
+  }
+}
+
+enum group_mode_t {
+  group_unique,
+  group_unique_inverse,
+  group_value_counts
+};
+
+/**
+ * Groups the elements of a row by value with a hash table, then copies the
+ * first element of each group into the ``values`` var dim. Depending on
+ * the mode, the group of each element or the size of each group is
+ * written alongside.
+ */
+template <typename Hasher>
+struct group_ck : nd::base_kernel<group_ck<Hasher>, kernel_request_host, 1> {
+  typedef group_ck self_type;
+
+  Hasher m_hasher;
+  group_mode_t m_mode;
+  intptr_t m_size, m_src_stride;
+  ndt::type m_values_tp, m_counts_tp;
+  const char *m_values_meta, *m_counts_meta;
+  // Data offsets of the values and the inverse or counts within dst
+  intptr_t m_values_offset, m_second_offset;
+  intptr_t m_inverse_stride;
+
+  group_ck(const Hasher &hasher, group_mode_t mode)
+      : m_hasher(hasher), m_mode(mode), m_size(0), m_src_stride(0),
+        m_values_meta(NULL), m_counts_meta(NULL), m_values_offset(0),
+        m_second_offset(0), m_inverse_stride(0)
+  {
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    element_hash_table<Hasher> table(m_hasher);
+    vector<intptr_t> counts;
+    const char *src0 = src[0];
+    char *inverse = dst + m_second_offset;
+    for (intptr_t i = 0; i < m_size; ++i, src0 += m_src_stride) {
+      intptr_t group = table.insert(src0);
+      if (m_mode == group_unique_inverse) {
+        *reinterpret_cast<intptr_t *>(inverse) = group;
+        inverse += m_inverse_stride;
+      } else if (m_mode == group_value_counts) {
+        if (group == static_cast<intptr_t>(counts.size())) {
+          counts.push_back(1);
+        } else {
+          ++counts[group];
+        }
+      }
+    }
+
+    // Copy the first element of each group
+    intptr_t group_count = table.size();
+    char *values = dst + m_values_offset;
+    ndt::var_dim_element_initialize(m_values_tp, m_values_meta, values,
+                                    group_count);
+    char *values_ptr = reinterpret_cast<var_dim_type_data *>(values)->begin;
+    intptr_t values_stride =
+        reinterpret_cast<const var_dim_type_arrmeta *>(m_values_meta)->stride;
+    ckernel_prefix *copy = this->get_child_ckernel();
+    expr_single_t copy_fn = copy->get_function<expr_single_t>();
+    for (intptr_t group = 0; group < group_count; ++group) {
+      char *child_src = const_cast<char *>(table.get_group_data(group));
+      copy_fn(values_ptr, &child_src, copy);
+      values_ptr += values_stride;
+    }
+
+    if (m_mode == group_value_counts) {
+      char *counts_dst = dst + m_second_offset;
+      ndt::var_dim_element_initialize(m_counts_tp, m_counts_meta, counts_dst,
+                                      group_count);
+      char *counts_ptr =
+          reinterpret_cast<var_dim_type_data *>(counts_dst)->begin;
+      intptr_t counts_stride =
+          reinterpret_cast<const var_dim_type_arrmeta *>(m_counts_meta)
+              ->stride;
+      for (intptr_t group = 0; group < group_count; ++group) {
+        *reinterpret_cast<intptr_t *>(counts_ptr) = counts[group];
+        counts_ptr += counts_stride;
+      }
+    }
+  }
+
+  void destruct_children() { this->get_child_ckernel()->destroy(); }
+
+  static intptr_t instantiate_with(
+      const Hasher &hasher, void *ckb, intptr_t ckb_offset,
+      const ndt::type &dst_tp, const char *dst_arrmeta, const ndt::type *src_tp,
+      const char *const *src_arrmeta, kernel_request_t kernreq,
+      const eval::eval_context *ectx, const nd::array &DYND_UNUSED(kwds))
+  {
+    group_mode_t mode;
+    if (dst_tp.get_type_id() == var_dim_type_id) {
+      mode = group_unique;
+    } else if (dst_tp.extended<ndt::base_struct_type>()->get_field_index(
+                   "inverse") >= 0) {
+      mode = group_unique_inverse;
+    } else {
+      mode = group_value_counts;
+    }
+    self_type *self = self_type::make(ckb, kernreq, ckb_offset, hasher, mode);
+
+    ndt::type src_el_tp;
+    const char *src_el_meta;
+    get_strided_src(mode == group_value_counts ? "value_counts" : "unique",
+                    src_tp[0], src_arrmeta[0], &self->m_size,
+                    &self->m_src_stride, &src_el_tp, &src_el_meta);
+
+    if (mode == group_unique) {
+      self->m_values_tp = dst_tp;
+      self->m_values_meta = dst_arrmeta;
+    } else {
+      const ndt::base_struct_type *bst =
+          dst_tp.extended<ndt::base_struct_type>();
+      const uintptr_t *data_offsets = bst->get_data_offsets(dst_arrmeta);
+      const uintptr_t *arrmeta_offsets = bst->get_arrmeta_offsets_raw();
+      self->m_values_tp = bst->get_field_type(0);
+      self->m_values_meta = dst_arrmeta + arrmeta_offsets[0];
+      self->m_values_offset = data_offsets[0];
+      self->m_second_offset = data_offsets[1];
+      if (mode == group_unique_inverse) {
+        self->m_inverse_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(
+                                     dst_arrmeta + arrmeta_offsets[1])->stride;
+      } else {
+        self->m_counts_tp = bst->get_field_type(1);
+        self->m_counts_meta = dst_arrmeta + arrmeta_offsets[1];
+      }
+    }
+
+    ndt::type dst_el_tp =
+        self->m_values_tp.template extended<ndt::var_dim_type>()
+            ->get_element_type();
+    const char *dst_el_meta = self->m_values_meta + sizeof(var_dim_type_arrmeta);
+    return make_assignment_kernel(ckb, ckb_offset, dst_el_tp, dst_el_meta,
+                                  src_el_tp, src_el_meta, kernel_request_single,
+                                  ectx);
+  }
+};
+
+template <group_mode_t Mode>
+struct group_virtual_ck : nd::base_virtual_kernel<group_virtual_ck<Mode>> {
+  static void resolve_dst_type(
+      char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+      char *DYND_UNUSED(data), ndt::type &dst_tp, intptr_t DYND_UNUSED(nsrc),
+      const ndt::type *src_tp, const nd::array &kwds,
+      const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    ndt::type el_tp = src_tp[0].get_type_at_dimension(NULL, 1);
+    if (!element_hasher::is_hashable(el_tp)) {
+      stringstream ss;
+      ss << (Mode == group_value_counts ? "value_counts" : "unique");
+      ss << " arrfunc: cannot hash values of type " << el_tp;
+      throw type_error(ss.str());
+    }
+    ndt::type values_tp = ndt::make_var_dim(el_tp.get_canonical_type());
+    if (Mode == group_value_counts) {
+      dst_tp = ndt::make_struct(values_tp, "values",
+                                ndt::make_var_dim(ndt::make_type<intptr_t>()),
+                                "counts");
+      return;
+    }
+
+    nd::array return_inverse = kwds.p("return_inverse");
+    if (!return_inverse.is_missing() && return_inverse.as<bool>()) {
+      dst_tp = ndt::make_struct(
+          values_tp, "values",
+          ndt::make_fixed_dim(src_tp[0].get_dim_size(NULL, NULL),
+                              ndt::make_type<intptr_t>()),
+          "inverse");
+    } else {
+      dst_tp = values_tp;
+    }
+  }
+
+  static intptr_t
+  instantiate(char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *ectx, const nd::array &kwds,
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    return instantiate_with_hasher<group_ck>(
+        src_tp[0].get_type_at_dimension(NULL, 1),
+        src_arrmeta[0] + sizeof(fixed_dim_type_arrmeta), ckb, ckb_offset,
+        dst_tp, dst_arrmeta, src_tp, src_arrmeta, kernreq, ectx, kwds);
+  }
+};
+
+/**
+ * Tests each element of a row for membership in a set. The set is hashed
+ * the first time it is seen, and again only when elwise hands over a
+ * different one.
+ */
+template <typename Hasher>
+struct isin_ck : nd::base_kernel<isin_ck<Hasher>, kernel_request_host, 2> {
+  typedef isin_ck self_type;
+
+  Hasher m_hasher;
+  intptr_t m_size, m_src_stride, m_dst_stride;
+  intptr_t m_set_size, m_set_stride;
+  const char *m_set_data;
+  unique_ptr<element_hash_table<Hasher>> m_set;
+
+  isin_ck(const Hasher &hasher)
+      : m_hasher(hasher), m_size(0), m_src_stride(0), m_dst_stride(0),
+        m_set_size(0), m_set_stride(0), m_set_data(NULL)
+  {
+  }
+
+  void single(char *dst, char *const *src)
+  {
+    if (!m_set || src[1] != m_set_data) {
+      m_set.reset(new element_hash_table<Hasher>(m_hasher, m_set_size));
+      m_set_data = src[1];
+      const char *set_ptr = m_set_data;
+      for (intptr_t i = 0; i < m_set_size; ++i, set_ptr += m_set_stride) {
+        m_set->insert(set_ptr);
+      }
+    }
+
+    const element_hash_table<Hasher> &set = *m_set;
+    const char *src0 = src[0];
+    for (intptr_t i = 0; i < m_size;
+         ++i, src0 += m_src_stride, dst += m_dst_stride) {
+      *reinterpret_cast<bool1 *>(dst) = set.find(src0) >= 0;
+    }
+  }
+
+  static intptr_t instantiate_with(
+      const Hasher &hasher, void *ckb, intptr_t ckb_offset,
+      const ndt::type &dst_tp, const char *dst_arrmeta, const ndt::type *src_tp,
+      const char *const *src_arrmeta, kernel_request_t kernreq,
+      const eval::eval_context *DYND_UNUSED(ectx),
+      const nd::array &DYND_UNUSED(kwds))
+  {
+    self_type *self = self_type::make(ckb, kernreq, ckb_offset, hasher);
+
+    intptr_t dst_size;
+    ndt::type src_el_tp, set_el_tp, dst_el_tp;
+    const char *src_el_meta, *set_el_meta, *dst_el_meta;
+    get_strided_src("isin", src_tp[0], src_arrmeta[0], &self->m_size,
+                    &self->m_src_stride, &src_el_tp, &src_el_meta);
+    get_strided_src("isin", src_tp[1], src_arrmeta[1], &self->m_set_size,
+                    &self->m_set_stride, &set_el_tp, &set_el_meta);
+    get_strided_src("isin", dst_tp, dst_arrmeta, &dst_size,
+                    &self->m_dst_stride, &dst_el_tp, &dst_el_meta);
+
+    // The elements of the set are hashed with the arrmeta of the values,
+    // so their layouts must agree
+    element_hasher src_hasher(src_el_tp, src_el_meta),
+        set_hasher(set_el_tp, set_el_meta);
+    const vector<element_hasher::leaf> &src_leaves = src_hasher.get_leaves(),
+                                       &set_leaves = set_hasher.get_leaves();
+    for (size_t i = 0; i < src_leaves.size(); ++i) {
+      if (src_leaves[i].offset != set_leaves[i].offset) {
+        stringstream ss;
+        ss << "isin arrfunc: the values and the set have different layouts "
+              "of type " << src_el_tp;
+        throw type_error(ss.str());
+      }
+    }
+
+    return ckb_offset;
+  }
+};
+
+struct isin_virtual_ck : nd::base_virtual_kernel<isin_virtual_ck> {
+  static void resolve_dst_type(
+      char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+      char *DYND_UNUSED(data), ndt::type &dst_tp, intptr_t DYND_UNUSED(nsrc),
+      const ndt::type *src_tp, const nd::array &DYND_UNUSED(kwds),
+      const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    ndt::type el_tp = src_tp[0].get_type_at_dimension(NULL, 1);
+    if (!element_hasher::is_hashable(el_tp)) {
+      stringstream ss;
+      ss << "isin arrfunc: cannot hash values of type " << el_tp;
+      throw type_error(ss.str());
+    }
+    dst_tp = ndt::make_fixed_dim(src_tp[0].get_dim_size(NULL, NULL),
+                                 ndt::make_type<bool1>());
+  }
+
+  static intptr_t
+  instantiate(char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &dst_tp, const char *dst_arrmeta,
+              intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+              const char *const *src_arrmeta, kernel_request_t kernreq,
+              const eval::eval_context *ectx, const nd::array &kwds,
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    return instantiate_with_hasher<isin_ck>(
+        src_tp[0].get_type_at_dimension(NULL, 1),
+        src_arrmeta[0] + sizeof(fixed_dim_type_arrmeta), ckb, ckb_offset,
+        dst_tp, dst_arrmeta, src_tp, src_arrmeta, kernreq, ectx, kwds);
+  }
+};
+
+} // anonymous namespace
+
+nd::arrfunc nd::unique::make()
+{
+  // Not lifted with elwise, which can't tell how many dimensions the
+  // return type has before it is resolved
+  return arrfunc::make<group_virtual_ck<group_unique>>(
+      ndt::type("(N * T, return_inverse: ?bool) -> R"), 0);
+}
+
+nd::arrfunc nd::value_counts::make()
+{
+  return functional::elwise(arrfunc::make<group_virtual_ck<group_value_counts>>(
+      ndt::type("(N * T) -> {values: var * T, counts: var * intptr}"), 0));
+}
+
+nd::arrfunc nd::isin::make()
+{
+  return functional::elwise(arrfunc::make<isin_virtual_ck>(
+      ndt::type("(N * T, M * T) -> N * bool"), 0));
+}
+
+struct nd::unique nd::unique;
+
+struct nd::value_counts nd::value_counts;
+
+struct nd::isin nd::isin;
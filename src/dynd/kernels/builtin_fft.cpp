@@ -0,0 +1,684 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include <dynd/func/call_callable.hpp>
+#include <dynd/kernels/builtin_fft.hpp>
+
+using namespace dynd;
+
+namespace {
+
+// Prime factors above this are done with Bluestein's algorithm
+const intptr_t max_generic_radix = 31;
+
+const double pi = 3.14159265358979323846;
+
+inline complex<double> conj_of(const complex<double> &z)
+{
+  return complex<double>(z.real(), -z.imag());
+}
+
+inline complex<double> mul(const complex<double> &a, const complex<double> &b)
+{
+  return complex<double>(a.real() * b.real() - a.imag() * b.imag(),
+                         a.real() * b.imag() + a.imag() * b.real());
+}
+
+// The caches are never destroyed, so plans stay valid during static
+// destruction
+template <typename KeyType, typename PlanType>
+std::map<KeyType, std::shared_ptr<const PlanType>> &get_plan_cache()
+{
+  static std::map<KeyType, std::shared_ptr<const PlanType>> *cache =
+      new std::map<KeyType, std::shared_ptr<const PlanType>>;
+  return *cache;
+}
+
+std::mutex &get_plan_cache_mutex()
+{
+  static std::mutex *m = new std::mutex;
+  return *m;
+}
+
+// Plans are made outside the lock, as Bluestein plans get other plans
+template <typename KeyType, typename PlanType, typename... A>
+std::shared_ptr<const PlanType> get_cached_plan(const KeyType &key,
+                                                A... args)
+{
+  std::map<KeyType, std::shared_ptr<const PlanType>> &cache =
+      get_plan_cache<KeyType, PlanType>();
+  {
+    std::lock_guard<std::mutex> lock(get_plan_cache_mutex());
+    typename std::map<KeyType, std::shared_ptr<const PlanType>>::iterator it =
+        cache.find(key);
+    if (it != cache.end()) {
+      return it->second;
+    }
+  }
+  std::shared_ptr<const PlanType> plan = std::make_shared<PlanType>(args...);
+  std::lock_guard<std::mutex> lock(get_plan_cache_mutex());
+  return cache.insert(std::make_pair(key, plan)).first->second;
+}
+
+void butterfly2(complex<double> *out, intptr_t fstride, intptr_t m,
+                const complex<double> *twiddles)
+{
+  complex<double> *out1 = out + m;
+  for (intptr_t k = 0; k < m; ++k) {
+    complex<double> t = mul(out1[k], twiddles[k * fstride]);
+    out1[k] = out[k] - t;
+    out[k] += t;
+  }
+}
+
+void butterfly3(complex<double> *out, intptr_t fstride, intptr_t m,
+                const complex<double> *twiddles)
+{
+  double epi3 = twiddles[fstride * m].imag();
+  for (intptr_t k = 0; k < m; ++k) {
+    complex<double> s1 = mul(out[k + m], twiddles[k * fstride]);
+    complex<double> s2 = mul(out[k + 2 * m], twiddles[2 * k * fstride]);
+    complex<double> s3 = s1 + s2;
+    complex<double> s0 = s1 - s2;
+    complex<double> h(out[k].real() - 0.5 * s3.real(),
+                      out[k].imag() - 0.5 * s3.imag());
+    s0 = complex<double>(s0.real() * epi3, s0.imag() * epi3);
+    out[k] += s3;
+    out[k + m] = complex<double>(h.real() - s0.imag(), h.imag() + s0.real());
+    out[k + 2 * m] =
+        complex<double>(h.real() + s0.imag(), h.imag() - s0.real());
+  }
+}
+
+void butterfly4(complex<double> *out, intptr_t fstride, intptr_t m,
+                const complex<double> *twiddles, int sign)
+{
+  for (intptr_t k = 0; k < m; ++k) {
+    complex<double> s0 = mul(out[k + m], twiddles[k * fstride]);
+    complex<double> s1 = mul(out[k + 2 * m], twiddles[2 * k * fstride]);
+    complex<double> s2 = mul(out[k + 3 * m], twiddles[3 * k * fstride]);
+    complex<double> s5 = out[k] - s1;
+    complex<double> s6 = out[k] + s1;
+    complex<double> s3 = s0 + s2;
+    complex<double> s4 = s0 - s2;
+    out[k] = s6 + s3;
+    out[k + 2 * m] = s6 - s3;
+    if (sign < 0) {
+      out[k + m] = complex<double>(s5.real() + s4.imag(), s5.imag() - s4.real());
+      out[k + 3 * m] =
+          complex<double>(s5.real() - s4.imag(), s5.imag() + s4.real());
+    } else {
+      out[k + m] = complex<double>(s5.real() - s4.imag(), s5.imag() + s4.real());
+      out[k + 3 * m] =
+          complex<double>(s5.real() + s4.imag(), s5.imag() - s4.real());
+    }
+  }
+}
+
+void butterfly5(complex<double> *out, intptr_t fstride, intptr_t m,
+                const complex<double> *twiddles)
+{
+  complex<double> ya = twiddles[fstride * m];
+  complex<double> yb = twiddles[2 * fstride * m];
+  for (intptr_t k = 0; k < m; ++k) {
+    complex<double> s0 = out[k];
+    complex<double> s1 = mul(out[k + m], twiddles[k * fstride]);
+    complex<double> s2 = mul(out[k + 2 * m], twiddles[2 * k * fstride]);
+    complex<double> s3 = mul(out[k + 3 * m], twiddles[3 * k * fstride]);
+    complex<double> s4 = mul(out[k + 4 * m], twiddles[4 * k * fstride]);
+    complex<double> s7 = s1 + s4, s10 = s1 - s4;
+    complex<double> s8 = s2 + s3, s9 = s2 - s3;
+
+    out[k] = s0 + s7 + s8;
+
+    complex<double> s5(s0.real() + s7.real() * ya.real() +
+                           s8.real() * yb.real(),
+                       s0.imag() + s7.imag() * ya.real() +
+                           s8.imag() * yb.real());
+    complex<double> s6(s10.imag() * ya.imag() + s9.imag() * yb.imag(),
+                       -s10.real() * ya.imag() - s9.real() * yb.imag());
+    out[k + m] = s5 - s6;
+    out[k + 4 * m] = s5 + s6;
+
+    complex<double> s11(s0.real() + s7.real() * yb.real() +
+                            s8.real() * ya.real(),
+                        s0.imag() + s7.imag() * yb.real() +
+                            s8.imag() * ya.real());
+    complex<double> s12(-s10.imag() * yb.imag() + s9.imag() * ya.imag(),
+                        s10.real() * yb.imag() - s9.real() * ya.imag());
+    out[k + 2 * m] = s11 + s12;
+    out[k + 3 * m] = s11 - s12;
+  }
+}
+
+void butterfly_generic(complex<double> *out, intptr_t fstride, intptr_t m,
+                       intptr_t p, const complex<double> *twiddles,
+                       intptr_t n, complex<double> *scratch)
+{
+  for (intptr_t u = 0; u < m; ++u) {
+    for (intptr_t q = 0; q < p; ++q) {
+      scratch[q] = out[u + q * m];
+    }
+    for (intptr_t q1 = 0; q1 < p; ++q1) {
+      intptr_t k = u + q1 * m;
+      intptr_t step = fstride * k % n;
+      intptr_t t = 0;
+      complex<double> sum = scratch[0];
+      for (intptr_t q = 1; q < p; ++q) {
+        t += step;
+        if (t >= n) {
+          t -= n;
+        }
+        sum += mul(scratch[q], twiddles[t]);
+      }
+      out[k] = sum;
+    }
+  }
+}
+
+} // anonymous namespace
+
+nd::detail::fft_plan::fft_plan(intptr_t n, int sign)
+    : m_n(n), m_sign(sign), m_scratch_size(0), m_m(0)
+{
+  if (n < 1) {
+    throw std::invalid_argument("fft sizes must be positive");
+  }
+
+  // Factors of 4 first, then 2, then odd primes
+  intptr_t p = 4, rest = n;
+  while (rest > 1) {
+    while (rest % p != 0) {
+      p = (p == 4) ? 2 : ((p == 2) ? 3 : p + 2);
+      if (p * p > rest) {
+        p = rest;
+      }
+    }
+    rest /= p;
+    factor f = {p, rest};
+    m_factors.push_back(f);
+  }
+
+  if (!m_factors.empty() &&
+      m_factors.back().radix > max_generic_radix) {
+    // The chirp exponent is taken modulo 2 n, which keeps its argument small
+    m_factors.clear();
+    m_m = 1;
+    while (m_m < 2 * n - 1) {
+      m_m *= 2;
+    }
+    m_forward = get(m_m, -1);
+    m_backward = get(m_m, 1);
+    m_chirp.resize(n);
+    for (intptr_t k = 0; k < n; ++k) {
+      unsigned long long k2 = static_cast<unsigned long long>(k) * k %
+                              (2 * static_cast<unsigned long long>(n));
+      double theta = sign * pi * static_cast<double>(k2) / n;
+      m_chirp[k] = complex<double>(std::cos(theta), std::sin(theta));
+    }
+    std::vector<complex<double>> filter(m_m, complex<double>(0.0, 0.0));
+    filter[0] = conj_of(m_chirp[0]);
+    for (intptr_t k = 1; k < n; ++k) {
+      filter[k] = filter[m_m - k] = conj_of(m_chirp[k]);
+    }
+    m_chirp_fft.resize(m_m);
+    m_forward->execute(filter.data(), m_chirp_fft.data(), NULL);
+    for (intptr_t k = 0; k < m_m; ++k) {
+      m_chirp_fft[k] = m_chirp_fft[k] / static_cast<double>(m_m);
+    }
+    m_scratch_size = 2 * m_m;
+    return;
+  }
+
+  m_twiddles.resize(n);
+  for (intptr_t k = 0; k < n; ++k) {
+    double theta = sign * 2 * pi * static_cast<double>(k) / n;
+    m_twiddles[k] = complex<double>(std::cos(theta), std::sin(theta));
+  }
+  for (size_t i = 0; i < m_factors.size(); ++i) {
+    if (m_factors[i].radix > 5) {
+      m_scratch_size = std::max(m_scratch_size, m_factors[i].radix);
+    }
+  }
+}
+
+std::shared_ptr<const nd::detail::fft_plan>
+nd::detail::fft_plan::get(intptr_t n, int sign)
+{
+  return get_cached_plan<std::pair<intptr_t, int>, fft_plan>(
+      std::make_pair(n, sign), n, sign);
+}
+
+void nd::detail::fft_plan::work(complex<double> *out,
+                                const complex<double> *in, intptr_t fstride,
+                                const factor *f, complex<double> *scratch) const
+{
+  intptr_t p = f->radix, m = f->size;
+  if (m == 1) {
+    for (intptr_t j = 0; j < p; ++j) {
+      out[j] = in[j * fstride];
+    }
+  } else {
+    for (intptr_t j = 0; j < p; ++j) {
+      work(out + j * m, in + j * fstride, fstride * p, f + 1, scratch);
+    }
+  }
+
+  switch (p) {
+  case 2:
+    butterfly2(out, fstride, m, m_twiddles.data());
+    break;
+  case 3:
+    butterfly3(out, fstride, m, m_twiddles.data());
+    break;
+  case 4:
+    butterfly4(out, fstride, m, m_twiddles.data(), m_sign);
+    break;
+  case 5:
+    butterfly5(out, fstride, m, m_twiddles.data());
+    break;
+  default:
+    butterfly_generic(out, fstride, m, p, m_twiddles.data(), m_n, scratch);
+    break;
+  }
+}
+
+void nd::detail::fft_plan::execute(const complex<double> *in,
+                                   complex<double> *out,
+                                   complex<double> *scratch) const
+{
+  if (m_m != 0) {
+    complex<double> *a = scratch, *b = scratch + m_m;
+    for (intptr_t k = 0; k < m_n; ++k) {
+      a[k] = mul(in[k], m_chirp[k]);
+    }
+    for (intptr_t k = m_n; k < m_m; ++k) {
+      a[k] = complex<double>(0.0, 0.0);
+    }
+    m_forward->execute(a, b, NULL);
+    for (intptr_t k = 0; k < m_m; ++k) {
+      b[k] = mul(b[k], m_chirp_fft[k]);
+    }
+    m_backward->execute(b, a, NULL);
+    for (intptr_t k = 0; k < m_n; ++k) {
+      out[k] = mul(a[k], m_chirp[k]);
+    }
+  } else if (m_factors.empty()) {
+    out[0] = in[0];
+  } else {
+    work(out, in, 1, m_factors.data(), scratch);
+  }
+}
+
+nd::detail::rfft_plan::rfft_plan(intptr_t n) : m_n(n), m_scratch_size(0)
+{
+  if (n < 1) {
+    throw std::invalid_argument("fft sizes must be positive");
+  }
+
+  intptr_t size = (n % 2 == 0) ? n / 2 : n;
+  m_forward = fft_plan::get(size, -1);
+  m_backward = fft_plan::get(size, 1);
+  m_scratch_size =
+      2 * size + std::max(m_forward->get_scratch_size(),
+                     m_backward->get_scratch_size());
+  if (n % 2 == 0) {
+    m_twiddles.resize(n / 2 + 1);
+    for (intptr_t k = 0; k <= n / 2; ++k) {
+      double theta = -2 * pi * static_cast<double>(k) / n;
+      m_twiddles[k] = complex<double>(std::cos(theta), std::sin(theta));
+    }
+  }
+}
+
+std::shared_ptr<const nd::detail::rfft_plan>
+nd::detail::rfft_plan::get(intptr_t n)
+{
+  return get_cached_plan<intptr_t, rfft_plan>(n, n);
+}
+
+void nd::detail::rfft_plan::forward(const double *in, complex<double> *out,
+                                    complex<double> *scratch) const
+{
+  if (m_n % 2 != 0) {
+    complex<double> *z = scratch, *zf = scratch + m_n;
+    for (intptr_t k = 0; k < m_n; ++k) {
+      z[k] = complex<double>(in[k], 0.0);
+    }
+    m_forward->execute(z, zf, scratch + 2 * m_n);
+    for (intptr_t k = 0; k <= m_n / 2; ++k) {
+      out[k] = zf[k];
+    }
+    return;
+  }
+
+  // Pack the even and odd samples as the real and imaginary parts of a
+  // complex sequence of half the size, and untangle its transform
+  intptr_t h = m_n / 2;
+  complex<double> *z = scratch, *zf = scratch + h;
+  for (intptr_t k = 0; k < h; ++k) {
+    z[k] = complex<double>(in[2 * k], in[2 * k + 1]);
+  }
+  m_forward->execute(z, zf, scratch + 2 * h);
+  for (intptr_t k = 0; k <= h; ++k) {
+    complex<double> a = zf[k % h], b = conj_of(zf[(h - k) % h]);
+    complex<double> e = (a + b) * 0.5, d = a - b;
+    // o = (a - b) / 2i
+    complex<double> o(0.5 * d.imag(), -0.5 * d.real());
+    out[k] = e + mul(m_twiddles[k], o);
+  }
+}
+
+void nd::detail::rfft_plan::backward(const complex<double> *in, double *out,
+                                     complex<double> *scratch) const
+{
+  if (m_n % 2 != 0) {
+    complex<double> *z = scratch, *zf = scratch + m_n;
+    z[0] = complex<double>(in[0].real(), 0.0);
+    for (intptr_t k = 1; k <= m_n / 2; ++k) {
+      z[k] = in[k];
+      z[m_n - k] = conj_of(in[k]);
+    }
+    m_backward->execute(z, zf, scratch + 2 * m_n);
+    for (intptr_t k = 0; k < m_n; ++k) {
+      out[k] = zf[k].real();
+    }
+    return;
+  }
+
+  intptr_t h = m_n / 2;
+  complex<double> *z = scratch, *zf = scratch + h;
+  for (intptr_t k = 0; k < h; ++k) {
+    complex<double> a = in[k], b = conj_of(in[h - k]);
+    if (k == 0) {
+      a = complex<double>(a.real(), 0.0);
+      b = complex<double>(b.real(), 0.0);
+    }
+    complex<double> d = mul(a - b, conj_of(m_twiddles[k]));
+    // z = (a + b) + i (a - b) / w
+    z[k] = (a + b) + complex<double>(-d.imag(), d.real());
+  }
+  m_backward->execute(z, zf, scratch + 2 * h);
+  for (intptr_t k = 0; k < h; ++k) {
+    out[2 * k] = zf[k].real();
+    out[2 * k + 1] = zf[k].imag();
+  }
+}
+
+namespace {
+
+struct line_loop {
+  intptr_t ndim, axis;
+  const intptr_t *dst_shape, *dst_stride, *src_shape, *src_stride;
+};
+
+// Calls f(dst_line, src_line) for each line along the axis, with src_line
+// NULL where the line is in the zero padding of the source
+template <typename F>
+void for_each_line(const line_loop &loop, intptr_t dim, char *dst,
+                   const char *src, F &f)
+{
+  if (dim == loop.ndim) {
+    f(dst, src);
+  } else if (dim == loop.axis) {
+    for_each_line(loop, dim + 1, dst, src, f);
+  } else {
+    for (intptr_t i = 0; i < loop.dst_shape[dim]; ++i) {
+      for_each_line(loop, dim + 1, dst + i * loop.dst_stride[dim],
+                    (src != NULL && i < loop.src_shape[dim])
+                        ? src + i * loop.src_stride[dim]
+                        : NULL,
+                    f);
+    }
+  }
+}
+
+template <typename T>
+void gather_line(T *out, intptr_t n, const char *src, intptr_t src_size,
+                 intptr_t src_stride)
+{
+  intptr_t count = (src == NULL) ? 0 : std::min(n, src_size);
+  for (intptr_t i = 0; i < count; ++i) {
+    out[i] = *reinterpret_cast<const T *>(src + i * src_stride);
+  }
+  for (intptr_t i = count; i < n; ++i) {
+    out[i] = T(0);
+  }
+}
+
+template <typename T>
+void scatter_line(char *dst, intptr_t dst_stride, const T *in, intptr_t n)
+{
+  for (intptr_t i = 0; i < n; ++i) {
+    *reinterpret_cast<T *>(dst + i * dst_stride) = in[i];
+  }
+}
+
+// A complex transform along an axis, or a copy if plan is NULL
+struct complex_line_fn {
+  const nd::detail::fft_plan *plan;
+  intptr_t n, dst_stride, src_size, src_stride;
+  complex<double> *buffer;
+
+  void operator()(char *dst, const char *src)
+  {
+    complex<double> *in = buffer, *out = buffer + n;
+    gather_line(in, n, src, src_size, src_stride);
+    if (plan != NULL) {
+      plan->execute(in, out, out + n);
+      scatter_line(dst, dst_stride, out, n);
+    } else {
+      scatter_line(dst, dst_stride, in, n);
+    }
+  }
+};
+
+struct real_forward_line_fn {
+  const nd::detail::rfft_plan *plan;
+  intptr_t n, dst_stride, src_size, src_stride;
+  complex<double> *buffer;
+
+  void operator()(char *dst, const char *src)
+  {
+    double *in = reinterpret_cast<double *>(buffer);
+    complex<double> *out = buffer + n;
+    gather_line(in, n, src, src_size, src_stride);
+    plan->forward(in, out, out + n / 2 + 1);
+    scatter_line(dst, dst_stride, out, n / 2 + 1);
+  }
+};
+
+struct real_backward_line_fn {
+  const nd::detail::rfft_plan *plan;
+  intptr_t n, dst_stride, src_size, src_stride;
+  complex<double> *buffer;
+
+  void operator()(char *dst, const char *src)
+  {
+    complex<double> *in = buffer;
+    double *out = reinterpret_cast<double *>(buffer + n / 2 + 1);
+    gather_line(in, n / 2 + 1, src, src_size, src_stride);
+    plan->backward(in, out, buffer + n / 2 + 1 + n);
+    scatter_line(dst, dst_stride, out, n);
+  }
+};
+
+} // anonymous namespace
+
+nd::detail::strided_fft::strided_fft(fft_kind_t kind, int sign, intptr_t ndim,
+                                     const size_stride_t *dst_size_stride,
+                                     const size_stride_t *src_size_stride,
+                                     const std::vector<intptr_t> &axes,
+                                     intptr_t n)
+    : m_kind(kind), m_sign(sign), m_ndim(ndim), m_axes(axes)
+{
+  for (intptr_t i = 0; i < ndim; ++i) {
+    m_dst_shape.push_back(dst_size_stride[i].dim_size);
+    m_dst_stride.push_back(dst_size_stride[i].stride);
+    m_src_shape.push_back(src_size_stride[i].dim_size);
+    m_src_stride.push_back(src_size_stride[i].stride);
+  }
+
+  // The axes of the complex passes, which for real transforms are all but
+  // the last
+  size_t ncomplex = m_axes.size();
+  if (kind != complex_to_complex_fft && !m_axes.empty()) {
+    --ncomplex;
+    if (n < 1) {
+      throw std::invalid_argument("real fft sizes must be positive");
+    }
+    m_rplan = rfft_plan::get(n);
+    m_buffer.resize(3 * n + 2 + m_rplan->get_scratch_size());
+  }
+  int complex_sign = (kind == complex_to_complex_fft)
+                         ? sign
+                         : (kind == real_to_complex_fft ? -1 : 1);
+  intptr_t buffer_size = 2 * (ndim > 0 ? m_dst_shape.back() : 1);
+  for (size_t i = 0; i < ncomplex; ++i) {
+    intptr_t size = m_dst_shape[m_axes[i]];
+    if (size > 0) {
+      m_plans.push_back(fft_plan::get(size, complex_sign));
+      buffer_size =
+          std::max(buffer_size, 2 * size + m_plans.back()->get_scratch_size());
+    } else {
+      m_plans.push_back(std::shared_ptr<const fft_plan>());
+    }
+  }
+  if (static_cast<intptr_t>(m_buffer.size()) < buffer_size) {
+    m_buffer.resize(buffer_size);
+  }
+
+  if (kind == complex_to_real_fft && ncomplex > 0) {
+    m_temp_shape = m_dst_shape;
+    m_temp_shape[m_axes.back()] = n / 2 + 1;
+    m_temp_stride.resize(ndim);
+    intptr_t size = 1;
+    for (intptr_t i = ndim - 1; i >= 0; --i) {
+      m_temp_stride[i] = size * sizeof(complex<double>);
+      size *= m_temp_shape[i];
+    }
+    m_temp.resize(size);
+  }
+}
+
+void nd::detail::strided_fft::execute(char *dst, const char *src)
+{
+  for (intptr_t i = 0; i < m_ndim; ++i) {
+    if (m_dst_shape[i] == 0) {
+      return;
+    }
+  }
+
+  if (m_kind == complex_to_complex_fft) {
+    // The first pass reads the source, and the others are in place
+    for (size_t i = 0; i < std::max<size_t>(m_axes.size(), 1); ++i) {
+      intptr_t axis = m_axes.empty() ? m_ndim - 1 : m_axes[i];
+      bool first = (i == 0);
+      line_loop loop = {m_ndim, axis, m_dst_shape.data(), m_dst_stride.data(),
+                        first ? m_src_shape.data() : m_dst_shape.data(),
+                        first ? m_src_stride.data() : m_dst_stride.data()};
+      intptr_t n = (axis >= 0) ? m_dst_shape[axis] : 1;
+      complex_line_fn f = {m_axes.empty() ? NULL : m_plans[i].get(), n,
+                           (axis >= 0) ? m_dst_stride[axis] : 0,
+                           (axis >= 0) ? loop.src_shape[axis] : 1,
+                           (axis >= 0) ? loop.src_stride[axis] : 0,
+                           m_buffer.data()};
+      for_each_line(loop, 0, dst, first ? src : dst, f);
+    }
+  } else if (m_kind == real_to_complex_fft) {
+    intptr_t last = m_axes.back();
+    line_loop loop = {m_ndim, last, m_dst_shape.data(), m_dst_stride.data(),
+                      m_src_shape.data(), m_src_stride.data()};
+    real_forward_line_fn f = {m_rplan.get(), m_rplan->get_size(),
+                              m_dst_stride[last], m_src_shape[last],
+                              m_src_stride[last], m_buffer.data()};
+    for_each_line(loop, 0, dst, src, f);
+    for (size_t i = 0; i + 1 < m_axes.size(); ++i) {
+      intptr_t axis = m_axes[i];
+      line_loop loop = {m_ndim, axis, m_dst_shape.data(), m_dst_stride.data(),
+                        m_dst_shape.data(), m_dst_stride.data()};
+      complex_line_fn f = {m_plans[i].get(), m_dst_shape[axis],
+                           m_dst_stride[axis], m_dst_shape[axis],
+                           m_dst_stride[axis], m_buffer.data()};
+      for_each_line(loop, 0, dst, dst, f);
+    }
+  } else {
+    intptr_t last = m_axes.back();
+    const char *rsrc = src;
+    const intptr_t *rsrc_shape = m_src_shape.data(),
+                   *rsrc_stride = m_src_stride.data();
+    if (m_axes.size() > 1) {
+      // The complex passes go through the temporary, so the source is
+      // left as it is
+      char *temp = reinterpret_cast<char *>(m_temp.data());
+      for (size_t i = 0; i + 1 < m_axes.size(); ++i) {
+        intptr_t axis = m_axes[i];
+        bool first = (i == 0);
+        line_loop loop = {m_ndim, axis, m_temp_shape.data(),
+                          m_temp_stride.data(),
+                          first ? m_src_shape.data() : m_temp_shape.data(),
+                          first ? m_src_stride.data() : m_temp_stride.data()};
+        complex_line_fn f = {m_plans[i].get(), m_temp_shape[axis],
+                             m_temp_stride[axis], loop.src_shape[axis],
+                             loop.src_stride[axis], m_buffer.data()};
+        for_each_line(loop, 0, temp, first ? src : temp, f);
+      }
+      rsrc = temp;
+      rsrc_shape = m_temp_shape.data();
+      rsrc_stride = m_temp_stride.data();
+    }
+    line_loop loop = {m_ndim, last, m_dst_shape.data(), m_dst_stride.data(),
+                      rsrc_shape, rsrc_stride};
+    real_backward_line_fn f = {m_rplan.get(), m_rplan->get_size(),
+                               m_dst_stride[last], rsrc_shape[last],
+                               rsrc_stride[last], m_buffer.data()};
+    for_each_line(loop, 0, dst, rsrc, f);
+  }
+}
+
+std::vector<intptr_t> nd::detail::get_fft_axes(const nd::array &kwds,
+                                               intptr_t ndim)
+{
+  std::vector<intptr_t> axes;
+  nd::array a = kwds.p("axes");
+  if (a.is_missing()) {
+    for (intptr_t i = 0; i < ndim; ++i) {
+      axes.push_back(i);
+    }
+    return axes;
+  }
+
+  if (a.get_type().get_type_id() == pointer_type_id) {
+    a = a.f("dereference");
+  }
+  for (intptr_t i = 0; i < a.get_dim_size(); ++i) {
+    intptr_t axis = a(i).as<intptr_t>();
+    if (axis < 0 || axis >= ndim) {
+      throw std::invalid_argument("fft axis is out of range");
+    }
+    axes.push_back(axis);
+  }
+  return axes;
+}
+
+std::vector<intptr_t> nd::detail::get_fft_shape(const nd::array &kwds)
+{
+  std::vector<intptr_t> shape;
+  nd::array s = kwds.p("shape");
+  if (!s.is_missing()) {
+    if (s.get_type().get_type_id() == pointer_type_id) {
+      s = s.f("dereference");
+    }
+    for (intptr_t i = 0; i < s.get_dim_size(); ++i) {
+      shape.push_back(s(i).as<intptr_t>());
+    }
+  }
+  return shape;
+}
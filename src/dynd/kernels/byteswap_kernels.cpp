@@ -3,78 +3,163 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <cstring>
 #include <stdexcept>
 
-#include <dynd/diagnostics.hpp>
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/byteswap_kernels.hpp>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) &&        \
+    !defined(__CUDACC__)
+#include <cpuid.h>
+#include <tmmintrin.h>
+#define DYND_BYTESWAP_SSSE3 1
+#else
+#define DYND_BYTESWAP_SSSE3 0
+#endif
+
 using namespace std;
 using namespace dynd;
 
 namespace {
 
-template <typename T>
-struct aligned_fixed_size_byteswap
-    : nd::base_kernel<aligned_fixed_size_byteswap<T>, kernel_request_host, 1> {
-  void single(char *dst, char *const *src)
-  {
-    DYND_ASSERT_ALIGNED(dst, 0, sizeof(T),
-                        "type: " << ndt::type(dynd::type_id_of<T>::value));
-    DYND_ASSERT_ALIGNED(src, 0, sizeof(T),
-                        "type: " << ndt::type(dynd::type_id_of<T>::value));
-    *reinterpret_cast<T *>(dst) =
-        byteswap_value(**reinterpret_cast<T *const *>(src));
+/**
+ * Byteswaps one value of the given size. The data may be unaligned, and
+ * may be swapped in place.
+ */
+template <size_t Size>
+void byteswap_bytes(char *dst, const char *src);
+
+template <>
+inline void byteswap_bytes<2>(char *dst, const char *src)
+{
+  uint16_t value;
+  memcpy(&value, src, sizeof(value));
+  value = byteswap_value(value);
+  memcpy(dst, &value, sizeof(value));
+}
+
+template <>
+inline void byteswap_bytes<4>(char *dst, const char *src)
+{
+  uint32_t value;
+  memcpy(&value, src, sizeof(value));
+  value = byteswap_value(value);
+  memcpy(dst, &value, sizeof(value));
+}
+
+template <>
+inline void byteswap_bytes<8>(char *dst, const char *src)
+{
+  uint64_t value;
+  memcpy(&value, src, sizeof(value));
+  value = byteswap_value(value);
+  memcpy(dst, &value, sizeof(value));
+}
+
+template <>
+inline void byteswap_bytes<16>(char *dst, const char *src)
+{
+  uint64_t value[2];
+  memcpy(value, src, sizeof(value));
+  uint64_t swapped[2] = {byteswap_value(value[1]), byteswap_value(value[0])};
+  memcpy(dst, swapped, sizeof(swapped));
+}
+
+#if DYND_BYTESWAP_SSSE3
+bool cpu_has_ssse3()
+{
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return false;
   }
+  return (ecx & bit_SSSE3) != 0;
+}
 
-  void strided(char *dst, intptr_t dst_stride, char *const *src,
-               const intptr_t *src_stride, size_t count)
-  {
-    DYND_ASSERT_ALIGNED(dst, dst_stride, sizeof(T),
-                        "type: " << ndt::type(dynd::type_id_of<T>::value));
-    DYND_ASSERT_ALIGNED(src, src_stride, sizeof(T),
-                        "type: " << ndt::type(dynd::type_id_of<T>::value));
-    char *src0 = src[0];
-    intptr_t src0_stride = src_stride[0];
-    for (size_t i = 0; i != count; ++i) {
-      *reinterpret_cast<T *>(dst) =
-          byteswap_value(*reinterpret_cast<T *>(src0));
-      dst += dst_stride;
-      src0 += src0_stride;
-    }
+/**
+ * Byteswaps each ``Size`` byte value in the whole 16 byte blocks of
+ * ``nbytes``, with one pshufb per block. Returns the number of bytes
+ * done.
+ */
+template <size_t Size>
+__attribute__((target("ssse3"))) size_t
+byteswap_blocks_ssse3(char *dst, const char *src, size_t nbytes)
+{
+  char m[16];
+  for (size_t i = 0; i < 16; ++i) {
+    m[i] = static_cast<char>((i / Size) * Size + (Size - 1 - i % Size));
   }
-};
+  const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(m));
+  size_t i = 0;
+  for (; i + 32 <= nbytes; i += 32) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                     _mm_shuffle_epi8(a, mask));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 16),
+                     _mm_shuffle_epi8(b, mask));
+  }
+  if (i + 16 <= nbytes) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                     _mm_shuffle_epi8(a, mask));
+    i += 16;
+  }
+  return i;
+}
 
-template <typename T>
-struct aligned_fixed_size_pairwise_byteswap_kernel
-    : nd::base_kernel<aligned_fixed_size_pairwise_byteswap_kernel<T>,
-                      kernel_request_host, 1> {
-  void single(char *dst, char *const *src)
+bool use_ssse3()
+{
+  static const bool result = cpu_has_ssse3();
+  return result;
+}
+#endif
+
+/** Byteswaps ``count`` contiguous values of the given size */
+template <size_t Size>
+void byteswap_contiguous(char *dst, const char *src, size_t count)
+{
+  size_t i = 0;
+#if DYND_BYTESWAP_SSSE3
+  if (use_ssse3()) {
+    i = byteswap_blocks_ssse3<Size>(dst, src, count * Size) / Size;
+  }
+#endif
+  for (; i < count; ++i) {
+    byteswap_bytes<Size>(dst + i * Size, src + i * Size);
+  }
+}
+
+/**
+ * Byteswaps elements made of ``N`` values of ``Size`` bytes, swapping each
+ * value separately. N is 1 for a plain byteswap, and 2 for the pairwise
+ * byteswap of complex types.
+ */
+template <size_t Size, int N>
+struct fixed_size_byteswap_ck
+    : nd::base_kernel<fixed_size_byteswap_ck<Size, N>, kernel_request_host,
+                      1> {
+  static void swap_element(char *dst, const char *src)
   {
-    DYND_ASSERT_ALIGNED(dst, 0, sizeof(T),
-                        "type: " << ndt::type(dynd::type_id_of<T>::value));
-    DYND_ASSERT_ALIGNED(src, 0, sizeof(T),
-                        "type: " << ndt::type(dynd::type_id_of<T>::value));
-    *reinterpret_cast<T *>(dst) =
-        byteswap_value(**reinterpret_cast<T *const *>(src));
-    *(reinterpret_cast<T *>(dst) + 1) =
-        byteswap_value(*(*reinterpret_cast<T *const *>(src) + 1));
+    for (int i = 0; i < N; ++i) {
+      byteswap_bytes<Size>(dst + i * Size, src + i * Size);
+    }
   }
 
+  void single(char *dst, char *const *src) { swap_element(dst, src[0]); }
+
   void strided(char *dst, intptr_t dst_stride, char *const *src,
-                      const intptr_t *src_stride, size_t count)
+               const intptr_t *src_stride, size_t count)
   {
-    DYND_ASSERT_ALIGNED(dst, dst_stride, sizeof(T),
-                        "type: " << ndt::type(dynd::type_id_of<T>::value));
-    DYND_ASSERT_ALIGNED(src, src_stride, sizeof(T),
-                        "type: " << ndt::type(dynd::type_id_of<T>::value));
-    char *src0 = src[0];
+    const char *src0 = src[0];
     intptr_t src0_stride = src_stride[0];
+    if (dst_stride == Size * N && src0_stride == Size * N) {
+      byteswap_contiguous<Size>(dst, src0, count * N);
+      return;
+    }
     for (size_t i = 0; i != count; ++i) {
-      *reinterpret_cast<T *>(dst) =
-          byteswap_value(**reinterpret_cast<T *const *>(src0));
-      *(reinterpret_cast<T *>(dst) + 1) =
-          byteswap_value(*(*reinterpret_cast<T *const *>(src0) + 1));
+      swap_element(dst, src0);
       dst += dst_stride;
       src0 += src0_stride;
     }
@@ -135,25 +220,25 @@ struct pairwise_byteswap_ck
 };
 } // anonymous namespace
 
-size_t dynd::make_byteswap_assignment_function(void *ckb, intptr_t ckb_offset,
-                                               intptr_t data_size,
-                                               intptr_t data_alignment,
-                                               kernel_request_t kernreq)
+size_t dynd::make_byteswap_assignment_function(
+    void *ckb, intptr_t ckb_offset, intptr_t data_size,
+    intptr_t DYND_UNUSED(data_alignment), kernel_request_t kernreq)
 {
-  if (data_size == data_alignment) {
-    switch (data_size) {
-    case 2:
-      aligned_fixed_size_byteswap<uint16_t>::make(ckb, kernreq, ckb_offset);
-      return ckb_offset;
-    case 4:
-      aligned_fixed_size_byteswap<uint32_t>::make(ckb, kernreq, ckb_offset);
-      return ckb_offset;
-    case 8:
-      aligned_fixed_size_byteswap<uint64_t>::make(ckb, kernreq, ckb_offset);
-      return ckb_offset;
-    default:
-      break;
-    }
+  switch (data_size) {
+  case 2:
+    fixed_size_byteswap_ck<2, 1>::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  case 4:
+    fixed_size_byteswap_ck<4, 1>::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  case 8:
+    fixed_size_byteswap_ck<8, 1>::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  case 16:
+    fixed_size_byteswap_ck<16, 1>::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  default:
+    break;
   }
 
   // Otherwise use the general case ckernel
@@ -162,26 +247,21 @@ size_t dynd::make_byteswap_assignment_function(void *ckb, intptr_t ckb_offset,
 }
 
 size_t dynd::make_pairwise_byteswap_assignment_function(
-    void *ckb, intptr_t ckb_offset, intptr_t data_size, intptr_t data_alignment,
-    kernel_request_t kernreq)
+    void *ckb, intptr_t ckb_offset, intptr_t data_size,
+    intptr_t DYND_UNUSED(data_alignment), kernel_request_t kernreq)
 {
-  if (data_size == data_alignment) {
-    switch (data_size) {
-    case 4:
-      aligned_fixed_size_pairwise_byteswap_kernel<uint16_t>::make(ckb, kernreq,
-                                                                  ckb_offset);
-      return ckb_offset;
-    case 8:
-      aligned_fixed_size_pairwise_byteswap_kernel<uint32_t>::make(ckb, kernreq,
-                                                                  ckb_offset);
-      return ckb_offset;
-    case 16:
-      aligned_fixed_size_pairwise_byteswap_kernel<uint64_t>::make(ckb, kernreq,
-                                                                  ckb_offset);
-      return ckb_offset;
-    default:
-      break;
-    }
+  switch (data_size) {
+  case 4:
+    fixed_size_byteswap_ck<2, 2>::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  case 8:
+    fixed_size_byteswap_ck<4, 2>::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  case 16:
+    fixed_size_byteswap_ck<8, 2>::make(ckb, kernreq, ckb_offset);
+    return ckb_offset;
+  default:
+    break;
   }
 
   // Otherwise use the general case ckernel
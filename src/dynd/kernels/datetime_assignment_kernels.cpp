@@ -6,6 +6,7 @@
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/datetime_assignment_kernels.hpp>
 #include <dynd/types/datetime_type.hpp>
+#include <dynd/types/datetime_parser.hpp>
 #include <datetime_strings.h>
 
 using namespace std;
@@ -23,12 +24,28 @@ struct string_to_datetime_ck
   assign_error_mode m_errmode;
   date_parse_order_t m_date_parse_order;
   int m_century_window;
+  // Whether the source string bytes can be read directly as UTF-8
+  bool m_src_utf8;
+  // The fixed ISO 8601 layout of the strings seen so far, if any
+  parse::iso8601_datetime_layout m_layout;
 
   void single(char *dst, char *const *src)
   {
     const ndt::base_string_type *bst =
         static_cast<const ndt::base_string_type *>(m_src_string_tp.extended());
-    const string &s = bst->get_utf8_string(m_src_arrmeta, src[0], m_errmode);
+    if (m_src_utf8) {
+      // Fast path for a column of uniformly formatted ISO 8601 datetimes
+      const char *begin, *end;
+      bst->get_string_range(&begin, &end, m_src_arrmeta, src[0]);
+      if (m_layout.parse(begin, end, *reinterpret_cast<int64_t *>(dst))) {
+        return;
+      }
+    }
+    parse_general(dst, bst->get_utf8_string(m_src_arrmeta, src[0], m_errmode));
+  }
+
+  void parse_general(char *dst, const string &s)
+  {
     datetime_struct dts;
     // TODO: properly distinguish "date" and "option[date]" with respect to NA
     // support
@@ -36,6 +53,10 @@ struct string_to_datetime_ck
       dts.set_to_na();
     } else {
       dts.set_from_str(s, m_date_parse_order, m_century_window);
+      if (m_src_utf8) {
+        // Pick up the layout of this string for the following ones
+        m_layout.detect(s.data(), s.data() + s.size());
+      }
     }
     *reinterpret_cast<int64_t *>(dst) = dts.to_ticks();
   }
@@ -63,6 +84,10 @@ size_t dynd::make_string_to_datetime_assignment_kernel(
   self->m_errmode = ectx->errmode;
   self->m_date_parse_order = ectx->date_parse_order;
   self->m_century_window = ectx->century_window;
+  string_encoding_t encoding =
+      src_string_tp.extended<ndt::base_string_type>()->get_encoding();
+  self->m_src_utf8 =
+      (encoding == string_encoding_utf_8 || encoding == string_encoding_ascii);
   return ckb_offset;
 }
 
@@ -70,25 +95,84 @@ size_t dynd::make_string_to_datetime_assignment_kernel(
 // datetime to string assignment
 
 namespace {
+/**
+ * Formats ticks as an ISO 8601 datetime into the buffer, which must hold
+ * at least 32 characters, matching datetime_struct::to_str. Returns the
+ * end of the string, or NULL if the year needs the expanded format.
+ */
+static char *format_iso8601_datetime(int64_t ticks, bool utc_suffix, char *out)
+{
+  datetime_struct dts;
+  dts.set_from_ticks(ticks);
+  int year = dts.ymd.year;
+  if (!dts.is_valid() || year < 1 || year > 9999) {
+    return NULL;
+  }
+  out[0] = '0' + (year / 1000);
+  out[1] = '0' + ((year / 100) % 10);
+  out[2] = '0' + ((year / 10) % 10);
+  out[3] = '0' + (year % 10);
+  out[4] = '-';
+  out[5] = '0' + (dts.ymd.month / 10);
+  out[6] = '0' + (dts.ymd.month % 10);
+  out[7] = '-';
+  out[8] = '0' + (dts.ymd.day / 10);
+  out[9] = '0' + (dts.ymd.day % 10);
+  out[10] = 'T';
+  out[11] = '0' + (dts.hmst.hour / 10);
+  out[12] = '0' + (dts.hmst.hour % 10);
+  out[13] = ':';
+  out[14] = '0' + (dts.hmst.minute / 10);
+  out[15] = '0' + (dts.hmst.minute % 10);
+  char *end = out + 16;
+  int second = dts.hmst.second, tick = dts.hmst.tick;
+  if (second != 0 || tick != 0) {
+    end[0] = ':';
+    end[1] = '0' + (second / 10);
+    end[2] = '0' + (second % 10);
+    end += 3;
+    if (tick != 0) {
+      // Trailing zeros of the fraction are dropped
+      *end++ = '.';
+      for (int divisor = 1000000; tick != 0; divisor /= 10) {
+        *end++ = '0' + (tick / divisor);
+        tick %= divisor;
+      }
+    }
+  }
+  if (utc_suffix) {
+    *end++ = 'Z';
+  }
+  return end;
+}
+
 struct datetime_to_string_ck : nd::base_kernel<datetime_to_string_ck, kernel_request_host, 1> {
   ndt::type m_dst_string_tp;
   ndt::type m_src_datetime_tp;
   const char *m_dst_arrmeta;
   eval::eval_context m_ectx;
+  bool m_utc;
 
   void single(char *dst, char *const *src)
   {
+    const ndt::base_string_type *bst =
+        static_cast<const ndt::base_string_type *>(m_dst_string_tp.extended());
+    int64_t ticks = *reinterpret_cast<const int64_t *>(src[0]);
+    char buf[32];
+    char *buf_end = format_iso8601_datetime(ticks, m_utc, buf);
+    if (buf_end != NULL) {
+      bst->set_from_utf8_string(m_dst_arrmeta, dst, buf, buf_end, &m_ectx);
+      return;
+    }
+
     datetime_struct dts;
-    dts.set_from_ticks(*reinterpret_cast<const int64_t *>(src[0]));
+    dts.set_from_ticks(ticks);
     string s = dts.to_str();
     if (s.empty()) {
       s = "NA";
-    } else if (m_src_datetime_tp.extended<ndt::datetime_type>()->get_timezone() ==
-               tz_utc) {
+    } else if (m_utc) {
       s += "Z";
     }
-    const ndt::base_string_type *bst =
-        static_cast<const ndt::base_string_type *>(m_dst_string_tp.extended());
     bst->set_from_utf8_string(m_dst_arrmeta, dst, s, &m_ectx);
   }
 };
@@ -113,5 +197,7 @@ size_t dynd::make_datetime_to_string_assignment_kernel(
   self->m_src_datetime_tp = src_datetime_tp;
   self->m_dst_arrmeta = dst_arrmeta;
   self->m_ectx = *ectx;
+  self->m_utc =
+      src_datetime_tp.extended<ndt::datetime_type>()->get_timezone() == tz_utc;
   return ckb_offset;
 }
@@ -0,0 +1,613 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <dynd/kernels/matmul.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define DYND_GEMM_SSE2 1
+#else
+#define DYND_GEMM_SSE2 0
+#endif
+
+#ifdef DYND_BLAS
+#include <cblas.h>
+#endif
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * The rows of ``a`` and columns of ``b`` of the tile of ``c`` the
+ * micro-kernel keeps in registers.
+ */
+template <typename T>
+struct gemm_tile {
+  enum { mr = 4, nr = 4 };
+};
+
+template <>
+struct gemm_tile<float> {
+  enum { mr = 4, nr = 8 };
+};
+
+// The depth of the packed panels, the rows of a packed block of a, which
+// should fit in L2, and the columns of b packed at once
+enum { gemm_kc = 256, gemm_mc = 96, gemm_nc = 2048 };
+
+inline intptr_t round_up(intptr_t n, intptr_t multiple)
+{
+  return (n + multiple - 1) / multiple * multiple;
+}
+
+/**
+ * Packs an ``mc`` by ``kc`` block of a into panels of mr rows, each stored
+ * column by column, padding the last panel with zeros.
+ */
+template <typename T>
+void pack_a(intptr_t mc, intptr_t kc, const char *a, intptr_t row_stride,
+            intptr_t col_stride, T *out)
+{
+  const intptr_t mr = gemm_tile<T>::mr;
+  for (intptr_t i0 = 0; i0 < mc; i0 += mr) {
+    intptr_t rows = min(mr, mc - i0);
+    for (intptr_t p = 0; p < kc; ++p) {
+      const char *col = a + i0 * row_stride + p * col_stride;
+      intptr_t i = 0;
+      for (; i < rows; ++i) {
+        out[i] = *reinterpret_cast<const T *>(col + i * row_stride);
+      }
+      for (; i < mr; ++i) {
+        out[i] = T(0);
+      }
+      out += mr;
+    }
+  }
+}
+
+/**
+ * Packs a ``kc`` by ``nc`` panel of b into strips of nr columns, each
+ * stored row by row, padding the last strip with zeros.
+ */
+template <typename T>
+void pack_b(intptr_t kc, intptr_t nc, const char *b, intptr_t row_stride,
+            intptr_t col_stride, T *out)
+{
+  const intptr_t nr = gemm_tile<T>::nr;
+  for (intptr_t j0 = 0; j0 < nc; j0 += nr) {
+    intptr_t cols = min(nr, nc - j0);
+    for (intptr_t p = 0; p < kc; ++p) {
+      const char *row = b + p * row_stride + j0 * col_stride;
+      intptr_t j = 0;
+      for (; j < cols; ++j) {
+        out[j] = *reinterpret_cast<const T *>(row + j * col_stride);
+      }
+      for (; j < nr; ++j) {
+        out[j] = T(0);
+      }
+      out += nr;
+    }
+  }
+}
+
+/** The mr by nr product of a packed panel of a and one of b, row by row */
+template <typename T>
+void micro_kernel(intptr_t kc, const T *a, const T *b, T *ab)
+{
+  const intptr_t mr = gemm_tile<T>::mr, nr = gemm_tile<T>::nr;
+  T acc[mr * nr];
+  for (intptr_t i = 0; i < mr * nr; ++i) {
+    acc[i] = T(0);
+  }
+  for (intptr_t p = 0; p < kc; ++p) {
+    for (intptr_t i = 0; i < mr; ++i) {
+      T ai = a[i];
+      for (intptr_t j = 0; j < nr; ++j) {
+        acc[i * nr + j] += ai * b[j];
+      }
+    }
+    a += mr;
+    b += nr;
+  }
+  for (intptr_t i = 0; i < mr * nr; ++i) {
+    ab[i] = acc[i];
+  }
+}
+
+#if DYND_GEMM_SSE2
+template <>
+void micro_kernel<double>(intptr_t kc, const double *a, const double *b,
+                          double *ab)
+{
+  __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd();
+  __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+  __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd();
+  __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+  for (intptr_t p = 0; p < kc; ++p) {
+    __m128d b0 = _mm_loadu_pd(b), b1 = _mm_loadu_pd(b + 2);
+    __m128d ai = _mm_set1_pd(a[0]);
+    c00 = _mm_add_pd(c00, _mm_mul_pd(ai, b0));
+    c01 = _mm_add_pd(c01, _mm_mul_pd(ai, b1));
+    ai = _mm_set1_pd(a[1]);
+    c10 = _mm_add_pd(c10, _mm_mul_pd(ai, b0));
+    c11 = _mm_add_pd(c11, _mm_mul_pd(ai, b1));
+    ai = _mm_set1_pd(a[2]);
+    c20 = _mm_add_pd(c20, _mm_mul_pd(ai, b0));
+    c21 = _mm_add_pd(c21, _mm_mul_pd(ai, b1));
+    ai = _mm_set1_pd(a[3]);
+    c30 = _mm_add_pd(c30, _mm_mul_pd(ai, b0));
+    c31 = _mm_add_pd(c31, _mm_mul_pd(ai, b1));
+    a += 4;
+    b += 4;
+  }
+  _mm_storeu_pd(ab, c00);
+  _mm_storeu_pd(ab + 2, c01);
+  _mm_storeu_pd(ab + 4, c10);
+  _mm_storeu_pd(ab + 6, c11);
+  _mm_storeu_pd(ab + 8, c20);
+  _mm_storeu_pd(ab + 10, c21);
+  _mm_storeu_pd(ab + 12, c30);
+  _mm_storeu_pd(ab + 14, c31);
+}
+
+template <>
+void micro_kernel<float>(intptr_t kc, const float *a, const float *b,
+                         float *ab)
+{
+  __m128 c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps();
+  __m128 c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+  __m128 c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps();
+  __m128 c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+  for (intptr_t p = 0; p < kc; ++p) {
+    __m128 b0 = _mm_loadu_ps(b), b1 = _mm_loadu_ps(b + 4);
+    __m128 ai = _mm_set1_ps(a[0]);
+    c00 = _mm_add_ps(c00, _mm_mul_ps(ai, b0));
+    c01 = _mm_add_ps(c01, _mm_mul_ps(ai, b1));
+    ai = _mm_set1_ps(a[1]);
+    c10 = _mm_add_ps(c10, _mm_mul_ps(ai, b0));
+    c11 = _mm_add_ps(c11, _mm_mul_ps(ai, b1));
+    ai = _mm_set1_ps(a[2]);
+    c20 = _mm_add_ps(c20, _mm_mul_ps(ai, b0));
+    c21 = _mm_add_ps(c21, _mm_mul_ps(ai, b1));
+    ai = _mm_set1_ps(a[3]);
+    c30 = _mm_add_ps(c30, _mm_mul_ps(ai, b0));
+    c31 = _mm_add_ps(c31, _mm_mul_ps(ai, b1));
+    a += 4;
+    b += 8;
+  }
+  _mm_storeu_ps(ab, c00);
+  _mm_storeu_ps(ab + 4, c01);
+  _mm_storeu_ps(ab + 8, c10);
+  _mm_storeu_ps(ab + 12, c11);
+  _mm_storeu_ps(ab + 16, c20);
+  _mm_storeu_ps(ab + 20, c21);
+  _mm_storeu_ps(ab + 24, c30);
+  _mm_storeu_ps(ab + 28, c31);
+}
+#endif
+
+/**
+ * Stores the top left ``rows`` by ``cols`` of a micro-kernel tile into c,
+ * adding it to what's there if ``accumulate`` is set.
+ */
+template <typename T>
+void store_tile(const T *ab, intptr_t rows, intptr_t cols, char *c,
+                intptr_t row_stride, intptr_t col_stride, bool accumulate)
+{
+  const intptr_t nr = gemm_tile<T>::nr;
+  for (intptr_t i = 0; i < rows; ++i) {
+    char *row = c + i * row_stride;
+    for (intptr_t j = 0; j < cols; ++j) {
+      T &cij = *reinterpret_cast<T *>(row + j * col_stride);
+      if (accumulate) {
+        cij += ab[i * nr + j];
+      } else {
+        cij = ab[i * nr + j];
+      }
+    }
+  }
+}
+
+template <typename T>
+void builtin_gemm(intptr_t m, intptr_t n, intptr_t k, const char *a,
+                  intptr_t a_row_stride, intptr_t a_col_stride, const char *b,
+                  intptr_t b_row_stride, intptr_t b_col_stride, char *c,
+                  intptr_t c_row_stride, intptr_t c_col_stride)
+{
+  const intptr_t mr = gemm_tile<T>::mr, nr = gemm_tile<T>::nr;
+  if (k == 0) {
+    for (intptr_t i = 0; i < m; ++i) {
+      for (intptr_t j = 0; j < n; ++j) {
+        *reinterpret_cast<T *>(c + i * c_row_stride + j * c_col_stride) = T(0);
+      }
+    }
+    return;
+  }
+
+  intptr_t kc_max = min<intptr_t>(gemm_kc, k);
+  std::vector<T> a_pack(round_up(min<intptr_t>(gemm_mc, m), mr) * kc_max);
+  std::vector<T> b_pack(round_up(min<intptr_t>(gemm_nc, n), nr) * kc_max);
+  T ab[mr * nr];
+  for (intptr_t jc = 0; jc < n; jc += gemm_nc) {
+    intptr_t nc = min<intptr_t>(gemm_nc, n - jc);
+    for (intptr_t pc = 0; pc < k; pc += gemm_kc) {
+      intptr_t kc = min<intptr_t>(gemm_kc, k - pc);
+      pack_b(kc, nc, b + pc * b_row_stride + jc * b_col_stride, b_row_stride,
+             b_col_stride, b_pack.data());
+      for (intptr_t ic = 0; ic < m; ic += gemm_mc) {
+        intptr_t mc = min<intptr_t>(gemm_mc, m - ic);
+        pack_a(mc, kc, a + ic * a_row_stride + pc * a_col_stride,
+               a_row_stride, a_col_stride, a_pack.data());
+        for (intptr_t jr = 0; jr < nc; jr += nr) {
+          for (intptr_t ir = 0; ir < mc; ir += mr) {
+            micro_kernel(kc, a_pack.data() + ir * kc, b_pack.data() + jr * kc,
+                         ab);
+            store_tile(ab, min(mr, mc - ir), min(nr, nc - jr),
+                       c + (ic + ir) * c_row_stride + (jc + jr) * c_col_stride,
+                       c_row_stride, c_col_stride, pc != 0);
+          }
+        }
+      }
+    }
+  }
+}
+
+#ifdef DYND_BLAS
+/**
+ * Gets the transpose flag and leading dimension of a matrix for a row-major
+ * BLAS call, if one of its strides is the element size.
+ */
+bool get_blas_layout(intptr_t rows, intptr_t cols, intptr_t row_stride,
+                     intptr_t col_stride, intptr_t el_size,
+                     CBLAS_TRANSPOSE &trans, int &ld)
+{
+  if (col_stride == el_size && row_stride % el_size == 0 &&
+      row_stride / el_size >= max<intptr_t>(cols, 1)) {
+    trans = CblasNoTrans;
+    ld = static_cast<int>(row_stride / el_size);
+    return true;
+  } else if (row_stride == el_size && col_stride % el_size == 0 &&
+             col_stride / el_size >= max<intptr_t>(rows, 1)) {
+    trans = CblasTrans;
+    ld = static_cast<int>(col_stride / el_size);
+    return true;
+  }
+  return false;
+}
+
+void call_blas_gemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, int m,
+                    int n, int k, const float *a, int lda, const float *b,
+                    int ldb, float *c, int ldc)
+{
+  cblas_sgemm(CblasRowMajor, trans_a, trans_b, m, n, k, 1.0f, a, lda, b, ldb,
+              0.0f, c, ldc);
+}
+
+void call_blas_gemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, int m,
+                    int n, int k, const double *a, int lda, const double *b,
+                    int ldb, double *c, int ldc)
+{
+  cblas_dgemm(CblasRowMajor, trans_a, trans_b, m, n, k, 1.0, a, lda, b, ldb,
+              0.0, c, ldc);
+}
+
+void call_blas_gemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, int m,
+                    int n, int k, const dynd::complex<float> *a, int lda,
+                    const dynd::complex<float> *b, int ldb,
+                    dynd::complex<float> *c, int ldc)
+{
+  dynd::complex<float> alpha(1), beta(0);
+  cblas_cgemm(CblasRowMajor, trans_a, trans_b, m, n, k, &alpha, a, lda, b,
+              ldb, &beta, c, ldc);
+}
+
+void call_blas_gemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, int m,
+                    int n, int k, const dynd::complex<double> *a, int lda,
+                    const dynd::complex<double> *b, int ldb,
+                    dynd::complex<double> *c, int ldc)
+{
+  dynd::complex<double> alpha(1), beta(0);
+  cblas_zgemm(CblasRowMajor, trans_a, trans_b, m, n, k, &alpha, a, lda, b,
+              ldb, &beta, c, ldc);
+}
+
+/**
+ * Does the product through BLAS if the rows of c are contiguous, and a and
+ * b are contiguous one way or the other, returning false otherwise.
+ */
+template <typename T>
+bool blas_gemm(intptr_t m, intptr_t n, intptr_t k, const char *a,
+               intptr_t a_row_stride, intptr_t a_col_stride, const char *b,
+               intptr_t b_row_stride, intptr_t b_col_stride, char *c,
+               intptr_t c_row_stride, intptr_t c_col_stride)
+{
+  const intptr_t el_size = sizeof(T), int_max = 0x7fffffff;
+  if (m == 0 || n == 0 || k == 0 || m > int_max || n > int_max ||
+      k > int_max) {
+    return false;
+  }
+  CBLAS_TRANSPOSE trans_a, trans_b, trans_c;
+  int lda, ldb, ldc;
+  if (!get_blas_layout(m, k, a_row_stride, a_col_stride, el_size, trans_a,
+                       lda) ||
+      !get_blas_layout(k, n, b_row_stride, b_col_stride, el_size, trans_b,
+                       ldb) ||
+      !get_blas_layout(m, n, c_row_stride, c_col_stride, el_size, trans_c,
+                       ldc) ||
+      trans_c != CblasNoTrans) {
+    return false;
+  }
+  call_blas_gemm(trans_a, trans_b, static_cast<int>(m), static_cast<int>(n),
+                 static_cast<int>(k), reinterpret_cast<const T *>(a), lda,
+                 reinterpret_cast<const T *>(b), ldb, reinterpret_cast<T *>(c),
+                 ldc);
+  return true;
+}
+#endif
+
+/** An inner product with four partial sums */
+template <typename T>
+T builtin_dot(intptr_t n, const char *a, intptr_t a_stride, const char *b,
+              intptr_t b_stride)
+{
+  T s0 = T(0), s1 = T(0), s2 = T(0), s3 = T(0);
+  intptr_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    s0 += *reinterpret_cast<const T *>(a) * *reinterpret_cast<const T *>(b);
+    s1 += *reinterpret_cast<const T *>(a + a_stride) *
+          *reinterpret_cast<const T *>(b + b_stride);
+    s2 += *reinterpret_cast<const T *>(a + 2 * a_stride) *
+          *reinterpret_cast<const T *>(b + 2 * b_stride);
+    s3 += *reinterpret_cast<const T *>(a + 3 * a_stride) *
+          *reinterpret_cast<const T *>(b + 3 * b_stride);
+    a += 4 * a_stride;
+    b += 4 * b_stride;
+  }
+  for (; i < n; ++i) {
+    s0 += *reinterpret_cast<const T *>(a) * *reinterpret_cast<const T *>(b);
+    a += a_stride;
+    b += b_stride;
+  }
+  return (s0 + s1) + (s2 + s3);
+}
+
+} // anonymous namespace
+
+template <typename T>
+void nd::detail::gemm(intptr_t m, intptr_t n, intptr_t k, const char *a,
+                      intptr_t a_row_stride, intptr_t a_col_stride,
+                      const char *b, intptr_t b_row_stride,
+                      intptr_t b_col_stride, char *c, intptr_t c_row_stride,
+                      intptr_t c_col_stride)
+{
+  if (m == 0 || n == 0) {
+    return;
+  }
+#ifdef DYND_BLAS
+  if (blas_gemm<T>(m, n, k, a, a_row_stride, a_col_stride, b, b_row_stride,
+                   b_col_stride, c, c_row_stride, c_col_stride)) {
+    return;
+  }
+#endif
+  builtin_gemm<T>(m, n, k, a, a_row_stride, a_col_stride, b, b_row_stride,
+                  b_col_stride, c, c_row_stride, c_col_stride);
+}
+
+template <typename T>
+T nd::detail::dot(intptr_t n, const char *a, intptr_t a_stride, const char *b,
+                  intptr_t b_stride)
+{
+  return builtin_dot<T>(n, a, a_stride, b, b_stride);
+}
+
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    template void gemm<float>(intptr_t, intptr_t, intptr_t, const char *,
+                              intptr_t, intptr_t, const char *, intptr_t,
+                              intptr_t, char *, intptr_t, intptr_t);
+    template void gemm<double>(intptr_t, intptr_t, intptr_t, const char *,
+                               intptr_t, intptr_t, const char *, intptr_t,
+                               intptr_t, char *, intptr_t, intptr_t);
+    template void gemm<complex<float>>(intptr_t, intptr_t, intptr_t,
+                                       const char *, intptr_t, intptr_t,
+                                       const char *, intptr_t, intptr_t,
+                                       char *, intptr_t, intptr_t);
+    template void gemm<complex<double>>(intptr_t, intptr_t, intptr_t,
+                                        const char *, intptr_t, intptr_t,
+                                        const char *, intptr_t, intptr_t,
+                                        char *, intptr_t, intptr_t);
+
+    template float dot<float>(intptr_t, const char *, intptr_t, const char *,
+                              intptr_t);
+    template double dot<double>(intptr_t, const char *, intptr_t,
+                                const char *, intptr_t);
+    template complex<float> dot<complex<float>>(intptr_t, const char *,
+                                                intptr_t, const char *,
+                                                intptr_t);
+    template complex<double> dot<complex<double>>(intptr_t, const char *,
+                                                  intptr_t, const char *,
+                                                  intptr_t);
+
+  } // namespace dynd::nd::detail
+} // namespace dynd::nd
+} // namespace dynd
+
+namespace {
+
+template <typename T>
+intptr_t make_matmul_ck(void *ckb, kernel_request_t kernreq,
+                        intptr_t ckb_offset, const size_stride_t *dst,
+                        const size_stride_t *src0, const size_stride_t *src1)
+{
+  nd::matmul_ck<T> *self = nd::matmul_ck<T>::make(ckb, kernreq, ckb_offset);
+  self->m_m = src0[0].dim_size;
+  self->m_n = src1[1].dim_size;
+  self->m_k = src0[1].dim_size;
+  for (int i = 0; i < 2; ++i) {
+    self->m_dst_stride[i] = dst[i].stride;
+    self->m_src0_stride[i] = src0[i].stride;
+    self->m_src1_stride[i] = src1[i].stride;
+  }
+  return ckb_offset;
+}
+
+template <typename T>
+intptr_t make_dot_ck(void *ckb, kernel_request_t kernreq, intptr_t ckb_offset,
+                     intptr_t n, const intptr_t *src_stride)
+{
+  nd::dot_ck<T> *self = nd::dot_ck<T>::make(ckb, kernreq, ckb_offset);
+  self->m_n = n;
+  self->m_src_stride[0] = src_stride[0];
+  self->m_src_stride[1] = src_stride[1];
+  return ckb_offset;
+}
+
+} // anonymous namespace
+
+void nd::matmul_virtual_ck::resolve_dst_type(
+    char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+    char *DYND_UNUSED(data), ndt::type &dst_tp, intptr_t DYND_UNUSED(nsrc),
+    const ndt::type *src_tp, const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  intptr_t shape0[2], shape1[2];
+  src_tp[0].extended()->get_shape(2, 0, shape0, NULL, NULL);
+  src_tp[1].extended()->get_shape(2, 0, shape1, NULL, NULL);
+  if (shape0[0] < 0 || shape1[1] < 0) {
+    stringstream ss;
+    ss << "matmul requires fixed dimensions, not " << src_tp[0] << " and "
+       << src_tp[1];
+    throw invalid_argument(ss.str());
+  }
+  dst_tp = ndt::make_fixed_dim(
+      shape0[0], ndt::make_fixed_dim(shape1[1], src_tp[0].get_dtype()));
+}
+
+intptr_t nd::matmul_virtual_ck::instantiate(
+    char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+    char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+    const ndt::type &dst_tp, const char *dst_arrmeta,
+    intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *DYND_UNUSED(ectx),
+    const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  const size_stride_t *dst_size_stride, *src0_size_stride, *src1_size_stride;
+  ndt::type dst_el_tp, src0_el_tp, src1_el_tp;
+  const char *dst_el_arrmeta, *src0_el_arrmeta, *src1_el_arrmeta;
+  if (!dst_tp.get_as_strided(dst_arrmeta, 2, &dst_size_stride, &dst_el_tp,
+                             &dst_el_arrmeta) ||
+      !src_tp[0].get_as_strided(src_arrmeta[0], 2, &src0_size_stride,
+                                &src0_el_tp, &src0_el_arrmeta) ||
+      !src_tp[1].get_as_strided(src_arrmeta[1], 2, &src1_size_stride,
+                                &src1_el_tp, &src1_el_arrmeta)) {
+    stringstream ss;
+    ss << "matmul requires strided matrices, not " << src_tp[0] << " and "
+       << src_tp[1];
+    throw invalid_argument(ss.str());
+  }
+  if (src0_el_tp != src1_el_tp || dst_el_tp != src0_el_tp) {
+    stringstream ss;
+    ss << "matmul requires matrices of the same type, not " << src0_el_tp
+       << " and " << src1_el_tp;
+    throw type_error(ss.str());
+  }
+  if (src0_size_stride[1].dim_size != src1_size_stride[0].dim_size) {
+    stringstream ss;
+    ss << "matmul requires the columns of the first matrix to match the rows "
+          "of the second, not " << src0_size_stride[1].dim_size << " and "
+       << src1_size_stride[0].dim_size;
+    throw broadcast_error(ss.str());
+  }
+
+  switch (src0_el_tp.get_type_id()) {
+  case float32_type_id:
+    return make_matmul_ck<float>(ckb, kernreq, ckb_offset, dst_size_stride,
+                                 src0_size_stride, src1_size_stride);
+  case float64_type_id:
+    return make_matmul_ck<double>(ckb, kernreq, ckb_offset, dst_size_stride,
+                                  src0_size_stride, src1_size_stride);
+  case complex_float32_type_id:
+    return make_matmul_ck<dynd::complex<float>>(
+        ckb, kernreq, ckb_offset, dst_size_stride, src0_size_stride,
+        src1_size_stride);
+  case complex_float64_type_id:
+    return make_matmul_ck<dynd::complex<double>>(
+        ckb, kernreq, ckb_offset, dst_size_stride, src0_size_stride,
+        src1_size_stride);
+  default: {
+    stringstream ss;
+    ss << "matmul requires float32, float64 or complex values, not "
+       << src0_el_tp;
+    throw type_error(ss.str());
+  }
+  }
+}
+
+intptr_t nd::dot_virtual_ck::instantiate(
+    char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+    char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+    const ndt::type &dst_tp, const char *DYND_UNUSED(dst_arrmeta),
+    intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *DYND_UNUSED(ectx),
+    const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  intptr_t src_size[2], src_stride[2];
+  ndt::type src_el_tp[2];
+  const char *src_el_arrmeta[2];
+  for (int i = 0; i < 2; ++i) {
+    if (!src_tp[i].get_as_strided(src_arrmeta[i], &src_size[i],
+                                  &src_stride[i], &src_el_tp[i],
+                                  &src_el_arrmeta[i])) {
+      stringstream ss;
+      ss << "dot requires strided vectors, not " << src_tp[i];
+      throw invalid_argument(ss.str());
+    }
+  }
+  if (src_el_tp[0] != src_el_tp[1] || dst_tp != src_el_tp[0]) {
+    stringstream ss;
+    ss << "dot requires vectors of the same type, not " << src_el_tp[0]
+       << " and " << src_el_tp[1];
+    throw type_error(ss.str());
+  }
+  if (src_size[0] != src_size[1]) {
+    stringstream ss;
+    ss << "dot requires vectors of the same size, not " << src_size[0]
+       << " and " << src_size[1];
+    throw broadcast_error(ss.str());
+  }
+
+  switch (dst_tp.get_type_id()) {
+  case float32_type_id:
+    return make_dot_ck<float>(ckb, kernreq, ckb_offset, src_size[0],
+                              src_stride);
+  case float64_type_id:
+    return make_dot_ck<double>(ckb, kernreq, ckb_offset, src_size[0],
+                               src_stride);
+  case complex_float32_type_id:
+    return make_dot_ck<dynd::complex<float>>(ckb, kernreq, ckb_offset,
+                                             src_size[0], src_stride);
+  case complex_float64_type_id:
+    return make_dot_ck<dynd::complex<double>>(ckb, kernreq, ckb_offset,
+                                              src_size[0], src_stride);
+  default: {
+    stringstream ss;
+    ss << "dot requires float32, float64 or complex values, not " << dst_tp;
+    throw type_error(ss.str());
+  }
+  }
+}
@@ -9,35 +9,115 @@
 using namespace std;
 using namespace dynd;
 
-void nd::functional::old_multidispatch_ck::resolve_dst_type(
-    char *static_data, size_t data_size, char *data, ndt::type &dst_tp,
-    intptr_t nsrc, const ndt::type *src_tp, const nd::array &kwds,
-    const std::map<nd::string, ndt::type> &tp_vars)
+nd::functional::old_multidispatch_static_data::old_multidispatch_static_data(
+    vector<arrfunc> &&children)
+    : m_children(std::move(children))
+{
+  // Index the children with builtin signatures up front
+  for (size_t i = 0; i < m_children.size(); ++i) {
+    const ndt::arrfunc_type *af_tp = m_children[i].get_type();
+    uint64_t key;
+    if (get_key(af_tp->get_npos(), af_tp->get_pos_types_raw(), key)) {
+      m_index[key] = match(af_tp->get_npos(), af_tp->get_pos_types_raw());
+    }
+  }
+}
+
+bool nd::functional::old_multidispatch_static_data::get_key(
+    intptr_t nsrc, const ndt::type *src_tp, uint64_t &out_key)
+{
+  // Eight bits for the count, and eight for each type id
+  if (nsrc > 7) {
+    return false;
+  }
+  uint64_t key = nsrc;
+  for (intptr_t i = 0; i < nsrc; ++i) {
+    if (!src_tp[i].is_builtin()) {
+      return false;
+    }
+    key |= static_cast<uint64_t>(src_tp[i].get_type_id()) << (8 * (i + 1));
+  }
+  out_key = key;
+  return true;
+}
+
+nd::functional::old_multidispatch_static_data::decision
+nd::functional::old_multidispatch_static_data::match(
+    intptr_t nsrc, const ndt::type *src_tp) const
 {
-  const vector<nd::arrfunc> *icd =
-      reinterpret_cast<const vector<nd::arrfunc> *>(static_data);
-  for (intptr_t i = 0; i < (intptr_t)icd->size(); ++i) {
-    const nd::arrfunc &child = (*icd)[i];
-    if (nsrc == child.get_type()->get_npos()) {
-      intptr_t isrc;
-      std::map<nd::string, ndt::type> typevars;
+  decision result;
+  for (intptr_t i = 0; i < (intptr_t)m_children.size(); ++i) {
+    const ndt::arrfunc_type *af_tp = m_children[i].get_type();
+    if (nsrc != af_tp->get_npos()) {
+      continue;
+    }
+    intptr_t isrc;
+    std::map<nd::string, ndt::type> typevars;
+    for (isrc = 0; isrc < nsrc; ++isrc) {
+      if (!can_implicitly_convert(src_tp[isrc], af_tp->get_pos_type(isrc),
+                                  typevars)) {
+        break;
+      }
+    }
+    if (isrc == nsrc) {
+      result.child = i;
+      result.exact = true;
       for (isrc = 0; isrc < nsrc; ++isrc) {
-        if (!can_implicitly_convert(
-                src_tp[isrc], child.get_type()->get_pos_type(isrc), typevars)) {
+        const ndt::type &arg_tp = af_tp->get_pos_type(isrc);
+        if (!arg_tp.is_symbolic() && src_tp[isrc] != arg_tp) {
+          result.exact = false;
           break;
         }
       }
-      if (isrc == nsrc) {
-        dst_tp = child.get_type()->get_return_type();
-        if (dst_tp.is_symbolic()) {
-          child.get()->resolve_dst_type(
-              const_cast<char *>(child.get()->static_data), data_size, data,
-              dst_tp, nsrc, src_tp, kwds, tp_vars);
-        }
-        return;
-      }
+      return result;
     }
   }
+  result.child = -1;
+  result.exact = false;
+  return result;
+}
+
+nd::functional::old_multidispatch_static_data::decision
+nd::functional::old_multidispatch_static_data::resolve(intptr_t nsrc,
+                                                       const ndt::type *src_tp)
+{
+  uint64_t key;
+  if (!get_key(nsrc, src_tp, key)) {
+    return match(nsrc, src_tp);
+  }
+
+  {
+    lock_guard<mutex> lock(m_index_mutex);
+    unordered_map<uint64_t, decision>::const_iterator it = m_index.find(key);
+    if (it != m_index.end()) {
+      return it->second;
+    }
+  }
+  decision result = match(nsrc, src_tp);
+  lock_guard<mutex> lock(m_index_mutex);
+  m_index[key] = result;
+  return result;
+}
+
+void nd::functional::old_multidispatch_ck::resolve_dst_type(
+    char *static_data, size_t data_size, char *data, ndt::type &dst_tp,
+    intptr_t nsrc, const ndt::type *src_tp, const nd::array &kwds,
+    const std::map<nd::string, ndt::type> &tp_vars)
+{
+  old_multidispatch_static_data &sd =
+      **reinterpret_cast<std::shared_ptr<old_multidispatch_static_data> *>(
+          static_data);
+  old_multidispatch_static_data::decision d = sd.resolve(nsrc, src_tp);
+  if (d.child >= 0) {
+    const nd::arrfunc &child = sd.get_child(d.child);
+    dst_tp = child.get_type()->get_return_type();
+    if (dst_tp.is_symbolic()) {
+      child.get()->resolve_dst_type(
+          const_cast<char *>(child.get()->static_data), data_size, data,
+          dst_tp, nsrc, src_tp, kwds, tp_vars);
+    }
+    return;
+  }
 
   stringstream ss;
   ss << "Failed to find suitable signature in multidispatch resolution "
@@ -56,46 +136,31 @@ void nd::functional::old_multidispatch_ck::resolve_dst_type(
 intptr_t nd::functional::old_multidispatch_ck::instantiate(
     char *static_data, size_t DYND_UNUSED(data_size), char *DYND_UNUSED(data),
     void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
-    const char *dst_arrmeta, intptr_t DYND_UNUSED(nsrc),
-    const ndt::type *src_tp, const char *const *src_arrmeta,
-    kernel_request_t kernreq, const eval::eval_context *ectx,
-    const nd::array &kwds, const std::map<dynd::nd::string, ndt::type> &tp_vars)
+    const char *dst_arrmeta, intptr_t nsrc, const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &kwds,
+    const std::map<dynd::nd::string, ndt::type> &tp_vars)
 {
-  const vector<nd::arrfunc> *icd =
-      reinterpret_cast<vector<nd::arrfunc> *>(static_data);
-  for (intptr_t i = 0; i < (intptr_t)icd->size(); ++i) {
-    const nd::arrfunc &af = (*icd)[i];
-    intptr_t isrc, nsrc = af.get_type()->get_npos();
-    std::map<nd::string, ndt::type> typevars;
-    for (isrc = 0; isrc < nsrc; ++isrc) {
-      if (!can_implicitly_convert(
-              src_tp[isrc], af.get_type()->get_pos_type(isrc), typevars)) {
-        break;
-      }
-    }
-    if (isrc == nsrc) {
-      intptr_t j;
-      for (j = 0; j < nsrc; ++j) {
-        const ndt::type &arg_tp = af.get_type()->get_pos_type(j);
-        if (!arg_tp.is_symbolic() && src_tp[j] != arg_tp) {
-          break;
-        }
-      }
-      if (j == nsrc) {
-        return af.get()->instantiate(const_cast<char *>(af.get()->static_data),
-                                     0, NULL, ckb, ckb_offset, dst_tp,
-                                     dst_arrmeta, nsrc, src_tp, src_arrmeta,
-                                     kernreq, ectx, kwds, tp_vars);
-      } else {
-        return make_buffered_ckernel(af.get(), af.get_type(), ckb, ckb_offset,
-                                     dst_tp, dst_arrmeta, nsrc, src_tp,
-                                     af.get_type()->get_pos_types_raw(),
-                                     src_arrmeta, kernreq, ectx);
-      }
+  old_multidispatch_static_data &sd =
+      **reinterpret_cast<std::shared_ptr<old_multidispatch_static_data> *>(
+          static_data);
+  old_multidispatch_static_data::decision d = sd.resolve(nsrc, src_tp);
+  if (d.child >= 0) {
+    const nd::arrfunc &af = sd.get_child(d.child);
+    if (d.exact) {
+      return af.get()->instantiate(const_cast<char *>(af.get()->static_data),
+                                   0, NULL, ckb, ckb_offset, dst_tp,
+                                   dst_arrmeta, nsrc, src_tp, src_arrmeta,
+                                   kernreq, ectx, kwds, tp_vars);
+    } else {
+      return make_buffered_ckernel(af.get(), af.get_type(), ckb, ckb_offset,
+                                   dst_tp, dst_arrmeta, nsrc, src_tp,
+                                   af.get_type()->get_pos_types_raw(),
+                                   src_arrmeta, kernreq, ectx);
     }
   }
   // TODO: Good message here
   stringstream ss;
   ss << "No matching signature found in multidispatch arrfunc";
   throw invalid_argument(ss.str());
-}
\ No newline at end of file
+}
@@ -0,0 +1,415 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include <dynd/kernels/outer.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * Gets the size and stride of the outer dimension of both operands, and the
+ * types and arrmeta the child sees, if each has exactly one strided
+ * dimension more than the child takes.
+ */
+bool get_outer_operands(const ndt::arrfunc_type *child_tp,
+                        const ndt::type *src_tp,
+                        const char *const *src_arrmeta, intptr_t *src_size,
+                        intptr_t *src_stride, ndt::type *child_src_tp,
+                        const char **child_src_arrmeta)
+{
+  for (intptr_t i = 0; i < 2; ++i) {
+    const ndt::type &param_tp = child_tp->get_pos_type(i);
+    if (param_tp.is_variadic() || src_tp[i].get_kind() == memory_kind ||
+        src_tp[i].get_ndim() - param_tp.get_ndim() != 1) {
+      return false;
+    }
+    if (!src_tp[i].get_as_strided(src_arrmeta[i], &src_size[i],
+                                  &src_stride[i], &child_src_tp[i],
+                                  &child_src_arrmeta[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** The value type of an outer product, resolving a symbolic return type */
+ndt::type get_outer_value_type(const nd::arrfunc &child, const ndt::type *src_tp,
+                               const nd::array &kwds,
+                               const std::map<nd::string, ndt::type> &tp_vars)
+{
+  const ndt::arrfunc_type *child_tp = child.get_type();
+  ndt::type child_src_tp[2];
+  for (intptr_t i = 0; i < 2; ++i) {
+    if (src_tp[i].get_ndim() - child_tp->get_pos_type(i).get_ndim() != 1) {
+      stringstream ss;
+      ss << "outer reductions require operands with one dimension more than "
+            "the child takes, not " << src_tp[i];
+      throw invalid_argument(ss.str());
+    }
+    child_src_tp[i] = src_tp[i].get_dtype(child_tp->get_pos_type(i).get_ndim());
+  }
+
+  ndt::type value_tp = child_tp->get_return_type();
+  if (value_tp.is_symbolic()) {
+    child.get()->resolve_dst_type(const_cast<char *>(child.get()->static_data),
+                                  0, NULL, value_tp, 2, child_src_tp, kwds,
+                                  tp_vars);
+  }
+  return value_tp;
+}
+
+} // anonymous namespace
+
+void nd::functional::get_outer_block_shape(intptr_t src0_el_size,
+                                           intptr_t src1_el_size,
+                                           intptr_t &block_rows,
+                                           intptr_t &block_cols)
+{
+  block_rows = max<intptr_t>(4, outer_block_bytes / 2 /
+                                    max<intptr_t>(src0_el_size, 1));
+  block_cols = max<intptr_t>(16, outer_block_bytes / 2 /
+                                     max<intptr_t>(src1_el_size, 1));
+}
+
+void nd::functional::outer_blocked_ck::single(char *dst, char *const *src)
+{
+  ckernel_prefix *child = get_child_ckernel();
+  expr_strided_t child_fn = child->get_function<expr_strided_t>();
+  intptr_t child_src_stride[2] = {0, m_src_stride[1]};
+  char *child_src[2];
+  for (intptr_t i0 = 0; i0 < m_src_size[0]; i0 += m_block_rows) {
+    intptr_t i1 = min(i0 + m_block_rows, m_src_size[0]);
+    for (intptr_t j0 = 0; j0 < m_src_size[1]; j0 += m_block_cols) {
+      intptr_t count = min(m_block_cols, m_src_size[1] - j0);
+      child_src[1] = src[1] + j0 * m_src_stride[1];
+      for (intptr_t i = i0; i < i1; ++i) {
+        child_src[0] = src[0] + i * m_src_stride[0];
+        child_fn(dst + i * m_dst_stride[0] + j0 * m_dst_stride[1],
+                 m_dst_stride[1], child_src, child_src_stride, count, child);
+      }
+    }
+  }
+}
+
+void nd::functional::outer_blocked_ck::destruct_children()
+{
+  get_child_ckernel()->destroy();
+}
+
+intptr_t nd::functional::outer_blocked_ck::instantiate(
+    char *static_data, size_t DYND_UNUSED(data_size), char *DYND_UNUSED(data),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, intptr_t nsrc, const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &kwds,
+    const std::map<nd::string, ndt::type> &tp_vars)
+{
+  const arrfunc &child = *reinterpret_cast<arrfunc *>(static_data);
+  const ndt::arrfunc_type *child_tp = child.get_type();
+  if (nsrc != 2 || child_tp->get_return_type().is_variadic() ||
+      dst_tp.get_kind() == memory_kind ||
+      dst_tp.get_ndim() - child_tp->get_return_type().get_ndim() != 2) {
+    return -1;
+  }
+
+  intptr_t src_size[2], src_stride[2];
+  ndt::type child_src_tp[2];
+  const char *child_src_arrmeta[2];
+  if (!get_outer_operands(child_tp, src_tp, src_arrmeta, src_size, src_stride,
+                          child_src_tp, child_src_arrmeta)) {
+    return -1;
+  }
+
+  const size_stride_t *dst_size_stride;
+  ndt::type child_dst_tp;
+  const char *child_dst_arrmeta;
+  if (!dst_tp.get_as_strided(dst_arrmeta, 2, &dst_size_stride, &child_dst_tp,
+                             &child_dst_arrmeta) ||
+      dst_size_stride[0].dim_size != src_size[0] ||
+      dst_size_stride[1].dim_size != src_size[1]) {
+    return -1;
+  }
+
+  outer_blocked_ck *self = make(ckb, kernreq, ckb_offset);
+  for (intptr_t i = 0; i < 2; ++i) {
+    self->m_dst_stride[i] = dst_size_stride[i].stride;
+    self->m_src_size[i] = src_size[i];
+    self->m_src_stride[i] = src_stride[i];
+  }
+  get_outer_block_shape(child_src_tp[0].get_data_size(),
+                        child_src_tp[1].get_data_size(), self->m_block_rows,
+                        self->m_block_cols);
+
+  return child.get()->instantiate(
+      const_cast<char *>(child.get()->static_data), 0, NULL, ckb, ckb_offset, child_dst_tp,
+      child_dst_arrmeta, nsrc, child_src_tp, child_src_arrmeta,
+      kernel_request_strided, ectx, kwds, tp_vars);
+}
+
+void nd::functional::outer_reduce_ck::single(char *dst, char *const *src)
+{
+  ckernel_prefix *child = get_child_ckernel();
+  expr_strided_t child_fn = child->get_function<expr_strided_t>();
+  ckernel_prefix *reduction = get_child_ckernel(m_reduction_offset);
+  expr_strided_t reduction_fn = reduction->get_function<expr_strided_t>();
+  intptr_t child_src_stride[2] = {0, m_src_stride[1]};
+  char *child_src[2];
+  char *values = m_buffer.data();
+  for (intptr_t i0 = 0; i0 < m_src_size[0]; i0 += m_block_rows) {
+    intptr_t i1 = min(i0 + m_block_rows, m_src_size[0]);
+    for (intptr_t j0 = 0; j0 < m_src_size[1]; j0 += m_block_cols) {
+      intptr_t count = min(m_block_cols, m_src_size[1] - j0);
+      child_src[1] = src[1] + j0 * m_src_stride[1];
+      for (intptr_t i = i0; i < i1; ++i) {
+        child_src[0] = src[0] + i * m_src_stride[0];
+        child_fn(values, m_value_size, child_src, child_src_stride, count,
+                 child);
+        char *acc = dst + i * m_dst_stride;
+        char *reduction_src = values;
+        intptr_t reduction_count = count;
+        if (j0 == 0) {
+          memcpy(acc, values, m_value_size);
+          reduction_src += m_value_size;
+          --reduction_count;
+        }
+        if (reduction_count > 0) {
+          reduction_fn(acc, 0, &reduction_src, &m_value_size, reduction_count,
+                       reduction);
+        }
+      }
+    }
+  }
+}
+
+void nd::functional::outer_reduce_ck::destruct_children()
+{
+  get_child_ckernel()->destroy();
+  destroy_child_ckernel(m_reduction_offset);
+}
+
+void nd::functional::outer_reduce_ck::resolve_dst_type(
+    char *static_data, size_t DYND_UNUSED(data_size), char *DYND_UNUSED(data),
+    ndt::type &dst_tp, intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+    const nd::array &kwds, const std::map<nd::string, ndt::type> &tp_vars)
+{
+  const outer_reduce_data &od =
+      **reinterpret_cast<std::shared_ptr<outer_reduce_data> *>(static_data);
+  dst_tp = ndt::make_fixed_dim(src_tp[0].get_dim_size(NULL, NULL),
+                               get_outer_value_type(od.child, src_tp, kwds,
+                                                    tp_vars));
+}
+
+intptr_t nd::functional::outer_reduce_ck::instantiate(
+    char *static_data, size_t DYND_UNUSED(data_size), char *DYND_UNUSED(data),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, intptr_t nsrc, const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &kwds,
+    const std::map<nd::string, ndt::type> &tp_vars)
+{
+  const outer_reduce_data &od =
+      **reinterpret_cast<std::shared_ptr<outer_reduce_data> *>(static_data);
+
+  intptr_t src_size[2], src_stride[2];
+  ndt::type child_src_tp[2];
+  const char *child_src_arrmeta[2];
+  if (!get_outer_operands(od.child.get_type(), src_tp, src_arrmeta, src_size,
+                          src_stride, child_src_tp, child_src_arrmeta)) {
+    stringstream ss;
+    ss << "outer_reduce requires operands with one strided dimension more "
+          "than the child takes, not " << src_tp[0] << " and " << src_tp[1];
+    throw invalid_argument(ss.str());
+  }
+
+  intptr_t dst_size, dst_stride;
+  ndt::type value_tp;
+  const char *value_arrmeta;
+  if (!dst_tp.get_as_strided(dst_arrmeta, &dst_size, &dst_stride, &value_tp,
+                             &value_arrmeta)) {
+    stringstream ss;
+    ss << "outer_reduce requires a strided destination, not " << dst_tp;
+    throw invalid_argument(ss.str());
+  }
+  if (!value_tp.is_builtin()) {
+    stringstream ss;
+    ss << "outer_reduce requires the child to return a builtin type, not "
+       << value_tp;
+    throw type_error(ss.str());
+  }
+  if (src_size[0] > 0 && src_size[1] == 0) {
+    throw invalid_argument(
+        "outer_reduce cannot reduce an empty second operand");
+  }
+
+  intptr_t root_ckb_offset = ckb_offset;
+  outer_reduce_ck *self = make(ckb, kernreq, ckb_offset);
+  self->m_dst_stride = dst_stride;
+  for (intptr_t i = 0; i < 2; ++i) {
+    self->m_src_size[i] = src_size[i];
+    self->m_src_stride[i] = src_stride[i];
+  }
+  get_outer_block_shape(child_src_tp[0].get_data_size(),
+                        child_src_tp[1].get_data_size(), self->m_block_rows,
+                        self->m_block_cols);
+  self->m_value_size = value_tp.get_data_size();
+  self->m_buffer.resize(self->m_block_cols * self->m_value_size);
+
+  ckb_offset = od.child.get()->instantiate(
+      const_cast<char *>(od.child.get()->static_data), 0, NULL, ckb, ckb_offset, value_tp, NULL,
+      nsrc, child_src_tp, child_src_arrmeta, kernel_request_strided, ectx,
+      kwds, tp_vars);
+
+  self = get_self(reinterpret_cast<ckernel_builder<kernel_request_host> *>(ckb),
+                  root_ckb_offset);
+  self->m_reduction_offset = ckb_offset - root_ckb_offset;
+  return od.reduction.get()->instantiate(
+      const_cast<char *>(od.reduction.get()->static_data), 0, NULL, ckb, ckb_offset, value_tp, NULL,
+      1, &value_tp, NULL, kernel_request_strided, ectx, nd::array(), tp_vars);
+}
+
+void nd::functional::outer_arg_virtual_ck::resolve_dst_type(
+    char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+    char *DYND_UNUSED(data), ndt::type &dst_tp, intptr_t DYND_UNUSED(nsrc),
+    const ndt::type *src_tp, const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  dst_tp = ndt::make_fixed_dim(src_tp[0].get_dim_size(NULL, NULL),
+                               ndt::make_type<intptr_t>());
+}
+
+namespace {
+
+template <bool Max>
+intptr_t make_outer_arg_ck(type_id_t value_type_id, void *ckb,
+                           kernel_request_t kernreq, intptr_t &ckb_offset,
+                           intptr_t dst_stride, const intptr_t *src_size,
+                           const intptr_t *src_stride, intptr_t block_rows,
+                           intptr_t block_cols)
+{
+  switch (value_type_id) {
+  case int8_type_id:
+    nd::functional::outer_arg_ck<int8_t, Max>::make(
+        ckb, kernreq, ckb_offset, dst_stride, src_size, src_stride, block_rows,
+        block_cols);
+    return ckb_offset;
+  case int16_type_id:
+    nd::functional::outer_arg_ck<int16_t, Max>::make(
+        ckb, kernreq, ckb_offset, dst_stride, src_size, src_stride, block_rows,
+        block_cols);
+    return ckb_offset;
+  case int32_type_id:
+    nd::functional::outer_arg_ck<int32_t, Max>::make(
+        ckb, kernreq, ckb_offset, dst_stride, src_size, src_stride, block_rows,
+        block_cols);
+    return ckb_offset;
+  case int64_type_id:
+    nd::functional::outer_arg_ck<int64_t, Max>::make(
+        ckb, kernreq, ckb_offset, dst_stride, src_size, src_stride, block_rows,
+        block_cols);
+    return ckb_offset;
+  case uint8_type_id:
+    nd::functional::outer_arg_ck<uint8_t, Max>::make(
+        ckb, kernreq, ckb_offset, dst_stride, src_size, src_stride, block_rows,
+        block_cols);
+    return ckb_offset;
+  case uint16_type_id:
+    nd::functional::outer_arg_ck<uint16_t, Max>::make(
+        ckb, kernreq, ckb_offset, dst_stride, src_size, src_stride, block_rows,
+        block_cols);
+    return ckb_offset;
+  case uint32_type_id:
+    nd::functional::outer_arg_ck<uint32_t, Max>::make(
+        ckb, kernreq, ckb_offset, dst_stride, src_size, src_stride, block_rows,
+        block_cols);
+    return ckb_offset;
+  case uint64_type_id:
+    nd::functional::outer_arg_ck<uint64_t, Max>::make(
+        ckb, kernreq, ckb_offset, dst_stride, src_size, src_stride, block_rows,
+        block_cols);
+    return ckb_offset;
+  case float32_type_id:
+    nd::functional::outer_arg_ck<float, Max>::make(
+        ckb, kernreq, ckb_offset, dst_stride, src_size, src_stride, block_rows,
+        block_cols);
+    return ckb_offset;
+  case float64_type_id:
+    nd::functional::outer_arg_ck<double, Max>::make(
+        ckb, kernreq, ckb_offset, dst_stride, src_size, src_stride, block_rows,
+        block_cols);
+    return ckb_offset;
+  default:
+    return -1;
+  }
+}
+
+} // anonymous namespace
+
+intptr_t nd::functional::outer_arg_virtual_ck::instantiate(
+    char *static_data, size_t DYND_UNUSED(data_size), char *DYND_UNUSED(data),
+    void *ckb, intptr_t ckb_offset, const ndt::type &dst_tp,
+    const char *dst_arrmeta, intptr_t nsrc, const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &kwds,
+    const std::map<nd::string, ndt::type> &tp_vars)
+{
+  const outer_reduce_data &od =
+      **reinterpret_cast<std::shared_ptr<outer_reduce_data> *>(static_data);
+
+  intptr_t src_size[2], src_stride[2];
+  ndt::type child_src_tp[2];
+  const char *child_src_arrmeta[2];
+  if (!get_outer_operands(od.child.get_type(), src_tp, src_arrmeta, src_size,
+                          src_stride, child_src_tp, child_src_arrmeta)) {
+    stringstream ss;
+    ss << "outer_argmin and outer_argmax require operands with one strided "
+          "dimension more than the child takes, not " << src_tp[0] << " and "
+       << src_tp[1];
+    throw invalid_argument(ss.str());
+  }
+
+  intptr_t dst_size, dst_stride;
+  ndt::type dst_el_tp;
+  const char *dst_el_arrmeta;
+  if (!dst_tp.get_as_strided(dst_arrmeta, &dst_size, &dst_stride, &dst_el_tp,
+                             &dst_el_arrmeta)) {
+    stringstream ss;
+    ss << "outer_argmin and outer_argmax require a strided destination, not "
+       << dst_tp;
+    throw invalid_argument(ss.str());
+  }
+  if (src_size[0] > 0 && src_size[1] == 0) {
+    throw invalid_argument(
+        "outer_argmin and outer_argmax cannot reduce an empty second operand");
+  }
+
+  ndt::type value_tp = get_outer_value_type(od.child, src_tp, kwds, tp_vars);
+  intptr_t block_rows, block_cols;
+  get_outer_block_shape(child_src_tp[0].get_data_size(),
+                        child_src_tp[1].get_data_size(), block_rows,
+                        block_cols);
+  intptr_t child_ckb_offset =
+      od.arg_max ? make_outer_arg_ck<true>(
+                       value_tp.get_type_id(), ckb, kernreq, ckb_offset,
+                       dst_stride, src_size, src_stride, block_rows, block_cols)
+                 : make_outer_arg_ck<false>(
+                       value_tp.get_type_id(), ckb, kernreq, ckb_offset,
+                       dst_stride, src_size, src_stride, block_rows, block_cols);
+  if (child_ckb_offset < 0) {
+    stringstream ss;
+    ss << "outer_argmin and outer_argmax require the child to return an "
+          "integer or floating point type, not " << value_tp;
+    throw type_error(ss.str());
+  }
+
+  return od.child.get()->instantiate(
+      const_cast<char *>(od.child.get()->static_data), 0, NULL, ckb,
+      child_ckb_offset, value_tp, NULL, nsrc, child_src_tp, child_src_arrmeta,
+      kernel_request_strided, ectx, kwds, tp_vars);
+}
@@ -11,6 +11,136 @@
 using namespace std;
 using namespace dynd;
 
+namespace {
+
+// How many indices ahead of the current one gather and scatter prefetch
+enum { take_prefetch_distance = 16 };
+
+/**
+ * Prefetches the element an upcoming index points at, ignoring indices
+ * that are negative or out of bounds.
+ */
+template <int RW>
+inline void prefetch_indexed(const char *data, const char *index,
+                             intptr_t dim_size, intptr_t stride)
+{
+#if defined(__GNUC__)
+  intptr_t ix = *reinterpret_cast<const intptr_t *>(index);
+  if (ix >= 0 && ix < dim_size) {
+    __builtin_prefetch(data + ix * stride, RW);
+  }
+#else
+  (void)data, (void)index, (void)dim_size, (void)stride;
+#endif
+}
+
+/** Gathers builtin elements the size of T by the intptr indices */
+template <typename T>
+void gather(char *dst, intptr_t dst_stride, const char *src0,
+            intptr_t src0_dim_size, intptr_t src0_stride, const char *index,
+            intptr_t index_stride, intptr_t count)
+{
+  for (intptr_t i = 0; i < count; ++i) {
+    if (i + take_prefetch_distance < count) {
+      prefetch_indexed<0>(src0, index + take_prefetch_distance * index_stride,
+                          src0_dim_size, src0_stride);
+    }
+    intptr_t ix = apply_single_index(*reinterpret_cast<const intptr_t *>(index),
+                                     src0_dim_size, NULL);
+    *reinterpret_cast<T *>(dst) =
+        *reinterpret_cast<const T *>(src0 + ix * src0_stride);
+    dst += dst_stride;
+    index += index_stride;
+  }
+}
+
+/** Scatters builtin elements the size of T to the intptr indices */
+template <typename T>
+void scatter(char *dst, intptr_t dst_dim_size, intptr_t dst_stride,
+             const char *src0, intptr_t src0_stride, const char *index,
+             intptr_t index_stride, intptr_t count)
+{
+  for (intptr_t i = 0; i < count; ++i) {
+    if (i + take_prefetch_distance < count) {
+      prefetch_indexed<1>(dst, index + take_prefetch_distance * index_stride,
+                          dst_dim_size, dst_stride);
+    }
+    intptr_t ix = apply_single_index(*reinterpret_cast<const intptr_t *>(index),
+                                     dst_dim_size, NULL);
+    *reinterpret_cast<T *>(dst + ix * dst_stride) =
+        *reinterpret_cast<const T *>(src0);
+    src0 += src0_stride;
+    index += index_stride;
+  }
+}
+
+/**
+ * Copies the builtin elements the size of T whose mask is true, returning
+ * how many there were. The destination must have room for all of them.
+ * With a contiguous mask, eight mask bytes are tested at once so runs of
+ * all false or all true are skipped or copied without branching per
+ * element, and mixed runs store every element and advance the output by
+ * the mask value.
+ */
+template <typename T>
+intptr_t compress(char *dst, intptr_t dst_stride, const char *src0,
+                  intptr_t src0_stride, const char *mask, intptr_t mask_stride,
+                  intptr_t dim_size)
+{
+  intptr_t count = 0, i = 0;
+  if (mask_stride == 1) {
+    for (; i + 8 <= dim_size; i += 8) {
+      uint64_t word;
+      memcpy(&word, mask + i, sizeof(word));
+      if (word == 0) {
+        continue;
+      } else if (word == 0x0101010101010101ULL) {
+        for (intptr_t j = 0; j < 8; ++j) {
+          *reinterpret_cast<T *>(dst + (count + j) * dst_stride) =
+              *reinterpret_cast<const T *>(src0 + (i + j) * src0_stride);
+        }
+        count += 8;
+      } else {
+        for (intptr_t j = 0; j < 8; ++j) {
+          *reinterpret_cast<T *>(dst + count * dst_stride) =
+              *reinterpret_cast<const T *>(src0 + (i + j) * src0_stride);
+          count += mask[i + j] != 0;
+        }
+      }
+    }
+  }
+  for (; i < dim_size; ++i) {
+    if (mask[i * mask_stride] != 0) {
+      *reinterpret_cast<T *>(dst + count * dst_stride) =
+          *reinterpret_cast<const T *>(src0 + i * src0_stride);
+      ++count;
+    }
+  }
+  return count;
+}
+
+/**
+ * Returns the size of the elements if they're builtin, of the same type
+ * and a size the typed loops handle, and 0 otherwise.
+ */
+intptr_t get_pod_size(const ndt::type &dst_el_tp, const ndt::type &src0_el_tp)
+{
+  if (dst_el_tp.is_builtin() && dst_el_tp == src0_el_tp) {
+    switch (dst_el_tp.get_data_size()) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+      return dst_el_tp.get_data_size();
+    default:
+      break;
+    }
+  }
+  return 0;
+}
+
+} // anonymous namespace
+
 void nd::masked_take_ck::single(char *dst, char *const *src)
 {
   ckernel_prefix *child = get_child_ckernel();
@@ -27,7 +157,27 @@ void nd::masked_take_ck::single(char *dst, char *const *src)
   intptr_t dst_stride =
       reinterpret_cast<const var_dim_type_arrmeta *>(m_dst_meta)->stride;
   intptr_t dst_count = 0;
-  intptr_t i = 0;
+  switch (m_pod_size) {
+  case 1:
+    dst_count = compress<uint8_t>(dst_ptr, dst_stride, src0, src0_stride, mask,
+                                  mask_stride, dim_size);
+    break;
+  case 2:
+    dst_count = compress<uint16_t>(dst_ptr, dst_stride, src0, src0_stride,
+                                   mask, mask_stride, dim_size);
+    break;
+  case 4:
+    dst_count = compress<uint32_t>(dst_ptr, dst_stride, src0, src0_stride,
+                                   mask, mask_stride, dim_size);
+    break;
+  case 8:
+    dst_count = compress<uint64_t>(dst_ptr, dst_stride, src0, src0_stride,
+                                   mask, mask_stride, dim_size);
+    break;
+  default:
+    break;
+  }
+  intptr_t i = m_pod_size != 0 ? dim_size : 0;
   while (i < dim_size) {
     // Run of false
     for (; i < dim_size && *mask == 0;
@@ -114,6 +264,8 @@ intptr_t nd::masked_take_ck::instantiate(
     throw type_error(ss.str());
   }
 
+  self->m_pod_size = get_pod_size(dst_el_tp, src0_el_tp);
+
   // Create the child element assignment ckernel
   return make_assignment_kernel(ckb, ckb_offset, dst_el_tp, dst_el_meta,
                                 src0_el_tp, src0_el_meta,
@@ -129,6 +281,26 @@ void nd::indexed_take_ck::single(char *dst, char *const *src)
   intptr_t dst_dim_size = m_dst_dim_size, src0_dim_size = m_src0_dim_size,
            dst_stride = m_dst_stride, src0_stride = m_src0_stride,
            index_stride = m_index_stride;
+  switch (m_pod_size) {
+  case 1:
+    gather<uint8_t>(dst, dst_stride, src0, src0_dim_size, src0_stride, index,
+                    index_stride, dst_dim_size);
+    return;
+  case 2:
+    gather<uint16_t>(dst, dst_stride, src0, src0_dim_size, src0_stride, index,
+                     index_stride, dst_dim_size);
+    return;
+  case 4:
+    gather<uint32_t>(dst, dst_stride, src0, src0_dim_size, src0_stride, index,
+                     index_stride, dst_dim_size);
+    return;
+  case 8:
+    gather<uint64_t>(dst, dst_stride, src0, src0_dim_size, src0_stride, index,
+                     index_stride, dst_dim_size);
+    return;
+  default:
+    break;
+  }
   for (intptr_t i = 0; i < dst_dim_size; ++i) {
     intptr_t ix = *reinterpret_cast<const intptr_t *>(index);
     // Handle Python-style negative index, bounds checking
@@ -202,6 +374,128 @@ intptr_t nd::indexed_take_ck::instantiate(
     throw type_error(ss.str());
   }
 
+  self->m_pod_size = get_pod_size(dst_el_tp, src0_el_tp);
+
+  // Create the child element assignment ckernel
+  return make_assignment_kernel(ckb, ckb_offset, dst_el_tp, dst_el_meta,
+                                src0_el_tp, src0_el_meta, kernel_request_single,
+                                ectx);
+}
+
+void nd::put_ck::single(char *dst, char *const *src)
+{
+  ckernel_prefix *child = get_child_ckernel();
+  expr_single_t child_fn = child->get_function<expr_single_t>();
+  const char *index = src[0];
+  char *src0 = src[1];
+  intptr_t dst_dim_size = m_dst_dim_size, src0_dim_size = m_src0_dim_size,
+           dst_stride = m_dst_stride, src0_stride = m_src0_stride,
+           index_stride = m_index_stride;
+  switch (m_pod_size) {
+  case 1:
+    scatter<uint8_t>(dst, dst_dim_size, dst_stride, src0, src0_stride, index,
+                     index_stride, src0_dim_size);
+    return;
+  case 2:
+    scatter<uint16_t>(dst, dst_dim_size, dst_stride, src0, src0_stride, index,
+                      index_stride, src0_dim_size);
+    return;
+  case 4:
+    scatter<uint32_t>(dst, dst_dim_size, dst_stride, src0, src0_stride, index,
+                      index_stride, src0_dim_size);
+    return;
+  case 8:
+    scatter<uint64_t>(dst, dst_dim_size, dst_stride, src0, src0_stride, index,
+                      index_stride, src0_dim_size);
+    return;
+  default:
+    break;
+  }
+  for (intptr_t i = 0; i < src0_dim_size; ++i) {
+    intptr_t ix = *reinterpret_cast<const intptr_t *>(index);
+    // Handle Python-style negative index, bounds checking
+    ix = apply_single_index(ix, dst_dim_size, NULL);
+    // Copy one element at a time
+    child_fn(dst + ix * dst_stride, &src0, child);
+    src0 += src0_stride;
+    index += index_stride;
+  }
+}
+
+void nd::put_ck::destruct_children()
+{
+  // The child copy ckernel
+  get_child_ckernel()->destroy();
+}
+
+void nd::put_ck::resolve_dst_type(
+    char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+    char *DYND_UNUSED(data), ndt::type &DYND_UNUSED(dst_tp),
+    intptr_t DYND_UNUSED(nsrc), const ndt::type *DYND_UNUSED(src_tp),
+    const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  throw invalid_argument("put arrfunc: the array to put into must be "
+                         "provided with the \"dst\" keyword");
+}
+
+intptr_t nd::put_ck::instantiate(
+    char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+    char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+    const ndt::type &dst_tp, const char *dst_arrmeta,
+    intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+    const char *const *src_arrmeta, kernel_request_t kernreq,
+    const eval::eval_context *ectx, const nd::array &DYND_UNUSED(kwds),
+    const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+{
+  typedef nd::put_ck self_type;
+
+  self_type *self = self_type::make(ckb, kernreq, ckb_offset);
+
+  ndt::type dst_el_tp;
+  const char *dst_el_meta;
+  if (!dst_tp.get_as_strided(dst_arrmeta, &self->m_dst_dim_size,
+                             &self->m_dst_stride, &dst_el_tp, &dst_el_meta)) {
+    stringstream ss;
+    ss << "put arrfunc: could not process type " << dst_tp;
+    ss << " as a strided dimension";
+    throw type_error(ss.str());
+  }
+
+  intptr_t index_dim_size;
+  ndt::type src0_el_tp, index_el_tp;
+  const char *src0_el_meta, *index_el_meta;
+  if (!src_tp[0].get_as_strided(src_arrmeta[0], &index_dim_size,
+                                &self->m_index_stride, &index_el_tp,
+                                &index_el_meta)) {
+    stringstream ss;
+    ss << "put arrfunc: could not process type " << src_tp[0];
+    ss << " as a strided dimension";
+    throw type_error(ss.str());
+  }
+  if (!src_tp[1].get_as_strided(src_arrmeta[1], &self->m_src0_dim_size,
+                                &self->m_src0_stride, &src0_el_tp,
+                                &src0_el_meta)) {
+    stringstream ss;
+    ss << "put arrfunc: could not process type " << src_tp[1];
+    ss << " as a strided dimension";
+    throw type_error(ss.str());
+  }
+  if (self->m_src0_dim_size != index_dim_size) {
+    stringstream ss;
+    ss << "put arrfunc: index data and values have different sizes, ";
+    ss << index_dim_size << " and " << self->m_src0_dim_size;
+    throw invalid_argument(ss.str());
+  }
+  if (index_el_tp.get_type_id() != (type_id_t)type_id_of<intptr_t>::value) {
+    stringstream ss;
+    ss << "put arrfunc: index type should be intptr, not ";
+    ss << index_el_tp;
+    throw type_error(ss.str());
+  }
+
+  self->m_pod_size = get_pod_size(dst_el_tp, src0_el_tp);
+
   // Create the child element assignment ckernel
   return make_assignment_kernel(ckb, ckb_offset, dst_el_tp, dst_el_meta,
                                 src0_el_tp, src0_el_meta, kernel_request_single,
@@ -3,7 +3,10 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <atomic>
+
 #include <dynd/memblock/array_memory_block.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
 #include <dynd/types/base_memory_type.hpp>
 #include <dynd/array.hpp>
 #include <dynd/exceptions.hpp>
@@ -12,6 +15,179 @@
 using namespace std;
 using namespace dynd;
 
+namespace {
+    /**
+     * Every array memory block allocation is prefixed by this header, which
+     * records where the memory came from so it can be returned there.
+     */
+    struct array_memory_block_header {
+        memory_allocator *m_allocator;
+        size_t m_allocated_size;
+    };
+
+    /** The offset from the allocation to the memory block, preserving alignment */
+    static const size_t array_memory_block_header_size = 16;
+
+    /**
+     * Small array memory blocks are rounded up to a power of two size
+     * class between 64 and 4096 bytes (including the header), and freed
+     * blocks are kept on a per-thread free list for their size class
+     * instead of going back to the allocator.
+     *
+     * Only blocks from the malloc allocator are pooled, so a custom
+     * allocator sees every allocation and never has blocks outliving it
+     * in a cache. Blocks sitting in a cache still count as live bytes of
+     * the malloc allocator.
+     */
+// MSVC 2013 doesn't support thread_local, so it goes without the pool
+#if !(defined(_MSC_VER) && (_MSC_VER == 1800))
+#define DYND_ARRAY_MEMORY_BLOCK_POOL
+#endif
+
+    static const size_t array_memory_block_min_class_size = 64;
+    static const int array_memory_block_size_class_count = 7;
+    /** The maximum number of blocks a thread keeps per size class */
+    static const intptr_t array_memory_block_pool_depth = 32;
+
+    std::atomic<bool> &array_memory_block_pool_enabled()
+    {
+        static std::atomic<bool> enabled(true);
+        return enabled;
+    }
+
+    /** Returns the size class for an allocation size, or -1 if it's too big */
+    inline int get_array_memory_block_size_class(size_t allocated_size)
+    {
+        size_t class_size = array_memory_block_min_class_size;
+        for (int i = 0; i < array_memory_block_size_class_count; ++i, class_size *= 2) {
+            if (allocated_size <= class_size) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+#ifdef DYND_ARRAY_MEMORY_BLOCK_POOL
+    /**
+     * A free list entry, overlaid on the memory of a cached allocation.
+     */
+    struct array_memory_block_free_entry {
+        array_memory_block_header m_header;
+        array_memory_block_free_entry *m_next;
+    };
+
+    /**
+     * The per-thread cache. This is kept trivially destructible so it stays
+     * usable while other thread_local and static objects are destroyed, with
+     * a separate guard object freeing its contents at thread exit.
+     */
+    struct array_memory_block_cache {
+        array_memory_block_free_entry *m_free_list[array_memory_block_size_class_count];
+        intptr_t m_count[array_memory_block_size_class_count];
+        bool m_guard_registered, m_thread_exited;
+
+        void clear()
+        {
+            for (int i = 0; i < array_memory_block_size_class_count; ++i) {
+                while (m_free_list[i] != NULL) {
+                    array_memory_block_free_entry *entry = m_free_list[i];
+                    m_free_list[i] = entry->m_next;
+                    detail::memory_allocator_deallocate(entry->m_header.m_allocator,
+                                                        array_memory_block_type, entry,
+                                                        entry->m_header.m_allocated_size);
+                }
+                m_count[i] = 0;
+            }
+        }
+    };
+
+    thread_local array_memory_block_cache tls_array_memory_block_cache;
+
+    struct array_memory_block_cache_guard {
+        ~array_memory_block_cache_guard()
+        {
+            tls_array_memory_block_cache.clear();
+            tls_array_memory_block_cache.m_thread_exited = true;
+        }
+    };
+
+    /**
+     * Returns the calling thread's cache, or NULL if the thread is
+     * exiting and the cache has already been freed.
+     */
+    array_memory_block_cache *get_array_memory_block_cache()
+    {
+        array_memory_block_cache *cache = &tls_array_memory_block_cache;
+        if (cache->m_thread_exited) {
+            return NULL;
+        }
+        if (!cache->m_guard_registered) {
+            static thread_local array_memory_block_cache_guard guard;
+            (void)guard;
+            cache->m_guard_registered = true;
+        }
+        return cache;
+    }
+#endif // DYND_ARRAY_MEMORY_BLOCK_POOL
+
+    char *allocate_array_memory_block(size_t size_bytes)
+    {
+        memory_allocator *alloc = get_memory_allocator();
+        size_t allocated_size = array_memory_block_header_size + size_bytes;
+#ifdef DYND_ARRAY_MEMORY_BLOCK_POOL
+        if (alloc == get_malloc_memory_allocator() && array_memory_block_pool_enabled().load()) {
+            int size_class = get_array_memory_block_size_class(allocated_size);
+            if (size_class >= 0) {
+                array_memory_block_cache *cache = get_array_memory_block_cache();
+                array_memory_block_free_entry *entry =
+                    cache != NULL ? cache->m_free_list[size_class] : NULL;
+                if (entry != NULL) {
+                    cache->m_free_list[size_class] = entry->m_next;
+                    --cache->m_count[size_class];
+                    // A reused block is still an allocation in the statistics
+                    ++alloc->allocation_count_by_type[array_memory_block_type];
+                    return reinterpret_cast<char *>(entry) + array_memory_block_header_size;
+                }
+                allocated_size = array_memory_block_min_class_size << size_class;
+            }
+        }
+#endif // DYND_ARRAY_MEMORY_BLOCK_POOL
+        char *result = detail::memory_allocator_allocate(alloc, array_memory_block_type,
+                                                         allocated_size);
+        array_memory_block_header *header = reinterpret_cast<array_memory_block_header *>(result);
+        header->m_allocator = alloc;
+        header->m_allocated_size = allocated_size;
+        return result + array_memory_block_header_size;
+    }
+
+    void free_array_memory(memory_block_data *memblock)
+    {
+        array_memory_block_header *header = reinterpret_cast<array_memory_block_header *>(
+            reinterpret_cast<char *>(memblock) - array_memory_block_header_size);
+#ifdef DYND_ARRAY_MEMORY_BLOCK_POOL
+        // Only allocations which were rounded to a size class go in the cache
+        if (header->m_allocator == get_malloc_memory_allocator() &&
+                        array_memory_block_pool_enabled().load()) {
+            int size_class = get_array_memory_block_size_class(header->m_allocated_size);
+            if (size_class >= 0 &&
+                            header->m_allocated_size == (array_memory_block_min_class_size << size_class)) {
+                array_memory_block_cache *cache = get_array_memory_block_cache();
+                if (cache != NULL && cache->m_count[size_class] < array_memory_block_pool_depth) {
+                    array_memory_block_free_entry *entry =
+                        reinterpret_cast<array_memory_block_free_entry *>(header);
+                    entry->m_next = cache->m_free_list[size_class];
+                    cache->m_free_list[size_class] = entry;
+                    ++cache->m_count[size_class];
+                    return;
+                }
+            }
+        }
+#endif // DYND_ARRAY_MEMORY_BLOCK_POOL
+        detail::memory_allocator_deallocate(header->m_allocator, array_memory_block_type,
+                                            header, header->m_allocated_size);
+    }
+} // anonymous namespace
+
 namespace dynd { namespace detail {
 
 void free_array_memory_block(memory_block_data *memblock)
@@ -49,19 +225,17 @@ void free_array_memory_block(memory_block_data *memblock)
     }
 
     // Finally free the memory block itself
-    free(reinterpret_cast<void *>(memblock));
+    free_array_memory(memblock);
 }
 
 }} // namespace dynd::detail
 
 memory_block_ptr dynd::make_array_memory_block(size_t arrmeta_size)
 {
-    char *result = (char *)malloc(sizeof(memory_block_data) + sizeof(array_preamble) + arrmeta_size);
-    if (result == 0) {
-        throw bad_alloc();
-    }
+    char *result = allocate_array_memory_block(sizeof(array_preamble) + arrmeta_size);
     // Zero out all the arrmeta to start
-    memset(result + sizeof(memory_block_data), 0, sizeof(array_preamble) + arrmeta_size);
+    memset(result + sizeof(memory_block_data), 0,
+           sizeof(array_preamble) - sizeof(memory_block_data) + arrmeta_size);
     return memory_block_ptr(new (result) memory_block_data(1, array_memory_block_type), false);
 }
 
@@ -70,22 +244,37 @@ memory_block_ptr dynd::make_array_memory_block(size_t arrmeta_size,
                                                size_t extra_alignment,
                                                char **out_extra_ptr)
 {
-  size_t extra_offset = inc_to_alignment(
-      sizeof(memory_block_data) + sizeof(array_preamble) + arrmeta_size,
-      extra_alignment);
-  char *result = (char *)malloc(extra_offset + extra_size);
-  if (result == 0) {
-    throw bad_alloc();
-  }
+  size_t extra_offset =
+      inc_to_alignment(sizeof(array_preamble) + arrmeta_size, extra_alignment);
+  char *result = allocate_array_memory_block(extra_offset + extra_size);
   // Zero out all the arrmeta to start
   memset(result + sizeof(memory_block_data), 0,
-         sizeof(array_preamble) + arrmeta_size);
+         sizeof(array_preamble) - sizeof(memory_block_data) + arrmeta_size);
   // Return a pointer to the extra allocated memory
   *out_extra_ptr = result + extra_offset;
   return memory_block_ptr(
       new (result) memory_block_data(1, array_memory_block_type), false);
 }
 
+bool dynd::set_array_memory_block_pool_enabled(bool enabled)
+{
+    bool previous = array_memory_block_pool_enabled().exchange(enabled);
+    if (!enabled) {
+        clear_array_memory_block_pool();
+    }
+    return previous;
+}
+
+void dynd::clear_array_memory_block_pool()
+{
+#ifdef DYND_ARRAY_MEMORY_BLOCK_POOL
+    array_memory_block_cache *cache = get_array_memory_block_cache();
+    if (cache != NULL) {
+        cache->clear();
+    }
+#endif // DYND_ARRAY_MEMORY_BLOCK_POOL
+}
+
 memory_block_ptr dynd::shallow_copy_array_memory_block(const memory_block_ptr& ndo)
 {
     // Allocate the new memory block.
@@ -6,15 +6,29 @@
 #include <cstdlib>
 
 #include <dynd/memblock/fixed_size_pod_memory_block.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
 
 using namespace std;
 using namespace dynd;
 
+namespace {
+    struct fixed_size_pod_memory_block {
+        /** Every memory block object needs this at the front */
+        memory_block_data m_mbd;
+        /** The allocator the memory block comes from */
+        memory_allocator *m_allocator;
+        /** The total size of the allocation, including this header */
+        intptr_t m_allocated_size;
+    };
+} // anonymous namespace
+
 namespace dynd { namespace detail {
 
 void free_fixed_size_pod_memory_block(memory_block_data *memblock)
 {
-    free(reinterpret_cast<void *>(memblock));
+    fixed_size_pod_memory_block *emb = reinterpret_cast<fixed_size_pod_memory_block *>(memblock);
+    memory_allocator_deallocate(emb->m_allocator, fixed_size_pod_memory_block_type,
+                                emb, emb->m_allocated_size);
 }
 
 }} // namespace dynd::detail
@@ -22,20 +36,25 @@ void free_fixed_size_pod_memory_block(memory_block_data *memblock)
 memory_block_ptr dynd::make_fixed_size_pod_memory_block(intptr_t size_bytes, intptr_t alignment, char **out_datapointer)
 {
     // Calculate the aligned starting point for the data
-    intptr_t start = (intptr_t)(((uintptr_t)sizeof(memory_block_data) + (uintptr_t)(alignment - 1))
+    intptr_t start = (intptr_t)(((uintptr_t)sizeof(fixed_size_pod_memory_block) + (uintptr_t)(alignment - 1))
                         & ~((uintptr_t)(alignment - 1)));
     // Allocate it
-    char *result = (char *)malloc(start + size_bytes);
-    if (result == 0) {
-        throw bad_alloc();
-    }
+    memory_allocator *alloc = get_memory_allocator();
+    char *result = detail::memory_allocator_allocate(alloc, fixed_size_pod_memory_block_type,
+                                                     start + size_bytes);
     // Give back the data pointer
     *out_datapointer = result + start;
     // Use placement new to initialize and return the memory block
-    return memory_block_ptr(new (result) memory_block_data(1, fixed_size_pod_memory_block_type), false);
+    fixed_size_pod_memory_block *emb = reinterpret_cast<fixed_size_pod_memory_block *>(result);
+    new (&emb->m_mbd) memory_block_data(1, fixed_size_pod_memory_block_type);
+    emb->m_allocator = alloc;
+    emb->m_allocated_size = start + size_bytes;
+    return memory_block_ptr(&emb->m_mbd, false);
 }
 
-void dynd::fixed_size_pod_memory_block_debug_print(const memory_block_data *DYND_UNUSED(memblock),
-                std::ostream& DYND_UNUSED(o), const std::string& DYND_UNUSED(indent))
+void dynd::fixed_size_pod_memory_block_debug_print(const memory_block_data *memblock,
+                std::ostream& o, const std::string& indent)
 {
+    const fixed_size_pod_memory_block *emb = reinterpret_cast<const fixed_size_pod_memory_block *>(memblock);
+    o << indent << " allocated: " << emb->m_allocated_size << "\n";
 }
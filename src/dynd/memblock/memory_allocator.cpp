@@ -0,0 +1,128 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstdlib>
+#include <new>
+
+#include <dynd/memblock/memory_allocator.hpp>
+
+using namespace std;
+using namespace dynd;
+
+dynd::memory_allocator::memory_allocator(
+    void *(*allocate_func)(memory_allocator *, size_t),
+    void (*deallocate_func)(memory_allocator *, void *, size_t))
+    : allocate(allocate_func), deallocate(deallocate_func), limit_bytes(0),
+      live_bytes(0), peak_bytes(0)
+{
+    for (int i = 0; i < memory_block_type_count; ++i) {
+        live_bytes_by_type[i] = 0;
+        allocation_count_by_type[i] = 0;
+    }
+}
+
+void dynd::memory_allocator::reset_peak()
+{
+    peak_bytes = live_bytes.load();
+}
+
+namespace {
+    void *malloc_allocate(memory_allocator *DYND_UNUSED(self), size_t size_bytes)
+    {
+        return malloc(size_bytes);
+    }
+
+    void malloc_deallocate(memory_allocator *DYND_UNUSED(self), void *ptr,
+                           size_t DYND_UNUSED(size_bytes))
+    {
+        free(ptr);
+    }
+
+    memory_allocator& malloc_memory_allocator()
+    {
+        static memory_allocator alloc(&malloc_allocate, &malloc_deallocate);
+        return alloc;
+    }
+
+    std::atomic<memory_allocator *>& current_memory_allocator()
+    {
+        static std::atomic<memory_allocator *> current(&malloc_memory_allocator());
+        return current;
+    }
+} // anonymous namespace
+
+memory_allocator *dynd::get_malloc_memory_allocator()
+{
+    return &malloc_memory_allocator();
+}
+
+memory_allocator *dynd::get_memory_allocator()
+{
+    return current_memory_allocator().load();
+}
+
+memory_allocator *dynd::set_memory_allocator(memory_allocator *alloc)
+{
+    if (alloc == NULL) {
+        alloc = &malloc_memory_allocator();
+    }
+    return current_memory_allocator().exchange(alloc);
+}
+
+char *dynd::detail::memory_allocator_allocate(memory_allocator *alloc,
+                                              memory_block_type_t mbt, size_t size_bytes)
+{
+    intptr_t live = (alloc->live_bytes += size_bytes);
+    intptr_t limit = alloc->limit_bytes.load();
+    if (limit != 0 && live > limit) {
+        alloc->live_bytes -= size_bytes;
+        throw bad_alloc();
+    }
+
+    char *result = reinterpret_cast<char *>(alloc->allocate(alloc, size_bytes));
+    if (result == NULL) {
+        alloc->live_bytes -= size_bytes;
+        throw bad_alloc();
+    }
+
+    // Raise the high water mark if this allocation went past it
+    intptr_t peak = alloc->peak_bytes.load();
+    while (live > peak && !alloc->peak_bytes.compare_exchange_weak(peak, live)) {
+    }
+    alloc->live_bytes_by_type[mbt] += size_bytes;
+    ++alloc->allocation_count_by_type[mbt];
+
+    return result;
+}
+
+void dynd::detail::memory_allocator_deallocate(memory_allocator *alloc,
+                                               memory_block_type_t mbt, void *ptr,
+                                               size_t size_bytes)
+{
+    if (ptr != NULL) {
+        alloc->deallocate(alloc, ptr, size_bytes);
+        alloc->live_bytes -= size_bytes;
+        alloc->live_bytes_by_type[mbt] -= size_bytes;
+    }
+}
+
+void dynd::memory_allocator_debug_print(const memory_allocator *alloc, std::ostream &o,
+                                        const std::string &indent)
+{
+    o << indent << "------ memory_allocator at " << (const void *)alloc << "\n";
+    o << indent << " live bytes: " << alloc->live_bytes.load() << "\n";
+    o << indent << " peak bytes: " << alloc->peak_bytes.load() << "\n";
+    if (alloc->limit_bytes.load() != 0) {
+        o << indent << " limit bytes: " << alloc->limit_bytes.load() << "\n";
+    }
+    for (int i = 0; i < memory_block_type_count; ++i) {
+        if (alloc->allocation_count_by_type[i].load() != 0) {
+            o << indent << " " << (memory_block_type_t)i << ": "
+              << alloc->allocation_count_by_type[i].load() << " allocations, "
+              << alloc->live_bytes_by_type[i].load() << " live bytes\n";
+        }
+    }
+    o << indent << "------" << endl;
+}
@@ -9,6 +9,7 @@
 #include <algorithm>
 
 #include <dynd/memblock/objectarray_memory_block.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -27,7 +28,9 @@ namespace {
         intptr_t m_stride;
         size_t m_total_allocated_count;
         bool m_finalized;
-        /** The malloc'd memory */
+        /** The allocator the memory comes from */
+        memory_allocator *m_allocator;
+        /** The allocated memory */
         vector<memory_chunk> m_memory_handles;
 
         /**
@@ -40,19 +43,27 @@ namespace {
             memory_chunk& mc = m_memory_handles.back();
             mc.used_count = 0;
             mc.capacity_count = count;
-            char *memory = reinterpret_cast<char *>(malloc(m_stride * count));
-            mc.memory = memory;
-            if (memory == NULL) {
+            try {
+                mc.memory = detail::memory_allocator_allocate(
+                    m_allocator, objectarray_memory_block_type, m_stride * count);
+            } catch(...) {
                 m_memory_handles.pop_back();
-                throw bad_alloc();
+                throw;
             }
             m_total_allocated_count += count;
         }
 
+        void free_memory(const memory_chunk& mc)
+        {
+            detail::memory_allocator_deallocate(m_allocator, objectarray_memory_block_type,
+                                                mc.memory, m_stride * mc.capacity_count);
+        }
+
         objectarray_memory_block(const ndt::type& dt, const char *arrmeta, intptr_t stride, intptr_t initial_count)
             : m_mbd(1, objectarray_memory_block_type), m_dt(dt), m_arrmeta(arrmeta),
                             m_stride(stride), m_total_allocated_count(0),
-                            m_finalized(false), m_memory_handles()
+                            m_finalized(false), m_allocator(get_memory_allocator()),
+                            m_memory_handles()
         {
             if ((dt.get_flags()&type_flag_destructor) == 0) {
                 stringstream ss;
@@ -68,7 +79,7 @@ namespace {
             for (size_t i = 0, i_end = m_memory_handles.size(); i != i_end; ++i) {
                 memory_chunk& mc = m_memory_handles[i];
                 m_dt.extended()->data_destruct_strided(m_arrmeta, mc.memory, m_stride, mc.used_count);
-                free(mc.memory);
+                free_memory(mc);
             }
         }
     };
@@ -134,7 +145,7 @@ static char *resize(memory_block_data *self, char *previous_allocated, size_t co
             // If the old memory only had the memory being resized,
             // free it completely.
             if (previous_allocated == mc->memory) {
-                free(mc->memory);
+                emb->free_memory(*mc);
                 // Remove the second-last element of the vector
                 emb->m_memory_handles.erase(
                             emb->m_memory_handles.begin() +
@@ -190,7 +201,7 @@ static void reset(memory_block_data *self)
             memory_chunk& mc = emb->m_memory_handles[i];
             emb->m_dt.extended()->data_destruct_strided(
                 emb->m_arrmeta, mc.memory, emb->m_stride, mc.used_count);
-            free(mc.memory);
+            emb->free_memory(mc);
         }
         emb->m_memory_handles.front() = emb->m_memory_handles.back();
         emb->m_memory_handles.resize(1);
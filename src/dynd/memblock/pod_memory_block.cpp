@@ -9,19 +9,32 @@
 #include <algorithm>
 
 #include <dynd/memblock/pod_memory_block.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
 
 using namespace std;
 using namespace dynd;
 
 namespace {
+    struct memory_chunk {
+        char *memory;
+        intptr_t capacity_bytes;
+    };
+
     struct pod_memory_block {
         /** Every memory block object needs this at the front */
         memory_block_data m_mbd;
         intptr_t m_total_allocated_capacity;
-        /** The malloc'd memory */
-        vector<char *> m_memory_handles;
-        /** The current malloc'd memory being doled out */
+        /** The allocator the memory comes from */
+        memory_allocator *m_allocator;
+        /** The allocated memory */
+        vector<memory_chunk> m_memory_handles;
+        /** The current allocated memory being doled out */
         char *m_memory_begin, *m_memory_current, *m_memory_end;
+        /**
+         * The number of bytes the block expects to need between resets,
+         * learned from the memory used by previous batches
+         */
+        intptr_t m_size_hint;
 
         /**
          * Allocates some new memory from which to dole out
@@ -29,13 +42,18 @@ namespace {
          */
         void append_memory(intptr_t capacity_bytes)
         {
-            m_memory_handles.push_back(NULL);
-            m_memory_begin = reinterpret_cast<char *>(malloc(capacity_bytes));
-            m_memory_handles.back() = m_memory_begin;
-            if (m_memory_begin == NULL) {
-                m_memory_handles.pop_back();
-                throw bad_alloc();
+            memory_chunk mc;
+            mc.memory = detail::memory_allocator_allocate(m_allocator, pod_memory_block_type,
+                                                          capacity_bytes);
+            mc.capacity_bytes = capacity_bytes;
+            try {
+                m_memory_handles.push_back(mc);
+            } catch(...) {
+                detail::memory_allocator_deallocate(m_allocator, pod_memory_block_type,
+                                                    mc.memory, capacity_bytes);
+                throw;
             }
+            m_memory_begin = mc.memory;
             m_memory_current = m_memory_begin;
             m_memory_end = m_memory_current + capacity_bytes;
             m_total_allocated_capacity += capacity_bytes;
@@ -43,15 +61,28 @@ namespace {
 
         pod_memory_block(intptr_t initial_capacity_bytes)
             : m_mbd(1, pod_memory_block_type), m_total_allocated_capacity(0),
-                    m_memory_handles()
+                    m_allocator(get_memory_allocator()), m_memory_handles(),
+                    m_size_hint(initial_capacity_bytes)
         {
             append_memory(initial_capacity_bytes);
         }
 
+        /** The number of bytes handed out since the last reset */
+        intptr_t get_used_bytes() const
+        {
+            return m_total_allocated_capacity - (m_memory_end - m_memory_current);
+        }
+
+        void free_memory(const memory_chunk& mc)
+        {
+            detail::memory_allocator_deallocate(m_allocator, pod_memory_block_type,
+                                                mc.memory, mc.capacity_bytes);
+        }
+
         ~pod_memory_block()
         {
             for (size_t i = 0, i_end = m_memory_handles.size(); i != i_end; ++i) {
-                free(m_memory_handles[i]);
+                free_memory(m_memory_handles[i]);
             }
         }
     };
@@ -82,7 +113,7 @@ static void allocate(memory_block_data *self, intptr_t size_bytes, intptr_t alig
     if (end > emb->m_memory_end) {
         emb->m_total_allocated_capacity -= emb->m_memory_end - emb->m_memory_current;
         // Allocate memory to double the amount used so far, or the requested size, whichever is larger
-        // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
+        // NOTE: We're assuming the allocator produces memory which has good enough alignment for anything
         emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes));
         begin = emb->m_memory_begin;
         end = begin + size_bytes;
@@ -113,10 +144,11 @@ static void resize(memory_block_data *self, intptr_t size_bytes, char **inout_be
         emb->m_memory_current = end;
         *inout_end = end;
     } else {
-        // If it doesn't fit, need to copy to newly malloc'd memory
+        // If it doesn't fit, need to copy to newly allocated memory
 		char *old_current = *inout_begin, *old_end = *inout_end;
+        emb->m_total_allocated_capacity -= emb->m_memory_end - emb->m_memory_current;
         // Allocate memory to double the amount used so far, or the requested size, whichever is larger
-        // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
+        // NOTE: We're assuming the allocator produces memory which has good enough alignment for anything
         emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes));
         memcpy(emb->m_memory_begin, *inout_begin, *inout_end - *inout_begin);
         end = emb->m_memory_begin + size_bytes;
@@ -124,6 +156,15 @@ static void resize(memory_block_data *self, intptr_t size_bytes, char **inout_be
         *inout_begin = emb->m_memory_begin;
         *inout_end = end;
         emb->m_total_allocated_capacity -= old_end - old_current;
+        // If the moved allocation was the only thing in its chunk, that
+        // chunk is no longer referenced, so give it back right away. This
+        // is the usual case for a single var_dim or string growing by doubling.
+        size_t prev_index = emb->m_memory_handles.size() - 2;
+        memory_chunk prev = emb->m_memory_handles[prev_index];
+        if (prev.memory == old_current) {
+            emb->m_memory_handles.erase(emb->m_memory_handles.begin() + prev_index);
+            emb->free_memory(prev);
+        }
     }
 //    cout << "memory state after " << (void *)emb->m_memory_begin << " / " << (void *)emb->m_memory_current << " / " << (void *)emb->m_memory_end << endl;
 }
@@ -145,20 +186,37 @@ static void reset(memory_block_data *self)
 {
     // Resets the POD memory so it can reuse it from the start
     pod_memory_block *emb = reinterpret_cast<pod_memory_block *>(self);
-   
-    if (emb->m_memory_handles.size() > 1) {
-        // If there are more than one allocated memory chunks,
-        // throw them all away except the last
-        for (size_t i = 0, i_end = emb->m_memory_handles.size() - 1; i != i_end; ++i) {
-            free(emb->m_memory_handles[i]);
+
+    // Learn how much memory a batch needs. The hint follows increases
+    // immediately, and decays by a quarter per reset when batches shrink,
+    // so one unusually large batch doesn't pin its memory forever.
+    intptr_t used = emb->m_memory_begin != NULL ? emb->get_used_bytes()
+                                                : emb->m_total_allocated_capacity;
+    emb->m_size_hint = max(used, emb->m_size_hint - emb->m_size_hint / 4);
+
+    const memory_chunk &last = emb->m_memory_handles.back();
+    if (emb->m_size_hint > 0 &&
+                    (emb->m_memory_handles.size() > 1 || last.capacity_bytes < emb->m_size_hint ||
+                     last.capacity_bytes > 4 * emb->m_size_hint)) {
+        // Replace the chunks with a single one sized from the hint, so the
+        // next batch of similar size is served without touching the allocator
+        memory_chunk mc;
+        mc.capacity_bytes = emb->m_size_hint + emb->m_size_hint / 8;
+        mc.memory = detail::memory_allocator_allocate(emb->m_allocator, pod_memory_block_type,
+                                                      mc.capacity_bytes);
+        for (size_t i = 0, i_end = emb->m_memory_handles.size(); i != i_end; ++i) {
+            emb->free_memory(emb->m_memory_handles[i]);
         }
-        emb->m_memory_handles.front() = emb->m_memory_handles.back();
         emb->m_memory_handles.resize(1);
+        emb->m_memory_handles.front() = mc;
     }
 
     // Reset to use the whole chunk
-    emb->m_memory_current = emb->m_memory_begin;
-    emb->m_total_allocated_capacity = emb->m_memory_end - emb->m_memory_begin;
+    const memory_chunk &chunk = emb->m_memory_handles.back();
+    emb->m_memory_begin = chunk.memory;
+    emb->m_memory_current = chunk.memory;
+    emb->m_memory_end = chunk.memory + chunk.capacity_bytes;
+    emb->m_total_allocated_capacity = chunk.capacity_bytes;
 }
 
 memory_block_pod_allocator_api pod_memory_block_allocator_api = {
@@ -177,5 +235,7 @@ void dynd::pod_memory_block_debug_print(const memory_block_data *memblock, std::
         o << indent << " allocated: " << emb->m_total_allocated_capacity << "\n";
     } else {
         o << indent << " finalized: " << emb->m_total_allocated_capacity << "\n";
-    } 
+    }
+    o << indent << " chunks: " << emb->m_memory_handles.size() << "\n";
+    o << indent << " size hint: " << emb->m_size_hint << "\n";
 }
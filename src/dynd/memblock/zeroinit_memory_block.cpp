@@ -9,18 +9,26 @@
 #include <algorithm>
 
 #include <dynd/memblock/zeroinit_memory_block.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
 
 using namespace std;
 using namespace dynd;
 
 namespace {
+    struct memory_chunk {
+        char *memory;
+        intptr_t capacity_bytes;
+    };
+
     struct zeroinit_memory_block {
         /** Every memory block object needs this at the front */
         memory_block_data m_mbd;
         intptr_t m_total_allocated_capacity;
-        /** The malloc'd memory */
-        vector<char *> m_memory_handles;
-        /** The current malloc'd memory being doled out */
+        /** The allocator the memory comes from */
+        memory_allocator *m_allocator;
+        /** The allocated memory */
+        vector<memory_chunk> m_memory_handles;
+        /** The current allocated memory being doled out */
         char *m_memory_begin, *m_memory_current, *m_memory_end;
 
         /**
@@ -29,13 +37,18 @@ namespace {
          */
         void append_memory(intptr_t capacity_bytes)
         {
-            m_memory_handles.push_back(NULL);
-            m_memory_begin = reinterpret_cast<char *>(malloc(capacity_bytes));
-            m_memory_handles.back() = m_memory_begin;
-            if (m_memory_begin == NULL) {
-                m_memory_handles.pop_back();
-                throw bad_alloc();
+            memory_chunk mc;
+            mc.memory = detail::memory_allocator_allocate(m_allocator, zeroinit_memory_block_type,
+                                                          capacity_bytes);
+            mc.capacity_bytes = capacity_bytes;
+            try {
+                m_memory_handles.push_back(mc);
+            } catch(...) {
+                detail::memory_allocator_deallocate(m_allocator, zeroinit_memory_block_type,
+                                                    mc.memory, capacity_bytes);
+                throw;
             }
+            m_memory_begin = mc.memory;
             m_memory_current = m_memory_begin;
             m_memory_end = m_memory_current + capacity_bytes;
             m_total_allocated_capacity += capacity_bytes;
@@ -43,15 +56,21 @@ namespace {
 
         zeroinit_memory_block(intptr_t initial_capacity_bytes)
             : m_mbd(1, zeroinit_memory_block_type), m_total_allocated_capacity(0),
-                    m_memory_handles()
+                    m_allocator(get_memory_allocator()), m_memory_handles()
         {
             append_memory(initial_capacity_bytes);
         }
 
+        void free_memory(const memory_chunk& mc)
+        {
+            detail::memory_allocator_deallocate(m_allocator, zeroinit_memory_block_type,
+                                                mc.memory, mc.capacity_bytes);
+        }
+
         ~zeroinit_memory_block()
         {
             for (size_t i = 0, i_end = m_memory_handles.size(); i != i_end; ++i) {
-                free(m_memory_handles[i]);
+                free_memory(m_memory_handles[i]);
             }
         }
     };
@@ -82,7 +101,7 @@ static void allocate(memory_block_data *self, intptr_t size_bytes, intptr_t alig
     if (end > emb->m_memory_end) {
         emb->m_total_allocated_capacity -= emb->m_memory_end - emb->m_memory_current;
         // Allocate memory to double the amount used so far, or the requested size, whichever is larger
-        // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
+        // NOTE: We're assuming the allocator produces memory which has good enough alignment for anything
         emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes));
         begin = emb->m_memory_begin;
         end = begin + size_bytes;
@@ -120,11 +139,11 @@ static void resize(memory_block_data *self, intptr_t size_bytes, char **inout_be
         }
         *inout_end = end;
     } else {
-        // If it doesn't fit, need to copy to newly malloc'd memory
+        // If it doesn't fit, need to copy to newly allocated memory
 		char *old_current = *inout_begin, *old_end = *inout_end;
         intptr_t old_size_bytes = *inout_end - *inout_begin;
         // Allocate memory to double the amount used so far, or the requested size, whichever is larger
-        // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
+        // NOTE: We're assuming the allocator produces memory which has good enough alignment for anything
         emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes));
         memcpy(emb->m_memory_begin, *inout_begin, old_size_bytes);
         end = emb->m_memory_begin + size_bytes;
@@ -161,7 +180,7 @@ static void reset(memory_block_data *self)
         // If there are more than one allocated memory chunks,
         // throw them all away except the last
         for (size_t i = 0, i_end = emb->m_memory_handles.size() - 1; i != i_end; ++i) {
-            free(emb->m_memory_handles[i]);
+            emb->free_memory(emb->m_memory_handles[i]);
         }
         emb->m_memory_handles.front() = emb->m_memory_handles.back();
         emb->m_memory_handles.resize(1);
@@ -26,6 +26,8 @@
 #include <functional>
 #include <iterator>
 #include <iomanip>
+#include <mutex>
+#include <unordered_map>
 
 using namespace std;
 using namespace dynd;
@@ -75,12 +77,82 @@ const ndt::type ndt::static_builtin_types[builtin_type_id_count] = {
 
 ndt::type::type(const std::string &rep) : m_extended(NULL)
 {
-  type_from_datashape(rep).swap(*this);
+  cached_type_from_datashape(rep.data(), rep.data() + rep.size()).swap(*this);
 }
 
 ndt::type::type(const char *rep_begin, const char *rep_end) : m_extended(NULL)
 {
-  type_from_datashape(rep_begin, rep_end).swap(*this);
+  cached_type_from_datashape(rep_begin, rep_end).swap(*this);
+}
+
+namespace {
+/**
+ * The interned types, each holding a reference. Lookups take their
+ * reference under the mutex, so an entry whose use count is 1 is held by
+ * nothing but the table and can be dropped under the mutex. The table is
+ * swept of those entries whenever it doubles in size, so it stays in
+ * proportion to the interned types still in use.
+ */
+struct intern_table {
+  std::mutex mutex;
+  std::unordered_multimap<size_t, ndt::type> types;
+  size_t sweep_size;
+
+  intern_table() : sweep_size(intern_table_min_sweep_size) {}
+
+  enum { intern_table_min_sweep_size = 64 };
+
+  void sweep()
+  {
+    for (auto it = types.begin(); it != types.end();) {
+      if (it->second.extended()->get_use_count() == 1) {
+        it = types.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    sweep_size = std::max<size_t>(intern_table_min_sweep_size,
+                                  2 * types.size());
+  }
+};
+
+intern_table &get_intern_table()
+{
+  // Never destroyed, so interned types outlive everything that uses them
+  static intern_table *table = new intern_table;
+  return *table;
+}
+} // anonymous namespace
+
+ndt::type ndt::intern(const type &tp)
+{
+  if (tp.is_builtin() || tp.extended()->is_interned()) {
+    return tp;
+  }
+
+  size_t h = tp.get_hash();
+  intern_table &table = get_intern_table();
+  lock_guard<mutex> lock(table.mutex);
+  auto range = table.types.equal_range(h);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (*it->second.extended() == *tp.extended()) {
+      return it->second;
+    }
+  }
+  if (table.types.size() >= table.sweep_size) {
+    table.sweep();
+  }
+  tp.extended()->m_interned = true;
+  table.types.insert(make_pair(h, tp));
+  return tp;
+}
+
+size_t ndt::get_interned_type_count()
+{
+  intern_table &table = get_intern_table();
+  lock_guard<mutex> lock(table.mutex);
+  table.sweep();
+  return table.types.size();
 }
 
 ndt::type ndt::type::at_array(int nindices, const irange *indices) const
@@ -48,6 +48,23 @@ ndt::base_struct_type::base_struct_type(type_id_t type_id,
 
 ndt::base_struct_type::~base_struct_type() {}
 
+bool ndt::base_struct_type::field_names_equal(const base_struct_type &rhs) const
+{
+  if (m_field_count != rhs.m_field_count) {
+    return false;
+  }
+  for (intptr_t i = 0; i < m_field_count; ++i) {
+    const string_type_data &lhs_name = get_field_name_raw(i);
+    const string_type_data &rhs_name = rhs.get_field_name_raw(i);
+    size_t size = lhs_name.end - lhs_name.begin;
+    if (size != static_cast<size_t>(rhs_name.end - rhs_name.begin) ||
+        memcmp(lhs_name.begin, rhs_name.begin, size) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 intptr_t
 ndt::base_struct_type::get_field_index(const char *field_name_begin,
                                        const char *field_name_end) const
@@ -62,6 +62,21 @@ ndt::base_tuple_type::base_tuple_type(type_id_t type_id,
 
 ndt::base_tuple_type::~base_tuple_type() {}
 
+bool ndt::base_tuple_type::field_types_equal(const base_tuple_type &rhs) const
+{
+  if (m_field_count != rhs.m_field_count) {
+    return false;
+  }
+  const type *lhs_types = get_field_types_raw();
+  const type *rhs_types = rhs.get_field_types_raw();
+  for (intptr_t i = 0; i < m_field_count; ++i) {
+    if (lhs_types[i] != rhs_types[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void ndt::base_tuple_type::print_data(std::ostream &o, const char *arrmeta,
                                       const char *data) const
 {
@@ -3,10 +3,13 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <sstream>
+
 #include <dynd/type.hpp>
 #include <dynd/func/callable.hpp>
 #include <dynd/types/builtin_type_properties.hpp>
 #include <dynd/func/arrfunc.hpp>
+#include <dynd/types/hash_util.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -14,6 +17,22 @@ using namespace dynd;
 // Default destructor for the extended type does nothing
 ndt::base_type::~base_type() {}
 
+size_t ndt::base_type::compute_hash() const
+{
+  // Equal types have the same datashape, so it determines the hash
+  stringstream ss;
+  print_type(ss);
+  string ds = ss.str();
+  size_t h = static_cast<size_t>(
+      hash_bytes(ds.data(), ds.size(), get_type_id()));
+  // 0 is reserved to mean the hash hasn't been computed
+  if (h == 0) {
+    h = 1;
+  }
+  m_hash.store(h, memory_order_relaxed);
+  return h;
+}
+
 bool ndt::base_type::is_type_subarray(const type &subarray_tp) const
 {
   // The default implementation is to check by-value equality.
@@ -4,14 +4,16 @@
 //
 
 #include <cstring>
+#include <algorithm>
 #include <map>
-#include <set>
+#include <vector>
 
 #include <dynd/auxiliary_data.hpp>
 #include <dynd/types/categorical_type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/comparison_kernels.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/hash_util.hpp>
 #include <dynd/types/convert_type.hpp>
 #include <dynd/func/make_callable.hpp>
 #include <dynd/array_range.hpp>
@@ -170,9 +172,9 @@ struct category_to_categorical_kernel_extra
 
 } // anoymous namespace
 
-/** This function converts the set of char* pointers into a strided immutable
+/** This function converts the sorted char* pointers into a strided immutable
  * nd::array of the categories */
-static nd::array make_sorted_categories(const set<const char *, cmp> &uniques,
+static nd::array make_sorted_categories(const vector<const char *> &uniques,
                                         const ndt::type &element_tp,
                                         const char *arrmeta)
 {
@@ -187,7 +189,7 @@ static nd::array make_sorted_categories(const set<const char *, cmp> &uniques,
   intptr_t stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(
                         categories.get_arrmeta())->stride;
   char *dst_ptr = categories.get_readwrite_originptr();
-  for (set<const char *, cmp>::const_iterator it = uniques.begin();
+  for (vector<const char *>::const_iterator it = uniques.begin();
        it != uniques.end(); ++it) {
     char *src = const_cast<char *>(*it);
     fn(dst_ptr, &src, k.get());
@@ -245,9 +247,6 @@ ndt::categorical_type::categorical_type(const nd::array &categories,
                              &eval::default_eval_context);
     expr_single_t fn = k.get()->get_function<expr_single_t>();
 
-    cmp less(fn, k.get());
-    set<const char *, cmp> uniques(less);
-
     m_value_to_category_index =
         nd::empty(category_count, make_type<intptr_t>());
     m_category_index_to_value =
@@ -257,29 +256,33 @@ ndt::categorical_type::categorical_type(const nd::array &categories,
     // categories to values
     for (size_t i = 0; i != (size_t)category_count; ++i) {
       unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, i) = i;
-      const char *category_value =
-          categories.get_readonly_originptr() + i * categories_stride;
+    }
+    sorter less(categories.get_readonly_originptr(), categories_stride, fn,
+                k.get());
+    std::sort(
+        &unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, 0),
+        &unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value,
+                                              category_count),
+        less);
 
-      if (uniques.find(category_value) == uniques.end()) {
-        uniques.insert(category_value);
-      } else {
+    // Once sorted, any repeated category is next to its duplicate
+    vector<const char *> uniques(category_count);
+    for (intptr_t i = 0; i < category_count; ++i) {
+      intptr_t value_index =
+          unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, i);
+      uniques[i] =
+          categories.get_readonly_originptr() + value_index * categories_stride;
+      if (i > 0 &&
+          !less(unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value,
+                                                  i - 1),
+                value_index)) {
         stringstream ss;
         ss << "categories must be unique: category value ";
-        m_category_tp.print_data(ss, categories_element_arrmeta,
-                                 category_value);
+        m_category_tp.print_data(ss, categories_element_arrmeta, uniques[i]);
         ss << " appears more than once";
         throw std::runtime_error(ss.str());
       }
     }
-    // TODO: Putting everything in a set already caused a sort operation to
-    // occur,
-    //       there's no reason we should need a second sort.
-    std::sort(
-        &unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, 0),
-        &unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value,
-                                              category_count),
-        sorter(categories.get_readonly_originptr(), categories_stride, fn,
-               k.get()));
 
     // invert the m_category_index_to_value permutation
     for (intptr_t i = 0; i < category_count; ++i) {
@@ -612,14 +615,33 @@ ndt::type ndt::factor_categorical(const nd::array &values)
   expr_single_t fn = k.get()->get_function<expr_single_t>();
 
   cmp less(fn, k.get());
-  set<const char *, cmp> uniques(less);
-
-  for (intptr_t i = 0; i < dim_size; ++i) {
-    const char *data = values_eval.get_readonly_originptr() + i * stride;
-    if (uniques.find(data) == uniques.end()) {
-      uniques.insert(data);
+  vector<const char *> uniques;
+  if (element_hasher::is_hashable(el_tp)) {
+    // Dedup in one pass, so only the distinct values get sorted
+    element_hasher hasher(el_tp, el_arrmeta);
+    element_hash_table<element_hasher> table(hasher);
+    for (intptr_t i = 0; i < dim_size; ++i) {
+      table.insert(values_eval.get_readonly_originptr() + i * stride);
+    }
+    uniques.resize(table.size());
+    for (intptr_t i = 0; i < table.size(); ++i) {
+      uniques[i] = table.get_group_data(i);
+    }
+  } else {
+    uniques.resize(dim_size);
+    for (intptr_t i = 0; i < dim_size; ++i) {
+      uniques[i] = values_eval.get_readonly_originptr() + i * stride;
+    }
+  }
+  std::sort(uniques.begin(), uniques.end(), less);
+  // Drop values the comparison considers equal
+  size_t count = 0;
+  for (size_t i = 0; i < uniques.size(); ++i) {
+    if (count == 0 || less(uniques[count - 1], uniques[i])) {
+      uniques[count++] = uniques[i];
     }
   }
+  uniques.resize(count);
 
   // Copy the values (now sorted and unique) into a new nd::array
   nd::array categories = make_sorted_categories(uniques, el_tp, el_arrmeta);
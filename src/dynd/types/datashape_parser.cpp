@@ -3,8 +3,12 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <limits>
+#include <list>
 #include <map>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 
 #include <dynd/types/datashape_parser.hpp>
 #include <dynd/parser_util.hpp>
@@ -1423,9 +1427,149 @@ static void get_error_line_column(const char *begin, const char *end,
       "Cannot get line number of error, its position is out of range");
 }
 
+namespace {
+struct builtin_scalar_name {
+  const char *name;
+  size_t size;
+  type_id_t type_id;
+};
+} // anonymous namespace
+
+#define DYND_BUILTIN_SCALAR_NAME(NAME, TYPE)                                   \
+  {                                                                            \
+    NAME, sizeof(NAME) - 1, type_id_of<TYPE>::value                            \
+  }
+
+// The builtin type names which have no parameterized form
+static const builtin_scalar_name builtin_scalar_names[] = {
+    DYND_BUILTIN_SCALAR_NAME("int32", int32),
+    DYND_BUILTIN_SCALAR_NAME("float64", float64),
+    DYND_BUILTIN_SCALAR_NAME("int64", int64),
+    DYND_BUILTIN_SCALAR_NAME("int", int32),
+    DYND_BUILTIN_SCALAR_NAME("bool", bool1),
+    DYND_BUILTIN_SCALAR_NAME("float32", float32),
+    DYND_BUILTIN_SCALAR_NAME("intptr", intptr_t),
+    DYND_BUILTIN_SCALAR_NAME("real", float64),
+    DYND_BUILTIN_SCALAR_NAME("int8", int8),
+    DYND_BUILTIN_SCALAR_NAME("int16", int16),
+    DYND_BUILTIN_SCALAR_NAME("uint8", uint8),
+    DYND_BUILTIN_SCALAR_NAME("uint16", uint16),
+    DYND_BUILTIN_SCALAR_NAME("uint32", uint32),
+    DYND_BUILTIN_SCALAR_NAME("uint64", uint64),
+    DYND_BUILTIN_SCALAR_NAME("uintptr", uintptr_t),
+    DYND_BUILTIN_SCALAR_NAME("complex64", dynd::complex<float>),
+    DYND_BUILTIN_SCALAR_NAME("complex128", dynd::complex<double>),
+    DYND_BUILTIN_SCALAR_NAME("float16", float16),
+    DYND_BUILTIN_SCALAR_NAME("float128", float128),
+    DYND_BUILTIN_SCALAR_NAME("int128", int128),
+    DYND_BUILTIN_SCALAR_NAME("uint128", uint128),
+    DYND_BUILTIN_SCALAR_NAME("void", void)};
+
+#undef DYND_BUILTIN_SCALAR_NAME
+
+static inline bool is_simple_ds_whitespace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline bool is_simple_ds_name_char(char c)
+{
+  return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') ||
+         ('0' <= c && c <= '9') || c == '_';
+}
+
+/**
+ * A fast path for the most common datashapes, a run of "N *", "var *" and
+ * "Fixed *" dimensions followed by a builtin scalar type name, which
+ * doesn't allocate while scanning. Returns false without consuming
+ * anything if the datashape isn't of that form, so the full parser can
+ * handle it, including reporting any error.
+ */
+static bool parse_simple_datashape(const char *begin, const char *end,
+                                   ndt::type &out_tp)
+{
+  // Each dimension is a fixed size, or -1 for var and -2 for Fixed
+  intptr_t dims[16];
+  int ndim = 0;
+  for (;;) {
+    while (begin < end && is_simple_ds_whitespace(*begin)) {
+      ++begin;
+    }
+    const char *nbegin = begin;
+    while (begin < end && is_simple_ds_name_char(*begin)) {
+      ++begin;
+    }
+    const char *nend = begin;
+    if (nbegin == nend) {
+      return false;
+    }
+    while (begin < end && is_simple_ds_whitespace(*begin)) {
+      ++begin;
+    }
+
+    if (begin == end) {
+      // The name must be the builtin scalar type
+      size_t size = nend - nbegin;
+      const builtin_scalar_name *bsn = builtin_scalar_names;
+      const builtin_scalar_name *bsn_end =
+          bsn + sizeof(builtin_scalar_names) / sizeof(builtin_scalar_names[0]);
+      for (; bsn != bsn_end; ++bsn) {
+        if (bsn->size == size && memcmp(bsn->name, nbegin, size) == 0) {
+          break;
+        }
+      }
+      if (bsn == bsn_end) {
+        return false;
+      }
+      ndt::type tp(bsn->type_id);
+      while (ndim > 0) {
+        intptr_t dim = dims[--ndim];
+        if (dim >= 0) {
+          tp = ndt::make_fixed_dim(dim, tp);
+        } else if (dim == -1) {
+          tp = ndt::make_var_dim(tp);
+        } else {
+          tp = ndt::make_fixed_dim_kind(tp);
+        }
+      }
+      out_tp.swap(tp);
+      return true;
+    }
+
+    // Otherwise it must be a dimension, "name *" but not "name **"
+    if (*begin != '*' || (begin + 1 < end && begin[1] == '*') ||
+        ndim == sizeof(dims) / sizeof(dims[0])) {
+      return false;
+    }
+    ++begin;
+    if ('1' <= *nbegin && *nbegin <= '9') {
+      intptr_t dim_size = 0;
+      for (const char *c = nbegin; c != nend; ++c) {
+        if (*c < '0' || *c > '9' ||
+            dim_size > (std::numeric_limits<intptr_t>::max() - 9) / 10) {
+          return false;
+        }
+        dim_size = dim_size * 10 + (*c - '0');
+      }
+      dims[ndim++] = dim_size;
+    } else if (parse::compare_range_to_literal(nbegin, nend, "var")) {
+      dims[ndim++] = -1;
+    } else if (parse::compare_range_to_literal(nbegin, nend, "Fixed")) {
+      dims[ndim++] = -2;
+    } else {
+      return false;
+    }
+  }
+}
+
 ndt::type dynd::type_from_datashape(const char *datashape_begin,
                                     const char *datashape_end)
 {
+  ndt::type result;
+  if (parse_simple_datashape(datashape_begin, datashape_end, result)) {
+    return result;
+  }
+
   try {
     // Symbol table for intermediate types declared in the datashape
     map<string, ndt::type> symtable;
@@ -1453,3 +1597,111 @@ ndt::type dynd::type_from_datashape(const char *datashape_begin,
     throw runtime_error(ss.str());
   }
 }
+
+namespace {
+/**
+ * A cache from datashape strings to interned types, which evicts the least
+ * recently used datashape when it is full. The cache holds the only
+ * reference to many of its types besides the intern table, which frees
+ * them once they are evicted.
+ */
+class datashape_cache {
+  typedef std::list<std::pair<std::string, ndt::type>> entry_list;
+
+  std::mutex m_mutex;
+  // The most recently used datashape is at the front
+  entry_list m_entries;
+  std::unordered_map<std::string, entry_list::iterator> m_index;
+  intptr_t m_capacity;
+  intptr_t m_hits, m_misses;
+
+  void evict()
+  {
+    while (static_cast<intptr_t>(m_entries.size()) > m_capacity) {
+      m_index.erase(m_entries.back().first);
+      m_entries.pop_back();
+    }
+  }
+
+public:
+  datashape_cache() : m_capacity(1024), m_hits(0), m_misses(0) {}
+
+  ndt::type get(const char *begin, const char *end)
+  {
+    std::string key(begin, end);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_index.find(key);
+      if (it != m_index.end()) {
+        ++m_hits;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->second;
+      }
+      ++m_misses;
+    }
+
+    // Parse without holding the lock
+    ndt::type tp = ndt::intern(type_from_datashape(begin, end));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_capacity > 0 && m_index.find(key) == m_index.end()) {
+      m_entries.push_front(std::make_pair(key, tp));
+      m_index[key] = m_entries.begin();
+      evict();
+    }
+    return tp;
+  }
+
+  datashape_cache_stats get_stats()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    datashape_cache_stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.size = m_entries.size();
+    stats.capacity = m_capacity;
+    return stats;
+  }
+
+  void set_capacity(intptr_t capacity)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_capacity = capacity > 0 ? capacity : 0;
+    evict();
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_hits = 0;
+    m_misses = 0;
+  }
+};
+
+datashape_cache &get_datashape_cache()
+{
+  // Never destroyed, so it may be used during static destruction
+  static datashape_cache *cache = new datashape_cache;
+  return *cache;
+}
+} // anonymous namespace
+
+ndt::type dynd::cached_type_from_datashape(const char *datashape_begin,
+                                           const char *datashape_end)
+{
+  return get_datashape_cache().get(datashape_begin, datashape_end);
+}
+
+datashape_cache_stats dynd::get_datashape_cache_stats()
+{
+  return get_datashape_cache().get_stats();
+}
+
+void dynd::set_datashape_cache_capacity(intptr_t capacity)
+{
+  get_datashape_cache().set_capacity(capacity);
+}
+
+void dynd::clear_datashape_cache() { get_datashape_cache().clear(); }
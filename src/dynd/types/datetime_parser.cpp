@@ -4,6 +4,7 @@
 //
 
 #include <string>
+#include <cstring>
 
 #include <dynd/parser_util.hpp>
 #include <dynd/types/date_parser.hpp>
@@ -255,3 +256,157 @@ bool dynd::string_to_datetime(const char *begin, const char *end,
         return false;
     }
 }
+
+namespace {
+    /**
+     * The fixed "YYYY-MM-DDThh:mm" prefix of every ISO 8601 layout, checked
+     * eight characters at a time. After xor-ing with '0', the digit positions
+     * must hold values 0 to 9 and the separator positions must match.
+     */
+    const char iso8601_prefix_digit_mask[16] = {
+        '\xff', '\xff', '\xff', '\xff', 0, '\xff', '\xff', 0,
+        '\xff', '\xff', 0, '\xff', '\xff', 0, '\xff', '\xff'};
+    const char iso8601_prefix_separators[16] = {
+        '0', '0', '0', '0', '-', '0', '0', '-',
+        '0', '0', 'T', '0', '0', ':', '0', '0'};
+
+    inline uint64_t load_uint64(const char *p)
+    {
+        uint64_t result;
+        memcpy(&result, p, sizeof(result));
+        return result;
+    }
+
+    /**
+     * Checks eight characters against the prefix pattern starting at
+     * the given offset, using the given date/time separator.
+     */
+    inline bool match_iso8601_prefix_part(const char *s, int offset, uint64_t separator_fix)
+    {
+        const uint64_t zeros = 0x3030303030303030ULL;
+        uint64_t digit_mask = load_uint64(iso8601_prefix_digit_mask + offset);
+        uint64_t v = load_uint64(s + offset) ^ zeros;
+        // Separators must match exactly
+        uint64_t expected = (load_uint64(iso8601_prefix_separators + offset) ^ zeros) ^ separator_fix;
+        if (((v ^ expected) & ~digit_mask) != 0) {
+            return false;
+        }
+        // Digits must be 0-9. Adding 0x76 sets the high bit of any byte
+        // above 9; carries between bytes can only cause spurious failures,
+        // which fall back to the general parser.
+        const uint64_t high_bits = 0x8080808080808080ULL;
+        return ((v | (v + 0x7676767676767676ULL)) & high_bits & digit_mask) == 0;
+    }
+
+    inline int digits2(const char *s)
+    {
+        return (s[0] - '0') * 10 + (s[1] - '0');
+    }
+
+    inline bool is_digit(char c)
+    {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+} // anonymous namespace
+
+bool parse::iso8601_datetime_layout::detect(const char *begin, const char *end)
+{
+    size = 0;
+    intptr_t len = end - begin;
+    if (len < 16 || (begin[10] != 'T' && begin[10] != ' ')) {
+        return false;
+    }
+    date_time_separator = begin[10];
+    intptr_t pos = 16;
+    has_seconds = false;
+    fraction_digits = 0;
+    if (pos + 3 <= len && begin[pos] == ':' && is_digit(begin[pos + 1]) &&
+            is_digit(begin[pos + 2])) {
+        has_seconds = true;
+        pos += 3;
+        if (pos < len && begin[pos] == '.') {
+            ++pos;
+            while (pos < len && is_digit(begin[pos]) && fraction_digits < 9) {
+                ++fraction_digits;
+                ++pos;
+            }
+            if (fraction_digits == 0) {
+                return false;
+            }
+        }
+    }
+    utc_suffix = (pos < len && begin[pos] == 'Z');
+    if (utc_suffix) {
+        ++pos;
+    }
+    if (pos != len) {
+        return false;
+    }
+
+    size = len;
+    int64_t ticks;
+    if (!parse(begin, end, ticks)) {
+        size = 0;
+        return false;
+    }
+    return true;
+}
+
+bool parse::iso8601_datetime_layout::parse(const char *begin, const char *end,
+                                           int64_t &out_ticks) const
+{
+    if (size == 0 || end - begin != size) {
+        return false;
+    }
+    uint64_t separator_fix = 0;
+    if (date_time_separator != 'T') {
+        // Adjust the expected separator at offset 10 (byte 2 of the second word)
+        char fix[8] = {0, 0, static_cast<char>('T' ^ date_time_separator), 0, 0, 0, 0, 0};
+        separator_fix = load_uint64(fix);
+    }
+    if (!match_iso8601_prefix_part(begin, 0, 0) ||
+            !match_iso8601_prefix_part(begin, 8, separator_fix)) {
+        return false;
+    }
+    int year = digits2(begin) * 100 + digits2(begin + 2);
+    int month = digits2(begin + 5), day = digits2(begin + 8);
+    int hour = digits2(begin + 11), minute = digits2(begin + 14);
+    int second = 0, tick = 0;
+    if (has_seconds) {
+        if (begin[16] != ':' || !is_digit(begin[17]) || !is_digit(begin[18])) {
+            return false;
+        }
+        second = digits2(begin + 17);
+        if (fraction_digits > 0) {
+            if (begin[19] != '.') {
+                return false;
+            }
+            // Ticks are 100ns, so digits past the seventh are truncated
+            const char *digits = begin + 20;
+            for (int i = 0; i < 7; ++i) {
+                tick *= 10;
+                if (i < fraction_digits) {
+                    if (!is_digit(digits[i])) {
+                        return false;
+                    }
+                    tick += digits[i] - '0';
+                }
+            }
+            for (int i = 7; i < fraction_digits; ++i) {
+                if (!is_digit(digits[i])) {
+                    return false;
+                }
+            }
+        }
+    }
+    if (utc_suffix && end[-1] != 'Z') {
+        return false;
+    }
+    if (!date_ymd::is_valid(year, month, day) ||
+            !time_hmst::is_valid(hour, minute, second, tick)) {
+        return false;
+    }
+    out_ticks = date_ymd::to_days(year, month, day) * DYND_TICKS_PER_DAY +
+                time_hmst::to_ticks(hour, minute, second, tick);
+    return true;
+}
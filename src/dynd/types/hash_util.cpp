@@ -0,0 +1,223 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/types/hash_util.hpp>
+#include <dynd/types/base_tuple_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+// Folds -0.0 into 0.0 and all NaNs into one NaN, so values which are equal
+// have the same bits
+template <typename T, typename U>
+inline U canonical_float_bits(const char *data)
+{
+  T value;
+  memcpy(&value, data, sizeof(T));
+  if (value == 0) {
+    return 0;
+  } else if (value != value) {
+    return ~static_cast<U>(0);
+  }
+  U bits;
+  memcpy(&bits, &value, sizeof(T));
+  return bits;
+}
+
+template <typename T>
+inline bool float_equal(const char *lhs, const char *rhs)
+{
+  T a, b;
+  memcpy(&a, lhs, sizeof(T));
+  memcpy(&b, rhs, sizeof(T));
+  return a == b || (a != a && b != b);
+}
+
+} // anonymous namespace
+
+element_hasher::element_hasher(const ndt::type &tp, const char *arrmeta)
+{
+  if (!is_hashable(tp)) {
+    stringstream ss;
+    ss << "cannot hash values of type " << tp;
+    throw type_error(ss.str());
+  }
+  add_leaves(tp, arrmeta, 0);
+
+  // Merge adjacent runs of raw bytes
+  vector<leaf> leaves;
+  for (size_t i = 0; i < m_leaves.size(); ++i) {
+    const leaf &l = m_leaves[i];
+    if (!leaves.empty() && l.kind == leaf_bytes &&
+        leaves.back().kind == leaf_bytes &&
+        leaves.back().offset + leaves.back().size == l.offset) {
+      leaves.back().size += l.size;
+    } else {
+      leaves.push_back(l);
+    }
+  }
+  m_leaves.swap(leaves);
+}
+
+bool element_hasher::is_hashable(const ndt::type &tp)
+{
+  if (tp.is_expression()) {
+    return false;
+  }
+
+  switch (tp.get_kind()) {
+  case struct_kind:
+  case tuple_kind: {
+    const ndt::base_tuple_type *bt = tp.extended<ndt::base_tuple_type>();
+    for (intptr_t i = 0; i < bt->get_field_count(); ++i) {
+      if (!is_hashable(bt->get_field_type(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  case string_kind:
+  case bytes_kind:
+    return tp.get_type_id() == string_type_id ||
+           tp.get_type_id() == bytes_type_id || tp.is_pod();
+  default:
+    if (tp.get_type_id() == fixed_dim_type_id) {
+      return is_hashable(tp.extended<ndt::fixed_dim_type>()->get_element_type());
+    }
+    return tp.is_pod() && !tp.is_symbolic();
+  }
+}
+
+void element_hasher::add_leaves(const ndt::type &tp, const char *arrmeta,
+                                intptr_t offset)
+{
+  leaf l;
+  l.offset = offset;
+  l.size = 0;
+
+  switch (tp.get_type_id()) {
+  case float32_type_id:
+    l.kind = leaf_float32;
+    m_leaves.push_back(l);
+    return;
+  case float64_type_id:
+    l.kind = leaf_float64;
+    m_leaves.push_back(l);
+    return;
+  case complex_float32_type_id:
+    l.kind = leaf_float32;
+    m_leaves.push_back(l);
+    l.offset += 4;
+    m_leaves.push_back(l);
+    return;
+  case complex_float64_type_id:
+    l.kind = leaf_float64;
+    m_leaves.push_back(l);
+    l.offset += 8;
+    m_leaves.push_back(l);
+    return;
+  case string_type_id:
+  case bytes_type_id:
+    // Both store a [begin, end) range of bytes
+    l.kind = leaf_string;
+    m_leaves.push_back(l);
+    return;
+  case fixed_dim_type_id: {
+    const ndt::fixed_dim_type *fdt = tp.extended<ndt::fixed_dim_type>();
+    const fixed_dim_type_arrmeta *md =
+        reinterpret_cast<const fixed_dim_type_arrmeta *>(arrmeta);
+    for (intptr_t i = 0; i < md->dim_size; ++i) {
+      add_leaves(fdt->get_element_type(),
+                 arrmeta + sizeof(fixed_dim_type_arrmeta),
+                 offset + i * md->stride);
+    }
+    return;
+  }
+  default:
+    break;
+  }
+
+  if (tp.get_kind() == struct_kind || tp.get_kind() == tuple_kind) {
+    const ndt::base_tuple_type *bt = tp.extended<ndt::base_tuple_type>();
+    const uintptr_t *data_offsets = bt->get_data_offsets(arrmeta);
+    const uintptr_t *arrmeta_offsets = bt->get_arrmeta_offsets_raw();
+    for (intptr_t i = 0; i < bt->get_field_count(); ++i) {
+      add_leaves(bt->get_field_type(i), arrmeta + arrmeta_offsets[i],
+                 offset + data_offsets[i]);
+    }
+    return;
+  }
+
+  // Everything else is compared by its raw bytes
+  l.kind = leaf_bytes;
+  l.size = tp.get_data_size();
+  m_leaves.push_back(l);
+}
+
+uint64_t element_hasher::hash(const char *data) const
+{
+  uint64_t h = 0;
+  for (vector<leaf>::const_iterator it = m_leaves.begin(); it != m_leaves.end();
+       ++it) {
+    const char *ptr = data + it->offset;
+    switch (it->kind) {
+    case leaf_bytes:
+      h = hash_bytes(ptr, it->size, h);
+      break;
+    case leaf_float32:
+      h = hash_mix(h ^ canonical_float_bits<float, uint32_t>(ptr));
+      break;
+    case leaf_float64:
+      h = hash_mix(h ^ canonical_float_bits<double, uint64_t>(ptr));
+      break;
+    case leaf_string: {
+      const string_type_data *s = reinterpret_cast<const string_type_data *>(ptr);
+      h = hash_bytes(s->begin, s->end - s->begin, h);
+      break;
+    }
+    }
+  }
+  return h;
+}
+
+bool element_hasher::equal(const char *lhs, const char *rhs) const
+{
+  for (vector<leaf>::const_iterator it = m_leaves.begin(); it != m_leaves.end();
+       ++it) {
+    const char *a = lhs + it->offset, *b = rhs + it->offset;
+    switch (it->kind) {
+    case leaf_bytes:
+      if (memcmp(a, b, it->size) != 0) {
+        return false;
+      }
+      break;
+    case leaf_float32:
+      if (!float_equal<float>(a, b)) {
+        return false;
+      }
+      break;
+    case leaf_float64:
+      if (!float_equal<double>(a, b)) {
+        return false;
+      }
+      break;
+    case leaf_string: {
+      const string_type_data *sa = reinterpret_cast<const string_type_data *>(a);
+      const string_type_data *sb = reinterpret_cast<const string_type_data *>(b);
+      size_t size = sa->end - sa->begin;
+      if (size != static_cast<size_t>(sb->end - sb->begin) ||
+          memcmp(sa->begin, sb->begin, size) != 0) {
+        return false;
+      }
+      break;
+    }
+    }
+  }
+  return true;
+}
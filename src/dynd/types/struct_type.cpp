@@ -193,8 +193,7 @@ bool ndt::struct_type::operator==(const base_type &rhs) const
   } else {
     const struct_type *dt = static_cast<const struct_type *>(&rhs);
     return get_data_alignment() == dt->get_data_alignment() &&
-           m_field_types.equals_exact(dt->m_field_types) &&
-           m_field_names.equals_exact(dt->m_field_names) &&
+           field_types_equal(*dt) && field_names_equal(*dt) &&
            m_variadic == dt->m_variadic;
   }
 }
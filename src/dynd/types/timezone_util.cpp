@@ -0,0 +1,477 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include <dynd/types/timezone_util.hpp>
+#include <dynd/types/date_util.hpp>
+#include <dynd/types/time_util.hpp>
+
+using namespace std;
+using namespace dynd;
+
+timezone_transitions::timezone_transitions(const std::string &name,
+                                           const std::vector<int64_t> &utc_ticks,
+                                           const std::vector<int64_t> &offsets,
+                                           int64_t initial_offset)
+    : m_name(name), m_utc_ticks(utc_ticks), m_offsets(offsets),
+      m_initial_offset(initial_offset)
+{
+  if (m_utc_ticks.size() != m_offsets.size()) {
+    throw invalid_argument("timezone_transitions: the transition instants and "
+                           "offsets must have the same size");
+  }
+}
+
+intptr_t timezone_transitions::find_entry(int64_t utc_ticks) const
+{
+  return upper_bound(m_utc_ticks.begin(), m_utc_ticks.end(), utc_ticks) -
+         m_utc_ticks.begin();
+}
+
+int64_t timezone_transitions::local_to_utc(int64_t local_ticks,
+                                           intptr_t &inout_hint) const
+{
+  // The offsets in effect a day either side of the wall clock time are the
+  // only two candidates, as transitions are always further apart than that
+  const int64_t day = 86400 * DYND_TICKS_PER_SECOND;
+  int64_t before = utc_offset_at_utc(local_ticks - day, inout_hint);
+  int64_t after = utc_offset_at_utc(local_ticks + day, inout_hint);
+  if (before == after) {
+    return local_ticks - before;
+  }
+  int64_t utc_before = local_ticks - before, utc_after = local_ticks - after;
+  bool valid_before = utc_offset_at_utc(utc_before, inout_hint) == before;
+  bool valid_after = utc_offset_at_utc(utc_after, inout_hint) == after;
+  if (valid_before && valid_after) {
+    // Ambiguous, when the clocks went back
+    return min(utc_before, utc_after);
+  } else if (valid_after) {
+    return utc_after;
+  } else {
+    // Either valid only before the transition, or skipped when the clocks
+    // went forward, in which case the earlier offset is used
+    return utc_before;
+  }
+}
+
+namespace {
+/** Reads big endian integers out of TZif data */
+struct tzif_reader {
+  const char *m_begin, *m_end;
+
+  tzif_reader(const char *begin, const char *end) : m_begin(begin), m_end(end)
+  {
+  }
+
+  void require(intptr_t size) const
+  {
+    if (m_end - m_begin < size) {
+      throw invalid_argument("TZif data is truncated");
+    }
+  }
+
+  int64_t read_int(int size)
+  {
+    require(size);
+    uint64_t result = 0;
+    for (int i = 0; i < size; ++i) {
+      result = (result << 8) | static_cast<unsigned char>(m_begin[i]);
+    }
+    m_begin += size;
+    // Sign extend
+    if (size < 8 && (result & (1ULL << (size * 8 - 1))) != 0) {
+      result |= ~0ULL << (size * 8);
+    }
+    return static_cast<int64_t>(result);
+  }
+
+  void skip(intptr_t size)
+  {
+    require(size);
+    m_begin += size;
+  }
+};
+
+struct tzif_header {
+  char version;
+  int64_t isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt;
+
+  void read(tzif_reader &r)
+  {
+    r.require(44);
+    if (memcmp(r.m_begin, "TZif", 4) != 0) {
+      throw invalid_argument("data is not in the TZif format");
+    }
+    version = r.m_begin[4];
+    r.skip(20);
+    isutcnt = r.read_int(4);
+    isstdcnt = r.read_int(4);
+    leapcnt = r.read_int(4);
+    timecnt = r.read_int(4);
+    typecnt = r.read_int(4);
+    charcnt = r.read_int(4);
+    if (typecnt <= 0) {
+      throw invalid_argument("TZif data has no time types");
+    }
+  }
+
+  intptr_t get_data_size(int time_size) const
+  {
+    return timecnt * time_size + timecnt + typecnt * 6 + charcnt +
+           leapcnt * (time_size + 4) + isstdcnt + isutcnt;
+  }
+};
+
+/**
+ * A POSIX TZ rule like "EST5EDT,M3.2.0,M11.1.0", which TZif files carry
+ * in their footer to describe the times after the last transition.
+ */
+struct posix_tz_rule {
+  int64_t std_offset, dst_offset;
+  bool has_dst;
+  // The rule dates, as 'M' (month.week.weekday), 'J' (1-365, no leap
+  // day) or 'D' (0-365, counting the leap day)
+  char start_kind, end_kind;
+  int start_month, start_week, start_day, end_month, end_week, end_day;
+  int64_t start_time, end_time;
+
+  posix_tz_rule()
+      : std_offset(0), dst_offset(0), has_dst(false), start_kind('M'),
+        end_kind('M'), start_month(0), start_week(0), start_day(0),
+        end_month(0), end_week(0), end_day(0), start_time(0), end_time(0)
+  {
+  }
+
+  static bool parse_name(const char *&p, const char *end)
+  {
+    if (p < end && *p == '<') {
+      while (p < end && *p != '>') {
+        ++p;
+      }
+      if (p == end) {
+        return false;
+      }
+      ++p;
+      return true;
+    }
+    const char *begin = p;
+    while (p < end && isalpha(static_cast<unsigned char>(*p))) {
+      ++p;
+    }
+    return p - begin >= 3;
+  }
+
+  static bool parse_int(const char *&p, const char *end, int &out)
+  {
+    const char *begin = p;
+    out = 0;
+    while (p < end && isdigit(static_cast<unsigned char>(*p))) {
+      out = out * 10 + (*p - '0');
+      ++p;
+    }
+    return p != begin;
+  }
+
+  /** Parses [+-]hh[:mm[:ss]] into seconds */
+  static bool parse_time(const char *&p, const char *end, int64_t &out)
+  {
+    int sign = 1;
+    if (p < end && (*p == '+' || *p == '-')) {
+      sign = (*p == '-') ? -1 : 1;
+      ++p;
+    }
+    int h = 0, m = 0, s = 0;
+    if (!parse_int(p, end, h)) {
+      return false;
+    }
+    if (p < end && *p == ':') {
+      ++p;
+      if (!parse_int(p, end, m)) {
+        return false;
+      }
+      if (p < end && *p == ':') {
+        ++p;
+        if (!parse_int(p, end, s)) {
+          return false;
+        }
+      }
+    }
+    out = sign * (h * 3600LL + m * 60LL + s);
+    return true;
+  }
+
+  static bool parse_date(const char *&p, const char *end, char &kind,
+                         int &month, int &week, int &day, int64_t &time)
+  {
+    if (p < end && *p == 'M') {
+      ++p;
+      kind = 'M';
+      if (!parse_int(p, end, month) || p == end || *p++ != '.' ||
+          !parse_int(p, end, week) || p == end || *p++ != '.' ||
+          !parse_int(p, end, day)) {
+        return false;
+      }
+      if (month < 1 || month > 12 || week < 1 || week > 5 || day > 6) {
+        return false;
+      }
+    } else if (p < end && *p == 'J') {
+      ++p;
+      kind = 'J';
+      if (!parse_int(p, end, day) || day < 1 || day > 365) {
+        return false;
+      }
+    } else {
+      kind = 'D';
+      if (!parse_int(p, end, day) || day > 365) {
+        return false;
+      }
+    }
+    time = 7200;
+    if (p < end && *p == '/') {
+      ++p;
+      if (!parse_time(p, end, time)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool parse(const char *p, const char *end)
+  {
+    int64_t offset;
+    if (!parse_name(p, end) || !parse_time(p, end, offset)) {
+      return false;
+    }
+    // POSIX offsets are positive west of Greenwich
+    std_offset = -offset;
+    if (p == end) {
+      has_dst = false;
+      return true;
+    }
+    if (!parse_name(p, end)) {
+      return false;
+    }
+    has_dst = true;
+    dst_offset = std_offset + 3600;
+    if (p < end && *p != ',') {
+      if (!parse_time(p, end, offset)) {
+        return false;
+      }
+      dst_offset = -offset;
+    }
+    if (p == end || *p++ != ',' ||
+        !parse_date(p, end, start_kind, start_month, start_week, start_day,
+                    start_time) ||
+        p == end || *p++ != ',' ||
+        !parse_date(p, end, end_kind, end_month, end_week, end_day,
+                    end_time)) {
+      return false;
+    }
+    return p == end;
+  }
+
+  /** Returns the days since 1970 of a rule date in the year */
+  static int64_t rule_days(int year, char kind, int month, int week, int day)
+  {
+    if (kind == 'J') {
+      // 1-365, February 29 is never counted
+      int64_t days = date_ymd::to_days(year, 1, 1) + day - 1;
+      if (date_ymd::is_leap_year(year) && day >= 60) {
+        ++days;
+      }
+      return days;
+    } else if (kind == 'D') {
+      return date_ymd::to_days(year, 1, 1) + day;
+    } else {
+      int64_t first = date_ymd::to_days(year, month, 1);
+      // 1970-01-01 was a Thursday
+      int first_weekday = static_cast<int>(((first + 4) % 7 + 7) % 7);
+      int mday = 1 + (day - first_weekday + 7) % 7 + (week - 1) * 7;
+      int month_length = date_ymd::get_month_length(year, month);
+      while (mday > month_length) {
+        mday -= 7;
+      }
+      return first + mday - 1;
+    }
+  }
+};
+
+/** The range of seconds representable in datetime ticks */
+const int64_t max_tzif_seconds =
+    numeric_limits<int64_t>::max() / DYND_TICKS_PER_SECOND - 1;
+/** Rules from the TZ footer are expanded into the table up to this year */
+const int tz_rule_expansion_end_year = 2200;
+} // anonymous namespace
+
+std::shared_ptr<const timezone_transitions>
+dynd::parse_tzif_data(const std::string &name, const char *begin,
+                      const char *end)
+{
+  tzif_reader r(begin, end);
+  tzif_header hdr;
+  hdr.read(r);
+  int time_size = 4;
+  if (hdr.version >= '2') {
+    // Skip the 32-bit data in favour of the 64-bit data that follows
+    r.skip(hdr.get_data_size(4));
+    hdr.read(r);
+    time_size = 8;
+  }
+
+  vector<int64_t> times(hdr.timecnt);
+  for (int64_t i = 0; i < hdr.timecnt; ++i) {
+    times[i] = r.read_int(time_size);
+  }
+  vector<int> indices(hdr.timecnt);
+  for (int64_t i = 0; i < hdr.timecnt; ++i) {
+    indices[i] = static_cast<int>(r.read_int(1) & 0xff);
+    if (indices[i] >= hdr.typecnt) {
+      throw invalid_argument("TZif data has an invalid time type index");
+    }
+  }
+  vector<int64_t> type_offsets(hdr.typecnt);
+  for (int64_t i = 0; i < hdr.typecnt; ++i) {
+    type_offsets[i] = r.read_int(4) * DYND_TICKS_PER_SECOND;
+    r.skip(2);
+  }
+  r.skip(hdr.charcnt + hdr.leapcnt * (time_size + 4) + hdr.isstdcnt +
+         hdr.isutcnt);
+
+  vector<int64_t> utc_ticks, offsets;
+  int64_t initial_offset = type_offsets[0];
+  for (int64_t i = 0; i < hdr.timecnt; ++i) {
+    int64_t offset = type_offsets[indices[i]];
+    if (times[i] < -max_tzif_seconds) {
+      // Before the representable range, acts as the initial offset
+      initial_offset = offset;
+      continue;
+    } else if (times[i] > max_tzif_seconds) {
+      break;
+    }
+    int64_t prev = offsets.empty() ? initial_offset : offsets.back();
+    if (offset != prev) {
+      utc_ticks.push_back(times[i] * DYND_TICKS_PER_SECOND);
+      offsets.push_back(offset);
+    }
+  }
+
+  // Expand the footer rule beyond the last transition
+  if (time_size == 8 && r.m_begin < r.m_end && *r.m_begin == '\n') {
+    const char *footer_begin = r.m_begin + 1;
+    const char *footer_end = footer_begin;
+    while (footer_end < r.m_end && *footer_end != '\n') {
+      ++footer_end;
+    }
+    posix_tz_rule rule;
+    if (footer_end > footer_begin && rule.parse(footer_begin, footer_end) &&
+        rule.has_dst) {
+      int64_t last = utc_ticks.empty() ? numeric_limits<int64_t>::min()
+                                         : utc_ticks.back();
+      int first_year = 1970;
+      if (!utc_ticks.empty()) {
+        date_ymd ymd;
+        ymd.set_from_days(static_cast<int32_t>(
+            utc_ticks.back() / (86400 * DYND_TICKS_PER_SECOND)));
+        first_year = ymd.year;
+      }
+      vector<pair<int64_t, int64_t>> rule_transitions;
+      for (int year = first_year; year <= tz_rule_expansion_end_year; ++year) {
+        // DST starts at a standard time, and ends at a daylight time
+        int64_t start =
+            (posix_tz_rule::rule_days(year, rule.start_kind, rule.start_month,
+                       rule.start_week, rule.start_day) *
+                 86400 +
+             rule.start_time - rule.std_offset) *
+            DYND_TICKS_PER_SECOND;
+        int64_t end =
+            (posix_tz_rule::rule_days(year, rule.end_kind, rule.end_month, rule.end_week,
+                       rule.end_day) *
+                 86400 +
+             rule.end_time - rule.dst_offset) *
+            DYND_TICKS_PER_SECOND;
+        rule_transitions.push_back(
+            make_pair(start, rule.dst_offset * DYND_TICKS_PER_SECOND));
+        rule_transitions.push_back(
+            make_pair(end, rule.std_offset * DYND_TICKS_PER_SECOND));
+      }
+      sort(rule_transitions.begin(), rule_transitions.end());
+      for (size_t i = 0; i < rule_transitions.size(); ++i) {
+        if (rule_transitions[i].first > last) {
+          int64_t prev = offsets.empty() ? initial_offset : offsets.back();
+          if (rule_transitions[i].second != prev) {
+            utc_ticks.push_back(rule_transitions[i].first);
+            offsets.push_back(rule_transitions[i].second);
+          }
+        }
+      }
+    }
+  }
+
+  return std::make_shared<timezone_transitions>(name, utc_ticks, offsets,
+                                                initial_offset);
+}
+
+namespace {
+std::string get_tzdata_dir()
+{
+  const char *tzdir = getenv("TZDIR");
+  if (tzdir != NULL && *tzdir != '\0') {
+    return tzdir;
+  }
+  return "/usr/share/zoneinfo";
+}
+
+std::shared_ptr<const timezone_transitions>
+load_timezone_transitions(const std::string &name)
+{
+  // Zone names are relative paths like "Europe/Paris", never escaping
+  // the tzdata directory
+  if (name.empty() || name[0] == '/' || name.find("..") != string::npos) {
+    stringstream ss;
+    ss << "invalid time zone name \"" << name << "\"";
+    throw invalid_argument(ss.str());
+  }
+  string path = get_tzdata_dir() + "/" + name;
+  ifstream f(path.c_str(), ios::in | ios::binary);
+  if (!f) {
+    stringstream ss;
+    ss << "unknown time zone \"" << name << "\", no tzdata file " << path;
+    throw invalid_argument(ss.str());
+  }
+  stringstream contents;
+  contents << f.rdbuf();
+  string data = contents.str();
+  return parse_tzif_data(name, data.data(), data.data() + data.size());
+}
+} // anonymous namespace
+
+std::shared_ptr<const timezone_transitions>
+dynd::get_timezone_transitions(const std::string &name)
+{
+  static std::mutex cache_mutex;
+  static std::map<std::string, std::shared_ptr<const timezone_transitions>>
+      cache;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  std::shared_ptr<const timezone_transitions> &result = cache[name];
+  if (!result) {
+    try {
+      result = load_timezone_transitions(name);
+    } catch (...) {
+      cache.erase(name);
+      throw;
+    }
+  }
+  return result;
+}
@@ -140,7 +140,7 @@ bool ndt::tuple_type::operator==(const base_type &rhs) const
   } else {
     const tuple_type *dt = static_cast<const tuple_type *>(&rhs);
     return get_data_alignment() == dt->get_data_alignment() &&
-           m_field_types.equals_exact(dt->m_field_types) &&
+           field_types_equal(*dt) &&
            m_variadic == dt->m_variadic;
   }
 }
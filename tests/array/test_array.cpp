@@ -13,6 +13,7 @@
 #include "dynd_assertions.hpp"
 
 #include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
 #include <dynd/types/fixed_bytes_type.hpp>
 #include <dynd/types/string_type.hpp>
 
@@ -656,6 +657,14 @@ TEST(Array, PrintBoolVector) {
   EXPECT_EQ("array([True, True, True],\n      type=\"3 * bool\")", ss.str());
 }
 
+TEST(Array, ForwardAsArrayStrided) {
+  // A strided value is copied into the contiguous layout of the type
+  nd::array a = parse_json("6 * int32", "[1, 10, 2, 20, 3, 30]")(irange().by(2));
+  nd::array b = nd::empty_shell(ndt::type("3 * int32"));
+  nd::forward_as_array(b.get_type(), b.get_arrmeta(), b.get_readwrite_originptr(), a);
+  EXPECT_JSON_EQ_ARR("[1, 2, 3]", b);
+}
+
 REGISTER_TYPED_TEST_CASE_P(Array, ScalarConstructor, OneDimConstructor, TwoDimConstructor, ThreeDimConstructor, AsScalar);
 
 INSTANTIATE_TYPED_TEST_CASE_P(Default, Array, DefaultMemory);
@@ -625,6 +625,61 @@ TEST(ArrayAssign, ZeroSizedAssign)
   a.vals() = b;
 }
 
+TEST(ArrayAssign, BlockedBuiltinCasts)
+{
+  // Long enough for several blocks plus a partial one
+  const intptr_t n = 1000;
+  eval::eval_context ectx_nocheck, ectx_overflow, ectx_fractional,
+      ectx_inexact;
+  ectx_nocheck.errmode = assign_error_nocheck;
+  ectx_overflow.errmode = assign_error_overflow;
+  ectx_fractional.errmode = assign_error_fractional;
+  ectx_inexact.errmode = assign_error_inexact;
+
+  nd::array a = nd::empty(n, "int32"), b = nd::empty(n, "int16");
+  for (intptr_t i = 0; i < n; ++i) {
+    a(i).vals() = i - 500;
+  }
+  b.val_assign(a, &ectx_overflow);
+  for (intptr_t i = 0; i < n; ++i) {
+    ASSERT_EQ(i - 500, b(i).as<int16_t>());
+  }
+  // An error deep inside a block is reported, after the elements before it
+  // are assigned
+  b.vals() = 0;
+  a(700).vals() = 40000;
+  EXPECT_THROW(b.val_assign(a, &ectx_overflow), overflow_error);
+  EXPECT_EQ(199, b(699).as<int16_t>());
+  EXPECT_EQ(0, b(700).as<int16_t>());
+  // Without checking, the value wraps
+  b.val_assign(a, &ectx_nocheck);
+  EXPECT_EQ(static_cast<int16_t>(40000), b(700).as<int16_t>());
+
+  nd::array x = nd::empty(n, "float64"), y = nd::empty(n, "int64");
+  for (intptr_t i = 0; i < n; ++i) {
+    x(i).vals() = i * 2.0;
+  }
+  y.val_assign(x, &ectx_fractional);
+  EXPECT_EQ(1998, y(n - 1).as<int64_t>());
+  x(999).vals() = 0.5;
+  EXPECT_THROW(y.val_assign(x, &ectx_fractional), runtime_error);
+  EXPECT_EQ(1996, y(998).as<int64_t>());
+
+  nd::array z = nd::empty(n, "float32");
+  x(999).vals() = 1.0 / 3.0;
+  z.val_assign(x, &ectx_overflow);
+  EXPECT_THROW(z.val_assign(x, &ectx_inexact), runtime_error);
+  x(999).vals() = 1e300;
+  EXPECT_THROW(z.val_assign(x, &ectx_overflow), overflow_error);
+
+  // Non-contiguous data takes the element by element path
+  y.vals() = 0;
+  x(999).vals() = 7.0;
+  y(irange().by(2)).val_assign(x(irange().by(2)), &ectx_fractional);
+  EXPECT_EQ(1996, y(998).as<int64_t>());
+  EXPECT_EQ(0, y(999).as<int64_t>());
+}
+
 /*
 Todo: Fix this test.
 TEST(ArrayAssign, VarToFixedStruct)
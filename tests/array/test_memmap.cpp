@@ -10,8 +10,10 @@
 #include <cmath>
 
 #include "inc_gtest.hpp"
+#include "dynd_assertions.hpp"
 
 #include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
 #include <dynd/types/bytes_type.hpp>
 #include <dynd/types/string_type.hpp>
 
@@ -57,3 +59,70 @@ TEST(ArrayMemMap, SimpleString) {
     unlink("test.txt");
 #endif
 }
+
+TEST(ArrayMemMap, SaveLoad) {
+    nd::array a = parse_json("2 * 3 * int32", "[[1, 2, 3], [4, 5, 6]]");
+    nd::save("test.dynd", a);
+    nd::array b = nd::load_mmap("test.dynd");
+    EXPECT_EQ(a.get_type(), b.get_type());
+    EXPECT_JSON_EQ_ARR("[[1, 2, 3], [4, 5, 6]]", b);
+    // The data is aligned within the mapping
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(b.get_readonly_originptr()) %
+                      nd::saved_array_alignment);
+
+    // Writes through the view go to the file
+    b(1, 2).vals() = 60;
+    b = nd::array();
+    b = nd::load_mmap("test.dynd", nd::read_access_flag);
+    EXPECT_JSON_EQ_ARR("[[1, 2, 3], [4, 5, 60]]", b);
+    EXPECT_THROW(b(0, 0).vals() = 10, runtime_error);
+
+    // A strided view is saved in C order
+    nd::array c = a(irange(), irange().by(2));
+    nd::save("test.dynd", c);
+    b = nd::load_mmap("test.dynd");
+    EXPECT_JSON_EQ_ARR("[[1, 3], [4, 6]]", b);
+    a = parse_json("3 * fixed_string[4]", "[\"abc\", \"\", \"wxyz\"]");
+    nd::save("test.dynd", a);
+    b = nd::load_mmap("test.dynd");
+    EXPECT_EQ(a.get_type(), b.get_type());
+    EXPECT_JSON_EQ_ARR("[\"abc\", \"\", \"wxyz\"]", b);
+    b = nd::array();
+
+    // Only fixed dimensions of POD types can be saved
+    EXPECT_THROW(nd::save("test.dynd", parse_json("2 * string", "[\"a\", \"b\"]")),
+                 type_error);
+    EXPECT_THROW(nd::save("test.dynd", parse_json("var * int32", "[1, 2]")),
+                 type_error);
+    // Files which weren't saved are rejected
+    write_string_file("test.dynd", "This is not an array.", 21);
+    EXPECT_THROW(nd::load_mmap("test.dynd"), runtime_error);
+
+    // Structs keep their layout in the arrmeta, which isn't saved
+    EXPECT_THROW(nd::save("test.dynd", parse_json("2 * {x: int32, y: float64}",
+                                                  "[[1, 2.5], [3, 4.5]]")),
+                 type_error);
+
+    // Headers whose sizes or strides reach past the mapping are rejected,
+    // including ones crafted to overflow the bounds arithmetic
+    a = parse_json("2 * 3 * int32", "[[1, 2, 3], [4, 5, 6]]");
+    // The offsets of data_size and of the first stride in the header
+    const streamoff data_size_offset = 24, stride_offset = 56;
+    uint64_t bad_values[3] = {~static_cast<uint64_t>(0) - 63,
+                              static_cast<uint64_t>(1) << 62, 1u << 20};
+    for (int i = 0; i < 3; ++i) {
+        nd::save("test.dynd", a);
+        {
+            fstream f("test.dynd", ios::binary | ios::in | ios::out);
+            f.seekp(i == 0 ? data_size_offset : stride_offset);
+            f.write(reinterpret_cast<const char *>(&bad_values[i]), sizeof(uint64_t));
+        }
+        EXPECT_THROW(nd::load_mmap("test.dynd"), runtime_error);
+    }
+
+#ifdef WIN32
+    _unlink("test.dynd");
+#else
+    unlink("test.dynd");
+#endif
+}
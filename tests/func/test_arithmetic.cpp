@@ -264,6 +264,31 @@ TEST(Arithmetic, Minus)
   EXPECT_ARR_EQ(nd::array({-0.0, -1.0, -2.0, -3.0, -4.0}), -a);
 }
 
+TEST(Arithmetic, LazyChildren)
+{
+  // Kernels for each pair of numeric types are made on their first call
+  EXPECT_EQ(7, nd::add(3, 4).as<int>());
+  EXPECT_EQ(7.5, nd::add(3, 4.5).as<double>());
+  EXPECT_EQ(7.5f, nd::add(4.5f, (int8_t)3).as<float>());
+  EXPECT_EQ(7, nd::add((int16_t)3, (int64_t)4).as<int64_t>());
+  EXPECT_EQ(ndt::make_type<int64_t>(),
+            nd::add((int16_t)3, (int64_t)4).get_type());
+  EXPECT_ARR_EQ(nd::array({5.0, 7.0}),
+                nd::add(nd::array({1.0, 2.0}), nd::array({4, 5})));
+  EXPECT_THROW(nd::add("a", 1), type_error);
+
+  // The add declfunc's construction was timed
+  vector<nd::declfunc_make_time> times = nd::get_declfunc_make_times();
+  bool found = false;
+  for (size_t i = 0; i < times.size(); ++i) {
+    if (times[i].name == "dynd::nd::add") {
+      found = true;
+      EXPECT_LE(0.0, times[i].seconds);
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
 REGISTER_TYPED_TEST_CASE_P(Arithmetic, SimpleBroadcast, StridedScalarBroadcast,
                            ScalarOnTheRight, ScalarOnTheLeft, ComplexScalar);
 
@@ -15,11 +15,13 @@
 #include <dynd/func/arrfunc.hpp>
 #include <dynd/func/apply.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/expr_kernel_generator.hpp>
 #include <dynd/func/elwise.hpp>
 #include <dynd/func/take.hpp>
 #include <dynd/func/call_callable.hpp>
 #include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -192,6 +194,80 @@ TEST(ArrFunc, KeywordParsing)
   EXPECT_THROW(af0(1, kwds("y", 4, "y", 2.5)).as<int>(), std::invalid_argument);
 }
 
+namespace {
+/**
+ * A nullary kernel whose value is computed by ``F`` from the "x" keyword
+ */
+template <typename F>
+struct kwd_value_ck : nd::base_kernel<kwd_value_ck<F>, kernel_request_host, 0> {
+  int m_value;
+
+  kwd_value_ck(int value) : m_value(value) {}
+
+  void single(char *dst, char *const *DYND_UNUSED(src))
+  {
+    *reinterpret_cast<int *>(dst) = m_value;
+  }
+
+  static intptr_t
+  instantiate(char *DYND_UNUSED(static_data), size_t DYND_UNUSED(data_size),
+              char *DYND_UNUSED(data), void *ckb, intptr_t ckb_offset,
+              const ndt::type &DYND_UNUSED(dst_tp),
+              const char *DYND_UNUSED(dst_arrmeta), intptr_t DYND_UNUSED(nsrc),
+              const ndt::type *DYND_UNUSED(src_tp),
+              const char *const *DYND_UNUSED(src_arrmeta),
+              kernel_request_t kernreq,
+              const eval::eval_context *DYND_UNUSED(ectx),
+              const nd::array &kwds,
+              const std::map<nd::string, ndt::type> &DYND_UNUSED(tp_vars))
+  {
+    kwd_value_ck::make(ckb, kernreq, ckb_offset, F()(kwds.p("x")));
+    return ckb_offset;
+  }
+};
+
+struct parse_int {
+  int operator()(const nd::array &x) const
+  {
+    return atoi(x.as<std::string>().c_str());
+  }
+};
+
+struct weighted_sum {
+  int operator()(const nd::array &x) const
+  {
+    // Array keywords are passed by pointer
+    nd::array values = x.f("dereference");
+    int sum = 0;
+    for (intptr_t i = 0; i < values.get_dim_size(); ++i) {
+      sum += static_cast<int>(i + 1) * values(i).as<int>();
+    }
+    return sum;
+  }
+};
+} // anonymous namespace
+
+TEST(ArrFunc, StringKeyword)
+{
+  nd::arrfunc af = nd::arrfunc::make<kwd_value_ck<parse_int>>(
+      ndt::type("(x: string) -> int32"), 0);
+  EXPECT_EQ(12345, af(kwds("x", nd::array("12345"))).as<int>());
+  // A string sliced out of another array
+  nd::array a = parse_json("3 * string", "[\"1\", \"-20\", \"300\"]");
+  EXPECT_EQ(-20, af(kwds("x", a(1))).as<int>());
+}
+
+TEST(ArrFunc, ArrayKeyword)
+{
+  nd::arrfunc af = nd::arrfunc::make<kwd_value_ck<weighted_sum>>(
+      ndt::type("(x: 3 * int32) -> int32"), 0);
+  nd::array a = parse_json("3 * int32", "[1, 2, 3]");
+  EXPECT_EQ(14, af(kwds("x", a)).as<int>());
+  // A strided view of the same values
+  a = parse_json("6 * int32", "[1, 10, 2, 20, 3, 30]");
+  EXPECT_EQ(14, af(kwds("x", a(irange().by(2)))).as<int>());
+}
+
 /*
 TEST(ArrFunc, Option)
 {
@@ -16,6 +16,7 @@
 #include <dynd/kernels/expr_kernel_generator.hpp>
 #include <dynd/func/apply.hpp>
 #include <dynd/func/elwise.hpp>
+#include <dynd/kernels/elwise.hpp>
 #include <dynd/func/take.hpp>
 #include <dynd/func/call_callable.hpp>
 #include <dynd/array.hpp>
@@ -239,6 +240,55 @@ nd::array((int32_t)0)).get_type();
 }
 */
 
+TEST(Elwise, CoalescedDims)
+{
+  nd::arrfunc af = nd::functional::elwise(nd::functional::apply<callable0>());
+
+  nd::array a = nd::empty("2 * 3 * 4 * int");
+  nd::array b = nd::empty("2 * 3 * 4 * int");
+  for (int i = 0; i < 24; ++i) {
+    a(i / 12, i / 4 % 3, i % 4).vals() = i;
+    b(i / 12, i / 4 % 3, i % 4).vals() = 100 * i;
+  }
+
+  // Contiguous dimensions are fused into one strided loop of 24
+  const char *src_arrmeta[2] = {a.get_arrmeta(), b.get_arrmeta()};
+  ndt::type src_tp[2] = {a.get_type(), b.get_type()};
+  nd::array c = nd::empty(a.get_type());
+  ckernel_builder<kernel_request_host> ckb;
+  af.get()->instantiate(af.get()->static_data, 0, NULL, &ckb, 0, c.get_type(),
+                        c.get_arrmeta(), 2, src_tp, src_arrmeta,
+                        kernel_request_single, &eval::default_eval_context,
+                        nd::array(), std::map<nd::string, ndt::type>());
+  typedef nd::functional::elwise_ck<fixed_dim_type_id, fixed_dim_type_id, 2>
+      ck_type;
+  EXPECT_EQ(24, ck_type::get_self(ckb.get())->m_size);
+  for (int i = 0; i < 24; ++i) {
+    EXPECT_EQ(101 * i, af(a, b)(i / 12, i / 4 % 3, i % 4).as<int>());
+  }
+
+  // A transposed operand still gives elementwise results
+  intptr_t axes[3] = {2, 1, 0};
+  nd::array at = a.permute(3, axes).eval();
+  nd::array bt = b.permute(3, axes);
+  c = af(at, bt);
+  for (int i = 0; i < 24; ++i) {
+    EXPECT_EQ(101 * i, c(i % 4, i / 4 % 3, i / 12).as<int>());
+  }
+
+  // Strided views and broadcast operands
+  c = af(a(irange(), irange().by(2)), b(1, 2));
+  EXPECT_EQ(ndt::type("2 * 2 * 4 * int"), c.get_type());
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      for (int k = 0; k < 4; ++k) {
+        EXPECT_EQ(12 * i + 8 * j + k + 100 * (20 + k),
+                  c(i, j, k).as<int>());
+      }
+    }
+  }
+}
+
 TEST(Elwise, Simple)
 {
   nd::arrfunc af;
@@ -853,3 +853,134 @@ INSTANTIATE_TEST_CASE_P(CUDADevice, FFT2D,
 // INSTANTIATE_TYPED_TEST_CASE_P(Double, RFFT2D, FixedDim2D<double>::Types);
 
 #endif // DYND_FFTW
+
+#ifndef DYND_FFTW
+
+// Sizes with only the dedicated butterflies, with a generic radix of 7 or
+// 13, and prime sizes that use Bluestein's algorithm
+static const intptr_t builtin_fft_sizes[] = {1,  2,  6,   16, 45,  60,
+                                             91, 97, 100, 128, 202, 1021};
+
+static nd::array naive_dft(const nd::array &x, int sign)
+{
+  intptr_t n = x.get_dim_size();
+  nd::array y = nd::empty(n, ndt::make_type<dynd::complex<double>>());
+  for (intptr_t k = 0; k < n; ++k) {
+    double re = 0.0, im = 0.0;
+    for (intptr_t j = 0; j < n; ++j) {
+      dynd::complex<double> v = x(j).as<dynd::complex<double>>();
+      double theta = sign * 2 * 3.14159265358979323846 * (j * k % n) / n;
+      re += v.real() * cos(theta) - v.imag() * sin(theta);
+      im += v.real() * sin(theta) + v.imag() * cos(theta);
+    }
+    y(k).vals() = dynd::complex<double>(re, im);
+  }
+  return y;
+}
+
+static nd::array as_complex(const nd::array &x)
+{
+  nd::array y = nd::empty(
+      x.get_type().with_replaced_dtype(ndt::make_type<dynd::complex<double>>()));
+  y.vals() = x;
+  return y;
+}
+
+TEST(FFT, BuiltinMatchesDFT)
+{
+  for (size_t i = 0; i < sizeof(builtin_fft_sizes) / sizeof(intptr_t); ++i) {
+    intptr_t n = builtin_fft_sizes[i];
+    nd::array x = nd::random::uniform(
+        kwds("dst_tp", ndt::make_fixed_dim(
+                           n, ndt::make_type<dynd::complex<double>>())));
+
+    EXPECT_ARRAY_NEAR(naive_dft(x, -1), nd::fft(x), 1e-9);
+    EXPECT_ARRAY_NEAR(naive_dft(x, 1), nd::ifft(x), 1e-9);
+    EXPECT_ARRAY_NEAR(x, nd::ifft(nd::fft(x)) / n, 1e-9);
+  }
+}
+
+TEST(FFT, BuiltinReal)
+{
+  for (size_t i = 0; i < sizeof(builtin_fft_sizes) / sizeof(intptr_t); ++i) {
+    intptr_t n = builtin_fft_sizes[i];
+    nd::array x = nd::random::uniform(
+        kwds("dst_tp", ndt::make_fixed_dim(n, ndt::make_type<double>())));
+    nd::array xc = as_complex(x);
+
+    nd::array y = nd::rfft(x);
+    EXPECT_EQ(n / 2 + 1, y.get_dim_size());
+    EXPECT_ARRAY_NEAR(naive_dft(xc, -1)(irange(0, n / 2 + 1)), y, 1e-9);
+
+    std::vector<intptr_t> shape(1, n);
+    EXPECT_ARRAY_NEAR(xc, as_complex(nd::irfft(y, kwds("shape", shape)) / n),
+                      1e-9);
+  }
+}
+
+TEST(FFT, BuiltinAxes)
+{
+  nd::array x = nd::random::uniform(
+      kwds("dst_tp", ndt::type("6 * 10 * complex[float64]")));
+
+  // Along one axis, each row is transformed on its own
+  std::vector<intptr_t> axes(1, 1);
+  nd::array y = nd::fft(x, kwds("axes", axes));
+  for (intptr_t i = 0; i < 6; ++i) {
+    EXPECT_ARRAY_NEAR(naive_dft(x(i), -1), y(i), 1e-9);
+  }
+
+  // Along both, the columns of the rows' transforms are transformed
+  y = nd::fft(x);
+  for (intptr_t j = 0; j < 10; ++j) {
+    EXPECT_ARRAY_NEAR(naive_dft(nd::fft(x, kwds("axes", axes))(irange(), j),
+                                -1),
+                      y(irange(), j), 1e-9);
+  }
+  EXPECT_ARRAY_NEAR(x, nd::ifft(y) / 60, 1e-9);
+
+  // A strided view, and a shape that pads with zeros
+  nd::array xs = x(irange().by(2));
+  EXPECT_ARRAY_NEAR(naive_dft(xs(irange(), 3), -1),
+                    nd::fft(xs, kwds("axes", std::vector<intptr_t>(1, 0)))(
+                        irange(), 3),
+                    1e-9);
+  std::vector<intptr_t> shape(2);
+  shape[0] = 6;
+  shape[1] = 16;
+  nd::array xp = nd::zeros(6, 16, ndt::make_type<dynd::complex<double>>());
+  xp(irange(), irange(0, 10)).vals() = x;
+  EXPECT_ARRAY_NEAR(nd::fft(xp), nd::fft(x, kwds("shape", shape)), 1e-9);
+
+  // Real transforms halve the last axis
+  nd::array r =
+      nd::random::uniform(kwds("dst_tp", ndt::type("6 * 9 * float64")));
+  nd::array rc = as_complex(r);
+  nd::array ry = nd::rfft(r);
+  EXPECT_EQ(ndt::type("6 * 5 * complex[float64]"), ry.get_type());
+  EXPECT_ARRAY_NEAR(nd::fft(rc)(irange(), irange(0, 5)), ry, 1e-9);
+  shape[0] = 6;
+  shape[1] = 9;
+  EXPECT_ARRAY_NEAR(rc, as_complex(nd::irfft(ry, kwds("shape", shape)) / 54),
+                    1e-9);
+}
+
+#endif // DYND_FFTW
+
+TEST(FFT, Signatures)
+{
+  // The same in builds with and without FFTW
+  EXPECT_EQ(ndt::type("(Fixed**N * complex[float64], shape: ?N * int64, "
+                      "axes: ?Fixed * int64, flags: ?int32) -> Fixed**N * "
+                      "complex[float64]"),
+            nd::arrfunc(nd::fft).get_array_type());
+  EXPECT_EQ(nd::arrfunc(nd::fft).get_array_type(),
+            nd::arrfunc(nd::ifft).get_array_type());
+  EXPECT_EQ(ndt::type("(Fixed**N * float64, shape: ?N * int64, axes: ?Fixed "
+                      "* int64, flags: ?int32) -> Fixed**N * complex[float64]"),
+            nd::arrfunc(nd::rfft).get_array_type());
+  EXPECT_EQ(ndt::type("(Fixed**N * complex[float64], shape: ?N * int64, "
+                      "axes: ?Fixed * int64, flags: ?int32) -> Fixed**N * "
+                      "float64"),
+            nd::arrfunc(nd::irfft).get_array_type());
+}
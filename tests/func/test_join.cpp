@@ -0,0 +1,122 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "inc_gtest.hpp"
+#include "dynd_assertions.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/func/join.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Join, Inner)
+{
+  nd::array left = parse_json("4 * {id: int32, name: string}",
+                              "[[1, \"a\"], [2, \"b\"], [3, \"c\"], [2, \"d\"]]");
+  nd::array right = parse_json("3 * {id: int32, score: float64}",
+                               "[[2, 0.5], [4, 1.5], [2, 2.5]]");
+  nd::array b = nd::join(left, right, kwds("on", nd::array("id")));
+  EXPECT_EQ(ndt::type("var * {id: int32, name: string, score: float64}"),
+            b.get_type());
+  EXPECT_JSON_EQ_ARR("[{\"id\":2,\"name\":\"b\",\"score\":0.5}, "
+                     "{\"id\":2,\"name\":\"b\",\"score\":2.5}, "
+                     "{\"id\":2,\"name\":\"d\",\"score\":0.5}, "
+                     "{\"id\":2,\"name\":\"d\",\"score\":2.5}]",
+                     b);
+
+  // Building the hash table on the left gives the same rows
+  nd::array b2 = nd::join(right, left, kwds("on", nd::array("id")));
+  EXPECT_EQ(ndt::type("var * {id: int32, score: float64, name: string}"),
+            b2.get_type());
+  EXPECT_JSON_EQ_ARR("[{\"id\":2,\"score\":0.5,\"name\":\"b\"}, "
+                     "{\"id\":2,\"score\":0.5,\"name\":\"d\"}, "
+                     "{\"id\":2,\"score\":2.5,\"name\":\"b\"}, "
+                     "{\"id\":2,\"score\":2.5,\"name\":\"d\"}]",
+                     b2);
+}
+
+TEST(Join, Left)
+{
+  nd::array left = parse_json("3 * {id: string, x: int32}",
+                              "[[\"p\", 1], [\"q\", 2], [\"r\", 3]]");
+  nd::array right = parse_json("var * {id: string, x: int64}",
+                               "[[\"r\", 30], [\"p\", 10], [\"p\", 11], "
+                               "[\"s\", 40], [\"t\", 50]]");
+  nd::array b =
+      nd::join(left, right, kwds("on", nd::array("id"), "how", nd::array("left")));
+  EXPECT_EQ(ndt::type("var * {id: string, x: int32, x_right: ?int64}"),
+            b.get_type());
+  // Option values don't compare, so check the JSON
+  EXPECT_EQ("[{\"id\":\"p\",\"x\":1,\"x_right\":10},"
+            "{\"id\":\"p\",\"x\":1,\"x_right\":11},"
+            "{\"id\":\"q\",\"x\":2,\"x_right\":null},"
+            "{\"id\":\"r\",\"x\":3,\"x_right\":30}]",
+            format_json(b).as<string>());
+}
+
+TEST(Join, Sorted)
+{
+  nd::array left = parse_json("5 * {k: int64, a: int32}",
+                              "[[1, 0], [3, 1], [3, 2], [5, 3], [8, 4]]");
+  nd::array right = parse_json("5 * {k: int64, b: int32}",
+                               "[[0, 0], [3, 10], [3, 11], [5, 12], [9, 13]]");
+  nd::array hashed = nd::join(left, right, kwds("on", nd::array("k"), "how",
+                                                nd::array("left")));
+  nd::array merged =
+      nd::join(left, right, kwds("on", nd::array("k"), "how", nd::array("left"),
+                                 "sorted", true));
+  EXPECT_EQ(hashed.get_type(), merged.get_type());
+  EXPECT_EQ("[{\"k\":1,\"a\":0,\"b\":null},"
+            "{\"k\":3,\"a\":1,\"b\":10},{\"k\":3,\"a\":1,\"b\":11},"
+            "{\"k\":3,\"a\":2,\"b\":10},{\"k\":3,\"a\":2,\"b\":11},"
+            "{\"k\":5,\"a\":3,\"b\":12},{\"k\":8,\"a\":4,\"b\":null}]",
+            format_json(merged).as<string>());
+  EXPECT_EQ(format_json(hashed).as<string>(), format_json(merged).as<string>());
+
+  merged = nd::join(left, right, kwds("on", nd::array("k"), "sorted", true));
+  EXPECT_EQ(5, merged.get_dim_size());
+}
+
+TEST(Join, Large)
+{
+  // Each left row matches the right rows with the same key mod 100
+  nd::array left = nd::empty(1000, ndt::type("{k: int32, i: intptr}"));
+  nd::array right = nd::empty(300, ndt::type("{k: int32, j: intptr}"));
+  for (intptr_t i = 0; i < 1000; ++i) {
+    left(i, 0).vals() = (i * 7) % 100;
+    left(i, 1).vals() = i;
+  }
+  for (intptr_t j = 0; j < 300; ++j) {
+    right(j, 0).vals() = j % 100;
+    right(j, 1).vals() = j;
+  }
+  nd::array b = nd::join(left, right, kwds("on", nd::array("k")));
+  ASSERT_EQ(3000, b.get_dim_size());
+  for (intptr_t r = 0; r < 3000; ++r) {
+    intptr_t i = b(r, 1).as<intptr_t>(), j = b(r, 2).as<intptr_t>();
+    ASSERT_EQ(r / 3, i);
+    ASSERT_EQ((i * 7) % 100, j % 100);
+    ASSERT_EQ(r % 3, j / 100);
+  }
+}
+
+TEST(Join, Errors)
+{
+  nd::array left = parse_json("2 * {id: int32}", "[[1], [2]]");
+  nd::array right = parse_json("2 * {id: int64}", "[[1], [2]]");
+  EXPECT_THROW(nd::join(left, right, kwds("on", nd::array("id"))), type_error);
+  EXPECT_THROW(nd::join(left, left, kwds("on", nd::array("x"))),
+               invalid_argument);
+  EXPECT_THROW(nd::join(left, left, kwds("on", nd::array("id"), "how",
+                                         nd::array("outer"))),
+               invalid_argument);
+}
@@ -0,0 +1,155 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+#include <vector>
+
+#include "inc_gtest.hpp"
+#include "../dynd_assertions.hpp"
+
+#include <dynd/func/matmul.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+/** Fills an array of T with small integer values, exact in any type */
+template <typename T>
+static nd::array make_matrix(intptr_t m, intptr_t n, int seed)
+{
+  nd::array a = nd::empty(m, n, ndt::make_type<T>());
+  T *data = reinterpret_cast<T *>(a.get_readwrite_originptr());
+  for (intptr_t i = 0; i < m * n; ++i) {
+    data[i] = static_cast<T>((i * 7 + seed) % 11 - 5);
+  }
+  return a;
+}
+
+/** The product computed directly, element by element */
+template <typename T>
+static vector<T> naive_matmul(const nd::array &a, const nd::array &b)
+{
+  intptr_t m = a.get_dim_size(), k = b.get_dim_size(),
+           n = b(0).get_dim_size();
+  // Contiguous copies, so the operands can be read directly
+  nd::array ac = nd::empty(m, k, ndt::make_type<T>()),
+            bc = nd::empty(k, n, ndt::make_type<T>());
+  ac.vals() = a;
+  bc.vals() = b;
+  const T *a_data = reinterpret_cast<const T *>(ac.get_readonly_originptr());
+  const T *b_data = reinterpret_cast<const T *>(bc.get_readonly_originptr());
+  vector<T> res(m * n, T(0));
+  for (intptr_t i = 0; i < m; ++i) {
+    for (intptr_t j = 0; j < n; ++j) {
+      for (intptr_t p = 0; p < k; ++p) {
+        res[i * n + j] += a_data[i * k + p] * b_data[p * n + j];
+      }
+    }
+  }
+  return res;
+}
+
+template <typename T>
+static void check_matmul(intptr_t m, intptr_t k, intptr_t n)
+{
+  nd::array a = make_matrix<T>(m, k, 1), b = make_matrix<T>(k, n, 2);
+  nd::array c = nd::matmul(a, b);
+  EXPECT_EQ(ndt::make_fixed_dim(m, ndt::make_fixed_dim(n, ndt::make_type<T>())),
+            c.get_type());
+  vector<T> expected = naive_matmul<T>(a, b);
+  const T *c_data = reinterpret_cast<const T *>(c.get_readonly_originptr());
+  for (intptr_t i = 0; i < m * n; ++i) {
+    ASSERT_EQ(expected[i], c_data[i]);
+  }
+}
+
+TEST(Matmul, Small)
+{
+  EXPECT_JSON_EQ_ARR("[[19, 22], [43, 50]]",
+                     nd::matmul(parse_json("2 * 2 * float64", "[[1, 2], [3, 4]]"),
+                                parse_json("2 * 2 * float64", "[[5, 6], [7, 8]]")));
+  EXPECT_JSON_EQ_ARR("[[4, 5, 6]]",
+                     nd::matmul(parse_json("1 * 2 * float32", "[[1, 0]]"),
+                                parse_json("2 * 3 * float32",
+                                           "[[4, 5, 6], [7, 8, 9]]")));
+}
+
+TEST(Matmul, Blocked)
+{
+  // Sizes which cross the cache blocks, with partial register tiles
+  check_matmul<double>(130, 300, 70);
+  check_matmul<float>(101, 259, 37);
+  check_matmul<dynd::complex<double>>(9, 270, 5);
+  check_matmul<dynd::complex<float>>(5, 3, 6);
+  check_matmul<double>(1, 1, 1);
+}
+
+TEST(Matmul, Strided)
+{
+  nd::array a = make_matrix<double>(40, 30, 1),
+            b = make_matrix<double>(80, 20, 2);
+  intptr_t axes[2] = {1, 0};
+  // The transpose of a, and every other row of b
+  nd::array at = a.permute(2, axes), bs = b(irange().by(2), irange());
+  nd::array c = nd::matmul(at, bs);
+  EXPECT_EQ(ndt::type("30 * 20 * float64"), c.get_type());
+  vector<double> expected = naive_matmul<double>(at, bs);
+  const double *c_data =
+      reinterpret_cast<const double *>(c.get_readonly_originptr());
+  for (intptr_t i = 0; i < 30 * 20; ++i) {
+    ASSERT_EQ(expected[i], c_data[i]);
+  }
+}
+
+TEST(Matmul, Batched)
+{
+  nd::array a = parse_json("2 * 2 * 3 * float64",
+                           "[[[1, 2, 3], [4, 5, 6]], [[0, 1, 0], [1, 0, 1]]]");
+  nd::array b = parse_json("3 * 2 * float64", "[[1, 0], [0, 1], [1, 1]]");
+  EXPECT_JSON_EQ_ARR("[[[4, 5], [10, 11]], [[0, 1], [2, 1]]]",
+                     nd::matmul(a, b));
+
+  nd::array bb = parse_json("2 * 3 * 1 * float64",
+                            "[[[1], [1], [1]], [[2], [0], [0]]]");
+  EXPECT_JSON_EQ_ARR("[[[6], [15]], [[0], [2]]]", nd::matmul(a, bb));
+}
+
+TEST(Matmul, Errors)
+{
+  EXPECT_THROW(nd::matmul(parse_json("2 * 3 * float64", "[[1, 2, 3], [4, 5, 6]]"),
+                          parse_json("2 * 2 * float64", "[[1, 2], [3, 4]]")),
+               exception);
+  EXPECT_THROW(nd::matmul(parse_json("1 * 1 * int32", "[[1]]"),
+                          parse_json("1 * 1 * int32", "[[1]]")),
+               type_error);
+}
+
+TEST(Dot, Vectors)
+{
+  EXPECT_EQ(32.0, nd::dot(parse_json("3 * float64", "[1, 2, 3]"),
+                          parse_json("3 * float64", "[4, 5, 6]")).as<double>());
+  EXPECT_JSON_EQ_ARR("[6, 15]",
+                     nd::dot(parse_json("2 * 3 * float32", "[[1, 2, 3], [4, 5, 6]]"),
+                             parse_json("3 * float32", "[1, 1, 1]")));
+
+  // Complex values are not conjugated
+  nd::array a = nd::empty(2, ndt::make_type<dynd::complex<double>>());
+  a(0).vals() = dynd::complex<double>(0, 1);
+  a(1).vals() = dynd::complex<double>(2, 0);
+  EXPECT_EQ(dynd::complex<double>(3, 0),
+            nd::dot(a, a).as<dynd::complex<double>>());
+
+  // Long enough for the unrolled loop, with a stride
+  nd::array x = make_matrix<double>(2, 103, 3);
+  nd::array y = make_matrix<double>(1, 103, 4)(0);
+  double expected = 0;
+  for (intptr_t i = 0; i < 103; ++i) {
+    expected += x(1, i).as<double>() * y(i).as<double>();
+  }
+  intptr_t axes[2] = {1, 0};
+  EXPECT_EQ(expected, nd::dot(x.permute(2, axes)(irange(), 1), y).as<double>());
+}
@@ -127,6 +127,33 @@ TEST(MultiDispatchArrfunc, Values)
   */
 }
 
+TEST(MultiDispatchArrfunc, RepeatedDispatch)
+{
+  vector<nd::arrfunc> funcs;
+  funcs.push_back(nd::functional::apply(&func0));
+  funcs.push_back(nd::functional::apply(&func1));
+  funcs.push_back(nd::functional::apply(&func2));
+  funcs.push_back(nd::functional::apply(&func3));
+  funcs.push_back(nd::functional::apply(&func4));
+  funcs.push_back(nd::functional::apply(&func5));
+
+  nd::arrfunc af = nd::functional::old_multidispatch(funcs.size(), &funcs[0]);
+
+  // Resolved signatures are remembered, so dispatch a second time through
+  // the memo, interleaving exact and promoted matches
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(5, af((int8_t)1, 1.f, 1.f).as<int>());
+    EXPECT_EQ(0, af(1, 1.f, 1.0).as<int>());
+    EXPECT_EQ(4, af((int8_t)1, 1.f, 1.0).as<int>());
+    EXPECT_EQ(1, af(1, 1.0, 1.f).as<int>());
+    EXPECT_EQ(5, af((int16_t)1, 1.f, 1.f).as<int>());
+  }
+
+  // Types with no matching signature keep failing
+  EXPECT_THROW(af(1.0, 1, 1), type_error);
+  EXPECT_THROW(af(1.0, 1, 1), type_error);
+}
+
 /**
 TODO: This test broken when the order of resolve_option_values and
       resolve_dst_type changed. It should be fixed when we sort out
@@ -169,14 +169,167 @@ TEST(Neighborhood, Sum3D) {
         af(a, kwds("mask", parse_json("3 * 3 * 3 * bool", "[[[true, false, true], [false, true, false], [true, false, true]],"
         "[[false, true, false], [true, false, true], [false, true, false]],"
         "[[true, false, true], [false, true, false], [true, false, true]]]"), "offset", parse_json("3 * int", "[-1, -1, -1]"))));
-}
-
-/*
-    Todo: Make this 3D test pass.
 
+    // A neighborhood larger than the array
     EXPECT_JSON_EQ_ARR("[[[1128, 864, 588, 300], [918, 702, 477, 243], [660, 504, 342, 174], [354, 270, 183, 93]],"
         "[[1896, 1440, 972, 492], [1494, 1134, 765, 387], [1044, 792, 534, 270], [546, 414, 279, 141]],"
         "[[1520, 1152, 776, 392], [1188, 900, 606, 306], [824, 624, 420, 212], [428, 324, 218, 110]],"
         "[[888, 672, 452, 228], [690, 522, 351, 177], [476, 360, 242, 122], [246, 186, 125, 63]]]",
         af(a, kwds("shape", parse_json("3 * int", "[3, 5, 7]"))));
-*/
+}
+
+// The neighborhood sums of a 2D int array, computed directly
+static vector<int> naive_sum2d(const vector<int> &a, intptr_t m, intptr_t n,
+                               intptr_t nh0, intptr_t nh1, intptr_t off0,
+                               intptr_t off1)
+{
+    vector<int> res(m * n);
+    for (intptr_t i = 0; i < m; ++i) {
+        for (intptr_t j = 0; j < n; ++j) {
+            int total = 0;
+            for (intptr_t k = 0; k < nh0; ++k) {
+                for (intptr_t l = 0; l < nh1; ++l) {
+                    intptr_t y = i + off0 + k, x = j + off1 + l;
+                    if (y >= 0 && y < m && x >= 0 && x < n) {
+                        total += a[y * n + x];
+                    }
+                }
+            }
+            res[i * n + j] = total;
+        }
+    }
+    return res;
+}
+
+TEST(Neighborhood, Sum2DTiled) {
+    nd::arrfunc af = nd::functional::neighborhood(nd::functional::apply(&sum<2>), 2);
+
+    // Large enough to be split into several tiles, with interior ones
+    intptr_t m = 40, n = 23000;
+    vector<int> vals(m * n);
+    for (intptr_t i = 0; i < m * n; ++i) {
+        vals[i] = static_cast<int>((i * 7919) % 23) - 11;
+    }
+    nd::array a = nd::empty(m, n, ndt::make_type<int>());
+    memcpy(a.get_readwrite_originptr(), vals.data(), vals.size() * sizeof(int));
+
+    vector<int> expected = naive_sum2d(vals, m, n, 3, 5, -1, -2);
+    nd::array b = af(a, kwds("shape", parse_json("2 * int", "[3, 5]"),
+                             "offset", parse_json("2 * int", "[-1, -2]")));
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+                           reinterpret_cast<const int *>(b.get_readonly_originptr())));
+
+    b = af(a, kwds("shape", parse_json("2 * int", "[3, 5]"),
+                   "offset", parse_json("2 * int", "[-1, -2]"), "threads", 4));
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+                           reinterpret_cast<const int *>(b.get_readonly_originptr())));
+
+    // Huge thread counts are capped rather than instantiating an op each
+    b = af(a, kwds("shape", parse_json("2 * int", "[3, 5]"),
+                   "offset", parse_json("2 * int", "[-1, -2]"), "threads", 100000));
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+                           reinterpret_cast<const int *>(b.get_readonly_originptr())));
+
+    EXPECT_THROW(af(a, kwds("shape", parse_json("2 * int", "[3, 5]"), "threads", 0)),
+                 invalid_argument);
+}
+
+static int sum_or_throw(const nd::strided_vals<int, 2> &nh) {
+    int res = sum<2>(nh);
+    if (res > 40) {
+        throw overflow_error("neighborhood sum is too large");
+    }
+    return res;
+}
+
+TEST(Neighborhood, ThreadedException) {
+    // An op which throws on a worker thread raises in the caller
+    nd::arrfunc af = nd::functional::neighborhood(nd::functional::apply(&sum_or_throw), 2);
+    intptr_t m = 40, n = 23000;
+    nd::array a = nd::empty(m, n, ndt::make_type<int>());
+    int *data = reinterpret_cast<int *>(a.get_readwrite_originptr());
+    for (intptr_t i = 0; i < m * n; ++i) {
+        data[i] = (i == m * n - 1) ? 1000 : 1;
+    }
+    EXPECT_THROW(af(a, kwds("shape", parse_json("2 * int", "[3, 5]"), "threads", 4)),
+                 overflow_error);
+}
+
+TEST(Neighborhood, SeparableConvolution) {
+    vector<vector<double>> weights(2);
+    weights[0].push_back(1);
+    weights[0].push_back(2);
+    weights[0].push_back(1);
+    weights[1].push_back(-1);
+    weights[1].push_back(0);
+    weights[1].push_back(1);
+    weights[1].push_back(3);
+    nd::arrfunc af = nd::functional::separable_convolution(weights);
+
+    intptr_t m = 37, n = 53;
+    vector<int> vals(m * n);
+    for (intptr_t i = 0; i < m * n; ++i) {
+        vals[i] = static_cast<int>((i * 31) % 17) - 8;
+    }
+
+    // The weighted sums, with the weights of each point as a product
+    vector<double> expected(m * n);
+    for (intptr_t i = 0; i < m; ++i) {
+        for (intptr_t j = 0; j < n; ++j) {
+            double total = 0;
+            for (intptr_t k = 0; k < 3; ++k) {
+                for (intptr_t l = 0; l < 4; ++l) {
+                    intptr_t y = i - 1 + k, x = j - 2 + l;
+                    if (y >= 0 && y < m && x >= 0 && x < n) {
+                        total += weights[0][k] * weights[1][l] * vals[y * n + x];
+                    }
+                }
+            }
+            expected[i * n + j] = total;
+        }
+    }
+
+    nd::array a = nd::empty(m, n, ndt::make_type<double>());
+    nd::array af32 = nd::empty(m, n, ndt::make_type<float>());
+    for (intptr_t i = 0; i < m * n; ++i) {
+        reinterpret_cast<double *>(a.get_readwrite_originptr())[i] = vals[i];
+        reinterpret_cast<float *>(af32.get_readwrite_originptr())[i] =
+            static_cast<float>(vals[i]);
+    }
+
+    nd::array b = af(a, kwds("offset", parse_json("2 * int", "[-1, -2]")));
+    EXPECT_EQ(ndt::type("37 * 53 * float64"), b.get_type());
+    const double *b_data = reinterpret_cast<const double *>(b.get_readonly_originptr());
+    for (intptr_t i = 0; i < m * n; ++i) {
+        EXPECT_EQ(expected[i], b_data[i]);
+    }
+
+    b = af(af32, kwds("offset", parse_json("2 * int", "[-1, -2]")));
+    EXPECT_EQ(ndt::type("37 * 53 * float32"), b.get_type());
+    const float *b32_data = reinterpret_cast<const float *>(b.get_readonly_originptr());
+    for (intptr_t i = 0; i < m * n; ++i) {
+        EXPECT_EQ(static_cast<float>(expected[i]), b32_data[i]);
+    }
+
+    // A transposed view, with the default offset of zero
+    nd::array at = a.permute(2, std::vector<intptr_t>({1, 0}).data());
+    b = af(at);
+    b_data = reinterpret_cast<const double *>(b.get_readonly_originptr());
+    for (intptr_t j = 0; j < n; ++j) {
+        for (intptr_t i = 0; i < m; ++i) {
+            double total = 0;
+            for (intptr_t k = 0; k < 3; ++k) {
+                for (intptr_t l = 0; l < 4; ++l) {
+                    intptr_t x = j + k, y = i + l;
+                    if (x < n && y < m) {
+                        total += weights[0][k] * weights[1][l] * vals[y * n + x];
+                    }
+                }
+            }
+            EXPECT_EQ(total, b_data[j * m + i]);
+        }
+    }
+
+    EXPECT_THROW(af(parse_json("2 * 2 * int32", "[[1, 2], [3, 4]]")), type_error);
+}
+
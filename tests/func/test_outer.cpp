@@ -7,13 +7,18 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <vector>
 
 #include "inc_gtest.hpp"
+#include "../dynd_assertions.hpp"
 
 #include <dynd/func/apply.hpp>
 #include <dynd/func/elwise.hpp>
 #include <dynd/func/outer.hpp>
 #include <dynd/func/random.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -58,4 +63,131 @@ TEST(Outer, 1D)
       }
     }
   }
-}
\ No newline at end of file
+}
+
+static double func1(double x, double y) { return x - 2 * y; }
+
+static double sqdist(double x, double y) { return (x - y) * (x - y); }
+
+static int absdiff(int x, int y) { return x < y ? y - x : x - y; }
+
+static uint8_t absdiff8(uint8_t x, uint8_t y) { return x < y ? y - x : x - y; }
+
+TEST(Outer, Blocked)
+{
+  nd::arrfunc af = nd::functional::outer(nd::functional::apply(&func1));
+
+  // Larger than a block in both dimensions
+  intptr_t m = 1100, n = 2100;
+  nd::array x = nd::empty(m, ndt::make_type<double>());
+  nd::array y = nd::empty(2 * n, ndt::make_type<double>());
+  double *x_data = reinterpret_cast<double *>(x.get_readwrite_originptr());
+  double *y_data = reinterpret_cast<double *>(y.get_readwrite_originptr());
+  for (intptr_t i = 0; i < m; ++i) {
+    x_data[i] = static_cast<double>(i % 37);
+  }
+  for (intptr_t j = 0; j < 2 * n; ++j) {
+    y_data[j] = static_cast<double>(j % 101) / 4;
+  }
+
+  // The second argument is strided
+  nd::array res = af(x, y(irange().by(2)));
+  EXPECT_EQ(ndt::make_fixed_dim(m, ndt::make_fixed_dim(n, ndt::make_type<double>())),
+            res.get_type());
+  const double *res_data =
+      reinterpret_cast<const double *>(res.get_readonly_originptr());
+  for (intptr_t i = 0; i < m; ++i) {
+    for (intptr_t j = 0; j < n; ++j) {
+      ASSERT_EQ(func1(x_data[i], y_data[2 * j]), res_data[i * n + j]);
+    }
+  }
+}
+
+TEST(Outer, Reduce)
+{
+  nd::arrfunc af = nd::functional::outer_reduce(
+      nd::functional::apply(&sqdist),
+      kernels::make_builtin_sum_reduction_arrfunc(float64_type_id));
+
+  intptr_t m = 20, n = 3000;
+  nd::array x = nd::empty(m, ndt::make_type<double>());
+  nd::array y = nd::empty(n, ndt::make_type<double>());
+  double *x_data = reinterpret_cast<double *>(x.get_readwrite_originptr());
+  double *y_data = reinterpret_cast<double *>(y.get_readwrite_originptr());
+  for (intptr_t i = 0; i < m; ++i) {
+    x_data[i] = static_cast<double>(i) / 2;
+  }
+  for (intptr_t j = 0; j < n; ++j) {
+    y_data[j] = static_cast<double>(j % 13);
+  }
+
+  nd::array res = af(x, y);
+  EXPECT_EQ(ndt::make_fixed_dim(m, ndt::make_type<double>()), res.get_type());
+  for (intptr_t i = 0; i < m; ++i) {
+    double expected = 0;
+    for (intptr_t j = 0; j < n; ++j) {
+      expected += sqdist(x_data[i], y_data[j]);
+    }
+    EXPECT_EQ(expected, res(i).as<double>());
+  }
+
+  EXPECT_THROW(af(x, nd::empty(0, ndt::make_type<double>())),
+               invalid_argument);
+}
+
+TEST(Outer, ArgMinMax)
+{
+  nd::arrfunc argmin =
+      nd::functional::outer_argmin(nd::functional::apply(&sqdist));
+  nd::arrfunc argmax =
+      nd::functional::outer_argmax(nd::functional::apply(&sqdist));
+
+  // Nearest and farthest neighbours
+  intptr_t m = 50, n = 2500;
+  nd::array x = nd::empty(m, ndt::make_type<double>());
+  nd::array y = nd::empty(n, ndt::make_type<double>());
+  double *x_data = reinterpret_cast<double *>(x.get_readwrite_originptr());
+  double *y_data = reinterpret_cast<double *>(y.get_readwrite_originptr());
+  for (intptr_t i = 0; i < m; ++i) {
+    x_data[i] = static_cast<double>(i * 7 % 50) * 20.5;
+  }
+  for (intptr_t j = 0; j < n; ++j) {
+    y_data[j] = static_cast<double>(j * 211 % n) / 2 + 0.25;
+  }
+
+  nd::array res_min = argmin(x, y), res_max = argmax(x, y);
+  EXPECT_EQ(ndt::make_fixed_dim(m, ndt::make_type<intptr_t>()),
+            res_min.get_type());
+  for (intptr_t i = 0; i < m; ++i) {
+    intptr_t best_min = 0, best_max = 0;
+    for (intptr_t j = 1; j < n; ++j) {
+      if (sqdist(x_data[i], y_data[j]) < sqdist(x_data[i], y_data[best_min])) {
+        best_min = j;
+      }
+      if (sqdist(x_data[i], y_data[j]) > sqdist(x_data[i], y_data[best_max])) {
+        best_max = j;
+      }
+    }
+    EXPECT_EQ(best_min, res_min(i).as<intptr_t>());
+    EXPECT_EQ(best_max, res_max(i).as<intptr_t>());
+  }
+
+  // NaNs are skipped unless they're all there is
+  double nan = numeric_limits<double>::quiet_NaN();
+  vector<double> a_vals = {1, nan}, b_vals = {nan, 5, 0, nan};
+  nd::array a = a_vals, b = b_vals;
+  EXPECT_JSON_EQ_ARR("[2, 0]", argmin(a, b));
+  EXPECT_JSON_EQ_ARR("[1, 0]", argmax(a, b));
+
+  // Integer values, with ties going to the first index
+  nd::arrfunc af = nd::functional::outer_argmin(nd::functional::apply(&absdiff));
+  EXPECT_JSON_EQ_ARR("[0, 2, 1]",
+                     af(parse_json("3 * int32", "[0, 5, 3]"),
+                        parse_json("4 * int32", "[1, 2, 6, -1]")));
+
+  // Narrow integer values
+  af = nd::functional::outer_argmax(nd::functional::apply(&absdiff8));
+  EXPECT_JSON_EQ_ARR("[2, 0]",
+                     af(parse_json("2 * uint8", "[0, 200]"),
+                        parse_json("4 * uint8", "[1, 2, 250, 3]")));
+}
@@ -6,7 +6,10 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <thread>
+#include <vector>
 
 #include "inc_gtest.hpp"
 
@@ -91,3 +94,81 @@ TEST(ArrFuncRegistry, Trig) {
   EXPECT_FLOAT_EQ(powf(1.5f, 2.25f), af(1.5f, 2.25f).as<float>());
   EXPECT_DOUBLE_EQ(pow(1.5, 2.25), af(1.5, 2.25).as<double>());
 }
+
+static int lazy_make_count = 0;
+
+static nd::arrfunc make_lazy_sin()
+{
+  ++lazy_make_count;
+  return func::get_regfunction("sin");
+}
+
+TEST(ArrFuncRegistry, Lazy) {
+  func::set_lazy_regfunction("test_lazy_sin", &make_lazy_sin);
+  EXPECT_EQ(0, lazy_make_count);
+  // Constructed on the first lookup only
+  nd::arrfunc af = func::get_regfunction("test_lazy_sin");
+  EXPECT_EQ(1, lazy_make_count);
+  EXPECT_DOUBLE_EQ(sin(1.0), af(1.0).as<double>());
+  af = func::get_regfunction("test_lazy_sin");
+  EXPECT_EQ(1, lazy_make_count);
+
+  // Registering again replaces the function
+  func::set_regfunction("test_lazy_sin", func::get_regfunction("cos"));
+  af = func::get_regfunction("test_lazy_sin");
+  EXPECT_DOUBLE_EQ(cos(1.0), af(1.0).as<double>());
+  EXPECT_EQ(1, lazy_make_count);
+
+  EXPECT_THROW(func::get_regfunction("test_not_registered"), invalid_argument);
+}
+
+TEST(ArrFuncRegistry, Concurrent) {
+  // Lookups from several threads race with registrations and with the first
+  // construction of each function
+  const char *names[] = {"sinh", "cosh", "tanh", "exp"};
+  vector<thread> threads;
+  vector<int> failures(4, 0);
+  for (int t = 0; t < 4; ++t) {
+    threads.push_back(thread([t, &names, &failures] {
+      for (int i = 0; i < 50; ++i) {
+        nd::arrfunc af = func::get_regfunction(names[(t + i) % 4]);
+        if (af.is_null()) {
+          ++failures[t];
+        }
+        func::set_regfunction("test_concurrent_" + to_string(t), af);
+      }
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); ++t) {
+    threads[t].join();
+  }
+  for (int t = 0; t < 4; ++t) {
+    EXPECT_EQ(0, failures[t]);
+    EXPECT_FALSE(func::get_regfunction("test_concurrent_" + to_string(t))
+                     .is_null());
+  }
+}
+
+TEST(ArrFuncRegistry, ReplaceWhileLookingUp) {
+  // Each registration frees the map it replaces, while another thread keeps
+  // looking the function up
+  func::set_regfunction("test_replaced", func::get_regfunction("sin"));
+  atomic<bool> done(false);
+  int failures = 0;
+  thread reader([&done, &failures] {
+    while (!done) {
+      if (func::get_regfunction("test_replaced").is_null()) {
+        ++failures;
+      }
+    }
+  });
+  nd::arrfunc af = func::get_regfunction("cos");
+  for (int i = 0; i < 1000; ++i) {
+    func::set_regfunction("test_replaced", af);
+  }
+  done = true;
+  reader.join();
+  EXPECT_EQ(0, failures);
+  EXPECT_DOUBLE_EQ(cos(1.0),
+                   func::get_regfunction("test_replaced")(1.0).as<double>());
+}
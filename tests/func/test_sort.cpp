@@ -0,0 +1,188 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "inc_gtest.hpp"
+#include "dynd_assertions.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/func/sort.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Sort, Int32)
+{
+  nd::array a = parse_json("6 * int32", "[3, -1, 4, 1, -5, 9]");
+  nd::array b = nd::sort(a);
+  EXPECT_EQ(ndt::type("6 * int32"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[-5, -1, 1, 3, 4, 9]", b);
+
+  b = nd::argsort(a);
+  EXPECT_EQ(ndt::type("6 * intptr"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[4, 1, 3, 0, 2, 5]", b);
+}
+
+TEST(Sort, Radix)
+{
+  // Large enough for the radix sort, with duplicates and both signs
+  vector<int64_t> vals(5000);
+  for (size_t i = 0; i < vals.size(); ++i) {
+    vals[i] = static_cast<int64_t>((i * 7919) % 1000) - 500;
+    if (i % 3 == 0) {
+      vals[i] *= 1000000007LL;
+    }
+  }
+  nd::array a = vals;
+  nd::array b = nd::sort(a);
+  nd::array c = nd::argsort(a);
+
+  vector<int64_t> expected(vals);
+  std::sort(expected.begin(), expected.end());
+  for (size_t i = 0; i < vals.size(); ++i) {
+    EXPECT_EQ(expected[i], b(i).as<int64_t>());
+    EXPECT_EQ(expected[i], vals[c(i).as<intptr_t>()]);
+    // Equal values keep their original order
+    if (i > 0 && expected[i] == expected[i - 1]) {
+      EXPECT_LT(c(i - 1).as<intptr_t>(), c(i).as<intptr_t>());
+    }
+  }
+}
+
+TEST(Sort, Float64)
+{
+  vector<double> vals(1000);
+  for (size_t i = 0; i < vals.size(); ++i) {
+    vals[i] = ((i * 37) % 101) * 0.25 - 12.0;
+  }
+  vals[10] = std::numeric_limits<double>::quiet_NaN();
+  vals[20] = -std::numeric_limits<double>::infinity();
+  vals[30] = std::numeric_limits<double>::infinity();
+  vals[40] = -0.0;
+  nd::array b = nd::sort(nd::array(vals));
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), b(0).as<double>());
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), b(998).as<double>());
+  // NaN goes last
+  EXPECT_TRUE(std::isnan(b(999).as<double>()));
+  for (intptr_t i = 1; i < 999; ++i) {
+    EXPECT_LE(b(i - 1).as<double>(), b(i).as<double>());
+  }
+
+  nd::array a = parse_json("4 * float32", "[2.5, -0.5, 1e10, -3e-5]");
+  EXPECT_JSON_EQ_ARR("[-0.5, -3e-05, 2.5, 1e+10]", nd::sort(a));
+}
+
+TEST(Sort, Datetime)
+{
+  nd::array a = parse_json("3 * datetime",
+                           "[\"2015-06-01T12:00\", \"1969-12-31T23:59\", "
+                           "\"2015-06-01T11:59:59.5\"]");
+  nd::array b = nd::sort(a);
+  EXPECT_EQ(ndt::type("3 * datetime"), b.get_type());
+  EXPECT_EQ("1969-12-31T23:59", b(0).as<string>());
+  EXPECT_EQ("2015-06-01T11:59:59.5", b(1).as<string>());
+  EXPECT_EQ("2015-06-01T12:00", b(2).as<string>());
+}
+
+TEST(Sort, String)
+{
+  nd::array a = parse_json("7 * string", "[\"pear\", \"apple\", \"applesauce\","
+                                         " \"\", \"apple\", \"applesaucer\","
+                                         " \"zebra\"]");
+  nd::array b = nd::sort(a);
+  EXPECT_EQ(ndt::type("7 * string"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[\"\", \"apple\", \"apple\", \"applesauce\", "
+                     "\"applesaucer\", \"pear\", \"zebra\"]",
+                     b);
+  EXPECT_JSON_EQ_ARR("[3, 1, 4, 2, 5, 0, 6]", nd::argsort(a));
+
+  a = parse_json("3 * fixed_string[8]", "[\"bb\", \"b\", \"a\"]");
+  EXPECT_JSON_EQ_ARR("[\"a\", \"b\", \"bb\"]", nd::sort(a));
+}
+
+TEST(Sort, Comparison)
+{
+  // Structs go through the comparison kernel, ordered field by field
+  nd::array a = parse_json("4 * {x: int32, y: string}",
+                           "[[2, \"a\"], [1, \"b\"], [2, \"a\"], [1, \"a\"]]");
+  EXPECT_JSON_EQ_ARR("[3, 1, 0, 2]", nd::argsort(a, kwds("stable", true)));
+  nd::array b = nd::sort(a);
+  EXPECT_EQ(ndt::type("4 * {x: int32, y: string}"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[{\"x\":1,\"y\":\"a\"}, {\"x\":1,\"y\":\"b\"}, "
+                     "{\"x\":2,\"y\":\"a\"}, {\"x\":2,\"y\":\"a\"}]",
+                     b);
+}
+
+TEST(Sort, Lifted)
+{
+  // Each row is sorted on its own
+  nd::array a = parse_json("2 * 3 * int16", "[[3, 1, 2], [0, -1, 5]]");
+  nd::array b = nd::sort(a);
+  EXPECT_EQ(ndt::type("2 * 3 * int16"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[[1, 2, 3], [-1, 0, 5]]", b);
+  EXPECT_JSON_EQ_ARR("[[1, 2, 0], [1, 0, 2]]", nd::argsort(a));
+
+  a = parse_json("2 * 2 * string", "[[\"b\", \"a\"], [\"c\", \"d\"]]");
+  EXPECT_JSON_EQ_ARR("[[\"a\", \"b\"], [\"c\", \"d\"]]", nd::sort(a));
+}
+
+TEST(Sort, Parallel)
+{
+  // Splitting the rows across threads gives the same result as one thread
+  vector<int32_t> vals(50000);
+  for (size_t i = 0; i < vals.size(); ++i) {
+    vals[i] = static_cast<int32_t>((i * 2654435761u) % 20011) - 10000;
+  }
+  nd::array a = vals;
+  nd::array expected = nd::argsort(a, kwds("threads", 1));
+  for (int threads = 2; threads <= 5; ++threads) {
+    nd::array b = nd::argsort(a, kwds("threads", threads));
+    for (size_t i = 0; i < vals.size(); ++i) {
+      ASSERT_EQ(expected(i).as<intptr_t>(), b(i).as<intptr_t>());
+    }
+    b = nd::sort(a, kwds("threads", threads));
+    for (size_t i = 0; i < vals.size(); ++i) {
+      ASSERT_EQ(vals[expected(i).as<intptr_t>()], b(i).as<int32_t>());
+    }
+  }
+
+  nd::array s = nd::empty(20000, ndt::make_string());
+  for (intptr_t i = 0; i < 20000; ++i) {
+    s(i).vals() = to_string((i * 7919) % 5003);
+  }
+  expected = nd::argsort(s, kwds("threads", 1));
+  nd::array b = nd::argsort(s, kwds("threads", 3));
+  for (intptr_t i = 0; i < 20000; ++i) {
+    ASSERT_EQ(expected(i).as<intptr_t>(), b(i).as<intptr_t>());
+  }
+  EXPECT_EQ(s(expected(19999).as<intptr_t>()).as<string>(),
+            nd::sort(s, kwds("threads", 3))(19999).as<string>());
+
+  // The comparison sort runs in parallel when it is stable
+  nd::array c = nd::empty(20000, ndt::type("{x: int32, y: int32}"));
+  for (intptr_t i = 0; i < 20000; ++i) {
+    c(i, 0).vals() = (i * 7919) % 101;
+    c(i, 1).vals() = (i * 13) % 7;
+  }
+  expected = nd::argsort(c, kwds("stable", true, "threads", 1));
+  b = nd::argsort(c, kwds("stable", true, "threads", 4));
+  for (intptr_t i = 0; i < 20000; ++i) {
+    ASSERT_EQ(expected(i).as<intptr_t>(), b(i).as<intptr_t>());
+  }
+
+  // Expression types compare through buffers, one set per thread
+  nd::array e = a.ucast(ndt::make_type<double>());
+  expected = nd::argsort(e, kwds("stable", true, "threads", 1));
+  b = nd::argsort(e, kwds("stable", true, "threads", 4));
+  for (size_t i = 0; i < vals.size(); ++i) {
+    ASSERT_EQ(expected(i).as<intptr_t>(), b(i).as<intptr_t>());
+  }
+}
@@ -80,4 +80,75 @@ TEST(ArrFunc, TakeOfArray) {
     EXPECT_EQ(5, c(2, 1).as<int>());
     EXPECT_EQ(2, c(3, 0).as<int>());
     EXPECT_EQ(3, c(3, 1).as<int>());
-}
\ No newline at end of file
+}
+
+TEST(ArrFunc, TakeBuiltinElements) {
+    // Long enough for the blocked mask tests and index prefetching
+    const int n = 100;
+    nd::array a = nd::empty(n, ndt::type("float64"));
+    nd::array mask = nd::empty(n, ndt::type("bool"));
+    nd::array index = nd::empty(n, ndt::type("intptr"));
+    for (int i = 0; i < n; ++i) {
+        a(i).vals() = 0.5 * i;
+        // All true, all false and mixed runs of eight
+        mask(i).vals() = (i < 16) || (i >= 32 && i % 3 == 0);
+        index(i).vals() = (i * 37) % n - (i % 2 ? n : 0);
+    }
+
+    nd::array c = nd::take(a, mask);
+    EXPECT_EQ(ndt::type("var * float64"), c.get_type());
+    int k = 0;
+    for (int i = 0; i < n; ++i) {
+        if (mask(i).as<bool>()) {
+            EXPECT_EQ(0.5 * i, c(k++).as<double>());
+        }
+    }
+    EXPECT_EQ(k, c.get_dim_size());
+
+    // A strided mask goes through the element loop
+    c = nd::take(a(irange().by(2)), mask(irange().by(2)));
+    k = 0;
+    for (int i = 0; i < n; i += 2) {
+        if (mask(i).as<bool>()) {
+            EXPECT_EQ(0.5 * i, c(k++).as<double>());
+        }
+    }
+    EXPECT_EQ(k, c.get_dim_size());
+
+    c = nd::take(a, index);
+    EXPECT_EQ(ndt::type("100 * float64"), c.get_type());
+    for (int i = 0; i < n; ++i) {
+        EXPECT_EQ(0.5 * ((i * 37) % n), c(i).as<double>());
+    }
+
+    intptr_t bad_index[3] = {0, 100, 1};
+    EXPECT_THROW(nd::take(a, bad_index), index_out_of_bounds);
+}
+
+TEST(ArrFunc, Put) {
+    nd::array a = nd::empty(10, ndt::type("int32"));
+    a.vals() = 0;
+
+    intptr_t index[4] = {3, 0, -1, 3};
+    int values[4] = {1, 2, 3, 4};
+    nd::array b = nd::put(index, values, kwds("dst", a));
+    EXPECT_EQ(a.get_readonly_originptr(), b.get_readonly_originptr());
+    // The last of a repeated index wins
+    EXPECT_EQ(4, a(3).as<int>());
+    EXPECT_EQ(2, a(0).as<int>());
+    EXPECT_EQ(3, a(9).as<int>());
+    EXPECT_EQ(0, a(1).as<int>());
+
+    // Values are converted to the destination type
+    double dvalues[4] = {1.5, 2.5, 3.5, 4.5};
+    nd::array d = nd::empty(10, ndt::type("float32"));
+    d.vals() = 0;
+    nd::put(index, dvalues, kwds("dst", d(irange().by(1))));
+    EXPECT_EQ(4.5f, d(3).as<float>());
+    EXPECT_EQ(3.5f, d(9).as<float>());
+
+    intptr_t bad_index[4] = {0, 10, 1, 2};
+    EXPECT_THROW(nd::put(bad_index, values, kwds("dst", a)),
+                 index_out_of_bounds);
+    EXPECT_THROW(nd::put(index, values), invalid_argument);
+}
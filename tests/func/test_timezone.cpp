@@ -0,0 +1,137 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <fstream>
+
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/func/timezone.hpp>
+#include <dynd/types/datetime_type.hpp>
+#include <dynd/types/time_util.hpp>
+#include <dynd/types/timezone_util.hpp>
+
+using namespace std;
+using namespace dynd;
+
+// The conversions need the system tzdata, which e.g. Windows doesn't have
+static bool have_tzdata()
+{
+  const char *tzdir = getenv("TZDIR");
+  string path = string(tzdir != NULL ? tzdir : "/usr/share/zoneinfo") +
+                "/America/New_York";
+  return ifstream(path.c_str()).good();
+}
+
+static nd::array utc_datetimes(const char *json)
+{
+  return parse_json(ndt::type("var * datetime[tz='UTC']"), json);
+}
+
+TEST(Timezone, UTCToLocal)
+{
+  if (!have_tzdata()) {
+    return;
+  }
+
+  nd::array a = utc_datetimes(
+      "[\"2015-01-15T12:00Z\", \"2015-07-01T12:00Z\", \"1900-07-01T12:00Z\", "
+      "\"2150-07-01T12:00Z\", \"2150-12-01T12:00Z\"]");
+  nd::array b = nd::utc_to_local(a, kwds("tz", nd::array("America/New_York")));
+  EXPECT_EQ(ndt::type("var * datetime"), b.get_type());
+  EXPECT_EQ("2015-01-15T07:00", b(0).as<string>());
+  EXPECT_EQ("2015-07-01T08:00", b(1).as<string>());
+  // Before 1901, from the 64-bit part of the file
+  EXPECT_EQ("1900-07-01T07:00", b(2).as<string>());
+  // Far past the table in the file, the footer rule applies
+  EXPECT_EQ("2150-07-01T08:00", b(3).as<string>());
+  EXPECT_EQ("2150-12-01T07:00", b(4).as<string>());
+
+  // Southern hemisphere daylight saving time
+  b = nd::utc_to_local(a, kwds("tz", nd::array("Australia/Sydney")));
+  EXPECT_EQ("2015-01-15T23:00", b(0).as<string>());
+  EXPECT_EQ("2015-07-01T22:00", b(1).as<string>());
+
+  b = nd::utc_to_local(a, kwds("tz", nd::array("UTC")));
+  EXPECT_EQ("2015-07-01T12:00", b(1).as<string>());
+}
+
+TEST(Timezone, LocalToUTC)
+{
+  if (!have_tzdata()) {
+    return;
+  }
+
+  nd::array a = parse_json(ndt::type("4 * datetime"),
+                           "[\"2015-07-01T08:00\", \"2015-01-15T07:00\", "
+                           "\"2015-11-01T01:30\", \"2015-03-08T02:30\"]");
+  nd::array b = nd::local_to_utc(a, kwds("tz", nd::array("America/New_York")));
+  EXPECT_EQ(ndt::type("4 * datetime[tz='UTC']"), b.get_type());
+  EXPECT_EQ("2015-07-01T12:00Z", b(0).as<string>());
+  EXPECT_EQ("2015-01-15T12:00Z", b(1).as<string>());
+  // 01:30 happens twice when the clocks go back, the earlier one is used
+  EXPECT_EQ("2015-11-01T05:30Z", b(2).as<string>());
+  // 02:30 is skipped when the clocks go forward, and is read as 03:30 EDT
+  EXPECT_EQ("2015-03-08T07:30Z", b(3).as<string>());
+}
+
+TEST(Timezone, RoundTrip)
+{
+  if (!have_tzdata()) {
+    return;
+  }
+
+  // Every hour across a year, including both transitions. The hour which
+  // repeats when the clocks go back comes back as its first occurrence.
+  nd::array a = nd::empty(24 * 366, ndt::type("datetime[tz='UTC']"));
+  int64_t start = nd::array("2016-01-01T00:00Z")
+                      .ucast(ndt::type("datetime[tz='UTC']"))
+                      .view_scalars(ndt::make_type<int64_t>())
+                      .as<int64_t>();
+  nd::array ticks = a.view_scalars(ndt::make_type<int64_t>());
+  for (intptr_t i = 0; i < 24 * 366; ++i) {
+    ticks(i).vals() = start + i * 3600LL * DYND_TICKS_PER_SECOND;
+  }
+  nd::array b = nd::local_to_utc(
+      nd::utc_to_local(a, kwds("tz", nd::array("Europe/London"))),
+      kwds("tz", nd::array("Europe/London")));
+  nd::array b_ticks = b.view_scalars(ndt::make_type<int64_t>());
+  int64_t repeated = nd::array("2016-10-30T01:00Z")
+                         .ucast(ndt::type("datetime[tz='UTC']"))
+                         .view_scalars(ndt::make_type<int64_t>())
+                         .as<int64_t>();
+  for (intptr_t i = 0; i < 24 * 366; ++i) {
+    int64_t expected = ticks(i).as<int64_t>();
+    if (expected == repeated) {
+      expected -= 3600LL * DYND_TICKS_PER_SECOND;
+    }
+    EXPECT_EQ(expected, b_ticks(i).as<int64_t>());
+  }
+}
+
+TEST(Timezone, Errors)
+{
+  EXPECT_THROW(get_timezone_transitions("No/Such_Zone"), invalid_argument);
+  EXPECT_THROW(get_timezone_transitions("../../etc/passwd"), invalid_argument);
+  const char data[] = "not a tzif file at all, but long enough to have a "
+                      "header";
+  EXPECT_THROW(parse_tzif_data("bad", data, data + sizeof(data) - 1),
+               invalid_argument);
+}
+
+TEST(Timezone, TransitionsCached)
+{
+  if (!have_tzdata()) {
+    return;
+  }
+
+  std::shared_ptr<const timezone_transitions> tz =
+      get_timezone_transitions("America/New_York");
+  EXPECT_EQ(tz, get_timezone_transitions("America/New_York"));
+  EXPECT_LT(200, tz->get_transition_count());
+}
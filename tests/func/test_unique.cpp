@@ -0,0 +1,137 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "inc_gtest.hpp"
+#include "dynd_assertions.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/func/unique.hpp>
+#include <dynd/types/categorical_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Unique, Int32)
+{
+  nd::array a = parse_json("8 * int32", "[3, -1, 3, 4, -1, 3, 0, 4]");
+  nd::array b = nd::unique(a);
+  EXPECT_EQ(ndt::type("var * int32"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[3, -1, 4, 0]", b);
+
+  b = nd::unique(a, kwds("return_inverse", true));
+  EXPECT_EQ(ndt::type("{values: var * int32, inverse: 8 * intptr}"),
+            b.get_type());
+  EXPECT_JSON_EQ_ARR("[3, -1, 4, 0]", b(0));
+  EXPECT_JSON_EQ_ARR("[0, 1, 0, 2, 1, 0, 3, 2]", b(1));
+}
+
+TEST(Unique, Float64)
+{
+  // All NaNs are one value, and -0.0 is 0.0
+  nd::array a = parse_json("6 * float64", "[1.5, 0, 1.5, 2, 0, 2]");
+  a(1).vals() = -0.0;
+  a(3).vals() = std::numeric_limits<double>::quiet_NaN();
+  a(5).vals() = -std::numeric_limits<double>::quiet_NaN();
+  nd::array b = nd::unique(a);
+  ASSERT_EQ(3, b.get_dim_size());
+  EXPECT_EQ(1.5, b(0).as<double>());
+  EXPECT_EQ(0.0, b(1).as<double>());
+  EXPECT_TRUE(std::isnan(b(2).as<double>()));
+}
+
+TEST(Unique, String)
+{
+  nd::array a = parse_json("6 * string", "[\"pear\", \"apple\", \"\", "
+                                         "\"apple\", \"pear\", \"\"]");
+  EXPECT_JSON_EQ_ARR("[\"pear\", \"apple\", \"\"]", nd::unique(a));
+
+  // Enough distinct values for the hash table to grow several times
+  nd::array s = nd::empty(3000, ndt::make_string());
+  for (intptr_t i = 0; i < 3000; ++i) {
+    s(i).vals() = "key_" + to_string(i % 1000);
+  }
+  nd::array b = nd::unique(s, kwds("return_inverse", true));
+  ASSERT_EQ(1000, b(0).get_dim_size());
+  for (intptr_t i = 0; i < 3000; ++i) {
+    ASSERT_EQ(i % 1000, b(1, i).as<intptr_t>());
+  }
+}
+
+TEST(Unique, Struct)
+{
+  nd::array a = parse_json("5 * {x: int32, y: string}",
+                           "[[1, \"a\"], [1, \"b\"], [1, \"a\"], [2, \"a\"], "
+                           "[1, \"b\"]]");
+  EXPECT_JSON_EQ_ARR("[{\"x\":1,\"y\":\"a\"}, {\"x\":1,\"y\":\"b\"}, "
+                     "{\"x\":2,\"y\":\"a\"}]",
+                     nd::unique(a));
+}
+
+TEST(Unique, OneDimensional)
+{
+  // Rows aren't treated as values, and unique isn't lifted over them
+  EXPECT_THROW(nd::unique(parse_json("2 * 2 * int32", "[[1, 2], [1, 2]]")),
+               invalid_argument);
+}
+
+TEST(ValueCounts, Simple)
+{
+  nd::array a = parse_json("7 * string", "[\"b\", \"a\", \"b\", \"c\", \"b\", "
+                                         "\"a\", \"b\"]");
+  nd::array b = nd::value_counts(a);
+  EXPECT_EQ(ndt::type("{values: var * string, counts: var * intptr}"),
+            b.get_type());
+  EXPECT_JSON_EQ_ARR("[\"b\", \"a\", \"c\"]", b(0));
+  EXPECT_JSON_EQ_ARR("[4, 2, 1]", b(1));
+
+  a = parse_json("5 * int64", "[7, 7, 7, 7, 7]");
+  b = nd::value_counts(a);
+  EXPECT_JSON_EQ_ARR("[7]", b(0));
+  EXPECT_JSON_EQ_ARR("[5]", b(1));
+
+  // Each row is counted on its own
+  a = parse_json("2 * 4 * int16", "[[1, 1, 2, 1], [5, 6, 7, 5]]");
+  b = nd::value_counts(a);
+  EXPECT_EQ(ndt::type("2 * {values: var * int16, counts: var * intptr}"),
+            b.get_type());
+  EXPECT_JSON_EQ_ARR("[1, 2]", b(0, 0));
+  EXPECT_JSON_EQ_ARR("[3, 1]", b(0, 1));
+  EXPECT_JSON_EQ_ARR("[5, 6, 7]", b(1, 0));
+  EXPECT_JSON_EQ_ARR("[2, 1, 1]", b(1, 1));
+}
+
+TEST(IsIn, Simple)
+{
+  nd::array a = parse_json("6 * int32", "[1, 2, 3, 4, 5, 6]");
+  nd::array s = parse_json("3 * int32", "[6, 2, 9]");
+  nd::array b = nd::isin(a, s);
+  EXPECT_EQ(ndt::type("6 * bool"), b.get_type());
+  EXPECT_JSON_EQ_ARR("[false, true, false, false, false, true]", b);
+
+  a = parse_json("2 * 3 * string", "[[\"x\", \"y\", \"z\"], [\"z\", \"w\", "
+                                   "\"x\"]]");
+  s = parse_json("2 * string", "[\"x\", \"z\"]");
+  EXPECT_JSON_EQ_ARR("[[true, false, true], [true, false, true]]",
+                     nd::isin(a, s));
+}
+
+TEST(Categorical, FactorHashed)
+{
+  // factor_categorical dedups through a hash table, then sorts
+  nd::array a = parse_json("6 * string", "[\"c\", \"a\", \"c\", \"b\", \"a\", "
+                                         "\"c\"]");
+  ndt::type tp = ndt::factor_categorical(a);
+  EXPECT_EQ(3u, tp.extended<ndt::categorical_type>()->get_category_count());
+  EXPECT_JSON_EQ_ARR("[\"a\", \"b\", \"c\"]",
+                     tp.extended<ndt::categorical_type>()->get_categories());
+
+  EXPECT_THROW(ndt::make_categorical(a), runtime_error);
+}
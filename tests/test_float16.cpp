@@ -12,6 +12,9 @@
 #include "dynd_assertions.hpp"
 
 #include <dynd/config.hpp>
+#include <dynd/array.hpp>
+#include <dynd/float16.hpp>
+#include <dynd/func/arithmetic.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -24,4 +27,137 @@ TEST(Float16, CommonType)
   EXPECT_TRUE((std::is_same<typename std::common_type<float16, float64>::type,
                             float64>::value));
 }
-*/
\ No newline at end of file
+*/
+
+static void check_bulk_float16_conversions()
+{
+  vector<uint16_t> h(65536);
+  for (size_t i = 0; i < h.size(); ++i) {
+    h[i] = static_cast<uint16_t>(i);
+  }
+
+  vector<float> f(h.size());
+  halfbits_to_float_n(&f[0], &h[0], h.size());
+  vector<double> d(h.size());
+  halfbits_to_double_n(&d[0], &h[0], h.size());
+  for (size_t i = 0; i < h.size(); ++i) {
+    if (std::isnan(halfbits_to_float(h[i]))) {
+      EXPECT_TRUE(std::isnan(f[i])) << i;
+      EXPECT_TRUE(std::isnan(d[i])) << i;
+    } else {
+      EXPECT_EQ(halfbits_to_float(h[i]), f[i]) << i;
+      EXPECT_EQ(halfbits_to_double(h[i]), d[i]) << i;
+    }
+  }
+
+  // Every float16 and the float32 values halfway between neighbours, which
+  // check round to nearest even, with an odd count to exercise the tail
+  vector<float> g;
+  for (size_t i = 0; i < h.size(); ++i) {
+    float x = halfbits_to_float(h[i]);
+    if (!std::isnan(x)) {
+      g.push_back(x);
+      if ((h[i] & 0x7fffu) < 0x7bffu) {
+        g.push_back((x + halfbits_to_float(h[i] + 1)) / 2);
+      }
+    }
+  }
+  g.push_back(1e10f);
+  g.push_back(-1e-10f);
+  g.push_back(3.f);
+  vector<uint16_t> r(g.size());
+  float_to_halfbits_n(&r[0], &g[0], g.size());
+  for (size_t i = 0; i < g.size(); ++i) {
+    EXPECT_EQ(float_to_halfbits(g[i], assign_error_nocheck), r[i]) << g[i];
+  }
+}
+
+TEST(Float16, BulkConversions)
+{
+  bool f16c = float16_f16c_enabled();
+  check_bulk_float16_conversions();
+  if (f16c) {
+    // Check the portable fallback too
+    set_float16_f16c_enabled(false);
+    check_bulk_float16_conversions();
+    set_float16_f16c_enabled(true);
+  }
+  EXPECT_EQ(f16c, float16_f16c_enabled());
+}
+
+TEST(Float16, ArrayAssign)
+{
+  nd::array a = nd::empty(1000, ndt::type("float32"));
+  for (int i = 0; i < 1000; ++i) {
+    a(i).vals() = 0.25f * i - 100.f;
+  }
+
+  nd::array b = nd::empty(1000, ndt::type("float16"));
+  b.vals() = a;
+  nd::array c = nd::empty(1000, ndt::type("float64"));
+  c.vals() = b;
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(0.25 * i - 100., c(i).as<double>());
+  }
+
+  // A strided source goes through the element loop
+  b = nd::empty(500, ndt::type("float16"));
+  b.vals() = a(irange().by(2));
+  for (int i = 0; i < 500; ++i) {
+    EXPECT_EQ(0.5f * i - 100.f, b(i).as<float>());
+  }
+
+  // Overflow is detected, in a block and in a single element
+  a(700).vals() = 1e10f;
+  b = nd::empty(1000, ndt::type("float16"));
+  EXPECT_THROW(b.vals() = a, overflow_error);
+  EXPECT_THROW(b(0).vals() = 1e10f, overflow_error);
+  EXPECT_THROW(b(0).vals() = 1e10, overflow_error);
+  eval::eval_context ectx_nocheck;
+  ectx_nocheck.errmode = assign_error_nocheck;
+  b.val_assign(a, &ectx_nocheck);
+  EXPECT_TRUE(std::isinf(b(700).as<float>()));
+
+  // Infinities and NaNs are not overflow
+  a(700).vals() = numeric_limits<float>::infinity();
+  a(701).vals() = numeric_limits<float>::quiet_NaN();
+  b.vals() = a;
+  EXPECT_TRUE(std::isinf(b(700).as<float>()));
+  EXPECT_TRUE(std::isnan(b(701).as<float>()));
+}
+
+TEST(Float16, Arithmetic)
+{
+  nd::array a = nd::empty(300, ndt::type("float16"));
+  nd::array b = nd::empty(300, ndt::type("float16"));
+  for (int i = 0; i < 300; ++i) {
+    a(i).vals() = 0.5f * i;
+    b(i).vals() = 2.f;
+  }
+
+  nd::array c = a + b;
+  EXPECT_EQ(ndt::type("300 * float16"), c.get_type());
+  for (int i = 0; i < 300; ++i) {
+    EXPECT_EQ(0.5f * i + 2.f, c(i).as<float>());
+  }
+  c = a - b;
+  EXPECT_EQ(0.5f * 299 - 2.f, c(299).as<float>());
+  c = a * b;
+  EXPECT_EQ(299.f, c(299).as<float>());
+  c = a / b;
+  EXPECT_EQ(0.25f * 299, c(299).as<float>());
+
+  // Strided inputs and outputs, and a scalar
+  c = a(irange().by(3)) + b(irange().by(2) < 200);
+  EXPECT_EQ(ndt::type("100 * float16"), c.get_type());
+  EXPECT_EQ(1.5f * 99 + 2.f, c(99).as<float>());
+  c = a + nd::array(float16(1.f, assign_error_nocheck));
+  EXPECT_EQ(0.5f * 299 + 1.f, c(299).as<float>());
+  EXPECT_EQ(3.f, (nd::array(float16(1.f, assign_error_nocheck)) +
+                  nd::array(float16(2.f, assign_error_nocheck))).as<float>());
+
+  // Results are rounded to float16
+  c = nd::array(float16(2048.f, assign_error_nocheck)) +
+      nd::array(float16(1.f, assign_error_nocheck));
+  EXPECT_EQ(2048.f, c.as<float>());
+}
@@ -0,0 +1,251 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
+#include <dynd/memblock/array_memory_block.hpp>
+#include <dynd/memblock/pod_memory_block.hpp>
+#include <dynd/memblock/fixed_size_pod_memory_block.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    struct counting_allocator : memory_allocator {
+        intptr_t m_allocate_calls, m_deallocate_calls;
+
+        static void *allocate_func(memory_allocator *self, size_t size_bytes)
+        {
+            ++static_cast<counting_allocator *>(self)->m_allocate_calls;
+            return malloc(size_bytes);
+        }
+
+        static void deallocate_func(memory_allocator *self, void *ptr, size_t DYND_UNUSED(size_bytes))
+        {
+            ++static_cast<counting_allocator *>(self)->m_deallocate_calls;
+            free(ptr);
+        }
+
+        counting_allocator()
+            : memory_allocator(&allocate_func, &deallocate_func),
+              m_allocate_calls(0), m_deallocate_calls(0)
+        {
+        }
+    };
+
+    /** Installs an allocator for the duration of a scope */
+    struct allocator_scope {
+        memory_allocator *m_previous;
+
+        allocator_scope(memory_allocator *alloc)
+            : m_previous(set_memory_allocator(alloc))
+        {
+        }
+
+        ~allocator_scope()
+        {
+            set_memory_allocator(m_previous);
+        }
+    };
+} // anonymous namespace
+
+TEST(MemoryAllocator, Default) {
+    EXPECT_EQ(get_malloc_memory_allocator(), get_memory_allocator());
+    memory_allocator *prev = set_memory_allocator(NULL);
+    EXPECT_EQ(get_malloc_memory_allocator(), prev);
+    EXPECT_EQ(get_malloc_memory_allocator(), get_memory_allocator());
+}
+
+TEST(MemoryAllocator, ArrayAccounting) {
+    counting_allocator alloc;
+    {
+        allocator_scope s(&alloc);
+        nd::array a = nd::empty(100, ndt::make_type<int32_t>());
+        EXPECT_EQ(1, alloc.m_allocate_calls);
+        EXPECT_EQ(1, alloc.allocation_count_by_type[array_memory_block_type].load());
+        EXPECT_LE(400, alloc.live_bytes.load());
+        EXPECT_EQ(alloc.live_bytes.load(), alloc.live_bytes_by_type[array_memory_block_type].load());
+        EXPECT_EQ(alloc.live_bytes.load(), alloc.peak_bytes.load());
+        intptr_t peak = alloc.peak_bytes.load();
+
+        a = nd::array();
+        EXPECT_EQ(1, alloc.m_deallocate_calls);
+        EXPECT_EQ(0, alloc.live_bytes.load());
+        EXPECT_EQ(peak, alloc.peak_bytes.load());
+        alloc.reset_peak();
+        EXPECT_EQ(0, alloc.peak_bytes.load());
+    }
+
+    // Arrays created after restoring the previous allocator don't touch it
+    nd::array b = nd::empty(100, ndt::make_type<int32_t>());
+    EXPECT_EQ(1, alloc.m_allocate_calls);
+}
+
+TEST(MemoryAllocator, FreedByOriginatingAllocator) {
+    counting_allocator alloc;
+    nd::array a;
+    {
+        allocator_scope s(&alloc);
+        a = nd::empty(10, ndt::make_type<double>());
+    }
+    EXPECT_EQ(1, alloc.m_allocate_calls);
+    EXPECT_EQ(0, alloc.m_deallocate_calls);
+    // Freeing after the allocator was uninstalled still goes back to it
+    a = nd::array();
+    EXPECT_EQ(1, alloc.m_deallocate_calls);
+    EXPECT_EQ(0, alloc.live_bytes.load());
+}
+
+TEST(MemoryAllocator, PODMemoryBlock) {
+    counting_allocator alloc;
+    allocator_scope s(&alloc);
+    memory_block_ptr mb = make_pod_memory_block(64);
+    EXPECT_EQ(64, alloc.live_bytes_by_type[pod_memory_block_type].load());
+    memory_block_pod_allocator_api *api = get_memory_block_pod_allocator_api(mb.get());
+    char *begin, *end;
+    api->allocate(mb.get(), 32, 1, &begin, &end);
+    EXPECT_EQ(1, alloc.allocation_count_by_type[pod_memory_block_type].load());
+    // Allocating past the capacity brings in another chunk
+    api->allocate(mb.get(), 100, 1, &begin, &end);
+    EXPECT_EQ(2, alloc.allocation_count_by_type[pod_memory_block_type].load());
+    EXPECT_EQ(alloc.live_bytes.load(), alloc.live_bytes_by_type[pod_memory_block_type].load());
+    mb = memory_block_ptr();
+    EXPECT_EQ(0, alloc.live_bytes.load());
+    EXPECT_EQ(alloc.m_allocate_calls, alloc.m_deallocate_calls);
+}
+
+TEST(MemoryAllocator, PODMemoryBlockReset) {
+    counting_allocator alloc;
+    allocator_scope s(&alloc);
+    memory_block_ptr mb = make_pod_memory_block(64);
+    memory_block_pod_allocator_api *api = get_memory_block_pod_allocator_api(mb.get());
+    char *begin, *end;
+    // A batch which needs several chunks
+    for (int i = 0; i < 10; ++i) {
+        api->allocate(mb.get(), 100, 1, &begin, &end);
+    }
+    EXPECT_LT(1, alloc.allocation_count_by_type[pod_memory_block_type].load());
+    // The reset consolidates into one chunk big enough for the whole batch
+    api->reset(mb.get());
+    intptr_t count = alloc.allocation_count_by_type[pod_memory_block_type].load();
+    EXPECT_EQ(1, alloc.m_allocate_calls - alloc.m_deallocate_calls);
+    // So repeating the same batch doesn't touch the allocator
+    for (int batch = 0; batch < 5; ++batch) {
+        for (int i = 0; i < 10; ++i) {
+            api->allocate(mb.get(), 100, 1, &begin, &end);
+        }
+        api->reset(mb.get());
+    }
+    EXPECT_EQ(count, alloc.allocation_count_by_type[pod_memory_block_type].load());
+}
+
+TEST(MemoryAllocator, PODMemoryBlockResizeReleasesChunk) {
+    counting_allocator alloc;
+    allocator_scope s(&alloc);
+    memory_block_ptr mb = make_pod_memory_block(64);
+    memory_block_pod_allocator_api *api = get_memory_block_pod_allocator_api(mb.get());
+    char *begin, *end;
+    api->allocate(mb.get(), 16, 1, &begin, &end);
+    memset(begin, 7, 16);
+    // Growing the only allocation by doubling keeps one chunk live at a time
+    for (intptr_t size = 32; size <= 4096; size *= 2) {
+        api->resize(mb.get(), size, &begin, &end);
+        EXPECT_EQ(size, end - begin);
+        EXPECT_EQ(1, alloc.m_allocate_calls - alloc.m_deallocate_calls);
+    }
+    EXPECT_EQ(7, begin[0]);
+    EXPECT_EQ(7, begin[15]);
+}
+
+TEST(MemoryAllocator, FixedSizePODMemoryBlock) {
+    counting_allocator alloc;
+    allocator_scope s(&alloc);
+    char *data = NULL;
+    memory_block_ptr mb = make_fixed_size_pod_memory_block(100, 16, &data);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(data) % 16);
+    EXPECT_LE(100, alloc.live_bytes_by_type[fixed_size_pod_memory_block_type].load());
+    mb = memory_block_ptr();
+    EXPECT_EQ(0, alloc.live_bytes.load());
+}
+
+TEST(MemoryAllocator, Limit) {
+    counting_allocator alloc;
+    allocator_scope s(&alloc);
+    alloc.limit_bytes = 1024;
+    nd::array a = nd::empty(16, ndt::make_type<int32_t>());
+    EXPECT_THROW(nd::empty(1024, ndt::make_type<int32_t>()), bad_alloc);
+    // The failed allocation was not counted
+    EXPECT_EQ(1, alloc.m_allocate_calls);
+    a = nd::array();
+    EXPECT_EQ(0, alloc.live_bytes.load());
+}
+
+TEST(ArrayMemoryBlockPool, Reuse) {
+    bool prev = set_array_memory_block_pool_enabled(true);
+    nd::array a = nd::empty(4, ndt::make_type<int32_t>());
+    const array_preamble *ndo = a.get_ndo();
+    a = nd::array();
+    // The most recently freed block of the size class is handed out again
+    nd::array b = nd::empty(3, ndt::make_type<int32_t>());
+    EXPECT_EQ(ndo, b.get_ndo());
+    // It comes back zeroed like a fresh block
+    EXPECT_EQ(NULL, b.get_ndo()->m_data_reference);
+    EXPECT_EQ(3, b.get_dim_size());
+    set_array_memory_block_pool_enabled(prev);
+}
+
+TEST(ArrayMemoryBlockPool, Counted) {
+    bool prev = set_array_memory_block_pool_enabled(true);
+    memory_allocator *alloc = get_malloc_memory_allocator();
+    nd::array a = nd::empty(4, ndt::make_type<int32_t>());
+    a = nd::array();
+    intptr_t count = alloc->allocation_count_by_type[array_memory_block_type].load();
+    // Taking the block back out of the pool counts as an allocation
+    nd::array b = nd::empty(4, ndt::make_type<int32_t>());
+    EXPECT_EQ(count + 1, alloc->allocation_count_by_type[array_memory_block_type].load());
+    set_array_memory_block_pool_enabled(prev);
+}
+
+TEST(ArrayMemoryBlockPool, Disabled) {
+    bool prev = set_array_memory_block_pool_enabled(false);
+    memory_allocator *alloc = get_malloc_memory_allocator();
+    intptr_t live = alloc->live_bytes.load();
+    nd::array a = nd::empty(4, ndt::make_type<int32_t>());
+    EXPECT_LT(live, alloc->live_bytes.load());
+    a = nd::array();
+    EXPECT_EQ(live, alloc->live_bytes.load());
+    set_array_memory_block_pool_enabled(prev);
+}
+
+TEST(ArrayMemoryBlockPool, LargeNotPooled) {
+    bool prev = set_array_memory_block_pool_enabled(true);
+    memory_allocator *alloc = get_malloc_memory_allocator();
+    intptr_t live = alloc->live_bytes.load();
+    nd::array a = nd::empty(10000, ndt::make_type<int32_t>());
+    a = nd::array();
+    EXPECT_EQ(live, alloc->live_bytes.load());
+    set_array_memory_block_pool_enabled(prev);
+}
+
+TEST(ArrayMemoryBlockPool, Clear) {
+    bool prev = set_array_memory_block_pool_enabled(true);
+    clear_array_memory_block_pool();
+    memory_allocator *alloc = get_malloc_memory_allocator();
+    intptr_t live = alloc->live_bytes.load();
+    nd::array a = nd::empty(4, ndt::make_type<int32_t>());
+    a = nd::array();
+    // The freed block is held in the cache until it is cleared
+    EXPECT_LT(live, alloc->live_bytes.load());
+    clear_array_memory_block_pool();
+    EXPECT_EQ(live, alloc->live_bytes.load());
+    set_array_memory_block_pool_enabled(prev);
+}
@@ -0,0 +1,69 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <atomic>
+#include <vector>
+#include "inc_gtest.hpp"
+
+#include "dynd/parallel.hpp"
+
+using namespace std;
+using namespace dynd;
+
+TEST(Parallel, For)
+{
+  vector<int> seen(5, 0);
+  detail::parallel_for(5, [&](int t) { ++seen[t]; });
+  for (int t = 0; t < 5; ++t) {
+    EXPECT_EQ(1, seen[t]);
+  }
+}
+
+TEST(Parallel, Exceptions)
+{
+  // Exceptions on any thread reach the caller once every thread is done
+  for (int thrower = 0; thrower < 4; ++thrower) {
+    atomic<int> finished(0);
+    EXPECT_THROW(detail::parallel_for(4, [&](int t) {
+      if (t == thrower) {
+        throw runtime_error("parallel_for test");
+      }
+      ++finished;
+    }), runtime_error);
+    EXPECT_EQ(3, finished.load());
+  }
+}
+
+TEST(Parallel, ThreadPool)
+{
+  // The same threads run every call, whatever its task count
+  detail::thread_pool pool(4);
+  EXPECT_EQ(4, pool.get_thread_count());
+  for (int task_count = 0; task_count < 10; ++task_count) {
+    vector<atomic<int>> seen(task_count);
+    pool.parallel_for(task_count, [&](int t) { ++seen[t]; });
+    for (int t = 0; t < task_count; ++t) {
+      EXPECT_EQ(1, seen[t].load());
+    }
+  }
+
+  atomic<int> finished(0);
+  EXPECT_THROW(pool.parallel_for(6, [&](int t) {
+    if (t == 5) {
+      throw runtime_error("thread_pool test");
+    }
+    ++finished;
+  }), runtime_error);
+  EXPECT_EQ(5, finished.load());
+
+  // The pool still works after a task threw
+  vector<int> seen(8, 0);
+  pool.parallel_for(8, [&](int t) { ++seen[t]; });
+  for (int t = 0; t < 8; ++t) {
+    EXPECT_EQ(1, seen[t]);
+  }
+}
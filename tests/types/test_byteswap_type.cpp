@@ -78,3 +78,53 @@ TEST(ByteswapDType, CanonicalDType) {
     // The canonical type of a byteswap type is always the non-swapped version
     EXPECT_EQ((ndt::make_type<float>()), (ndt::make_byteswap<float>().get_canonical_type()));
 }
+
+TEST(ByteswapDType, StridedAssign) {
+    // Enough values to use the SIMD blocks and a tail
+    const int n = 37;
+    nd::array a = nd::empty(n, ndt::make_byteswap<int32_t>());
+    char *data = a.get_readwrite_originptr();
+    for (int i = 0; i < n; ++i) {
+        int32_t value = i * 0x01020304;
+        for (int j = 0; j < 4; ++j) {
+            data[4 * i + j] = reinterpret_cast<char *>(&value)[3 - j];
+        }
+    }
+
+    nd::array b = nd::empty(n, ndt::make_type<int32_t>());
+    b.vals() = a;
+    for (int i = 0; i < n; ++i) {
+        EXPECT_EQ(i * 0x01020304, b(i).as<int32_t>());
+    }
+    // Strided, and chained with a conversion to float64
+    nd::array c = nd::empty(13, ndt::make_type<double>());
+    c.vals() = a(irange().by(3));
+    for (int i = 0; i < 13; ++i) {
+        EXPECT_EQ(3 * i * 0x01020304, c(i).as<double>());
+    }
+    // Back to the swapped storage
+    nd::array d = nd::empty(n, ndt::make_byteswap<int32_t>());
+    d.vals() = b;
+    EXPECT_EQ(0, memcmp(data, d.get_readonly_originptr(), 4 * n));
+
+    // Pairwise swaps of complex values, and full swaps of 16 byte values
+    nd::array e = nd::empty(n, ndt::make_byteswap<dynd::complex<double> >());
+    data = e.get_readwrite_originptr();
+    for (int i = 0; i < 16 * n; ++i) {
+        data[i] = static_cast<char>(i);
+    }
+    nd::array f = nd::empty(n, ndt::make_type<dynd::complex<double> >());
+    f.vals() = e;
+    const char *fdata = f.get_readonly_originptr();
+    for (int i = 0; i < 16 * n; ++i) {
+        EXPECT_EQ(data[i], fdata[(i & ~7) + 7 - (i & 7)]);
+    }
+    nd::array g = nd::empty(n, ndt::make_byteswap<uint128>());
+    memcpy(g.get_readwrite_originptr(), data, 16 * n);
+    nd::array h = nd::empty(n, ndt::make_type<uint128>());
+    h.vals() = g;
+    const char *hdata = h.get_readonly_originptr();
+    for (int i = 0; i < 16 * n; ++i) {
+        EXPECT_EQ(data[i], hdata[(i & ~15) + 15 - (i & 15)]);
+    }
+}
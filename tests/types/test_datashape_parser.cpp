@@ -871,3 +871,75 @@ TEST(DataShapeParser, SpecialCharacterFields)
                 string::npos);
   }
 }
+
+TEST(DataShapeParser, SimpleFastPath)
+{
+  // Dimensions over a builtin scalar skip the full parser, and must give the
+  // same types as it does
+  EXPECT_EQ(ndt::make_type<int32>(), type_from_datashape("  int  "));
+  EXPECT_EQ(ndt::make_fixed_dim(3, ndt::make_var_dim(ndt::make_fixed_dim_kind(
+                                       ndt::make_type<float64>()))),
+            type_from_datashape("3 * var *Fixed*  real"));
+  EXPECT_EQ(ndt::make_fixed_dim(12345678901LL, ndt::make_type<bool1>()),
+            type_from_datashape("12345678901 * bool"));
+  EXPECT_EQ(ndt::make_fixed_dim(0, ndt::make_type<int8>()),
+            type_from_datashape("0 * int8"));
+  EXPECT_EQ(ndt::make_fixed_dim(3, ndt::make_string()),
+            type_from_datashape("3 * string"));
+  EXPECT_EQ(ndt::make_fixed_dim(2, ndt::make_fixed_dim(2, ndt::make_type<int>())),
+            type_from_datashape("2 **2 * int"));
+  EXPECT_THROW(type_from_datashape("3 * int33"), runtime_error);
+  EXPECT_THROW(type_from_datashape("3 * "), runtime_error);
+  EXPECT_THROW(type_from_datashape("x * int32"), runtime_error);
+}
+
+TEST(DataShapeParser, Cache)
+{
+  clear_datashape_cache();
+  ndt::type a = ndt::type("{x: int32, y: var * string}");
+  ndt::type b = ndt::type("{x: int32, y: var * string}");
+  EXPECT_EQ(a.extended(), b.extended());
+  datashape_cache_stats stats = get_datashape_cache_stats();
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+  EXPECT_EQ(1, stats.size);
+
+  // Errors are not cached
+  EXPECT_THROW(ndt::type("{x: int32"), runtime_error);
+  EXPECT_THROW(ndt::type("{x: int32"), runtime_error);
+  stats = get_datashape_cache_stats();
+  EXPECT_EQ(3, stats.misses);
+  EXPECT_EQ(1, stats.size);
+
+  // The least recently used datashape is evicted
+  intptr_t capacity = stats.capacity;
+  set_datashape_cache_capacity(2);
+  ndt::type("3 * int32");
+  ndt::type("{x: int32, y: var * string}");
+  ndt::type("4 * int32");
+  stats = get_datashape_cache_stats();
+  EXPECT_EQ(2, stats.size);
+  EXPECT_EQ(2, stats.hits);
+  ndt::type("3 * int32");
+  stats = get_datashape_cache_stats();
+  EXPECT_EQ(2, stats.hits);
+  EXPECT_EQ(6, stats.misses);
+
+  // Evicted types which aren't used elsewhere are freed
+  set_datashape_cache_capacity(16);
+  size_t interned = ndt::get_interned_type_count();
+  for (int i = 0; i < 200; ++i) {
+    ndt::type("{x: int32, y: " + to_string(3000 + i) + " * float64}");
+  }
+  EXPECT_GE(interned + 16, ndt::get_interned_type_count());
+
+  // A capacity of 0 disables the cache
+  set_datashape_cache_capacity(0);
+  EXPECT_EQ(0, get_datashape_cache_stats().size);
+  EXPECT_EQ(ndt::make_fixed_dim(4, ndt::make_type<int32>()),
+            ndt::type("4 * int32"));
+  EXPECT_EQ(0, get_datashape_cache_stats().size);
+
+  set_datashape_cache_capacity(capacity);
+  clear_datashape_cache();
+}
@@ -6,11 +6,13 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <cstring>
 #include "inc_gtest.hpp"
 
 #include <dynd/array.hpp>
 #include <dynd/string.hpp>
 #include <dynd/types/datetime_type.hpp>
+#include <dynd/types/datetime_parser.hpp>
 #include <dynd/types/property_type.hpp>
 #include <dynd/types/fixed_string_type.hpp>
 #include <dynd/types/string_type.hpp>
@@ -137,6 +139,91 @@ TEST(DatetimeType, ConvertToString) {
                     nd::array("2013-02-16T12:13:19.0123456Z").cast(ndt::type("datetime[tz='UTC']")).as<string>());
 }
 
+TEST(DatetimeType, ConvertISO8601Column) {
+    // Mixes strings matching the fixed ISO 8601 fast path with ones which
+    // need the general parser
+    const char *strs[] = {
+        "2013-02-16T12:13:19.012", "2013-02-17T01:02:03.456",
+        "2013-02-17T01:02:03.4", "2013-02-18 05:06", "2013-02-18 23:59",
+        "Fri Dec 19 15:10:11 1997", "2013-02-30T01:02", "2013-02-28T24:02",
+        "1600-02-29T00:00", "2013-02-19T07:08:09.987654321"};
+    const char *expected[] = {
+        "2013-02-16T12:13:19.012", "2013-02-17T01:02:03.456",
+        "2013-02-17T01:02:03.4", "2013-02-18T05:06", "2013-02-18T23:59",
+        "1997-12-19T15:10:11", NULL, NULL,
+        "1600-02-29T00:00", "2013-02-19T07:08:09.9876543"};
+    for (size_t i = 0; i < sizeof(strs) / sizeof(strs[0]); ++i) {
+        nd::array a = nd::empty(3, ndt::make_string());
+        a(0).vals() = "2000-01-01T00:00:00.000";
+        a(1).vals() = strs[i];
+        a(2).vals() = "2000-01-02T00:00:00.000";
+        if (expected[i] == NULL) {
+            EXPECT_THROW(a.ucast(ndt::make_datetime()).eval(), invalid_argument);
+        } else {
+            nd::array b = a.ucast(ndt::make_datetime()).eval();
+            EXPECT_EQ("2000-01-01T00:00", b(0).as<string>());
+            EXPECT_EQ(expected[i], b(1).as<string>());
+            EXPECT_EQ("2000-01-02T00:00", b(2).as<string>());
+        }
+    }
+}
+
+TEST(DatetimeType, ConvertToStringExpandedYear) {
+    ndt::type d = ndt::make_datetime(tz_utc), di = ndt::make_type<int64_t>();
+    EXPECT_EQ("+010000-01-01T00:00Z",
+              nd::array("+010000-01-01T00:00Z").ucast(d).eval().as<string>());
+    EXPECT_EQ("-000001-12-31T23:59:59.5Z",
+              nd::array("-000001-12-31T23:59:59.5Z").ucast(d).eval().as<string>());
+    EXPECT_EQ("0001-01-01T00:00:00.0000001Z",
+              nd::array("0001-01-01T00:00:00.0000001Z").ucast(d).eval().as<string>());
+}
+
+TEST(DateTimeParser, ISO8601Layout) {
+    const char *strs[] = {
+        "1991-02-03T04:05", "1991-02-03 04:05Z", "1991-02-03T04:05:06",
+        "1991-02-03T04:05:06Z", "1991-02-03 04:05:06.1",
+        "1991-02-03T04:05:06.123456789Z", "9999-12-31T23:59:59.9999999"};
+    for (size_t i = 0; i < sizeof(strs) / sizeof(strs[0]); ++i) {
+        const char *begin = strs[i], *end = begin + strlen(begin);
+        parse::iso8601_datetime_layout layout;
+        EXPECT_TRUE(layout.detect(begin, end));
+        EXPECT_EQ(end - begin, layout.size);
+        int64_t ticks;
+        EXPECT_TRUE(layout.parse(begin, end, ticks));
+        datetime_struct dts;
+        dts.set_from_str(strs[i]);
+        EXPECT_EQ(dts.to_ticks(), ticks);
+    }
+
+    parse::iso8601_datetime_layout layout;
+    const char *s = "1991-02-03T04:05:06";
+    EXPECT_TRUE(layout.detect(s, s + strlen(s)));
+    int64_t ticks = 0;
+    // Same length but not matching
+    s = "1991-02-03T04:05.06";
+    EXPECT_FALSE(layout.parse(s, s + strlen(s), ticks));
+    s = "1991-02-03 04:05:06";
+    EXPECT_FALSE(layout.parse(s, s + strlen(s), ticks));
+    s = "1991-02-3xT04:05:06";
+    EXPECT_FALSE(layout.parse(s, s + strlen(s), ticks));
+    s = "1991-13-03T04:05:06";
+    EXPECT_FALSE(layout.parse(s, s + strlen(s), ticks));
+    s = "1991-02-03T04:60:06";
+    EXPECT_FALSE(layout.parse(s, s + strlen(s), ticks));
+    // Different length
+    s = "1991-02-03T04:05:06Z";
+    EXPECT_FALSE(layout.parse(s, s + strlen(s), ticks));
+
+    // Strings without a fixed layout
+    s = "1991-02-03T04";
+    EXPECT_FALSE(layout.detect(s, s + strlen(s)));
+    EXPECT_FALSE(layout.parse(s, s + strlen(s), ticks));
+    s = "1991-02-03T04:05:06+0100";
+    EXPECT_FALSE(layout.detect(s, s + strlen(s)));
+    s = "1991-02-30T04:05:06";
+    EXPECT_FALSE(layout.detect(s, s + strlen(s)));
+}
+
 TEST(DatetimeType, AbstractTZToUTC) {
     // Assigning from an abstract/naive timezone to UTC is allowed, the datetime
     // value adopts the destination time zone.
@@ -6,10 +6,14 @@
 #include <complex>
 #include <iostream>
 #include <stdexcept>
+#include <unordered_map>
 #include "inc_gtest.hpp"
 
 #include <dynd/type.hpp>
 #include <dynd/types/ndarrayarg_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -168,3 +172,50 @@ TEST(Type, NDArrayArg) {
     // Roundtripping through a string
     EXPECT_EQ(d, ndt::type(d.str()));
 }
+
+TEST(Type, Intern) {
+  // Types parsed from datashapes are interned, so share one instance
+  ndt::type a = ndt::type("{x: int32, y: 3 * string}");
+  ndt::type b = ndt::type("{x: int32,   y: 3 * string}");
+  EXPECT_TRUE(a.extended()->is_interned());
+  EXPECT_EQ(a.extended(), b.extended());
+  EXPECT_EQ(a.get_hash(), b.get_hash());
+
+  // A separately constructed equal type interns to the same instance
+  ndt::type c = ndt::make_struct(ndt::make_type<int32_t>(), "x",
+                                 ndt::make_fixed_dim(3, ndt::make_string()),
+                                 "y");
+  EXPECT_FALSE(c.extended()->is_interned());
+  EXPECT_EQ(a, c);
+  EXPECT_EQ(a.get_hash(), c.get_hash());
+  EXPECT_EQ(a.extended(), ndt::intern(c).extended());
+
+  // Different interned types are unequal
+  ndt::type d = ndt::type("{x: int32, y: 4 * string}");
+  EXPECT_NE(a, d);
+  EXPECT_NE(a.get_hash(), d.get_hash());
+
+  // Types can be hash table keys
+  unordered_map<ndt::type, int> m;
+  m[a] = 1;
+  m[d] = 2;
+  m[ndt::make_type<int32_t>()] = 3;
+  EXPECT_EQ(1, m[c]);
+  EXPECT_EQ(2, m[ndt::type("{x: int32, y: 4 * string}")]);
+  EXPECT_EQ(3, m[ndt::type("int32")]);
+  EXPECT_EQ(3u, m.size());
+}
+
+TEST(Type, InternReleased) {
+  // Interned types which are no longer used leave the intern table
+  size_t count = ndt::get_interned_type_count();
+  {
+    vector<ndt::type> types;
+    for (int i = 0; i < 500; ++i) {
+      types.push_back(ndt::intern(
+          ndt::make_fixed_dim(1000 + i, ndt::make_type<double>())));
+    }
+    EXPECT_EQ(count + 500, ndt::get_interned_type_count());
+  }
+  EXPECT_EQ(count, ndt::get_interned_type_count());
+}